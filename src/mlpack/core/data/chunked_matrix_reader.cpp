@@ -0,0 +1,246 @@
+/**
+ * @file core/data/chunked_matrix_reader.cpp
+ *
+ * Implementation of the ChunkedMatrixReader class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "chunked_matrix_reader.hpp"
+#include "extension.hpp"
+
+using namespace mlpack;
+using namespace mlpack::data;
+
+namespace {
+
+/**
+ * Parse the values of one line of a CSV or text file.  Commas and whitespace
+ * both separate values.  Returns false if something that isn't a number is
+ * found.
+ */
+bool ParseLine(std::string& line, std::vector<double>& values)
+{
+  values.clear();
+  std::replace(line.begin(), line.end(), ',', ' ');
+
+  const char* position = line.c_str();
+  while (true)
+  {
+    char* end;
+    const double value = std::strtod(position, &end);
+    if (end == position)
+    {
+      // Only trailing whitespace may be left.
+      while (std::isspace((unsigned char) *end))
+        ++end;
+      return (*end == '\0');
+    }
+
+    values.push_back(value);
+    position = end;
+  }
+}
+
+} // namespace
+
+ChunkedMatrixReader::ChunkedMatrixReader(const std::string& filename,
+                                         const size_t chunkSize,
+                                         const bool prefetch) :
+    filename(filename),
+    chunkSize(chunkSize),
+    prefetch(prefetch),
+    binary(false),
+    dimensionality(0),
+    points(0),
+    pointsKnown(false),
+    pointsRead(0),
+    linesRead(0)
+{
+  if (chunkSize == 0)
+  {
+    throw std::invalid_argument("ChunkedMatrixReader::ChunkedMatrixReader(): "
+        "the chunk size must be greater than 0!");
+  }
+
+  const std::string extension = Extension(filename);
+  if (extension == "bin")
+  {
+    binary = true;
+  }
+  else if (extension != "csv" && extension != "txt")
+  {
+    throw std::runtime_error("ChunkedMatrixReader::ChunkedMatrixReader(): "
+        "cannot read '" + filename + "'; only .csv, .txt, and .bin files can "
+        "be read in chunks!");
+  }
+
+  stream.open(filename, std::ifstream::in | std::ifstream::binary);
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("ChunkedMatrixReader::ChunkedMatrixReader(): "
+        "cannot open file '" + filename + "'!");
+  }
+
+  if (binary)
+  {
+    // The header gives the size of the matrix.
+    std::string header;
+    stream >> header >> dimensionality >> points;
+    if (!stream || header != "ARMA_MAT_BIN_FN008")
+    {
+      throw std::runtime_error("ChunkedMatrixReader::ChunkedMatrixReader(): "
+          "'" + filename + "' is not an Armadillo binary file of doubles!");
+    }
+    stream.get(); // Skip the end of the header line.
+    pointsKnown = true;
+  }
+  else
+  {
+    // The first line that isn't empty gives the dimensionality.
+    std::string line;
+    std::vector<double> values;
+    while (values.empty() && std::getline(stream, line))
+    {
+      if (!ParseLine(line, values))
+      {
+        throw std::runtime_error("ChunkedMatrixReader::ChunkedMatrixReader(): "
+            "cannot parse '" + filename + "'!");
+      }
+    }
+    dimensionality = values.size();
+
+    stream.clear();
+    stream.seekg(0);
+  }
+
+  if (dimensionality == 0)
+  {
+    throw std::runtime_error("ChunkedMatrixReader::ChunkedMatrixReader(): '" +
+        filename + "' is empty!");
+  }
+
+  dataStart = stream.tellg();
+}
+
+ChunkedMatrixReader::~ChunkedMatrixReader()
+{
+  if (pendingRead.valid())
+    pendingRead.wait();
+}
+
+bool ChunkedMatrixReader::NextChunk(arma::mat& chunk)
+{
+  if (!prefetch)
+  {
+    ReadChunk(chunk);
+    return (chunk.n_cols > 0);
+  }
+
+  // Start the read now if the last call didn't.
+  if (!pendingRead.valid())
+    pendingRead = std::async(std::launch::async, [this]() {
+        ReadChunk(nextChunk); });
+
+  WaitForRead();
+  chunk.swap(nextChunk);
+
+  // Read the chunk after this one while this one is in use.
+  if (chunk.n_cols > 0)
+  {
+    pendingRead = std::async(std::launch::async, [this]() {
+        ReadChunk(nextChunk); });
+  }
+
+  return (chunk.n_cols > 0);
+}
+
+void ChunkedMatrixReader::Rewind()
+{
+  WaitForRead();
+
+  stream.clear();
+  stream.seekg(dataStart);
+  pointsRead = 0;
+  linesRead = 0;
+}
+
+size_t ChunkedMatrixReader::Points()
+{
+  if (!pointsKnown)
+  {
+    // Count the lines that aren't empty, with a separate stream so that any
+    // read in progress is not disturbed.
+    std::ifstream counter(filename, std::ifstream::in | std::ifstream::binary);
+    std::string line;
+    while (std::getline(counter, line))
+    {
+      const bool empty = std::all_of(line.begin(), line.end(),
+          [](const char c) { return std::isspace((unsigned char) c); });
+      if (!empty)
+        ++points;
+    }
+    pointsKnown = true;
+  }
+
+  return points;
+}
+
+void ChunkedMatrixReader::ReadChunk(arma::mat& chunk)
+{
+  if (binary)
+  {
+    const size_t numPoints = std::min(chunkSize, points - pointsRead);
+    chunk.set_size(dimensionality, numPoints);
+    if (!stream.read(reinterpret_cast<char*>(chunk.memptr()),
+        sizeof(double) * chunk.n_elem))
+    {
+      throw std::runtime_error("ChunkedMatrixReader::NextChunk(): unexpected "
+          "end of file '" + filename + "'!");
+    }
+    pointsRead += numPoints;
+    return;
+  }
+
+  chunk.set_size(dimensionality, chunkSize);
+  size_t numPoints = 0;
+  std::string line;
+  std::vector<double> values;
+  while (numPoints < chunkSize && std::getline(stream, line))
+  {
+    ++linesRead;
+    if (!ParseLine(line, values))
+    {
+      std::ostringstream oss;
+      oss << "ChunkedMatrixReader::NextChunk(): cannot parse line " << linesRead
+          << " of '" << filename << "'!";
+      throw std::runtime_error(oss.str());
+    }
+
+    if (values.empty())
+      continue;
+
+    if (values.size() != dimensionality)
+    {
+      std::ostringstream oss;
+      oss << "ChunkedMatrixReader::NextChunk(): line " << linesRead << " of '"
+          << filename << "' has " << values.size() << " values, but "
+          << dimensionality << " were expected!";
+      throw std::runtime_error(oss.str());
+    }
+
+    std::copy(values.begin(), values.end(), chunk.colptr(numPoints));
+    ++numPoints;
+  }
+
+  chunk.resize(dimensionality, numPoints);
+  pointsRead += numPoints;
+}
+
+void ChunkedMatrixReader::WaitForRead()
+{
+  if (pendingRead.valid())
+    pendingRead.get();
+}
@@ -0,0 +1,143 @@
+/**
+ * @file core/data/chunked_matrix_reader.hpp
+ *
+ * The ChunkedMatrixReader class, which reads a dataset from disk a chunk of
+ * points at a time, so that datasets larger than memory can be processed.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_CHUNKED_MATRIX_READER_HPP
+#define MLPACK_CORE_DATA_CHUNKED_MATRIX_READER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <fstream>
+#include <future>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A ChunkedMatrixReader reads the points of a dataset file in order, a chunk
+ * of points at a time, so that only one or two chunks are in memory at once.
+ * Each chunk has one point per column, like the matrices given by data::Load().
+ * The reader can be rewound to make another pass over the file.
+ *
+ * Two formats are supported, chosen by the extension of the file:
+ *
+ *  - CSV (.csv) or whitespace-separated text (.txt), with one point per line,
+ *    as written by data::Save();
+ *  - Armadillo binary (.bin), with one point per column of the stored matrix,
+ *    as written by arma::mat::save() or by data::Save() with transpose set to
+ *    false.  (data::Save() writes one point per row by default, which can't be
+ *    read a point at a time.)
+ *
+ * If prefetching is enabled, the next chunk is read on another thread while
+ * the current chunk is in use (double buffering), so that the disk reads
+ * overlap whatever is done with each chunk.
+ *
+ * @code
+ * data::ChunkedMatrixReader reader("huge.csv", 100000);
+ * arma::mat chunk;
+ * while (reader.NextChunk(chunk))
+ * {
+ *   // Use the chunk.
+ * }
+ * reader.Rewind(); // Make another pass.
+ * @endcode
+ */
+class ChunkedMatrixReader
+{
+ public:
+  /**
+   * Open the given file.  A std::runtime_error is thrown if the file can't be
+   * opened or its format is not supported.
+   *
+   * @param filename Name of the file to read.
+   * @param chunkSize Maximum number of points in each chunk.
+   * @param prefetch If true, read each chunk while the previous one is in use.
+   */
+  ChunkedMatrixReader(const std::string& filename,
+                      const size_t chunkSize = 65536,
+                      const bool prefetch = true);
+
+  //! A reader can't be copied.
+  ChunkedMatrixReader(const ChunkedMatrixReader& other) = delete;
+  //! A reader can't be copied.
+  ChunkedMatrixReader& operator=(const ChunkedMatrixReader& other) = delete;
+
+  //! Wait for any read in progress.
+  ~ChunkedMatrixReader();
+
+  /**
+   * Get the next chunk of points.  When the end of the file has been reached,
+   * the chunk is empty and false is returned.  A std::runtime_error is thrown
+   * if the file is malformed.
+   *
+   * @param chunk Matrix to store the points in (one per column).
+   * @return false if there were no points left.
+   */
+  bool NextChunk(arma::mat& chunk);
+
+  //! Go back to the first point of the file.
+  void Rewind();
+
+  //! Get the dimensionality of the points.
+  size_t Dimensionality() const { return dimensionality; }
+
+  /**
+   * Get the number of points in the file.  For text files, this takes a pass
+   * over the file the first time it is called.
+   */
+  size_t Points();
+
+  //! Get the maximum number of points in each chunk.
+  size_t ChunkSize() const { return chunkSize; }
+
+  //! Get the name of the file.
+  const std::string& Filename() const { return filename; }
+
+ private:
+  //! Read the next chunk of the file into the given matrix.
+  void ReadChunk(arma::mat& chunk);
+
+  //! Wait for the read in progress, if any, and rethrow its errors.
+  void WaitForRead();
+
+  //! The name of the file.
+  std::string filename;
+  //! The maximum number of points in each chunk.
+  size_t chunkSize;
+  //! Whether or not the next chunk is read ahead.
+  bool prefetch;
+  //! Whether or not the file is binary (otherwise it is text).
+  bool binary;
+
+  //! The file.
+  std::ifstream stream;
+  //! The position of the first point in the file.
+  std::streampos dataStart;
+  //! The dimensionality of the points.
+  size_t dimensionality;
+  //! The number of points in the file (if known).
+  size_t points;
+  //! Whether or not the number of points is known.
+  bool pointsKnown;
+  //! The number of points read since the file was rewound.
+  size_t pointsRead;
+  //! The number of lines read since the file was rewound (for text files).
+  size_t linesRead;
+
+  //! The chunk read ahead.
+  arma::mat nextChunk;
+  //! The read of the chunk ahead, if it is in progress.
+  std::future<void> pendingRead;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -16,13 +16,15 @@
 namespace mlpack {
 namespace data {
 
-//! Define the formats we can read through cereal.
+//! Define the formats we can read through cereal, and the memory-mapped format
+//! that some models can be saved in.
 enum format
 {
   autodetect,
   json,
   xml,
-  binary
+  binary,
+  mapped
 };
 
 } // namespace data
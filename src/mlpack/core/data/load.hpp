@@ -344,8 +344,14 @@ extern template bool Load<double, IncrementPolicy>(
  *  - xml, denoted by .xml
  *  - binary, denoted by .bin
  *
+ * Models that have SaveMapped() and LoadMapped() members (such as NSModel and
+ * RSModel) can also be loaded in a format that is memory-mapped when loaded:
+ *
+ *  - mapped, denoted by .mmap
+ *
  * The format parameter can take any of the values in the 'format' enum:
- * 'format::autodetect', 'format::json', 'format::xml', and 'format::binary'.
+ * 'format::autodetect', 'format::json', 'format::xml', 'format::binary', and
+ * 'format::mapped'.
  * The autodetect functionality operates on the file extension (so, "file.txt"
  * would be autodetected as text).
  *
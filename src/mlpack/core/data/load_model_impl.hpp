@@ -19,6 +19,7 @@
 #include <mlpack/core/util/timers.hpp>
 
 #include "extension.hpp"
+#include "mapped_file.hpp"
 
 #include <boost/tokenizer.hpp>
 #include <boost/algorithm/string.hpp>
@@ -31,6 +32,52 @@
 namespace mlpack {
 namespace data {
 
+// Load a model that supports the memory-mapped format from file.
+template<typename T>
+bool LoadMappedModel(
+    const std::string& filename,
+    const std::string& name,
+    T& t,
+    const bool fatal,
+    const typename std::enable_if_t<HasMappedFormat<T>::value>* = 0)
+{
+  try
+  {
+    t.LoadMapped(filename);
+    return true;
+  }
+  catch (std::exception& e)
+  {
+    if (fatal)
+      Log::Fatal << "Unable to load object '" << name << "' from '" << filename
+          << "': " << e.what() << std::endl;
+    else
+      Log::Warn << "Unable to load object '" << name << "' from '" << filename
+          << "': " << e.what() << std::endl;
+
+    return false;
+  }
+}
+
+// The model can't be loaded from the memory-mapped format, so give an error.
+template<typename T>
+bool LoadMappedModel(
+    const std::string& filename,
+    const std::string& name,
+    T& /* t */,
+    const bool fatal,
+    const typename std::enable_if_t<!HasMappedFormat<T>::value>* = 0)
+{
+  if (fatal)
+    Log::Fatal << "Unable to load object '" << name << "' from '" << filename
+        << "': it does not support the memory-mapped format." << std::endl;
+  else
+    Log::Warn << "Unable to load object '" << name << "' from '" << filename
+        << "': it does not support the memory-mapped format." << std::endl;
+
+  return false;
+}
+
 // Load a model from file.
 template<typename T>
 bool Load(const std::string& filename,
@@ -49,6 +96,8 @@ bool Load(const std::string& filename,
       f = format::binary;
     else if (extension == "json")
       f = format::json;
+    else if (extension == "mmap")
+      f = format::mapped;
     else
     {
       if (fatal)
@@ -62,6 +111,10 @@ bool Load(const std::string& filename,
     }
   }
 
+  // Models in the memory-mapped format map their own files.
+  if (f == format::mapped)
+    return LoadMappedModel(filename, name, t, fatal);
+
   // Now load the given format.
   std::ifstream ifs;
 #ifdef _WIN32 // Open non-text in binary mode on Windows.
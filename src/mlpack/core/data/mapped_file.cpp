@@ -0,0 +1,88 @@
+/**
+ * @file core/data/mapped_file.cpp
+ *
+ * Implementation of the MappedFile class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "mapped_file.hpp"
+
+#ifdef _WIN32
+  #include <fstream>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+using namespace mlpack;
+using namespace mlpack::data;
+
+MappedFile::MappedFile(const std::string& filename) :
+    data(NULL),
+    size(0)
+{
+#ifdef _WIN32
+  std::ifstream ifs(filename, std::ifstream::in | std::ifstream::binary);
+  if (!ifs.is_open())
+  {
+    throw std::runtime_error("MappedFile::MappedFile(): cannot open file '" +
+        filename + "'!");
+  }
+
+  ifs.seekg(0, std::ios::end);
+  size = (size_t) ifs.tellg();
+  ifs.seekg(0, std::ios::beg);
+
+  data = new char[size];
+  if (!ifs.read(data, size))
+  {
+    delete[] data;
+    throw std::runtime_error("MappedFile::MappedFile(): cannot read file '" +
+        filename + "'!");
+  }
+#else
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd == -1)
+  {
+    throw std::runtime_error("MappedFile::MappedFile(): cannot open file '" +
+        filename + "'!");
+  }
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) == -1 || fileStat.st_size == 0)
+  {
+    close(fd);
+    throw std::runtime_error("MappedFile::MappedFile(): cannot map file '" +
+        filename + "'; it is empty or cannot be read!");
+  }
+
+  size = (size_t) fileStat.st_size;
+
+  // A private, writable mapping shares the pages with the page cache until
+  // they are written to.
+  void* mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+
+  if (mapping == MAP_FAILED)
+  {
+    throw std::runtime_error("MappedFile::MappedFile(): cannot map file '" +
+        filename + "'!");
+  }
+
+  data = static_cast<char*>(mapping);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+  delete[] data;
+#else
+  munmap(data, size);
+#endif
+}
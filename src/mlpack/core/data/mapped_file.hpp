@@ -0,0 +1,133 @@
+/**
+ * @file core/data/mapped_file.hpp
+ *
+ * The MappedFile class, which maps a file into memory so that its contents can
+ * be used in place, and utilities to write and read the memory-mapped format
+ * that models can be saved in.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_FILE_HPP
+#define MLPACK_CORE_DATA_MAPPED_FILE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A MappedFile maps a file into memory, so that its contents can be used in
+ * place without being read.  The mapping is private: the memory may be written
+ * to, but the writes are never seen by the file or by other processes, and
+ * only the pages that are written to are copied.  The pages that are only read
+ * are shared with the page cache, and thus with every other process that has
+ * mapped the same file.
+ *
+ * On Windows, the file is read into memory instead.
+ */
+class MappedFile
+{
+ public:
+  /**
+   * Map the given file into memory.  A std::runtime_error is thrown if the
+   * file can't be opened or mapped.
+   *
+   * @param filename Name of the file to map.
+   */
+  MappedFile(const std::string& filename);
+
+  //! A mapping can't be copied.
+  MappedFile(const MappedFile& other) = delete;
+  //! A mapping can't be copied.
+  MappedFile& operator=(const MappedFile& other) = delete;
+
+  //! Unmap the file.
+  ~MappedFile();
+
+  //! Get the contents of the file.
+  char* Data() const { return data; }
+  //! Get the size of the file, in bytes.
+  size_t Size() const { return size; }
+
+ private:
+  //! The contents of the file.
+  char* data;
+  //! The size of the file, in bytes.
+  size_t size;
+};
+
+/**
+ * Write the given objects to the stream, followed by enough padding that the
+ * number of bytes written is a multiple of 8.  As long as everything in a
+ * stream is written with this function, every array read with ReadMapped()
+ * will then be suitably aligned.  T must be trivially copyable.
+ *
+ * @param stream Stream to write to.
+ * @param values Objects to write.
+ * @param n Number of objects to write.
+ */
+template<typename T>
+void WriteMapped(std::ostream& stream, const T* values, const size_t n)
+{
+  const size_t bytes = n * sizeof(T);
+  stream.write(reinterpret_cast<const char*>(values), bytes);
+
+  const char padding[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+  stream.write(padding, (8 - bytes % 8) % 8);
+}
+
+/**
+ * Get the objects written by WriteMapped() at the given offset in the given
+ * memory, and advance the offset past them.  No objects are copied.  A
+ * std::runtime_error is thrown if the memory is too small.
+ *
+ * @param memory Memory written by WriteMapped().
+ * @param size Size of the memory, in bytes.
+ * @param offset Offset of the objects in the memory.  On return, the offset of
+ *     whatever was written next.
+ * @param n Number of objects to get.
+ * @return Pointer to the first object.
+ */
+template<typename T>
+T* ReadMapped(char* memory, const size_t size, size_t& offset, const uint64_t n)
+{
+  // The number of objects usually comes from the memory itself, so make sure
+  // that it can't overflow.
+  if (offset > size || n > (size - offset) / sizeof(T))
+  {
+    throw std::runtime_error("ReadMapped(): unexpected end of memory-mapped "
+        "data!");
+  }
+
+  const size_t bytes = n * sizeof(T);
+  T* values = reinterpret_cast<T*>(memory + offset);
+  offset += bytes + (8 - bytes % 8) % 8;
+  return values;
+}
+
+// These give us HasSaveMappedCheck<T, U> and HasLoadMappedCheck<T, U> types,
+// which we can use with SFINAE to find types that can be memory-mapped.
+HAS_MEM_FUNC(SaveMapped, HasSaveMappedCheck);
+HAS_MEM_FUNC(LoadMapped, HasLoadMappedCheck);
+
+/**
+ * 'value' is true if the type T can be saved in the memory-mapped format, which
+ * means it has a member void SaveMapped(const std::string& filename) const and
+ * a member void LoadMapped(const std::string& filename).
+ */
+template<typename T>
+struct HasMappedFormat
+{
+  static const bool value =
+      HasSaveMappedCheck<T, void(T::*)(const std::string&) const>::value &&
+      HasLoadMappedCheck<T, void(T::*)(const std::string&)>::value;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
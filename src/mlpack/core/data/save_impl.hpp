@@ -16,6 +16,7 @@
 #include "save.hpp"
 #include "extension.hpp"
 #include "detect_file_type.hpp"
+#include "mapped_file.hpp"
 
 #include <cereal/archives/xml.hpp>
 #include <cereal/archives/json.hpp>
@@ -259,6 +260,52 @@ bool Save(const std::string& filename,
   return true;
 }
 
+//! Save a model that supports the memory-mapped format to file.
+template<typename T>
+bool SaveMappedModel(
+    const std::string& filename,
+    const std::string& name,
+    T& t,
+    const bool fatal,
+    const typename std::enable_if_t<HasMappedFormat<T>::value>* = 0)
+{
+  try
+  {
+    t.SaveMapped(filename);
+    return true;
+  }
+  catch (std::exception& e)
+  {
+    if (fatal)
+      Log::Fatal << "Unable to save object '" << name << "' to '" << filename
+          << "': " << e.what() << std::endl;
+    else
+      Log::Warn << "Unable to save object '" << name << "' to '" << filename
+          << "': " << e.what() << std::endl;
+
+    return false;
+  }
+}
+
+//! The model can't be saved in the memory-mapped format, so give an error.
+template<typename T>
+bool SaveMappedModel(
+    const std::string& filename,
+    const std::string& name,
+    T& /* t */,
+    const bool fatal,
+    const typename std::enable_if_t<!HasMappedFormat<T>::value>* = 0)
+{
+  if (fatal)
+    Log::Fatal << "Unable to save object '" << name << "' to '" << filename
+        << "': it does not support the memory-mapped format." << std::endl;
+  else
+    Log::Warn << "Unable to save object '" << name << "' to '" << filename
+        << "': it does not support the memory-mapped format." << std::endl;
+
+  return false;
+}
+
 //! Save a model to file.
 template<typename T>
 bool Save(const std::string& filename,
@@ -277,20 +324,26 @@ bool Save(const std::string& filename,
       f = format::binary;
     else if (extension == "json")
       f = format::json;
+    else if (extension == "mmap")
+      f = format::mapped;
     else
     {
       if (fatal)
         Log::Fatal << "Unable to detect type of '" << filename << "'; incorrect"
-            << " extension? (allowed: xml/bin/json)" << std::endl;
+            << " extension? (allowed: xml/bin/json/mmap)" << std::endl;
       else
         Log::Warn << "Unable to detect type of '" << filename << "'; save "
-            << "failed.  Incorrect extension? (allowed: xml/bin/json)"
+            << "failed.  Incorrect extension? (allowed: xml/bin/json/mmap)"
             << std::endl;
 
       return false;
     }
   }
 
+  // Models in the memory-mapped format write their own files.
+  if (f == format::mapped)
+    return SaveMappedModel(filename, name, t, fatal);
+
   // Open the file to save to.
   std::ofstream ofs;
 #ifdef _WIN32
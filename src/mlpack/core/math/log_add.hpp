@@ -36,6 +36,16 @@ T LogAdd(T x, T y);
 template<typename T>
 typename T::elem_type AccuLog(const T& x);
 
+/**
+ * Element-wise log-addition of two objects of the same size.  (T should be an
+ * Armadillo type.)
+ *
+ * @param x matrix of log values; this is overwritten with log(e^x + e^y)
+ * @param y matrix of log values
+ */
+template<typename T>
+void LogAddInPlace(T& x, const T& y);
+
 } // namespace math
 } // namespace mlpack
 
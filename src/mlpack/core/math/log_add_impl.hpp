@@ -71,6 +71,25 @@ typename T::elem_type AccuLog(const T& x)
   return sum;
 }
 
+/**
+ * Element-wise log-addition of two objects of the same size.
+ *
+ * @param x matrix of log values; this is overwritten with log(e^x + e^y)
+ * @param y matrix of log values
+ */
+template<typename T>
+void LogAddInPlace(T& x, const T& y)
+{
+  typedef typename T::elem_type ElemType;
+  const ElemType negInf = -std::numeric_limits<ElemType>::infinity();
+
+  const T maxes = arma::max(x, y);
+  x = maxes + arma::log(1 + arma::exp(arma::min(x, y) - maxes));
+
+  // Where both values are -inf, the difference above is NaN.
+  x.elem(arma::find(maxes == negInf)).fill(negInf);
+}
+
 } // namespace math
 } // namespace mlpack
 
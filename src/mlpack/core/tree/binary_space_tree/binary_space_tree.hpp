@@ -13,12 +13,26 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include <mlpack/core/data/mapped_file.hpp>
 #include "../statistic.hpp"
 #include "midpoint_split.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
 
+/**
+ * The order in which BinarySpaceTree::Pack() lays out the nodes of a tree in
+ * memory.
+ */
+enum PackingOrder
+{
+  //! All nodes of one level of the tree come before those of the next level.
+  BREADTH_FIRST_ORDER,
+  //! The van Emde Boas layout: the top half of the levels of the tree is laid
+  //! out first, followed by each subtree of the bottom half, recursively.
+  VAN_EMDE_BOAS_ORDER
+};
+
 /**
  * A binary space partitioning tree, such as a KD-tree or a ball tree.  Once the
  * bound and type of dataset is defined, the tree will construct itself.  Call
@@ -88,6 +102,31 @@ class BinarySpaceTree
   //! The dataset.  If we are the root of the tree, we own the dataset and must
   //! delete it.
   MatType* dataset;
+  //! If this is the root of a packed tree, the contiguous block holding every
+  //! other node of the tree (NULL otherwise).
+  BinarySpaceTree* packedNodes;
+  //! The number of nodes in packedNodes.
+  size_t numPackedNodes;
+  //! If this is the root of a packed tree, the contiguous block holding the
+  //! bound ranges of every node in packedNodes (if the bound type allows it).
+  std::vector<math::RangeType<ElemType>> packedBounds;
+
+  //! Identifies the memory-mapped format written by SaveMapped().  All of the
+  //! integers in the format are 64-bit, so that it does not depend on the
+  //! platform.
+  static const uint64_t mappedFormatId = 0x314d4d5453424c4dULL;
+  //! The depth of the tree above which nodes are split one level at a time
+  //! when the tree is built in parallel; the subtrees below it are built in
+  //! parallel.
+  static const size_t parallelBuildDepth = 8;
+  //! Whether the tree can be built in parallel.  This is not possible with a
+  //! HollowBallBound, since the bound of a right child depends on the bound of
+  //! its left sibling.
+  static const bool canBuildInParallel =
+      SplitTraits<SplitType<BoundType<MetricType>, MatType>>::
+          CanSplitInParallel &&
+      !std::is_same<BoundType<MetricType>,
+          bound::HollowBallBound<MetricType>>::value;
 
  public:
   //! A single-tree traverser for binary space trees; see
@@ -308,6 +347,25 @@ class BinarySpaceTree
       Archive& ar,
       const typename std::enable_if_t<cereal::is_loading<Archive>()>* = 0);
 
+  /**
+   * Create a packed tree from a tree written by SaveMapped(), using the
+   * dataset and the bounds in place in the given memory (which is usually a
+   * data::MappedFile).  Nothing but the structure of the tree is copied, so
+   * the memory must outlive the tree.  Only trees with an HRectBound and a
+   * dense matrix can be used this way.  A std::runtime_error is thrown if the
+   * memory does not hold a tree of this type.
+   *
+   * The statistics are not stored, and are default-constructed rather than
+   * built from the nodes, so that loading the tree does not touch the dataset;
+   * the caller must initialize anything else the statistics need.
+   *
+   * @param memory Memory holding the tree.
+   * @param size Size of the memory, in bytes.
+   * @param offset Offset of the tree in the memory.  On return, the offset of
+   *     whatever was written after the tree.
+   */
+  BinarySpaceTree(char* memory, const size_t size, size_t& offset);
+
   /**
    * Deletes this node, deallocating the memory for the children and calling
    * their destructors in turn.  This will invalidate any pointers or references
@@ -507,6 +565,35 @@ class BinarySpaceTree
   //! Store the center of the bounding region in the given vector.
   void Center(arma::vec& center) const { bound.Center(center); }
 
+  /**
+   * Move every node of the tree except the root into one contiguous block of
+   * memory, in the given order.  If the bound type is an HRectBound, the ranges
+   * of all of the moved bounds are also stored in one contiguous block, in the
+   * same order.  This reduces the cache misses incurred when the tree is
+   * traversed; the structure of the tree is not changed, so any traverser can
+   * be used with a packed tree.  Pointers and references to any node other
+   * than the root are invalidated, including any held by statistics.  This can
+   * only be called on the root of a tree; a tree that is already packed is
+   * packed again in the given order.
+   *
+   * @param order Order of the nodes in the packed block.
+   */
+  void Pack(const PackingOrder order = BREADTH_FIRST_ORDER);
+
+  //! Return whether or not the nodes of this tree are packed (only the root
+  //! knows this).
+  bool IsPacked() const { return packedNodes != NULL; }
+
+  /**
+   * Write the tree, with its dataset, in a format that can be used in place
+   * after it is memory-mapped; see the BinarySpaceTree(memory, size, offset)
+   * constructor.  The statistics are not written; they are created again when
+   * the tree is loaded.  Only the root of a tree can be written.
+   *
+   * @param stream Stream to write the tree to.
+   */
+  void SaveMapped(std::ostream& stream) const;
+
  private:
   /**
    * Splits the current node, assigning its left and right children recursively.
@@ -529,6 +616,48 @@ class BinarySpaceTree
                  const size_t maxLeafSize,
                  SplitType<BoundType<MetricType>, MatType>& splitter);
 
+  /**
+   * Construct this node as a child of the given parent, holding the given
+   * points, without splitting it.  This is used by SplitNodeParallel(), which
+   * splits the node later.
+   *
+   * @param parent Parent of this node.
+   * @param begin Index of the first point held by this node.
+   * @param count Number of points held by this node.
+   */
+  BinarySpaceTree(BinarySpaceTree* parent,
+                  const size_t begin,
+                  const size_t count);
+
+  /**
+   * Build the tree below this node, which must be the root, in parallel.  The
+   * nodes above depth parallelBuildDepth are split one level at a time (with
+   * each split itself done in parallel, if the splitter supports it), and then
+   * the subtrees below them, which hold disjoint sets of points, are built in
+   * parallel with SplitNode().  The tree, and the permutation of the points, is
+   * the same as the one SplitNode() builds.
+   *
+   * @param oldFromNew If not NULL, the vector holding the permuted indices.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param splitter Instantiated SplitType object.
+   */
+  void SplitNodeParallel(std::vector<size_t>* oldFromNew,
+                         const size_t maxLeafSize,
+                         SplitType<BoundType<MetricType>, MatType>& splitter);
+
+  /**
+   * Split this node once, creating its left and right children without
+   * splitting them.  The bound of this node is updated.
+   *
+   * @param oldFromNew If not NULL, the vector holding the permuted indices.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param splitter Instantiated SplitType object.
+   * @return false if this node is a leaf.
+   */
+  bool SplitNodeOnce(std::vector<size_t>* oldFromNew,
+                     const size_t maxLeafSize,
+                     SplitType<BoundType<MetricType>, MatType>& splitter);
+
   /**
    * Update the bound of the current node. This method does not take into
    * account bound-specific properties.
@@ -546,6 +675,42 @@ class BinarySpaceTree
    */
   void UpdateBound(bound::HollowBallBound<MetricType>& boundToUpdate);
 
+  /**
+   * Delete the children of this node, whether they are held in a packed block
+   * or were allocated one at a time.
+   */
+  void DeleteChildren();
+
+  /**
+   * Collect the nodes of the subtree rooted at the given node, down to (but not
+   * including) the given relative depth, in van Emde Boas order.
+   */
+  static void VanEmdeBoasOrder(BinarySpaceTree* node,
+                               const size_t height,
+                               std::vector<BinarySpaceTree*>& nodes);
+
+  /**
+   * Return the number of levels of the subtree rooted at this node.
+   */
+  size_t Height() const;
+
+  /**
+   * Bounds other than HRectBound can't be stored in external memory, so do
+   * nothing.
+   */
+  template<typename BoundType2>
+  static void PackBound(BoundType2& /* boundToPack */,
+                        math::RangeType<ElemType>* /* memory */) { }
+
+  /**
+   * Store the ranges of the given HRectBound in the given memory.
+   */
+  static void PackBound(bound::HRectBound<MetricType, ElemType>& boundToPack,
+                        math::RangeType<ElemType>* memory)
+  {
+    boundToPack.UseExternalMemory(memory);
+  }
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
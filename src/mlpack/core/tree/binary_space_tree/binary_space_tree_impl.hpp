@@ -16,6 +16,7 @@
 
 #include <mlpack/core/util/log.hpp>
 #include <queue>
+#include <unordered_map>
 
 namespace mlpack {
 namespace tree {
@@ -39,7 +40,9 @@ BinarySpaceTree(
     count(data.n_cols), /* and spans all of the dataset. */
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Do the actual splitting of this node.
   SplitType<BoundType<MetricType>, MatType> splitter;
@@ -67,7 +70,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(data.n_cols);
@@ -101,7 +106,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(data.n_cols);
@@ -136,7 +143,9 @@ BinarySpaceTree(MatType&& data, const size_t maxLeafSize) :
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Do the actual splitting of this node.
   SplitType<BoundType<MetricType>, MatType> splitter;
@@ -164,7 +173,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -198,7 +209,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -237,7 +250,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset()) // Point to the parent's dataset.
+    dataset(&parent->Dataset()), // Point to the parent's dataset.
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Perform the actual splitting.
   SplitNode(maxLeafSize, splitter);
@@ -266,7 +281,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -300,7 +317,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset()->n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -318,6 +337,32 @@ BinarySpaceTree(
     newFromOld[oldFromNew[i]] = i;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BinarySpaceTree(
+    BinarySpaceTree* parent,
+    const size_t begin,
+    const size_t count) :
+    left(NULL),
+    right(NULL),
+    parent(parent),
+    begin(begin),
+    count(count),
+    bound(parent->Dataset().n_rows),
+    parentDistance(0),
+    furthestDescendantDistance(0),
+    dataset(&parent->Dataset()),
+    packedNodes(NULL),
+    numPackedNodes(0)
+{
+  // Nothing to do: the node is split later.
+}
+
 /**
  * Create a binary space tree by copying the other tree.  Be careful!  This can
  * take a long time and use a lot of memory.
@@ -342,7 +387,9 @@ BinarySpaceTree(
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
     // Copy matrix, but only if we are the root.
-    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL)
+    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL),
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Create left and right children (if any).
   if (other.Left())
@@ -398,8 +445,7 @@ operator=(const BinarySpaceTree& other)
 
   // Freeing memory that will not be used anymore.
   delete dataset;
-  delete left;
-  delete right;
+  DeleteChildren();
 
   left = NULL;
   right = NULL;
@@ -470,8 +516,7 @@ operator=(BinarySpaceTree&& other)
 
   // Freeing memory that will not be used anymore.
   delete dataset;
-  delete left;
-  delete right;
+  DeleteChildren();
 
   parent = other.Parent();
   left = other.Left();
@@ -484,6 +529,9 @@ operator=(BinarySpaceTree&& other)
   furthestDescendantDistance = other.FurthestDescendantDistance();
   minimumBoundDistance = other.MinimumBoundDistance();
   dataset = other.dataset;
+  packedNodes = other.packedNodes;
+  numPackedNodes = other.numPackedNodes;
+  packedBounds = std::move(other.packedBounds);
 
   other.left = NULL;
   other.right = NULL;
@@ -494,6 +542,8 @@ operator=(BinarySpaceTree&& other)
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
   other.dataset = NULL;
+  other.packedNodes = NULL;
+  other.numPackedNodes = 0;
 
   return *this;
 }
@@ -520,7 +570,10 @@ BinarySpaceTree(BinarySpaceTree&& other) :
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
-    dataset(other.dataset)
+    dataset(other.dataset),
+    packedNodes(other.packedNodes),
+    numPackedNodes(other.numPackedNodes),
+    packedBounds(std::move(other.packedBounds))
 {
   // Now we are a clone of the other tree.  But we must also clear the other
   // tree's contents, so it doesn't delete anything when it is destructed.
@@ -533,6 +586,8 @@ BinarySpaceTree(BinarySpaceTree&& other) :
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
   other.dataset = NULL;
+  other.packedNodes = NULL;
+  other.numPackedNodes = 0;
 
   // Set new parent.
   if (left)
@@ -562,6 +617,111 @@ BinarySpaceTree(
   ar(CEREAL_NVP(*this));
 }
 
+/**
+ * Create a packed tree that uses the dataset and bounds of a tree written by
+ * SaveMapped() in place.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BinarySpaceTree(char* memory, const size_t size, size_t& offset) :
+    BinarySpaceTree() // Create an empty BinarySpaceTree.
+{
+  static_assert(std::is_same<BoundType<MetricType>,
+      bound::HRectBound<MetricType, ElemType>>::value &&
+      std::is_same<MatType, arma::Mat<ElemType>>::value,
+      "Only trees with an HRectBound and a dense matrix can be memory-mapped.");
+
+  const uint64_t* header = data::ReadMapped<uint64_t>(memory, size, offset, 5);
+  if (header[0] != mappedFormatId || header[1] != sizeof(ElemType) ||
+      header[4] == 0)
+  {
+    throw std::runtime_error("BinarySpaceTree::BinarySpaceTree(): the memory "
+        "does not hold a tree of this type!");
+  }
+
+  const uint64_t maxSize = std::numeric_limits<size_t>::max();
+  if (header[2] > maxSize || header[3] > maxSize || header[4] > maxSize)
+  {
+    throw std::runtime_error("BinarySpaceTree::BinarySpaceTree(): the tree is "
+        "too large for this platform!");
+  }
+
+  const size_t dim = (size_t) header[2];
+  const size_t numPoints = (size_t) header[3];
+  const size_t numNodes = (size_t) header[4];
+
+  ElemType* points = data::ReadMapped<ElemType>(memory, size, offset,
+      (uint64_t) dim * numPoints);
+  const uint64_t* structure = data::ReadMapped<uint64_t>(memory, size, offset,
+      4 * (uint64_t) numNodes);
+  const ElemType* distances = data::ReadMapped<ElemType>(memory, size, offset,
+      4 * (uint64_t) numNodes);
+  math::RangeType<ElemType>* ranges =
+      data::ReadMapped<math::RangeType<ElemType>>(memory, size, offset,
+      (uint64_t) dim * numNodes);
+
+  // The dataset is not copied.
+  dataset = new MatType(points, dim, numPoints, false, true);
+
+  if (numNodes > 1)
+  {
+    packedNodes = new BinarySpaceTree[numNodes - 1];
+    numPackedNodes = numNodes - 1;
+  }
+
+  // The nodes were written in breadth-first order, so every child comes after
+  // its parent.
+  for (size_t i = 0; i < numNodes; ++i)
+  {
+    BinarySpaceTree& node = (i == 0) ? *this : packedNodes[i - 1];
+    const uint64_t* nodeStructure = structure + 4 * i;
+    const ElemType* nodeDistances = distances + 4 * i;
+
+    if (nodeStructure[0] > numPoints ||
+        nodeStructure[1] > numPoints - nodeStructure[0] ||
+        (nodeStructure[2] != 0 && (nodeStructure[2] <= i ||
+                                   nodeStructure[2] >= numNodes)) ||
+        (nodeStructure[3] != 0 && (nodeStructure[3] <= i ||
+                                   nodeStructure[3] >= numNodes)))
+    {
+      throw std::runtime_error("BinarySpaceTree::BinarySpaceTree(): the "
+          "memory-mapped tree is corrupt!");
+    }
+
+    node.begin = (size_t) nodeStructure[0];
+    node.count = (size_t) nodeStructure[1];
+    if (nodeStructure[2] != 0)
+    {
+      node.left = &packedNodes[nodeStructure[2] - 1];
+      node.left->parent = &node;
+    }
+    if (nodeStructure[3] != 0)
+    {
+      node.right = &packedNodes[nodeStructure[3] - 1];
+      node.right->parent = &node;
+    }
+
+    node.dataset = dataset;
+    node.parentDistance = nodeDistances[0];
+    node.furthestDescendantDistance = nodeDistances[1];
+    node.minimumBoundDistance = nodeDistances[2];
+
+    // The bound is not copied either.
+    node.bound = BoundType<MetricType>(dim);
+    node.bound.UseExternalMemory(ranges + i * dim, false);
+    node.bound.MinWidth() = nodeDistances[3];
+  }
+
+  // The statistics are left default-constructed: building them from the nodes
+  // could read the whole dataset (NeighborSearchStat caches the squared norms
+  // of the points of each leaf), which would defeat the point of mapping it.
+}
+
 /**
  * Deletes this node, deallocating the memory for the children and calling their
  * destructors in turn.  This will invalidate any pointers or references to any
@@ -576,8 +736,7 @@ template<typename MetricType,
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     ~BinarySpaceTree()
 {
-  delete left;
-  delete right;
+  DeleteChildren();
 
   // If we're the root, delete the matrix.
   if (!parent)
@@ -868,6 +1027,13 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     SplitNode(const size_t maxLeafSize,
               SplitType<BoundType<MetricType>, MatType>& splitter)
 {
+  // The subtrees of the root can be built in parallel.
+  if (parent == NULL && canBuildInParallel)
+  {
+    SplitNodeParallel(NULL, maxLeafSize, splitter);
+    return;
+  }
+
   // We need to expand the bounds of this node properly.
   UpdateBound(bound);
 
@@ -935,6 +1101,13 @@ SplitNode(std::vector<size_t>& oldFromNew,
           const size_t maxLeafSize,
           SplitType<BoundType<MetricType>, MatType>& splitter)
 {
+  // The subtrees of the root can be built in parallel.
+  if (parent == NULL && canBuildInParallel)
+  {
+    SplitNodeParallel(&oldFromNew, maxLeafSize, splitter);
+    return;
+  }
+
   // We need to expand the bounds of this node properly.
   UpdateBound(bound);
 
@@ -992,6 +1165,119 @@ SplitNode(std::vector<size_t>& oldFromNew,
   right->ParentDistance() = rightParentDistance;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+SplitNodeParallel(std::vector<size_t>* oldFromNew,
+                  const size_t maxLeafSize,
+                  SplitType<BoundType<MetricType>, MatType>& splitter)
+{
+  // Split the top levels of the tree one level at a time.  The nodes that are
+  // split are kept in breadth-first order, so that they can be finished from
+  // the bottom up.
+  std::vector<BinarySpaceTree*> frontier(1, this);
+  std::vector<BinarySpaceTree*> splitNodes;
+  for (size_t level = 0; level < parallelBuildDepth && !frontier.empty();
+      ++level)
+  {
+    std::vector<BinarySpaceTree*> nextFrontier;
+    for (size_t i = 0; i < frontier.size(); ++i)
+    {
+      BinarySpaceTree* node = frontier[i];
+      if (!node->SplitNodeOnce(oldFromNew, maxLeafSize, splitter))
+      {
+        // This is a leaf, so it is finished.  The statistic of the root is
+        // created by its constructor.
+        if (node != this)
+          node->stat = StatisticType(*node);
+        continue;
+      }
+
+      splitNodes.push_back(node);
+      nextFrontier.push_back(node->left);
+      nextFrontier.push_back(node->right);
+    }
+
+    frontier.swap(nextFrontier);
+  }
+
+  // Every node in the frontier holds its own range of points, so their
+  // subtrees can be built independently.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) frontier.size(); ++i)
+  {
+    if (oldFromNew == NULL)
+      frontier[i]->SplitNode(maxLeafSize, splitter);
+    else
+      frontier[i]->SplitNode(*oldFromNew, maxLeafSize, splitter);
+
+    frontier[i]->stat = StatisticType(*frontier[i]);
+  }
+
+  // Now finish the nodes that were split, children before parents.
+  for (size_t i = splitNodes.size(); i > 0; --i)
+  {
+    BinarySpaceTree* node = splitNodes[i - 1];
+
+    // Calculate parent distances for the children.
+    arma::vec center, leftCenter, rightCenter;
+    node->Center(center);
+    node->left->Center(leftCenter);
+    node->right->Center(rightCenter);
+
+    node->left->ParentDistance() = node->bound.Metric().Evaluate(center,
+        leftCenter);
+    node->right->ParentDistance() = node->bound.Metric().Evaluate(center,
+        rightCenter);
+
+    if (node != this)
+      node->stat = StatisticType(*node);
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+bool BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+SplitNodeOnce(std::vector<size_t>* oldFromNew,
+              const size_t maxLeafSize,
+              SplitType<BoundType<MetricType>, MatType>& splitter)
+{
+  // We need to expand the bounds of this node properly.
+  UpdateBound(bound);
+
+  // Calculate the furthest descendant distance.
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+
+  // First, check if we need to split at all.
+  if (count <= maxLeafSize)
+    return false;
+
+  // Find the partition of the node, if it can be split.
+  typename Split::SplitInfo splitInfo;
+  if (!splitter.SplitNode(bound, *dataset, begin, count, splitInfo))
+    return false;
+
+  const size_t splitCol = (oldFromNew == NULL) ?
+      splitter.PerformSplit(*dataset, begin, count, splitInfo) :
+      splitter.PerformSplit(*dataset, begin, count, splitInfo, *oldFromNew);
+
+  assert(splitCol > begin);
+  assert(splitCol < begin + count);
+
+  left = new BinarySpaceTree(this, begin, splitCol - begin);
+  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol);
+
+  return true;
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -1032,6 +1318,271 @@ UpdateBound(bound::HollowBallBound<MetricType>& boundToUpdate)
     boundToUpdate |= dataset->cols(begin, begin + count - 1);
 }
 
+/**
+ * Move all nodes but the root into one contiguous block.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+Pack(const PackingOrder order)
+{
+  if (parent != NULL)
+  {
+    throw std::invalid_argument("BinarySpaceTree::Pack(): only the root of a "
+        "tree can be packed!");
+  }
+
+  // Collect the nodes in the order they will be stored; the root comes first,
+  // but it is not moved.
+  std::vector<BinarySpaceTree*> nodes;
+  if (order == VAN_EMDE_BOAS_ORDER)
+  {
+    VanEmdeBoasOrder(this, Height(), nodes);
+  }
+  else
+  {
+    nodes.push_back(this);
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      if (nodes[i]->left)
+        nodes.push_back(nodes[i]->left);
+      if (nodes[i]->right)
+        nodes.push_back(nodes[i]->right);
+    }
+  }
+
+  if (nodes.size() == 1)
+    return;
+
+  // Map each node to its new location.
+  const size_t numNodes = nodes.size() - 1;
+  BinarySpaceTree* newNodes = new BinarySpaceTree[numNodes];
+  std::unordered_map<const BinarySpaceTree*, BinarySpaceTree*> newLocation;
+  newLocation[this] = this;
+  for (size_t i = 0; i < numNodes; ++i)
+    newLocation[nodes[i + 1]] = &newNodes[i];
+
+  // Move each node into the block.  Its children are taken along, so we must
+  // fix the pointers afterwards.
+  for (size_t i = 0; i < numNodes; ++i)
+    newNodes[i] = std::move(*nodes[i + 1]);
+
+  for (size_t i = 0; i < numNodes; ++i)
+  {
+    BinarySpaceTree& node = newNodes[i];
+    node.parent = newLocation[node.parent];
+    if (node.left)
+      node.left = newLocation[node.left];
+    if (node.right)
+      node.right = newLocation[node.right];
+  }
+
+  left = newLocation[left];
+  right = newLocation[right];
+
+  // The old nodes are now empty, so they can be freed.
+  if (packedNodes)
+  {
+    delete[] packedNodes;
+  }
+  else
+  {
+    for (size_t i = 0; i < numNodes; ++i)
+      delete nodes[i + 1];
+  }
+
+  packedNodes = newNodes;
+  numPackedNodes = numNodes;
+
+  // Now store the bounds of the packed nodes in one block, in the same order.
+  std::vector<math::RangeType<ElemType>> newBounds;
+  if (std::is_same<BoundType<MetricType>,
+                   bound::HRectBound<MetricType, ElemType>>::value)
+  {
+    const size_t dim = dataset->n_rows;
+    newBounds.resize(numNodes * dim);
+    for (size_t i = 0; i < numNodes; ++i)
+      PackBound(packedNodes[i].bound, newBounds.data() + i * dim);
+  }
+  packedBounds.swap(newBounds);
+}
+
+/**
+ * Write the tree in the memory-mapped format.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+SaveMapped(std::ostream& stream) const
+{
+  static_assert(std::is_same<BoundType<MetricType>,
+      bound::HRectBound<MetricType, ElemType>>::value &&
+      std::is_same<MatType, arma::Mat<ElemType>>::value,
+      "Only trees with an HRectBound and a dense matrix can be memory-mapped.");
+
+  if (parent != NULL)
+  {
+    throw std::invalid_argument("BinarySpaceTree::SaveMapped(): only the root "
+        "of a tree can be saved!");
+  }
+
+  // Collect the nodes in breadth-first order.
+  std::vector<const BinarySpaceTree*> nodes(1, this);
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    if (nodes[i]->left)
+      nodes.push_back(nodes[i]->left);
+    if (nodes[i]->right)
+      nodes.push_back(nodes[i]->right);
+  }
+
+  const size_t dim = dataset->n_rows;
+  const size_t numNodes = nodes.size();
+  std::vector<uint64_t> structure(4 * numNodes);
+  std::vector<ElemType> distances(4 * numNodes);
+  std::vector<math::RangeType<ElemType>> ranges(dim * numNodes);
+
+  // The children were collected in the same order we visit their parents, so
+  // we can compute their indices as we go.
+  size_t nextChild = 1;
+  for (size_t i = 0; i < numNodes; ++i)
+  {
+    const BinarySpaceTree& node = *nodes[i];
+    structure[4 * i] = node.begin;
+    structure[4 * i + 1] = node.count;
+    structure[4 * i + 2] = (node.left) ? nextChild++ : 0;
+    structure[4 * i + 3] = (node.right) ? nextChild++ : 0;
+
+    distances[4 * i] = node.parentDistance;
+    distances[4 * i + 1] = node.furthestDescendantDistance;
+    distances[4 * i + 2] = node.minimumBoundDistance;
+    distances[4 * i + 3] = node.bound.MinWidth();
+
+    for (size_t d = 0; d < dim; ++d)
+      ranges[i * dim + d] = node.bound[d];
+  }
+
+  const uint64_t header[5] = { mappedFormatId, sizeof(ElemType), dim,
+      dataset->n_cols, numNodes };
+  data::WriteMapped(stream, header, 5);
+  data::WriteMapped(stream, dataset->memptr(), dataset->n_elem);
+  data::WriteMapped(stream, structure.data(), structure.size());
+  data::WriteMapped(stream, distances.data(), distances.size());
+  data::WriteMapped(stream, ranges.data(), ranges.size());
+
+  if (!stream)
+  {
+    throw std::runtime_error("BinarySpaceTree::SaveMapped(): error writing "
+        "tree!");
+  }
+}
+
+/**
+ * Delete the children of this node.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+DeleteChildren()
+{
+  if (packedNodes)
+  {
+    // The nodes in the block don't own their children.
+    for (size_t i = 0; i < numPackedNodes; ++i)
+    {
+      packedNodes[i].left = NULL;
+      packedNodes[i].right = NULL;
+    }
+
+    delete[] packedNodes;
+    packedNodes = NULL;
+    numPackedNodes = 0;
+    packedBounds.clear();
+  }
+  else
+  {
+    delete left;
+    delete right;
+  }
+
+  left = NULL;
+  right = NULL;
+}
+
+/**
+ * Collect the nodes of a subtree in van Emde Boas order.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+VanEmdeBoasOrder(BinarySpaceTree* node,
+                 const size_t height,
+                 std::vector<BinarySpaceTree*>& nodes)
+{
+  if (height == 1)
+  {
+    nodes.push_back(node);
+    return;
+  }
+
+  // First lay out the top half of the levels.
+  const size_t topHeight = height / 2;
+  VanEmdeBoasOrder(node, topHeight, nodes);
+
+  // Then find the roots of the subtrees in the bottom half of the levels, and
+  // lay out each of those subtrees.
+  std::vector<BinarySpaceTree*> level(1, node);
+  for (size_t d = 0; d < topHeight; ++d)
+  {
+    std::vector<BinarySpaceTree*> nextLevel;
+    for (size_t i = 0; i < level.size(); ++i)
+    {
+      if (level[i]->left)
+        nextLevel.push_back(level[i]->left);
+      if (level[i]->right)
+        nextLevel.push_back(level[i]->right);
+    }
+
+    level.swap(nextLevel);
+  }
+
+  for (size_t i = 0; i < level.size(); ++i)
+    VanEmdeBoasOrder(level[i], height - topHeight, nodes);
+}
+
+/**
+ * Return the number of levels of the subtree rooted at this node.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+size_t BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
+                       SplitType>::Height() const
+{
+  const size_t leftHeight = (left) ? left->Height() : 0;
+  const size_t rightHeight = (right) ? right->Height() : 0;
+  return 1 + std::max(leftHeight, rightHeight);
+}
+
 // Default constructor (private), for cereal.
 template<typename MetricType,
          typename StatisticType,
@@ -1049,7 +1600,9 @@ BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     stat(*this),
     parentDistance(0),
     furthestDescendantDistance(0),
-    dataset(NULL)
+    dataset(NULL),
+    packedNodes(NULL),
+    numPackedNodes(0)
 {
   // Nothing to do.
 }
@@ -1070,10 +1623,7 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   // If we're loading, and we have children, they need to be deleted.
   if (cereal::is_loading<Archive>())
   {
-    if (left)
-      delete left;
-    if (right)
-      delete right;
+    DeleteChildren();
     if (!parent)
       delete dataset;
 
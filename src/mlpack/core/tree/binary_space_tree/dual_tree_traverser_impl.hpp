@@ -16,6 +16,7 @@
 
 // In case it hasn't been included yet.
 #include "dual_tree_traverser.hpp"
+#include "../block_base_case.hpp"
 
 namespace mlpack {
 namespace tree {
@@ -71,7 +72,13 @@ DualTreeTraverser<RuleType>::Traverse(
   // If both are leaves, we must evaluate the base case.
   if (queryNode.IsLeaf() && referenceNode.IsLeaf())
   {
-    // Loop through each of the points in each node.
+    // If the rules can evaluate the whole block of base cases at once, let
+    // them.  Restore the traversal information first.
+    rule.TraversalInfo() = traversalInfo;
+    if (BlockBaseCase(rule, queryNode, referenceNode, numBaseCases))
+      return;
+
+    // Otherwise, loop through each of the points in each node.
     const size_t queryEnd = queryNode.Begin() + queryNode.Count();
     const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
     for (size_t query = queryNode.Begin(); query < queryEnd; ++query)
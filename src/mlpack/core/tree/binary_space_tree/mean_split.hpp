@@ -16,6 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/tree/perform_split.hpp>
+#include "split_traits.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -61,7 +62,8 @@ class MeanSplit
    * Perform the split process according to the information about the
    * split. This will order the dataset such that points that belong to the left
    * subtree are on the left of the split column, and points from the right
-   * subtree are on the right side of the split column.
+   * subtree are on the right side of the split column.  Large nodes are split
+   * in parallel; see split::ParallelPerformSplit().
    *
    * @param data The dataset used by the binary space tree.
    * @param begin Index of the starting point in the dataset that belongs to
@@ -74,8 +76,8 @@ class MeanSplit
                              const size_t count,
                              const SplitInfo& splitInfo)
   {
-    return split::PerformSplit<MatType, MeanSplit>(data, begin, count,
-        splitInfo);
+    return split::ParallelPerformSplit<MatType, MeanSplit>(data, begin,
+        count, splitInfo, NULL);
   }
 
   /**
@@ -99,8 +101,8 @@ class MeanSplit
                              const SplitInfo& splitInfo,
                              std::vector<size_t>& oldFromNew)
   {
-    return split::PerformSplit<MatType, MeanSplit>(data, begin, count,
-        splitInfo, oldFromNew);
+    return split::ParallelPerformSplit<MatType, MeanSplit>(data, begin,
+        count, splitInfo, &oldFromNew);
   }
 
   /**
@@ -117,6 +119,14 @@ class MeanSplit
   }
 };
 
+// A specialization of SplitTraits for this class.
+template<typename BoundType, typename MatType>
+struct SplitTraits<MeanSplit<BoundType, MatType>>
+{
+  //! The split is deterministic and does not modify the splitter.
+  static const bool CanSplitInParallel = true;
+};
+
 } // namespace tree
 } // namespace mlpack
 
@@ -78,10 +78,28 @@ bool MeanSplit<BoundType, MatType>::SplitNode(const BoundType& bound,
   if (maxWidth == 0) // All these points are the same.  We can't split.
     return false;
 
-  // Split in the mean of that dimension.
+  // Split in the mean of that dimension.  The sum is taken over blocks of a
+  // fixed size in parallel, so that it is the same for any number of threads.
+  const size_t numBlocks = (count + split::parallelSplitBlockSize - 1) /
+      split::parallelSplitBlockSize;
+  arma::vec blockSums(numBlocks);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t blockBegin = begin + b * split::parallelSplitBlockSize;
+    const size_t blockEnd = std::min(blockBegin + split::parallelSplitBlockSize,
+        begin + count);
+
+    double sum = 0.0;
+    for (size_t i = blockBegin; i < blockEnd; ++i)
+      sum += data(splitInfo.splitDimension, i);
+    blockSums[b] = sum;
+  }
+
   splitInfo.splitVal = 0.0;
-  for (size_t i = begin; i < begin + count; ++i)
-    splitInfo.splitVal += data(splitInfo.splitDimension, i);
+  for (size_t b = 0; b < numBlocks; ++b)
+    splitInfo.splitVal += blockSums[b];
   splitInfo.splitVal /= count;
 
   Log::Assert(splitInfo.splitVal >= bound[splitInfo.splitDimension].Lo());
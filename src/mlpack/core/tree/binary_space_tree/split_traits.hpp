@@ -0,0 +1,38 @@
+/**
+ * @file core/tree/binary_space_tree/split_traits.hpp
+ *
+ * A class for template metaprogramming traits for the split types of the
+ * BinarySpaceTree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_SPLIT_TRAITS_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_SPLIT_TRAITS_HPP
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A class to obtain compile-time traits about the SplitType classes of the
+ * BinarySpaceTree.  If you are writing your own SplitType class, you should
+ * make a template specialization in order to set the values correctly.
+ *
+ * @see TreeTraits, BoundTraits
+ */
+template<typename SplitType>
+struct SplitTraits
+{
+  //! If true, then SplitNode() and PerformSplit() may be called for different
+  //! nodes from different threads at the same time, and do not use any random
+  //! numbers, so the subtrees of a node can be built in parallel.  This
+  //! defaults to false.
+  static const bool CanSplitInParallel = false;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
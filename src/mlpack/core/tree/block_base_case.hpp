@@ -0,0 +1,79 @@
+/**
+ * @file core/tree/block_base_case.hpp
+ *
+ * Detection of rules that can evaluate all base cases between two leaves with
+ * a single call to BlockBaseCase(), and a helper that calls it if it exists.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BLOCK_BASE_CASE_HPP
+#define MLPACK_CORE_TREE_BLOCK_BASE_CASE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+
+namespace mlpack {
+namespace tree {
+
+HAS_MEM_FUNC(BlockBaseCase, HasBlockBaseCaseCheck);
+
+/**
+ * 'value' is true if the RuleType class has a member
+ * size_t BlockBaseCase(TreeType& queryNode, TreeType& referenceNode).  That
+ * function must do the same work as calling Score(queryIndex, referenceNode)
+ * for every point held in the query node and then BaseCase() for every
+ * combination of an unpruned query point and a point held in the reference
+ * node, and must return the number of base cases that were evaluated.
+ */
+template<typename RuleType, typename TreeType>
+struct HasBlockBaseCase
+{
+  static const bool value = HasBlockBaseCaseCheck<RuleType,
+      size_t(RuleType::*)(TreeType&, TreeType&)>::value;
+};
+
+/**
+ * Evaluate all base cases between the points of two leaves with
+ * RuleType::BlockBaseCase().  The number of evaluated base cases is added to
+ * numBaseCases.
+ *
+ * @return true, since the base cases were evaluated.
+ */
+template<typename RuleType, typename TreeType>
+inline bool BlockBaseCase(
+    RuleType& rule,
+    TreeType& queryNode,
+    TreeType& referenceNode,
+    size_t& numBaseCases,
+    const typename std::enable_if_t<
+        HasBlockBaseCase<RuleType, TreeType>::value>* = 0)
+{
+  numBaseCases += rule.BlockBaseCase(queryNode, referenceNode);
+  return true;
+}
+
+/**
+ * The RuleType class does not have BlockBaseCase(), so do nothing.  The caller
+ * must then evaluate the base cases one at a time.
+ *
+ * @return false, since no base cases were evaluated.
+ */
+template<typename RuleType, typename TreeType>
+inline bool BlockBaseCase(
+    RuleType& /* rule */,
+    TreeType& /* queryNode */,
+    TreeType& /* referenceNode */,
+    size_t& /* numBaseCases */,
+    const typename std::enable_if_t<
+        !HasBlockBaseCase<RuleType, TreeType>::value>* = 0)
+{
+  return false;
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
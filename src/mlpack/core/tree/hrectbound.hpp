@@ -88,6 +88,23 @@ class HRectBound
    */
   void Clear();
 
+  /**
+   * Hold the range of each dimension in the given memory instead of memory
+   * owned by the bound.  The given memory must have space for at least Dim()
+   * ranges and must outlive the bound.  The bound never frees the given memory.
+   * This allows the bounds of many tree nodes to be stored in one contiguous
+   * block.
+   *
+   * @param memory Memory to hold the ranges of each dimension.
+   * @param copy If true, the current ranges are copied into the given memory;
+   *     otherwise, the given memory already holds the ranges of the bound.
+   */
+  void UseExternalMemory(math::RangeType<ElemType>* memory,
+                         const bool copy = true);
+
+  //! Return whether or not the bound owns the memory holding its ranges.
+  bool OwnsMemory() const { return ownsMemory; }
+
   //! Gets the dimensionality.
   size_t Dim() const { return dim; }
 
@@ -236,6 +253,8 @@ class HRectBound
   size_t dim;
   //! The bounds for each dimension.
   math::RangeType<ElemType>* bounds;
+  //! Whether or not the bound owns the memory pointed to by bounds.
+  bool ownsMemory;
   //! Cached minimum width of bound.
   ElemType minWidth;
   //! Instantiated metric (likely has size 0).
@@ -27,6 +27,7 @@ template<typename MetricType, typename ElemType>
 inline HRectBound<MetricType, ElemType>::HRectBound() :
     dim(0),
     bounds(NULL),
+    ownsMemory(true),
     minWidth(0)
 { /* Nothing to do. */ }
 
@@ -38,6 +39,7 @@ template<typename MetricType, typename ElemType>
 inline HRectBound<MetricType, ElemType>::HRectBound(const size_t dimension) :
     dim(dimension),
     bounds(new math::RangeType<ElemType>[dim]),
+    ownsMemory(true),
     minWidth(0)
 { /* Nothing to do. */ }
 
@@ -49,6 +51,7 @@ inline HRectBound<MetricType, ElemType>::HRectBound(
     const HRectBound<MetricType, ElemType>& other) :
     dim(other.Dim()),
     bounds(new math::RangeType<ElemType>[dim]),
+    ownsMemory(true),
     minWidth(other.MinWidth())
 {
   // Copy other bounds over.
@@ -71,11 +74,12 @@ inline HRectBound<
   if (dim != other.Dim())
   {
     // Reallocation is necessary.
-    if (bounds)
+    if (bounds && ownsMemory)
       delete[] bounds;
 
     dim = other.Dim();
     bounds = new math::RangeType<ElemType>[dim];
+    ownsMemory = true;
   }
 
   // Now copy each of the bound values.
@@ -95,11 +99,13 @@ inline HRectBound<MetricType, ElemType>::HRectBound(
     HRectBound<MetricType, ElemType>&& other) :
     dim(other.dim),
     bounds(other.bounds),
+    ownsMemory(other.ownsMemory),
     minWidth(other.minWidth)
 {
   // Fix the other bound.
   other.dim = 0;
   other.bounds = NULL;
+  other.ownsMemory = true;
   other.minWidth = 0.0;
 }
 
@@ -109,7 +115,7 @@ inline HRectBound<MetricType, ElemType>::HRectBound(
 template<typename MetricType, typename ElemType>
 inline HRectBound<MetricType, ElemType>::~HRectBound()
 {
-  if (bounds)
+  if (bounds && ownsMemory)
     delete[] bounds;
 }
 
@@ -124,6 +130,27 @@ inline void HRectBound<MetricType, ElemType>::Clear()
   minWidth = 0;
 }
 
+/**
+ * Hold the ranges in the given memory, which the bound will not free.
+ */
+template<typename MetricType, typename ElemType>
+inline void HRectBound<MetricType, ElemType>::UseExternalMemory(
+    math::RangeType<ElemType>* memory,
+    const bool copy)
+{
+  if (copy)
+  {
+    for (size_t i = 0; i < dim; ++i)
+      memory[i] = bounds[i];
+  }
+
+  if (bounds && ownsMemory)
+    delete[] bounds;
+
+  bounds = memory;
+  ownsMemory = false;
+}
+
 /***
  * Calculates the centroid of the range, placing it into the given vector.
  *
@@ -666,6 +693,14 @@ void HRectBound<MetricType, ElemType>::serialize(
     Archive& ar,
     const uint32_t /* version */)
 {
+  // When loading, the array wrapper frees the old ranges, so make sure we own
+  // them.
+  if (cereal::is_loading<Archive>() && !ownsMemory)
+  {
+    bounds = NULL;
+    ownsMemory = true;
+  }
+
   // We can't serialize a raw array directly, so wrap it.
   ar(CEREAL_POINTER_ARRAY(bounds, dim));
   ar(CEREAL_NVP(minWidth));
@@ -808,8 +808,8 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
     // all points belonging to children of index 2^(d - 1) and above will be on
     // the right side.
     typename SplitType::SplitInfo s(d, center);
-    const size_t firstRight = split::PerformSplit<MatType, SplitType>(*dataset,
-        childBegin, childCount, s);
+    const size_t firstRight = split::ParallelPerformSplit<MatType, SplitType>(
+        *dataset, childBegin, childCount, s, NULL);
 
     // We can set the first index of the right child.  The first index of the
     // left child is already set.
@@ -846,16 +846,24 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
     }
   }
 
-  // Now that the dataset is reordered, we can create the children.
-  arma::vec childCenter(center.n_elem);
-  const double childWidth = width / 2.0;
+  // Now that the dataset is reordered, we can create the children.  Children
+  // with no points are not created.
+  std::vector<size_t> childIndices;
   for (size_t i = 0; i < childBegins.n_elem - 1; ++i)
+    if (childBegins[i + 1] - childBegins[i] > 0)
+      childIndices.push_back(i);
+
+  // Each child holds its own range of points, so the children of the root are
+  // built in parallel.
+  const double childWidth = width / 2.0;
+  children.resize(childIndices.size());
+  #pragma omp parallel for schedule(dynamic) if (parent == NULL)
+  for (omp_size_t c = 0; c < (omp_size_t) childIndices.size(); ++c)
   {
-    // If the child has no points, don't create it.
-    if (childBegins[i + 1] - childBegins[i] == 0)
-      continue;
+    const size_t i = childIndices[c];
 
     // Create the correct center.
+    arma::vec childCenter(center.n_elem);
     for (size_t d = 0; d < center.n_elem; ++d)
     {
       // Is the dimension "right" (1) or "left" (0)?
@@ -865,9 +873,9 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
         childCenter[d] = center[d] + childWidth;
     }
 
-    children.push_back(new Octree(this, childBegins[i],
+    children[c] = new Octree(this, childBegins[i],
         childBegins[i + 1] - childBegins[i], childCenter, childWidth,
-        maxLeafSize));
+        maxLeafSize);
   }
 }
 
@@ -910,8 +918,8 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
     // all points belonging to children of index 2^(d - 1) and above will be on
     // the right side.
     typename SplitType::SplitInfo s(d, center);
-    const size_t firstRight = split::PerformSplit<MatType, SplitType>(*dataset,
-        childBegin, childCount, s, oldFromNew);
+    const size_t firstRight = split::ParallelPerformSplit<MatType, SplitType>(
+        *dataset, childBegin, childCount, s, &oldFromNew);
 
     // We can set the first index of the right child.  The first index of the
     // left child is already set.
@@ -948,16 +956,24 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
     }
   }
 
-  // Now that the dataset is reordered, we can create the children.
-  arma::vec childCenter(center.n_elem);
-  const double childWidth = width / 2.0;
+  // Now that the dataset is reordered, we can create the children.  Children
+  // with no points are not created.
+  std::vector<size_t> childIndices;
   for (size_t i = 0; i < childBegins.n_elem - 1; ++i)
+    if (childBegins[i + 1] - childBegins[i] > 0)
+      childIndices.push_back(i);
+
+  // Each child holds its own range of points, so the children of the root are
+  // built in parallel.
+  const double childWidth = width / 2.0;
+  children.resize(childIndices.size());
+  #pragma omp parallel for schedule(dynamic) if (parent == NULL)
+  for (omp_size_t c = 0; c < (omp_size_t) childIndices.size(); ++c)
   {
-    // If the child has no points, don't create it.
-    if (childBegins[i + 1] - childBegins[i] == 0)
-      continue;
+    const size_t i = childIndices[c];
 
     // Create the correct center.
+    arma::vec childCenter(center.n_elem);
     for (size_t d = 0; d < center.n_elem; ++d)
     {
       // Is the dimension "right" (1) or "left" (0)?
@@ -967,9 +983,9 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
         childCenter[d] = center[d] + childWidth;
     }
 
-    children.push_back(new Octree(this, childBegins[i],
+    children[c] = new Octree(this, childBegins[i],
         childBegins[i + 1] - childBegins[i], oldFromNew, childCenter,
-        childWidth, maxLeafSize));
+        childWidth, maxLeafSize);
   }
 }
 
@@ -0,0 +1,128 @@
+/**
+ * @file core/tree/parallel_dual_tree_traverser.hpp
+ *
+ * A dual-tree traverser which splits the query tree into independent subtrees
+ * above a given depth and traverses each of those subtrees against the
+ * reference tree in parallel, using the tree's own dual-tree traverser.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_HPP
+#define MLPACK_CORE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "tree_traits.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * Tag type for the constructor of a rules object that shares the results of
+ * another rules object; see ParallelDualTreeTraverser.
+ */
+struct SharedResultsTag { };
+
+/**
+ * The ParallelDualTreeTraverser collects the nodes of the query tree at a given
+ * depth (the "frontier"), and then traverses each frontier node against the
+ * reference node in parallel with OpenMP.  Below the frontier, the given serial
+ * dual-tree traverser is used.
+ *
+ * Each frontier node is processed with its own rules object, which is created
+ * with the RuleType(RuleType&, SharedResultsTag) constructor.  That constructor
+ * must give the new rules object its own traversal state, while sharing the
+ * results with the original rules object.  Because every query point belongs
+ * to exactly one frontier node, no two threads ever modify the results of the
+ * same query point.
+ *
+ * Trees that hold the same point in more than one node (such as the cover tree
+ * or the spill tree), or whose first point is the centroid of the node, can't
+ * be split like this; for those trees the traversal is done serially.
+ *
+ * @tparam TreeType Type of tree to traverse.
+ * @tparam RuleType Type of rules to use for the traversal.
+ * @tparam DualTreeTraversalType Serial dual-tree traverser to use below the
+ *     frontier.
+ */
+template<typename TreeType,
+         typename RuleType,
+         template<typename> class DualTreeTraversalType =
+             TreeType::template DualTreeTraverser>
+class ParallelDualTreeTraverser
+{
+ public:
+  /**
+   * Instantiate the parallel dual-tree traverser with the given rule set.
+   *
+   * @param rule Rules to use for the traversal.
+   * @param depth Depth of the query tree above which subtrees are split into
+   *     parallel tasks.
+   */
+  ParallelDualTreeTraverser(RuleType& rule, const size_t depth = 8);
+
+  /**
+   * Traverse the two trees.  This does not reset the number of prunes.
+   *
+   * @param queryNode The query node to be traversed.
+   * @param referenceNode The reference node to be traversed.
+   */
+  void Traverse(TreeType& queryNode, TreeType& referenceNode);
+
+  //! Get the depth at which the query tree is split.
+  size_t Depth() const { return depth; }
+  //! Modify the depth at which the query tree is split.
+  size_t& Depth() { return depth; }
+
+  //! Get the number of prunes.
+  size_t NumPrunes() const { return numPrunes; }
+  //! Modify the number of prunes.
+  size_t& NumPrunes() { return numPrunes; }
+
+  //! Get the number of visited combinations.
+  size_t NumVisited() const { return numVisited; }
+  //! Modify the number of visited combinations.
+  size_t& NumVisited() { return numVisited; }
+
+  //! Get the number of times a node combination was scored.
+  size_t NumScores() const { return numScores; }
+  //! Modify the number of times a node combination was scored.
+  size_t& NumScores() { return numScores; }
+
+  //! Get the number of times a base case was calculated.
+  size_t NumBaseCases() const { return numBaseCases; }
+  //! Modify the number of times a base case was calculated.
+  size_t& NumBaseCases() { return numBaseCases; }
+
+ private:
+  //! Reference to the rules with which the trees will be traversed.
+  RuleType& rule;
+
+  //! The depth of the query tree at which parallel tasks are created.
+  size_t depth;
+
+  //! The number of prunes.
+  size_t numPrunes;
+
+  //! The number of node combinations that have been visited during traversal.
+  size_t numVisited;
+
+  //! The number of times a node combination was scored.
+  size_t numScores;
+
+  //! The number of times a base case was calculated.
+  size_t numBaseCases;
+
+  //! Traverse the given trees serially with the serial traverser.
+  void SerialTraverse(TreeType& queryNode, TreeType& referenceNode);
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "parallel_dual_tree_traverser_impl.hpp"
+
+#endif
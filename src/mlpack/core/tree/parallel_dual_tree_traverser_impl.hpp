@@ -0,0 +1,152 @@
+/**
+ * @file core/tree/parallel_dual_tree_traverser_impl.hpp
+ *
+ * Implementation of the ParallelDualTreeTraverser.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_IMPL_HPP
+#define MLPACK_CORE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "parallel_dual_tree_traverser.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType,
+         typename RuleType,
+         template<typename> class DualTreeTraversalType>
+ParallelDualTreeTraverser<TreeType, RuleType, DualTreeTraversalType>::
+ParallelDualTreeTraverser(RuleType& rule, const size_t depth) :
+    rule(rule),
+    depth(depth),
+    numPrunes(0),
+    numVisited(0),
+    numScores(0),
+    numBaseCases(0)
+{ /* Nothing to do. */ }
+
+template<typename TreeType,
+         typename RuleType,
+         template<typename> class DualTreeTraversalType>
+void ParallelDualTreeTraverser<TreeType, RuleType, DualTreeTraversalType>::
+Traverse(TreeType& queryNode, TreeType& referenceNode)
+{
+  // The query tree can only be split into independent subtrees if every point
+  // is held by exactly one node, and if scoring a node combination does not
+  // modify the reference node.
+  const bool canSplit = !TreeTraits<TreeType>::HasDuplicatedPoints &&
+                        !TreeTraits<TreeType>::HasSelfChildren &&
+                        !TreeTraits<TreeType>::FirstPointIsCentroid &&
+                        TreeTraits<TreeType>::UniqueNumDescendants;
+
+  if (!canSplit || depth == 0 || queryNode.NumChildren() == 0)
+  {
+    SerialTraverse(queryNode, referenceNode);
+    return;
+  }
+
+  // If both nodes are root nodes, just score them.
+  if (queryNode.Parent() == NULL && referenceNode.Parent() == NULL)
+  {
+    ++numVisited;
+    ++numScores;
+    const double rootScore = rule.Score(queryNode, referenceNode);
+    // If root score is DBL_MAX, don't recurse.
+    if (rootScore == DBL_MAX)
+    {
+      ++numPrunes;
+      return;
+    }
+  }
+
+  // Collect the query nodes at the given depth.  Leaves above that depth, and
+  // nodes that hold points themselves, are not split any further.
+  std::vector<TreeType*> frontier(1, &queryNode);
+  for (size_t level = 0; level < depth; ++level)
+  {
+    std::vector<TreeType*> nextFrontier;
+    for (size_t i = 0; i < frontier.size(); ++i)
+    {
+      TreeType* node = frontier[i];
+      if (node->NumChildren() == 0 || node->NumPoints() > 0)
+      {
+        nextFrontier.push_back(node);
+        continue;
+      }
+
+      for (size_t c = 0; c < node->NumChildren(); ++c)
+        nextFrontier.push_back(&node->Child(c));
+    }
+
+    frontier.swap(nextFrontier);
+  }
+
+  size_t prunes = 0;
+  size_t visited = 0;
+  size_t scores = 0;
+  size_t baseCases = 0;
+  size_t ruleScores = 0;
+  size_t ruleBaseCases = 0;
+
+  #pragma omp parallel for schedule(dynamic) \
+      reduction(+:prunes, visited, scores, baseCases, ruleScores, ruleBaseCases)
+  for (omp_size_t i = 0; i < (omp_size_t) frontier.size(); ++i)
+  {
+    // Each query subtree gets its own rules, which share the results of the
+    // original rules.
+    RuleType taskRule(rule, SharedResultsTag());
+
+    ++scores;
+    const double score = taskRule.Score(*frontier[i], referenceNode);
+    if (score == DBL_MAX)
+    {
+      ++prunes;
+    }
+    else
+    {
+      DualTreeTraversalType<RuleType> traverser(taskRule);
+      traverser.Traverse(*frontier[i], referenceNode);
+
+      prunes += traverser.NumPrunes();
+      visited += traverser.NumVisited();
+      scores += traverser.NumScores();
+      baseCases += traverser.NumBaseCases();
+    }
+
+    ruleScores += taskRule.Scores();
+    ruleBaseCases += taskRule.BaseCases();
+  }
+
+  numPrunes += prunes;
+  numVisited += visited;
+  numScores += scores;
+  numBaseCases += baseCases;
+
+  rule.Scores() += ruleScores;
+  rule.BaseCases() += ruleBaseCases;
+}
+
+template<typename TreeType,
+         typename RuleType,
+         template<typename> class DualTreeTraversalType>
+void ParallelDualTreeTraverser<TreeType, RuleType, DualTreeTraversalType>::
+SerialTraverse(TreeType& queryNode, TreeType& referenceNode)
+{
+  DualTreeTraversalType<RuleType> traverser(rule);
+  traverser.Traverse(queryNode, referenceNode);
+
+  numPrunes += traverser.NumPrunes();
+  numVisited += traverser.NumVisited();
+  numScores += traverser.NumScores();
+  numBaseCases += traverser.NumBaseCases();
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -152,6 +152,122 @@ size_t PerformSplit(MatType& data,
   return left;
 }
 
+//! The number of points in each of the blocks that ParallelPerformSplit()
+//! partitions independently.  This does not depend on the number of threads,
+//! so that the result of the split does not either.
+const size_t parallelSplitBlockSize = 16384;
+
+/**
+ * Rearrange the points according to the split information, like
+ * PerformSplit(), but in parallel.  The points are divided into blocks of
+ * parallelSplitBlockSize points, each of which is split independently with
+ * PerformSplit().  Then, the points of the right part of each block that fall
+ * to the left of the split column are swapped with the points of the left part
+ * of each block that fall to its right.  The order of the points after the
+ * split depends only on the block size, not on the number of threads.
+ *
+ * If there is only one block, or the dataset is sparse, this is the same as
+ * PerformSplit().
+ *
+ * @param data The dataset used by the binary space tree.
+ * @param begin Index of the starting point in the dataset that belongs to
+ *    this node.
+ * @param count Number of points in this node.
+ * @param splitInfo The information about the split.
+ * @param oldFromNew If not NULL, this is updated with the old positions for
+ *    each new point.
+ */
+template<typename MatType, typename SplitType>
+size_t ParallelPerformSplit(MatType& data,
+                            const size_t begin,
+                            const size_t count,
+                            const typename SplitType::SplitInfo& splitInfo,
+                            std::vector<size_t>* oldFromNew)
+{
+  // Columns of a sparse matrix can't be swapped from different threads.
+  if (count <= parallelSplitBlockSize ||
+      arma::is_arma_sparse_type<MatType>::value)
+  {
+    return (oldFromNew == NULL) ?
+        PerformSplit<MatType, SplitType>(data, begin, count, splitInfo) :
+        PerformSplit<MatType, SplitType>(data, begin, count, splitInfo,
+            *oldFromNew);
+  }
+
+  // Split each block.  After this, the points of block b that belong to the
+  // left subtree are in [blockBegin, blockSplits[b]).
+  const size_t numBlocks = (count + parallelSplitBlockSize - 1) /
+      parallelSplitBlockSize;
+  std::vector<size_t> blockSplits(numBlocks);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t blockBegin = begin + b * parallelSplitBlockSize;
+    const size_t blockCount = std::min(parallelSplitBlockSize,
+        begin + count - blockBegin);
+    blockSplits[b] = (oldFromNew == NULL) ?
+        PerformSplit<MatType, SplitType>(data, blockBegin, blockCount,
+            splitInfo) :
+        PerformSplit<MatType, SplitType>(data, blockBegin, blockCount,
+            splitInfo, *oldFromNew);
+  }
+
+  size_t splitCol = begin;
+  for (size_t b = 0; b < numBlocks; ++b)
+    splitCol += blockSplits[b] - (begin + b * parallelSplitBlockSize);
+
+  // Now collect the ranges of points that are on the wrong side of splitCol, in
+  // order.  There are as many misplaced points on the left side as there are on
+  // the right side.
+  std::vector<size_t> leftRangeBegins, leftRangeOffsets(1, 0);
+  std::vector<size_t> rightRangeBegins, rightRangeOffsets(1, 0);
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t blockBegin = begin + b * parallelSplitBlockSize;
+    const size_t blockEnd = std::min(blockBegin + parallelSplitBlockSize,
+        begin + count);
+
+    // Points of the right subtree that are left of splitCol.
+    const size_t leftEnd = std::min(blockEnd, splitCol);
+    if (blockSplits[b] < leftEnd)
+    {
+      leftRangeBegins.push_back(blockSplits[b]);
+      leftRangeOffsets.push_back(leftRangeOffsets.back() + leftEnd -
+          blockSplits[b]);
+    }
+
+    // Points of the left subtree that are right of splitCol.
+    const size_t rightBegin = std::max(blockBegin, splitCol);
+    if (rightBegin < blockSplits[b])
+    {
+      rightRangeBegins.push_back(rightBegin);
+      rightRangeOffsets.push_back(rightRangeOffsets.back() + blockSplits[b] -
+          rightBegin);
+    }
+  }
+
+  // Swap the i'th misplaced point on the left with the i'th misplaced point on
+  // the right.  No point is swapped twice.
+  const size_t numMisplaced = leftRangeOffsets.back();
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) numMisplaced; ++i)
+  {
+    const size_t l = std::upper_bound(leftRangeOffsets.begin(),
+        leftRangeOffsets.end(), (size_t) i) - leftRangeOffsets.begin() - 1;
+    const size_t r = std::upper_bound(rightRangeOffsets.begin(),
+        rightRangeOffsets.end(), (size_t) i) - rightRangeOffsets.begin() - 1;
+    const size_t leftCol = leftRangeBegins[l] + (i - leftRangeOffsets[l]);
+    const size_t rightCol = rightRangeBegins[r] + (i - rightRangeOffsets[r]);
+
+    data.swap_cols(leftCol, rightCol);
+    if (oldFromNew != NULL)
+      std::swap((*oldFromNew)[leftCol], (*oldFromNew)[rightCol]);
+  }
+
+  return splitCol;
+}
+
 } // namespace split
 } // namespace tree
 } // namespace mlpack
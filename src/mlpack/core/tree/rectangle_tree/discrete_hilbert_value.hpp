@@ -197,6 +197,16 @@ class DiscreteHilbertValue
   template<typename TreeType>
   void UpdateLargestValue(TreeType* node);
 
+  /**
+   * Compute the Hilbert values of all points of a leaf node, which is used when
+   * the tree is bulk-loaded.  The points of the node should be arranged
+   * according to their Hilbert values.
+   *
+   * @param node The leaf node in which the values should be computed.
+   */
+  template<typename TreeType>
+  void ComputeLocalValues(TreeType* node);
+
   /**
    * This method updates the largest Hilbert value of a leaf node and
    * redistributes the Hilbert values of points according to their new position
@@ -50,10 +50,11 @@ DiscreteHilbertValue<TreeElemType>::DiscreteHilbertValue(const TreeType* tree) :
   // Calculate the Hilbert value for all points.
   if (!tree->Parent()) // This is the root node.
     ownsLocalHilbertValues = true;
-  else if (tree->Parent()->Child(0).IsLeaf())
+  else if (tree->Parent()->NumChildren() > 0 &&
+           tree->Parent()->Child(0).IsLeaf())
   {
-    // This is a leaf node.
-    assert(tree->Parent()->NumChildren() > 0);
+    // This is a leaf node.  (When a tree is bulk-loaded, the first child of a
+    // node is created before the kind of its siblings is known.)
     ownsLocalHilbertValues = true;
   }
 
@@ -470,6 +471,26 @@ void DiscreteHilbertValue<TreeElemType>::UpdateLargestValue(TreeType* node)
   }
 }
 
+template<typename TreeElemType>
+template<typename TreeType>
+void DiscreteHilbertValue<TreeElemType>::ComputeLocalValues(TreeType* node)
+{
+  if (!ownsLocalHilbertValues)
+  {
+    localHilbertValues = new arma::Mat<HilbertElemType>(
+        node->Dataset().n_rows, node->MaxLeafSize() + 1);
+    ownsLocalHilbertValues = true;
+  }
+
+  for (size_t i = 0; i < node->NumPoints(); ++i)
+  {
+    localHilbertValues->col(i) =
+        CalculateValue(node->Dataset().col(node->Point(i)));
+  }
+
+  numValues = node->NumPoints();
+}
+
 template<typename TreeElemType>
 template<typename TreeType>
 void DiscreteHilbertValue<TreeElemType>::RedistributeHilbertValues(
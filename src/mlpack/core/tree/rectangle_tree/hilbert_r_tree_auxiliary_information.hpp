@@ -117,6 +117,16 @@ class HilbertRTreeAuxiliaryInformation
    */
   bool UpdateAuxiliaryInfo(TreeType* node);
 
+  /**
+   * The Hilbert R tree requires the Hilbert values of the points of each leaf
+   * to be stored in the leaf.  This method computes them for a leaf of a
+   * bulk-loaded tree, and sets the largest Hilbert value of any other node.
+   * The children of the node must have been handled already.
+   *
+   * @param node The node that has been bulk-loaded.
+   */
+  void BulkLoadAuxiliaryInfo(TreeType* node);
+
   //! Clear memory.
   void NullifyData();
 
@@ -142,6 +152,18 @@ class HilbertRTreeAuxiliaryInformation
   void serialize(Archive& ar, const uint32_t /* version */);
 };
 
+/**
+ * The Hilbert R tree keeps the points and the children of every node in
+ * Hilbert order.
+ */
+template<typename TreeType,
+         template<typename> class HilbertValueType>
+struct RequiresHilbertOrder<
+    HilbertRTreeAuxiliaryInformation<TreeType, HilbertValueType>>
+{
+  static const bool value = true;
+};
+
 } // namespace tree
 } // namespace mlpack
 
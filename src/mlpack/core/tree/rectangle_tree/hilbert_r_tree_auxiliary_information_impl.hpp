@@ -167,6 +167,22 @@ UpdateAuxiliaryInfo(TreeType* node)
   return false;
 }
 
+template<typename TreeType,
+         template<typename> class HilbertValueType>
+void HilbertRTreeAuxiliaryInformation<TreeType, HilbertValueType>::
+BulkLoadAuxiliaryInfo(TreeType* node)
+{
+  if (node->IsLeaf())
+  {
+    hilbertValue.ComputeLocalValues(node);
+    return;
+  }
+
+  // The largest value of the node is the largest value of its last child.
+  hilbertValue =
+      node->Child(node->NumChildren() - 1).AuxiliaryInfo().HilbertValue();
+}
+
 template<typename TreeType,
          template<typename> class HilbertValueType>
 void HilbertRTreeAuxiliaryInformation<TreeType, HilbertValueType>::
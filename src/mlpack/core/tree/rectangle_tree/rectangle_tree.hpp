@@ -17,13 +17,41 @@
 
 #include "../hrectbound.hpp"
 #include "../statistic.hpp"
+#include "../tree_traits.hpp"
 #include "r_tree_split.hpp"
 #include "r_tree_descent_heuristic.hpp"
 #include "no_auxiliary_information.hpp"
+#include "discrete_hilbert_value.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
 
+/**
+ * The ways in which the bulk-loading constructor of the RectangleTree can
+ * arrange the points of the dataset into leaves.
+ */
+enum BulkLoadMethod
+{
+  //! Sort-Tile-Recursive: the points of each node are cut into slabs along the
+  //! first dimension, each slab is cut along the second dimension, and so on,
+  //! until there is one tile for each child.
+  SORT_TILE_RECURSIVE,
+  //! The points are sorted by their Hilbert values, and each node holds a run
+  //! of consecutive points.
+  HILBERT_CURVE
+};
+
+/**
+ * 'value' is true if the given auxiliary information requires the points and
+ * the children of every node to be arranged according to their Hilbert values,
+ * so that the tree can only be bulk-loaded with HILBERT_CURVE.
+ */
+template<typename AuxiliaryInformationType>
+struct RequiresHilbertOrder
+{
+  static const bool value = false;
+};
+
 /**
  * A rectangle type tree tree, such as an R-tree or X-tree.  Once the
  * bound and type of dataset is defined, the tree will construct itself.  Call
@@ -156,6 +184,57 @@ class RectangleTree
                 const size_t minNumChildren = 2,
                 const size_t firstDataIndex = 0);
 
+  /**
+   * Construct this as the root node of a rectangle type tree by bulk-loading
+   * the given dataset, instead of inserting the points one at a time.  The
+   * points are arranged with the given method and packed bottom-up into a
+   * balanced tree whose leaves are as full as possible, which is much faster
+   * than insertion and gives tighter bounds.  Ordering the points is done in
+   * parallel if OpenMP is available.  Insertions and deletions can be done
+   * afterwards as usual.
+   *
+   * Trees whose children may not overlap (the R+ and R++ trees) can't be
+   * bulk-loaded.  Trees that keep their points in Hilbert order (the Hilbert R
+   * tree) can only be bulk-loaded with HILBERT_CURVE; a std::invalid_argument
+   * is thrown otherwise.
+   *
+   * @param data Dataset from which to create the tree.
+   * @param method Method with which the points are arranged into leaves.
+   * @param maxLeafSize Maximum size of each leaf in the tree.
+   * @param minLeafSize Minimum size of each leaf in the tree.
+   * @param maxNumChildren The maximum number of child nodes a non-leaf node may
+   *      have.
+   * @param minNumChildren The minimum number of child nodes a non-leaf node may
+   *      have.
+   */
+  RectangleTree(const MatType& data,
+                const BulkLoadMethod method,
+                const size_t maxLeafSize = 20,
+                const size_t minLeafSize = 8,
+                const size_t maxNumChildren = 5,
+                const size_t minNumChildren = 2);
+
+  /**
+   * Construct this as the root node of a rectangle type tree by bulk-loading
+   * the given dataset, and taking ownership of the given dataset.  See the
+   * constructor above for details.
+   *
+   * @param data Dataset from which to create the tree.
+   * @param method Method with which the points are arranged into leaves.
+   * @param maxLeafSize Maximum size of each leaf in the tree.
+   * @param minLeafSize Minimum size of each leaf in the tree.
+   * @param maxNumChildren The maximum number of child nodes a non-leaf node may
+   *      have.
+   * @param minNumChildren The minimum number of child nodes a non-leaf node may
+   *      have.
+   */
+  RectangleTree(MatType&& data,
+                const BulkLoadMethod method,
+                const size_t maxLeafSize = 20,
+                const size_t minLeafSize = 8,
+                const size_t maxNumChildren = 5,
+                const size_t minNumChildren = 2);
+
   /**
    * Construct this as an empty node with the specified parent.  Copying the
    * parameters (maxLeafSize, minLeafSize, maxNumChildren, minNumChildren,
@@ -564,6 +643,64 @@ class RectangleTree
    */
   void BuildStatistics(RectangleTree* node);
 
+  /**
+   * Bulk-load the whole dataset into this empty root node with the given
+   * method.  This is called by the bulk-loading constructors.
+   *
+   * @param method Method with which the points are arranged into leaves.
+   */
+  void BulkLoad(const BulkLoadMethod method);
+
+  /**
+   * Compute the number of points held by each child of a bulk-loaded node.
+   * The points are divided as equally as possible between the fewest children
+   * that can hold them, so that every subtree has the same height.
+   *
+   * @param numPoints Number of points in the node.
+   * @param height Height of the node; leaves have height 0.
+   * @param sizes Filled with the number of points held by each child.
+   */
+  void BulkLoadChildSizes(const size_t numPoints,
+                          const size_t height,
+                          std::vector<size_t>& sizes) const;
+
+  /**
+   * Rearrange the given points so that each of the given groups is a
+   * contiguous range, with Sort-Tile-Recursive: the points are cut into slabs
+   * of whole groups along the given dimension, and each slab is then cut along
+   * the next dimension.
+   *
+   * @param order Indices of the points to rearrange.
+   * @param begin Index in order of the first point of the first group.
+   * @param sizes Number of points in each group.
+   * @param firstGroup Index in sizes of the first group to arrange.
+   * @param numGroups Number of groups to arrange.
+   * @param dim Dimension along which the slabs are cut.
+   */
+  void TileRecursive(std::vector<size_t>& order,
+                     const size_t begin,
+                     const std::vector<size_t>& sizes,
+                     const size_t firstGroup,
+                     const size_t numGroups,
+                     const size_t dim) const;
+
+  /**
+   * Create the subtree of this bulk-loaded node, which holds the given
+   * contiguous range of ordered points.  The nodes are appended to the given
+   * vector in post-order; their bounds and auxiliary information are not set.
+   *
+   * @param order Ordered indices of the points.
+   * @param begin Index in order of the first point of the node.
+   * @param numPoints Number of points in the node.
+   * @param height Height of the node; leaves have height 0.
+   * @param nodes Vector to which the nodes of the subtree are appended.
+   */
+  void BulkLoadNode(const std::vector<size_t>& order,
+                    const size_t begin,
+                    const size_t numPoints,
+                    const size_t height,
+                    std::vector<RectangleTree*>& nodes);
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
@@ -121,6 +121,378 @@ RectangleTree(MatType&& data,
   BuildStatistics(this);
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(const MatType& data,
+              const BulkLoadMethod method,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(data)),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{
+  BulkLoad(method);
+
+  // Initialize statistic recursively after tree construction is complete.
+  BuildStatistics(this);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(MatType&& data,
+              const BulkLoadMethod method,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(std::move(data))),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{
+  BulkLoad(method);
+
+  // Initialize statistic recursively after tree construction is complete.
+  BuildStatistics(this);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+BulkLoad(const BulkLoadMethod method)
+{
+  // A tiling of the points does not keep the children of a node apart, so
+  // these trees would have to be split all over again.
+  static_assert(TreeTraits<RectangleTree>::HasOverlappingChildren,
+      "RectangleTree: trees whose children can't overlap can't be "
+      "bulk-loaded.");
+
+  if (method != HILBERT_CURVE &&
+      RequiresHilbertOrder<AuxiliaryInformation>::value)
+  {
+    // The destructor won't be called, so the dataset must be freed here.
+    delete dataset;
+    dataset = NULL;
+    throw std::invalid_argument("RectangleTree::RectangleTree(): this tree "
+        "type can only be bulk-loaded with HILBERT_CURVE!");
+  }
+
+  const size_t numPoints = dataset->n_cols;
+
+  // Find the height of the smallest balanced tree that can hold every point.
+  size_t height = 0;
+  for (size_t capacity = maxLeafSize; capacity < numPoints; ++height)
+    capacity *= maxNumChildren;
+
+  std::vector<size_t> order(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+    order[i] = i;
+
+  if (method == HILBERT_CURVE)
+  {
+    typedef DiscreteHilbertValue<ElemType> HilbertValue;
+    typedef typename HilbertValue::HilbertElemType HilbertElemType;
+
+    arma::Mat<HilbertElemType> values(dataset->n_rows, numPoints);
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) numPoints; ++i)
+      values.col(i) = HilbertValue::CalculateValue(dataset->col(i));
+
+    // Ties are broken by index, so that the order does not depend on the number
+    // of threads.
+    auto less = [&values](const size_t a, const size_t b)
+    {
+      const HilbertElemType* valueA = values.colptr(a);
+      const HilbertElemType* valueB = values.colptr(b);
+      for (size_t d = 0; d < values.n_rows; ++d)
+      {
+        if (valueA[d] != valueB[d])
+          return valueA[d] < valueB[d];
+      }
+
+      return a < b;
+    };
+
+    // Sort blocks of points in parallel, then merge pairs of sorted runs in
+    // parallel until there is one run left.
+    const size_t blockSize = 16384;
+    const size_t numBlocks = (numPoints + blockSize - 1) / blockSize;
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t first = b * blockSize;
+      const size_t last = std::min(first + blockSize, numPoints);
+      std::sort(order.begin() + first, order.begin() + last, less);
+    }
+
+    for (size_t width = blockSize; width < numPoints; width *= 2)
+    {
+      const size_t numMerges = (numPoints + 2 * width - 1) / (2 * width);
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t m = 0; m < (omp_size_t) numMerges; ++m)
+      {
+        const size_t first = 2 * width * m;
+        const size_t middle = std::min(first + width, numPoints);
+        const size_t last = std::min(first + 2 * width, numPoints);
+        std::inplace_merge(order.begin() + first, order.begin() + middle,
+            order.begin() + last, less);
+      }
+    }
+  }
+  else
+  {
+    // Tile the points of the nodes of each level in turn, from the root down.
+    // The nodes of a level hold disjoint ranges of points, so they can be tiled
+    // in parallel.
+    std::vector<size_t> levelBegins(1, 0);
+    std::vector<size_t> levelCounts(1, numPoints);
+    for (size_t h = height; h > 0; --h)
+    {
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t i = 0; i < (omp_size_t) levelBegins.size(); ++i)
+      {
+        std::vector<size_t> sizes;
+        BulkLoadChildSizes(levelCounts[i], h, sizes);
+        TileRecursive(order, levelBegins[i], sizes, 0, sizes.size(), 0);
+      }
+
+      std::vector<size_t> nextBegins;
+      std::vector<size_t> nextCounts;
+      for (size_t i = 0; i < levelBegins.size(); ++i)
+      {
+        std::vector<size_t> sizes;
+        BulkLoadChildSizes(levelCounts[i], h, sizes);
+
+        size_t childBegin = levelBegins[i];
+        for (size_t j = 0; j < sizes.size(); ++j)
+        {
+          nextBegins.push_back(childBegin);
+          nextCounts.push_back(sizes[j]);
+          childBegin += sizes[j];
+        }
+      }
+
+      levelBegins.swap(nextBegins);
+      levelCounts.swap(nextCounts);
+    }
+  }
+
+  // The nodes are created serially, since the auxiliary information of a node
+  // may look at the siblings that were created before it.
+  std::vector<RectangleTree*> nodes;
+  BulkLoadNode(order, 0, numPoints, height, nodes);
+
+  // The leaves are independent of each other, so their bounds and auxiliary
+  // information can be computed in parallel.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) nodes.size(); ++i)
+  {
+    RectangleTree* node = nodes[i];
+    if (!node->IsLeaf())
+      continue;
+
+    for (size_t j = 0; j < node->count; ++j)
+      node->bound |= dataset->col(node->points[j]);
+
+    node->auxiliaryInfo.BulkLoadAuxiliaryInfo(node);
+  }
+
+  // The other nodes need their children, which come before them in post-order.
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    RectangleTree* node = nodes[i];
+    if (node->IsLeaf())
+      continue;
+
+    for (size_t j = 0; j < node->numChildren; ++j)
+      node->bound |= node->children[j]->bound;
+
+    node->auxiliaryInfo.BulkLoadAuxiliaryInfo(node);
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+BulkLoadChildSizes(const size_t numPoints,
+                   const size_t height,
+                   std::vector<size_t>& sizes) const
+{
+  // Each child can hold as many points as a full subtree of its height.
+  size_t childCapacity = maxLeafSize;
+  for (size_t h = 1; h < height; ++h)
+    childCapacity *= maxNumChildren;
+
+  const size_t numGroups = (numPoints + childCapacity - 1) / childCapacity;
+  sizes.resize(numGroups);
+  for (size_t i = 0; i < numGroups; ++i)
+    sizes[i] = numPoints / numGroups + ((i < numPoints % numGroups) ? 1 : 0);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+TileRecursive(std::vector<size_t>& order,
+              const size_t begin,
+              const std::vector<size_t>& sizes,
+              const size_t firstGroup,
+              const size_t numGroups,
+              const size_t dim) const
+{
+  if (numGroups <= 1)
+    return;
+
+  size_t end = begin;
+  for (size_t i = firstGroup; i < firstGroup + numGroups; ++i)
+    end += sizes[i];
+
+  // In the last dimension every group gets a slab of its own.  Otherwise we
+  // take the smallest number of slabs s such that s^(remaining dimensions) is
+  // at least the number of groups, so that the tiles are roughly square.
+  const size_t remainingDims = dataset->n_rows - dim;
+  size_t numSlabs = numGroups;
+  if (remainingDims > 1)
+  {
+    for (numSlabs = 1; numSlabs < numGroups; ++numSlabs)
+    {
+      size_t tiles = 1;
+      for (size_t i = 0; i < remainingDims && tiles < numGroups; ++i)
+        tiles *= numSlabs;
+
+      if (tiles >= numGroups)
+        break;
+    }
+  }
+
+  // Ties are broken by index, so that the tiling is deterministic.
+  const MatType& data = *dataset;
+  auto less = [&data, dim](const size_t a, const size_t b)
+  {
+    return (data(dim, a) < data(dim, b)) ||
+        (data(dim, a) == data(dim, b) && a < b);
+  };
+
+  size_t slabBegin = begin;
+  size_t group = firstGroup;
+  for (size_t s = 0; s < numSlabs; ++s)
+  {
+    const size_t slabGroups = numGroups / numSlabs +
+        ((s < numGroups % numSlabs) ? 1 : 0);
+    size_t slabSize = 0;
+    for (size_t i = group; i < group + slabGroups; ++i)
+      slabSize += sizes[i];
+
+    // Move the points with the smallest coordinates to this slab; there is no
+    // need to sort them.
+    if (slabBegin + slabSize < end)
+    {
+      std::nth_element(order.begin() + slabBegin,
+          order.begin() + slabBegin + slabSize, order.begin() + end, less);
+    }
+
+    TileRecursive(order, slabBegin, sizes, group, slabGroups, dim + 1);
+
+    slabBegin += slabSize;
+    group += slabGroups;
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+BulkLoadNode(const std::vector<size_t>& order,
+             const size_t begin,
+             const size_t numPoints,
+             const size_t height,
+             std::vector<RectangleTree*>& nodes)
+{
+  numDescendants = numPoints;
+
+  if (height == 0)
+  {
+    for (size_t i = 0; i < numPoints; ++i)
+      points[i] = order[begin + i];
+    count = numPoints;
+  }
+  else
+  {
+    std::vector<size_t> sizes;
+    BulkLoadChildSizes(numPoints, height, sizes);
+
+    size_t childBegin = begin;
+    for (size_t i = 0; i < sizes.size(); ++i)
+    {
+      // The child is only added once its subtree is complete, since the
+      // auxiliary information of the next child may look at it.
+      RectangleTree* child = new RectangleTree(this);
+      child->BulkLoadNode(order, childBegin, sizes[i], height - 1, nodes);
+      children[numChildren++] = child;
+      childBegin += sizes[i];
+    }
+  }
+
+  nodes.push_back(this);
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -156,6 +156,17 @@ class XTreeAuxiliaryInformation
     return false;
   }
 
+  /**
+   * Some tree types require to save some properties when the tree is
+   * bulk-loaded.  This method is called for each node of a bulk-loaded tree
+   * once the points (or the children) of the node are set.  The children of a
+   * node are always handled before the node, and leaves may be handled
+   * concurrently.
+   * @param * (node) The node that has been bulk-loaded.
+   */
+  void BulkLoadAuxiliaryInfo(TreeType* /* node */)
+  { }
+
   /**
    * Nullify the auxiliary information in order to prevent an invalid free.
    */
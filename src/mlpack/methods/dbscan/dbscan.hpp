@@ -15,7 +15,7 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/methods/range_search/range_search.hpp>
-#include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 #include "random_point_selection.hpp"
 #include "ordered_point_selection.hpp"
 #include <boost/dynamic_bitset.hpp>
@@ -44,6 +44,12 @@ namespace dbscan {
  * range search technique used and the point selection strategy by means of
  * template parameters.
  *
+ * Points are merged into clusters with a lock-free union-find structure, so
+ * the merging (and, in naive or single-tree mode, the range searches) is done
+ * in parallel if OpenMP is available.  The clusters are numbered in order of
+ * the smallest index of their points, so the assignments do not depend on the
+ * number of threads.
+ *
  * @tparam RangeSearchType Class to use for range searching.
  * @tparam PointSelectionPolicy Strategy for selecting next point to cluster
  *      with.
@@ -131,17 +137,17 @@ class DBSCAN
 
   /**
    * Performs DBSCAN clustering on the data, returning the number of clusters and
-   * also the list of cluster assignments.  This searches each point iteratively,
-   * and can save on RAM usage.  It may be slower than the batch search with a
-   * dual-tree algorithm.
+   * also the list of cluster assignments.  This searches one block of points at
+   * a time, and can save on RAM usage.  It may be slower than the batch search
+   * with a dual-tree algorithm.
    *
    * @param data Dataset to cluster.
    * @param assignments Assignments for each point.
-   * @param uf UnionFind structure that will be modified.
+   * @param uf Union-find structure that will be modified.
    */
   template<typename MatType>
   void PointwiseCluster(const MatType& data,
-                        emst::UnionFind& uf);
+                        emst::ConcurrentUnionFind& uf);
 
   /**
    * Performs DBSCAN clustering on the data, returning number of clusters
@@ -150,11 +156,11 @@ class DBSCAN
    *
    * @param data Dataset to cluster.
    * @param assignments Assignments for each point.
-   * @param uf UnionFind structure that will be modified.
+   * @param uf Union-find structure that will be modified.
    */
   template<typename MatType>
   void BatchCluster(const MatType& data,
-                    emst::UnionFind& uf);
+                    emst::ConcurrentUnionFind& uf);
 };
 
 } // namespace dbscan
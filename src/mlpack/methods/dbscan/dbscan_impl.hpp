@@ -100,8 +100,10 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
     const MatType& data,
     arma::Row<size_t>& assignments)
 {
-  // Initialize the UnionFind object.
-  emst::UnionFind uf(data.n_cols);
+  // Initialize the union-find object.  Each root is the smallest index in its
+  // component, so the clusters below are numbered in order of their first
+  // point, no matter how many threads performed the unions.
+  emst::ConcurrentUnionFind uf(data.n_cols);
   rangeSearch.Train(data);
 
   if (batchMode)
@@ -142,31 +144,36 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
 
 /**
  * Performs DBSCAN clustering on the data, returning the number of clusters and
- * also the list of cluster assignments.  This searches each point iteratively,
- * and can save on RAM usage.  It may be slower than the batch search with a
- * dual-tree algorithm.
+ * also the list of cluster assignments.  This searches one block of points at a
+ * time, and can save on RAM usage.  It may be slower than the batch search with
+ * a dual-tree algorithm.
  */
 template<typename RangeSearchType, typename PointSelectionPolicy>
 template<typename MatType>
 void DBSCAN<RangeSearchType, PointSelectionPolicy>::PointwiseCluster(
     const MatType& data,
-    emst::UnionFind& uf)
+    emst::ConcurrentUnionFind& uf)
 {
   std::vector<std::vector<size_t>> neighbors;
   std::vector<std::vector<double>> distances;
 
-  for (size_t i = 0; i < data.n_cols; ++i)
+  // Only the neighborhoods of one block are held in memory at once.
+  const size_t blockSize = 1000;
+  for (size_t begin = 0; begin < data.n_cols; begin += blockSize)
   {
-    if (i % 10000 == 0 && i > 0)
-      Log::Info << "DBSCAN clustering on point " << i << "..." << std::endl;
-
-    // Do the range search for only this point.
-    rangeSearch.Search(data.col(i), math::Range(0.0, epsilon), neighbors,
-        distances);
-
-    // Union to all neighbors.
-    for (size_t j = 0; j < neighbors[0].size(); ++j)
-      uf.Union(i, neighbors[0][j]);
+    if (begin % 10000 == 0 && begin > 0)
+      Log::Info << "DBSCAN clustering on point " << begin << "..." << std::endl;
+
+    // Do the range search for only this block of points.
+    const size_t end = std::min(begin + blockSize, (size_t) data.n_cols);
+    rangeSearch.Search(data.cols(begin, end - 1), math::Range(0.0, epsilon),
+        neighbors, distances);
+
+    // Union each point to all its neighbors.
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) (end - begin); ++i)
+      for (size_t j = 0; j < neighbors[i].size(); ++j)
+        uf.Union(begin + i, neighbors[i][j]);
   }
 }
 
@@ -179,7 +186,7 @@ template<typename RangeSearchType, typename PointSelectionPolicy>
 template<typename MatType>
 void DBSCAN<RangeSearchType, PointSelectionPolicy>::BatchCluster(
     const MatType& data,
-    emst::UnionFind& uf)
+    emst::ConcurrentUnionFind& uf)
 {
   // For each point, find the points in epsilon-nighborhood and their distances.
   std::vector<std::vector<size_t>> neighbors;
@@ -189,11 +196,16 @@ void DBSCAN<RangeSearchType, PointSelectionPolicy>::BatchCluster(
   rangeSearch.Search(data, math::Range(0.0, epsilon), neighbors, distances);
   Log::Info << "Range search complete." << std::endl;
 
-  // Now loop over all points.
+  // Get the order in which to visit the points.
+  arma::Col<size_t> order(data.n_cols);
   for (size_t i = 0; i < data.n_cols; ++i)
+    order[i] = pointSelector.Select(i, data);
+
+  // Now loop over all points.
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
   {
-    // Get the next index.
-    const size_t index = pointSelector.Select(i, data);
+    const size_t index = order[i];
     for (size_t j = 0; j < neighbors[index].size(); ++j)
       uf.Union(index, neighbors[index][j]);
   }
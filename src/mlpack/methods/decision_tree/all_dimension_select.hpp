@@ -12,6 +12,8 @@
 #ifndef MLPACK_METHODS_DECISION_TREE_ALL_DIMENSION_SELECT_HPP
 #define MLPACK_METHODS_DECISION_TREE_ALL_DIMENSION_SELECT_HPP
 
+#include "dimension_selection_traits.hpp"
+
 namespace mlpack {
 namespace tree {
 
@@ -58,6 +60,14 @@ class AllDimensionSelect
   size_t dimensions;
 };
 
+//! AllDimensionSelect always selects every dimension.
+template<>
+class DimensionSelectionTraits<AllDimensionSelect>
+{
+ public:
+  static const bool IsDeterministic = true;
+};
+
 } // namespace tree
 } // namespace mlpack
 
@@ -17,8 +17,11 @@
 #include "gini_gain.hpp"
 #include "information_gain.hpp"
 #include "best_binary_numeric_split.hpp"
+#include "histogram_numeric_split.hpp"
 #include "all_categorical_split.hpp"
 #include "all_dimension_select.hpp"
+#include "dimension_selection_traits.hpp"
+#include "numeric_split_traits.hpp"
 #include <type_traits>
 
 namespace mlpack {
@@ -30,6 +33,13 @@ namespace tree {
  *
  * The class inherits from the auxiliary split information in order to prevent
  * an empty auxiliary split information struct from taking any extra size.
+ *
+ * If OpenMP 3.0 is available, the tree is trained in parallel: the candidate
+ * dimensions of large nodes are searched for splits at the same time, and if
+ * the dimension selector is deterministic (see DimensionSelectionTraits), the
+ * children of large nodes are trained at the same time too.  The splits are
+ * chosen in the order that the dimension selector selects the dimensions, so
+ * the tree does not depend on the number of threads.
  */
 template<typename FitnessFunction = GiniGain,
          template<typename> class NumericSplitType = BestBinaryNumericSplit,
@@ -481,6 +491,9 @@ class DecisionTree :
   size_t NumClasses() const;
 
  private:
+  //! FlatForest needs access to the nodes to flatten them.
+  template<typename> friend class FlatForest;
+
   //! The vector of children.
   std::vector<DecisionTree*> children;
   //! The dimension this node splits on.
@@ -505,6 +518,21 @@ class DecisionTree :
   typedef typename CategoricalSplit::template AuxiliarySplitInfo<ElemType>
       CategoricalAuxiliarySplitInfo;
 
+  //! Nodes with fewer points than this are trained without OpenMP tasks, since
+  //! the overhead of a task would outweigh the work.
+  static const size_t MinimumParallelPoints = 1024;
+
+  /**
+   * Given the gains of the best splits of each candidate dimension, in the
+   * order the dimensions were selected (DBL_MAX means that the dimension could
+   * not be split), return the index of the split that would be chosen if the
+   * dimensions were searched one at a time, or gains.size() if none is.  If a
+   * split is chosen, bestGain is set to its gain.
+   */
+  static size_t SelectBestSplit(const std::vector<double>& gains,
+                                const double minimumGainSplit,
+                                double& bestGain);
+
   /**
    * Calculate the class probabilities of the given labels.
    */
@@ -570,6 +598,95 @@ class DecisionTree :
                const double minimumGainSplit,
                const size_t maximumDepth,
                DimensionSelectionType& dimensionSelector);
+
+  /**
+   * The bins of each numeric dimension of a dataset, for numeric split types
+   * that find splits from bins (see NumericSplitTraits).  They are computed
+   * once before a tree is trained, and used by all of its nodes.
+   */
+  struct BinnedDataset
+  {
+    //! The bin of each value, with the same shape as the dataset.  The columns
+    //! are reordered along with the dataset when the nodes are split.
+    arma::Mat<unsigned char> bins;
+    //! The smallest value in each bin of each numeric dimension.
+    std::vector<arma::vec> binMin;
+    //! The largest value in each bin of each numeric dimension.
+    std::vector<arma::vec> binMax;
+  };
+
+  /**
+   * Bin each numeric dimension of the points data.cols(begin, begin + count -
+   * 1), and train the tree on the bins with TrainBinnedNode().  This is called
+   * by Train() if the numeric split type uses bins.
+   *
+   * @param datasetInfo Type information for each dimension, or NULL if all the
+   *      dimensions are numeric.
+   */
+  template<bool UseWeights, typename MatType>
+  double TrainBinned(MatType& data,
+                     const size_t begin,
+                     const size_t count,
+                     const data::DatasetInfo* datasetInfo,
+                     arma::Row<size_t>& labels,
+                     const size_t numClasses,
+                     arma::rowvec& weights,
+                     const size_t minimumLeafSize,
+                     const double minimumGainSplit,
+                     const size_t maximumDepth,
+                     DimensionSelectionType& dimensionSelector,
+                     const std::true_type& /* usesBins */);
+
+  /**
+   * This overload is never called; it only lets Train() compile for numeric
+   * split types that don't use bins.
+   */
+  template<bool UseWeights, typename MatType>
+  double TrainBinned(MatType& /* data */,
+                     const size_t /* begin */,
+                     const size_t /* count */,
+                     const data::DatasetInfo* /* datasetInfo */,
+                     arma::Row<size_t>& /* labels */,
+                     const size_t /* numClasses */,
+                     arma::rowvec& /* weights */,
+                     const size_t /* minimumLeafSize */,
+                     const double /* minimumGainSplit */,
+                     const size_t /* maximumDepth */,
+                     DimensionSelectionType& /* dimensionSelector */,
+                     const std::false_type& /* usesBins */)
+  {
+    return 0.0;
+  }
+
+  /**
+   * Train this node on the binned points data.cols(begin, begin + count - 1),
+   * and then its children recursively, as Train() does.  The histograms of the
+   * node are given for the dimensions that its parent had histograms for, and
+   * are empty for the others; the missing ones are built as needed.  For each
+   * node that is split, the histograms are only built for the smaller
+   * children, and the histograms of the largest child are found by subtracting
+   * them from the histograms of the node.
+   *
+   * @param binned Bins of the dataset.
+   * @param histograms Histogram of each dimension, taken by value so that it
+   *      can be moved in and freed when it is no longer needed.
+   * @param datasetInfo Type information for each dimension, or NULL if all the
+   *      dimensions are numeric.
+   */
+  template<bool UseWeights, typename MatType, typename HistogramType>
+  double TrainBinnedNode(MatType& data,
+                         BinnedDataset& binned,
+                         std::vector<HistogramType> histograms,
+                         const size_t begin,
+                         const size_t count,
+                         const data::DatasetInfo* datasetInfo,
+                         arma::Row<size_t>& labels,
+                         const size_t numClasses,
+                         arma::rowvec& weights,
+                         const size_t minimumLeafSize,
+                         const double minimumGainSplit,
+                         const size_t maximumDepth,
+                         DimensionSelectionType& dimensionSelector);
 };
 
 /**
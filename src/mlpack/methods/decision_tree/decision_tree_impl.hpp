@@ -14,6 +14,14 @@
 
 #include "decision_tree.hpp"
 
+// Nodes and subtrees are trained in parallel with OpenMP tasks, which need
+// OpenMP 3.0.  With older implementations (such as Visual Studio's), trees are
+// trained serially.
+#if defined(_OPENMP) && (_OPENMP >= 200805)
+  #include <omp.h>
+  #define MLPACK_DECISION_TREE_USE_TASKS
+#endif
+
 namespace mlpack {
 namespace tree {
 
@@ -681,6 +689,35 @@ double DecisionTree<FitnessFunction,
     const size_t maximumDepth,
     DimensionSelectionType& dimensionSelector)
 {
+#ifdef MLPACK_DECISION_TREE_USE_TASKS
+  // The nodes are trained with OpenMP tasks, which need a parallel region.  If
+  // we aren't already inside one (as we are when RandomForest trains its
+  // trees), start one at the root.
+  if (omp_get_level() == 0 && count >= MinimumParallelPoints)
+  {
+    double gain = 0.0;
+    #pragma omp parallel
+    {
+      #pragma omp single
+      gain = Train<UseWeights>(data, begin, count, datasetInfo, labels,
+          numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+          dimensionSelector);
+    }
+
+    return gain;
+  }
+#endif
+
+  // If the numeric split type finds splits from bins, the dataset is binned
+  // once, and the whole tree is trained on the bins.
+  if (NumericSplitTraits<NumericSplit>::UsesBins)
+  {
+    return TrainBinned<UseWeights>(data, begin, count, &datasetInfo, labels,
+        numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+        dimensionSelector, std::integral_constant<bool,
+        NumericSplitTraits<NumericSplit>::UsesBins>());
+  }
+
   // Clear children if needed.
   for (size_t i = 0; i < children.size(); ++i)
     delete children[i];
@@ -700,48 +737,72 @@ double DecisionTree<FitnessFunction,
 
   if (maximumDepth != 1)
   {
+    // Get the candidate dimensions first, since the dimension selector may
+    // draw random numbers.
+    std::vector<size_t> dimensions;
     for (size_t i = dimensionSelector.Begin(); i != end;
          i = dimensionSelector.Next())
+      dimensions.push_back(i);
+
+    // Find the best split of each candidate dimension (in parallel for large
+    // nodes), keeping the auxiliary information of each one separate.
+    const double nodeGain = bestGain;
+    std::vector<double> dimGains(dimensions.size(), DBL_MAX);
+    std::vector<arma::vec> dimClassProbabilities(dimensions.size());
+    std::vector<NumericAuxiliarySplitInfo> numericAux(dimensions.size());
+    std::vector<CategoricalAuxiliarySplitInfo> categoricalAux(
+        dimensions.size());
+    for (size_t j = 0; j < dimensions.size(); ++j)
     {
-      double dimGain = -DBL_MAX;
-      if (datasetInfo.Type(i) == data::Datatype::categorical)
-      {
-        dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
-            data.cols(begin, begin + count - 1).row(i),
-            datasetInfo.NumMappings(i),
-            labels.subvec(begin, begin + count - 1),
-            numClasses,
-            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
-            minimumLeafSize,
-            minimumGainSplit,
-            classProbabilities,
-            *this);
-      }
-      else if (datasetInfo.Type(i) == data::Datatype::numeric)
+      #ifdef MLPACK_DECISION_TREE_USE_TASKS
+      #pragma omp task default(shared) firstprivate(j) \
+          if (count >= MinimumParallelPoints)
+      #endif
       {
-        dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
-            data.cols(begin, begin + count - 1).row(i),
-            labels.subvec(begin, begin + count - 1),
-            numClasses,
-            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
-            minimumLeafSize,
-            minimumGainSplit,
-            classProbabilities,
-            *this);
+        const size_t i = dimensions[j];
+        if (datasetInfo.Type(i) == data::Datatype::categorical)
+        {
+          dimGains[j] = CategoricalSplit::template SplitIfBetter<UseWeights>(
+              nodeGain,
+              data.cols(begin, begin + count - 1).row(i),
+              datasetInfo.NumMappings(i),
+              labels.subvec(begin, begin + count - 1),
+              numClasses,
+              UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+              minimumLeafSize,
+              minimumGainSplit,
+              dimClassProbabilities[j],
+              categoricalAux[j]);
+        }
+        else if (datasetInfo.Type(i) == data::Datatype::numeric)
+        {
+          dimGains[j] = NumericSplit::template SplitIfBetter<UseWeights>(
+              nodeGain,
+              data.cols(begin, begin + count - 1).row(i),
+              labels.subvec(begin, begin + count - 1),
+              numClasses,
+              UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+              minimumLeafSize,
+              minimumGainSplit,
+              dimClassProbabilities[j],
+              numericAux[j]);
+        }
       }
-
-      // If the splitter reported that it did not split, move to the next
-      // dimension.
-      if (dimGain == DBL_MAX)
-        continue;
-
-      // Was there an improvement?  If so mark that it's the new best dimension.
-      bestDim = i;
-      bestGain = dimGain;
-
-      // If the gain is the best possible, no need to keep looking.
-      if (bestGain >= 0.0)
-        break;
+    }
+    #ifdef MLPACK_DECISION_TREE_USE_TASKS
+    #pragma omp taskwait
+    #endif
+
+    // Now pick the best split in the order the dimensions were selected, so
+    // that the result doesn't depend on the number of threads.
+    const size_t bestIndex = SelectBestSplit(dimGains, minimumGainSplit,
+        bestGain);
+    if (bestIndex != dimensions.size())
+    {
+      bestDim = dimensions[bestIndex];
+      classProbabilities = std::move(dimClassProbabilities[bestIndex]);
+      NumericAuxiliarySplitInfo::operator=(numericAux[bestIndex]);
+      CategoricalAuxiliarySplitInfo::operator=(categoricalAux[bestIndex]);
     }
   }
 
@@ -787,11 +848,12 @@ double DecisionTree<FitnessFunction,
     }
 
     // Split into children.
+    arma::Row<size_t> childBegins(numChildren);
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = childBegins[i]; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
@@ -803,26 +865,49 @@ double DecisionTree<FitnessFunction,
           ++currentCol;
         }
       }
+    }
 
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, currentCol - currentChildBegin, minimumGainSplit,
-            maximumDepth - 1, dimensionSelector);
-      }
-      else
+    // Now build the children recursively.  Each child holds its own part of
+    // the data, so large children can be built in parallel, as long as the
+    // dimension selector doesn't draw random numbers.
+    children.resize(numChildren);
+    arma::vec childGains(numChildren, arma::fill::zeros);
+    for (size_t i = 0; i < numChildren; ++i)
+    {
+      children[i] = new DecisionTree();
+
+      #ifdef MLPACK_DECISION_TREE_USE_TASKS
+      #pragma omp task default(shared) firstprivate(i) \
+          if (DimensionSelectionTraits< \
+              DimensionSelectionType>::IsDeterministic && \
+              childCounts[i] >= MinimumParallelPoints)
+      #endif
       {
-        // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
+        DimensionSelectionType childSelector(dimensionSelector);
+        if (NoRecursion)
+        {
+          children[i]->Train<UseWeights>(data, childBegins[i], childCounts[i],
+              datasetInfo, labels, numClasses, weights, childCounts[i],
+              minimumGainSplit, maximumDepth - 1, childSelector);
+        }
+        else
+        {
+          childGains[i] = children[i]->Train<UseWeights>(data, childBegins[i],
+              childCounts[i], datasetInfo, labels, numClasses, weights,
+              minimumLeafSize, minimumGainSplit, maximumDepth - 1,
+              childSelector);
+        }
       }
-      children.push_back(child);
+    }
+    #ifdef MLPACK_DECISION_TREE_USE_TASKS
+    #pragma omp taskwait
+    #endif
+
+    // During recursion entropy of child node may change.
+    if (!NoRecursion)
+    {
+      for (size_t i = 0; i < numChildren; ++i)
+        bestGain += double(childCounts[i]) / double(count) * (-childGains[i]);
     }
   }
   else
@@ -866,6 +951,35 @@ double DecisionTree<FitnessFunction,
     const size_t maximumDepth,
     DimensionSelectionType& dimensionSelector)
 {
+#ifdef MLPACK_DECISION_TREE_USE_TASKS
+  // The nodes are trained with OpenMP tasks, which need a parallel region.  If
+  // we aren't already inside one (as we are when RandomForest trains its
+  // trees), start one at the root.
+  if (omp_get_level() == 0 && count >= MinimumParallelPoints)
+  {
+    double gain = 0.0;
+    #pragma omp parallel
+    {
+      #pragma omp single
+      gain = Train<UseWeights>(data, begin, count, labels, numClasses,
+          weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+          dimensionSelector);
+    }
+
+    return gain;
+  }
+#endif
+
+  // If the numeric split type finds splits from bins, the dataset is binned
+  // once, and the whole tree is trained on the bins.
+  if (NumericSplitTraits<NumericSplit>::UsesBins)
+  {
+    return TrainBinned<UseWeights>(data, begin, count, NULL, labels,
+        numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+        dimensionSelector, std::integral_constant<bool,
+        NumericSplitTraits<NumericSplit>::UsesBins>());
+  }
+
   // Clear children if needed.
   for (size_t i = 0; i < children.size(); ++i)
     delete children[i];
@@ -887,33 +1001,51 @@ double DecisionTree<FitnessFunction,
 
   if (maximumDepth != 1)
   {
+    // Get the candidate dimensions first, since the dimension selector may
+    // draw random numbers.
+    std::vector<size_t> dimensions;
     for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
          i = dimensionSelector.Next())
+      dimensions.push_back(i);
+
+    // Find the best split of each candidate dimension (in parallel for large
+    // nodes), keeping the auxiliary information of each one separate.
+    const double nodeGain = bestGain;
+    std::vector<double> dimGains(dimensions.size(), DBL_MAX);
+    std::vector<arma::vec> dimClassProbabilities(dimensions.size());
+    std::vector<NumericAuxiliarySplitInfo> numericAux(dimensions.size());
+    for (size_t j = 0; j < dimensions.size(); ++j)
     {
-      const double dimGain = NumericSplitType<FitnessFunction>::template
-          SplitIfBetter<UseWeights>(bestGain,
-                                    data.cols(begin, begin + count - 1).row(i),
-                                    labels.cols(begin, begin + count - 1),
-                                    numClasses,
-                                    UseWeights ?
-                                        weights.cols(begin, begin + count - 1) :
-                                        weights,
-                                    minimumLeafSize,
-                                    minimumGainSplit,
-                                    classProbabilities,
-                                    *this);
-
-      // If the splitter did not report that it improved, then move to the next
-      // dimension.
-      if (dimGain == DBL_MAX)
-        continue;
-
-      bestDim = i;
-      bestGain = dimGain;
-
-      // If the gain is the best possible, no need to keep looking.
-      if (bestGain >= 0.0)
-        break;
+      #ifdef MLPACK_DECISION_TREE_USE_TASKS
+      #pragma omp task default(shared) firstprivate(j) \
+          if (count >= MinimumParallelPoints)
+      #endif
+      {
+        dimGains[j] = NumericSplitType<FitnessFunction>::template
+            SplitIfBetter<UseWeights>(nodeGain,
+                data.cols(begin, begin + count - 1).row(dimensions[j]),
+                labels.cols(begin, begin + count - 1),
+                numClasses,
+                UseWeights ? weights.cols(begin, begin + count - 1) : weights,
+                minimumLeafSize,
+                minimumGainSplit,
+                dimClassProbabilities[j],
+                numericAux[j]);
+      }
+    }
+    #ifdef MLPACK_DECISION_TREE_USE_TASKS
+    #pragma omp taskwait
+    #endif
+
+    // Now pick the best split in the order the dimensions were selected, so
+    // that the result doesn't depend on the number of threads.
+    const size_t bestIndex = SelectBestSplit(dimGains, minimumGainSplit,
+        bestGain);
+    if (bestIndex != dimensions.size())
+    {
+      bestDim = dimensions[bestIndex];
+      classProbabilities = std::move(dimClassProbabilities[bestIndex]);
+      NumericAuxiliarySplitInfo::operator=(numericAux[bestIndex]);
     }
   }
 
@@ -946,11 +1078,13 @@ double DecisionTree<FitnessFunction,
       bestGain = 0.0;
     }
 
+    // Split into children.
+    arma::Row<size_t> childBegins(numChildren);
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = childBegins[i]; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
@@ -962,32 +1096,433 @@ double DecisionTree<FitnessFunction,
           ++currentCol;
         }
       }
+    }
+
+    // Now build the children recursively, in parallel when possible.
+    children.resize(numChildren);
+    arma::vec childGains(numChildren, arma::fill::zeros);
+    for (size_t i = 0; i < numChildren; ++i)
+    {
+      children[i] = new DecisionTree();
+
+      #ifdef MLPACK_DECISION_TREE_USE_TASKS
+      #pragma omp task default(shared) firstprivate(i) \
+          if (DimensionSelectionTraits< \
+              DimensionSelectionType>::IsDeterministic && \
+              childCounts[i] >= MinimumParallelPoints)
+      #endif
+      {
+        DimensionSelectionType childSelector(dimensionSelector);
+        if (NoRecursion)
+        {
+          children[i]->Train<UseWeights>(data, childBegins[i], childCounts[i],
+              labels, numClasses, weights, childCounts[i], minimumGainSplit,
+              maximumDepth - 1, childSelector);
+        }
+        else
+        {
+          childGains[i] = children[i]->Train<UseWeights>(data, childBegins[i],
+              childCounts[i], labels, numClasses, weights, minimumLeafSize,
+              minimumGainSplit, maximumDepth - 1, childSelector);
+        }
+      }
+    }
+    #ifdef MLPACK_DECISION_TREE_USE_TASKS
+    #pragma omp taskwait
+    #endif
 
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
+    // During recursion entropy of child node may change.
+    if (!NoRecursion)
+    {
+      for (size_t i = 0; i < numChildren; ++i)
+        bestGain += double(childCounts[i]) / double(count) * (-childGains[i]);
+    }
+  }
+  else
+  {
+    // We won't be needing these members, so reset them.
+    NumericAuxiliarySplitInfo::operator=(NumericAuxiliarySplitInfo());
+
+    // Calculate class probabilities because we are a leaf.
+    CalculateClassProbabilities<UseWeights>(
+        labels.subvec(begin, begin + count - 1),
+        numClasses,
+        UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+  }
+
+  return -bestGain;
+}
+
+//! Bin the dataset and train on the bins.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::TrainBinned(
+    MatType& data,
+    const size_t begin,
+    const size_t count,
+    const data::DatasetInfo* datasetInfo,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType& dimensionSelector,
+    const std::true_type& /* usesBins */)
+{
+  // Bin each numeric dimension of the points once (in parallel for large
+  // datasets).  Only the columns of the points are used.
+  BinnedDataset binned;
+  binned.bins.zeros(data.n_rows, data.n_cols);
+  binned.binMin.resize(data.n_rows);
+  binned.binMax.resize(data.n_rows);
+  for (size_t d = 0; d < data.n_rows; ++d)
+  {
+    #ifdef MLPACK_DECISION_TREE_USE_TASKS
+    #pragma omp task default(shared) firstprivate(d) \
+        if (count >= MinimumParallelPoints)
+    #endif
+    {
+      if (datasetInfo == NULL ||
+          datasetInfo->Type(d) == data::Datatype::numeric)
       {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            currentCol - currentChildBegin, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
+        arma::Row<unsigned char> bins;
+        NumericSplit::BinValues(data.cols(begin, begin + count - 1).row(d),
+            bins, binned.binMin[d], binned.binMax[d]);
+        binned.bins.submat(d, begin, d, begin + count - 1) = bins;
+      }
+    }
+  }
+  #ifdef MLPACK_DECISION_TREE_USE_TASKS
+  #pragma omp taskwait
+  #endif
+
+  // The root builds all of its histograms itself.
+  typedef typename NumericSplit::Histogram HistogramType;
+  return TrainBinnedNode<UseWeights>(data, binned,
+      std::vector<HistogramType>(data.n_rows), begin, count, datasetInfo,
+      labels, numClasses, weights, minimumLeafSize, minimumGainSplit,
+      maximumDepth, dimensionSelector);
+}
+
+//! Train a node on the bins of the dataset.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType, typename HistogramType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::TrainBinnedNode(
+    MatType& data,
+    BinnedDataset& binned,
+    std::vector<HistogramType> histograms,
+    const size_t begin,
+    const size_t count,
+    const data::DatasetInfo* datasetInfo,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType& dimensionSelector)
+{
+  // Clear children if needed.
+  for (size_t i = 0; i < children.size(); ++i)
+    delete children[i];
+  children.clear();
+
+  // Look through the list of dimensions and obtain the gain of the best split,
+  // as Train() does, but search the numeric dimensions with their histograms.
+  double bestGain = FitnessFunction::template Evaluate<UseWeights>(
+      labels.subvec(begin, begin + count - 1),
+      numClasses,
+      UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+  size_t bestDim = data.n_rows; // This means "no split".
+
+  if (maximumDepth != 1)
+  {
+    // Get the candidate dimensions first, since the dimension selector may
+    // draw random numbers.
+    std::vector<size_t> dimensions;
+    for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
+         i = dimensionSelector.Next())
+      dimensions.push_back(i);
+
+    // Find the best split of each candidate dimension (in parallel for large
+    // nodes), keeping the auxiliary information of each one separate.  The
+    // histograms that the parent didn't give are built into newHistograms.
+    const double nodeGain = bestGain;
+    std::vector<double> dimGains(dimensions.size(), DBL_MAX);
+    std::vector<arma::vec> dimClassProbabilities(dimensions.size());
+    std::vector<NumericAuxiliarySplitInfo> numericAux(dimensions.size());
+    std::vector<CategoricalAuxiliarySplitInfo> categoricalAux(
+        dimensions.size());
+    std::vector<HistogramType> newHistograms(dimensions.size());
+    for (size_t j = 0; j < dimensions.size(); ++j)
+    {
+      #ifdef MLPACK_DECISION_TREE_USE_TASKS
+      #pragma omp task default(shared) firstprivate(j) \
+          if (count >= MinimumParallelPoints)
+      #endif
+      {
+        const size_t i = dimensions[j];
+        if (datasetInfo != NULL &&
+            datasetInfo->Type(i) == data::Datatype::categorical)
+        {
+          dimGains[j] = CategoricalSplit::template SplitIfBetter<UseWeights>(
+              nodeGain,
+              data.cols(begin, begin + count - 1).row(i),
+              datasetInfo->NumMappings(i),
+              labels.subvec(begin, begin + count - 1),
+              numClasses,
+              UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+              minimumLeafSize,
+              minimumGainSplit,
+              dimClassProbabilities[j],
+              categoricalAux[j]);
+        }
+        else
+        {
+          const HistogramType* histogram = &histograms[i];
+          if (histograms[i].counts.n_elem == 0)
+          {
+            NumericSplit::template BuildHistogram<UseWeights>(
+                binned.bins.submat(i, begin, i, begin + count - 1),
+                binned.binMin[i].n_elem,
+                labels.subvec(begin, begin + count - 1),
+                numClasses,
+                UseWeights ? weights.subvec(begin, begin + count - 1) :
+                    weights,
+                newHistograms[j]);
+            histogram = &newHistograms[j];
+          }
+
+          dimGains[j] = NumericSplit::template SplitIfBetter<UseWeights>(
+              nodeGain,
+              *histogram,
+              binned.binMin[i],
+              binned.binMax[i],
+              numClasses,
+              minimumLeafSize,
+              minimumGainSplit,
+              dimClassProbabilities[j],
+              numericAux[j]);
+        }
+      }
+    }
+    #ifdef MLPACK_DECISION_TREE_USE_TASKS
+    #pragma omp taskwait
+    #endif
+
+    // Keep the new histograms for the children.
+    for (size_t j = 0; j < dimensions.size(); ++j)
+    {
+      if (newHistograms[j].counts.n_elem != 0 &&
+          histograms[dimensions[j]].counts.n_elem == 0)
+        histograms[dimensions[j]] = std::move(newHistograms[j]);
+    }
+
+    // Now pick the best split in the order the dimensions were selected, so
+    // that the result doesn't depend on the number of threads.
+    const size_t bestIndex = SelectBestSplit(dimGains, minimumGainSplit,
+        bestGain);
+    if (bestIndex != dimensions.size())
+    {
+      bestDim = dimensions[bestIndex];
+      classProbabilities = std::move(dimClassProbabilities[bestIndex]);
+      NumericAuxiliarySplitInfo::operator=(numericAux[bestIndex]);
+      CategoricalAuxiliarySplitInfo::operator=(categoricalAux[bestIndex]);
+    }
+  }
+
+  // Did we split or not?  If so, then split the data and create the children.
+  if (bestDim != data.n_rows)
+  {
+    const bool categorical = (datasetInfo != NULL &&
+        datasetInfo->Type(bestDim) == data::Datatype::categorical);
+    dimensionTypeOrMajorityClass = (size_t) (categorical ?
+        data::Datatype::categorical : data::Datatype::numeric);
+    splitDimension = bestDim;
+
+    // Get the number of children we will have.
+    size_t numChildren = 0;
+    if (categorical)
+      numChildren = CategoricalSplit::NumChildren(classProbabilities, *this);
+    else
+      numChildren = NumericSplit::NumChildren(classProbabilities, *this);
+
+    // Calculate all child assignments.
+    arma::Row<size_t> childAssignments(count);
+    for (size_t j = begin; j < begin + count; ++j)
+    {
+      if (categorical)
+      {
+        childAssignments[j - begin] = CategoricalSplit::CalculateDirection(
+            data(bestDim, j), classProbabilities, *this);
       }
       else
       {
-        // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
+        childAssignments[j - begin] = NumericSplit::CalculateDirection(
+            data(bestDim, j), classProbabilities, *this);
       }
-      children.push_back(child);
+    }
+
+    // Figure out counts of children.
+    arma::Row<size_t> childCounts(numChildren, arma::fill::zeros);
+    for (size_t i = begin; i < begin + count; ++i)
+      childCounts[childAssignments[i - begin]]++;
+
+    // Initialize bestGain if recursive split is allowed.
+    if (!NoRecursion)
+    {
+      bestGain = 0.0;
+    }
+
+    // Split into children; the bins are moved along with the points.
+    arma::Row<size_t> childBegins(numChildren);
+    size_t currentCol = begin;
+    for (size_t i = 0; i < numChildren; ++i)
+    {
+      childBegins[i] = currentCol;
+      for (size_t j = childBegins[i]; j < begin + count; ++j)
+      {
+        if (childAssignments[j - begin] == i)
+        {
+          childAssignments.swap_cols(currentCol - begin, j - begin);
+          data.swap_cols(currentCol, j);
+          binned.bins.swap_cols(currentCol, j);
+          labels.swap_cols(currentCol, j);
+          if (UseWeights)
+            weights.swap_cols(currentCol, j);
+          ++currentCol;
+        }
+      }
+    }
+
+    // Only the children that may be split need histograms.  The largest child
+    // gets ours, minus the histograms of its siblings, so the histograms of
+    // the points of the largest child are never built.
+    std::vector<bool> maySplit(numChildren);
+    size_t largest = 0;
+    for (size_t i = 0; i < numChildren; ++i)
+    {
+      maySplit[i] = (!NoRecursion && maximumDepth != 2 &&
+          childCounts[i] >= 2 * std::max(minimumLeafSize, (size_t) 1));
+      if (childCounts[i] > childCounts[largest])
+        largest = i;
+    }
+
+    std::vector<std::vector<HistogramType>> childHistograms(numChildren);
+    for (size_t i = 0; i < numChildren; ++i)
+    {
+      if (i == largest || childCounts[i] == 0 ||
+          (!maySplit[i] && !maySplit[largest]))
+        continue;
+
+      childHistograms[i].resize(data.n_rows);
+      for (size_t d = 0; d < data.n_rows; ++d)
+      {
+        #ifdef MLPACK_DECISION_TREE_USE_TASKS
+        #pragma omp task default(shared) firstprivate(d) \
+            if (childCounts[i] >= MinimumParallelPoints)
+        #endif
+        {
+          if (histograms[d].counts.n_elem != 0)
+          {
+            const size_t childEnd = childBegins[i] + childCounts[i] - 1;
+            NumericSplit::template BuildHistogram<UseWeights>(
+                binned.bins.submat(d, childBegins[i], d, childEnd),
+                binned.binMin[d].n_elem,
+                labels.subvec(childBegins[i], childEnd),
+                numClasses,
+                UseWeights ? weights.subvec(childBegins[i], childEnd) :
+                    weights,
+                childHistograms[i][d]);
+            if (maySplit[largest])
+              histograms[d] -= childHistograms[i][d];
+          }
+        }
+      }
+      #ifdef MLPACK_DECISION_TREE_USE_TASKS
+      #pragma omp taskwait
+      #endif
+
+      if (!maySplit[i])
+        childHistograms[i].clear();
+    }
+
+    if (maySplit[largest])
+      childHistograms[largest] = std::move(histograms);
+    else
+      histograms.clear();
+
+    // Now build the children recursively, in parallel when possible, as
+    // Train() does.  Each child takes its histograms and frees them when they
+    // are no longer needed.
+    children.resize(numChildren);
+    arma::vec childGains(numChildren, arma::fill::zeros);
+    for (size_t i = 0; i < numChildren; ++i)
+    {
+      children[i] = new DecisionTree();
+
+      #ifdef MLPACK_DECISION_TREE_USE_TASKS
+      #pragma omp task default(shared) firstprivate(i) \
+          if (DimensionSelectionTraits< \
+              DimensionSelectionType>::IsDeterministic && \
+              childCounts[i] >= MinimumParallelPoints)
+      #endif
+      {
+        DimensionSelectionType childSelector(dimensionSelector);
+        if (NoRecursion)
+        {
+          children[i]->TrainBinnedNode<UseWeights>(data, binned,
+              std::move(childHistograms[i]), childBegins[i], childCounts[i],
+              datasetInfo, labels, numClasses, weights, childCounts[i],
+              minimumGainSplit, maximumDepth - 1, childSelector);
+        }
+        else
+        {
+          childGains[i] = children[i]->TrainBinnedNode<UseWeights>(data,
+              binned, std::move(childHistograms[i]), childBegins[i],
+              childCounts[i], datasetInfo, labels, numClasses, weights,
+              minimumLeafSize, minimumGainSplit, maximumDepth - 1,
+              childSelector);
+        }
+      }
+    }
+    #ifdef MLPACK_DECISION_TREE_USE_TASKS
+    #pragma omp taskwait
+    #endif
+
+    // During recursion entropy of child node may change.
+    if (!NoRecursion)
+    {
+      for (size_t i = 0; i < numChildren; ++i)
+        bestGain += double(childCounts[i]) / double(count) * (-childGains[i]);
     }
   }
   else
   {
-    // We won't be needing these members, so reset them.
+    // Clear auxiliary info objects.
     NumericAuxiliarySplitInfo::operator=(NumericAuxiliarySplitInfo());
+    CategoricalAuxiliarySplitInfo::operator=(CategoricalAuxiliarySplitInfo());
 
     // Calculate class probabilities because we are a leaf.
     CalculateClassProbabilities<UseWeights>(
@@ -1195,6 +1730,47 @@ size_t DecisionTree<FitnessFunction,
     return children[0]->NumClasses();
 }
 
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+size_t DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::SelectBestSplit(
+    const std::vector<double>& gains,
+    const double minimumGainSplit,
+    double& bestGain)
+{
+  size_t bestIndex = gains.size();
+  for (size_t j = 0; j < gains.size(); ++j)
+  {
+    // If the splitter reported that it did not split, move to the next
+    // dimension.
+    if (gains[j] == DBL_MAX)
+      continue;
+
+    // Once a split is chosen, later dimensions must improve on it as they would
+    // have had to if they had been searched after it.
+    if (bestIndex != gains.size() &&
+        gains[j] <= std::min(bestGain + minimumGainSplit, 0.0))
+      continue;
+
+    bestIndex = j;
+    bestGain = gains[j];
+
+    // If the gain is the best possible, no need to keep looking.
+    if (bestGain >= 0.0)
+      break;
+  }
+
+  return bestIndex;
+}
+
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
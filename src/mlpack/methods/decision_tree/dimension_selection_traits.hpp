@@ -0,0 +1,40 @@
+/**
+ * @file methods/decision_tree/dimension_selection_traits.hpp
+ *
+ * This provides the DimensionSelectionTraits class, a template class to get
+ * information about dimension selection policies for decision trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_DIMENSION_SELECTION_TRAITS_HPP
+#define MLPACK_METHODS_DECISION_TREE_DIMENSION_SELECTION_TRAITS_HPP
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * This is a template class that can provide information about dimension
+ * selection policies.  By default, this class will provide the weakest
+ * possible assumptions on policies, and each policy should override values as
+ * necessary.  If a policy doesn't need to override a value, then there's no
+ * need to write a DimensionSelectionTraits specialization for that class.
+ */
+template<typename DimensionSelectionType>
+class DimensionSelectionTraits
+{
+ public:
+  /**
+   * If true, then the policy selects dimensions without drawing random
+   * numbers, so the children of a decision tree node can be trained in
+   * parallel without changing the tree.
+   */
+  static const bool IsDeterministic = false;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,232 @@
+/**
+ * @file methods/decision_tree/histogram_numeric_split.hpp
+ *
+ * A tree splitter that finds the best binary numeric split between the bins of
+ * a histogram of the values, without sorting them.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "quantile_bin_thresholds.hpp"
+#include "numeric_split_traits.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The HistogramNumericSplit is a splitting function for decision trees that
+ * searches a numeric dimension for the best binary split among the boundaries
+ * of a histogram.  The values are divided into at most 256 bins at their
+ * quantiles with QuantileBinThresholds(), so that each bin holds about the same
+ * number of points even when the values are skewed or have outliers.  The class
+ * counts (or weights) of each bin are accumulated in one pass over the points,
+ * and the gain of each boundary between two non-empty bins is evaluated from
+ * the cumulative counts.  The split value is halfway between the largest value
+ * of the bins on the left and the smallest value of the bins on the right.
+ *
+ * DecisionTree bins each numeric dimension of the dataset only once, before it
+ * trains a tree (see NumericSplitTraits): the bin of each value is stored as
+ * a byte, and the histograms of each node are built from the bins of its
+ * points.  For each node that is split, the histograms are only built for the
+ * smaller children, and the histograms of the largest child are found by
+ * subtracting them from the histograms of the node.  Called directly on the
+ * values of a node, SplitIfBetter() bins the values of that node instead.
+ *
+ * BestBinaryNumericSplit sorts the values and the labels of each candidate
+ * dimension at each node, which takes O(n log n) time; this takes O(n + 256 c)
+ * time for c classes, at the cost of only considering the splits that fall
+ * between bins.  When a dimension has at most 256 distinct values, each gets
+ * its own bin, and the splits are the same.  It can be used as the
+ * NumericSplitType of DecisionTree and RandomForest:
+ *
+ * @code
+ * RandomForest<GiniGain, MultipleRandomDimensionSelect,
+ *     HistogramNumericSplit> rf(data, labels, numClasses, 100);
+ * @endcode
+ *
+ * @tparam FitnessFunction Fitness function to use to calculate gain.
+ */
+template<typename FitnessFunction>
+class HistogramNumericSplit
+{
+ public:
+  //! The maximum number of bins of each histogram.
+  static const size_t MaxBins = 256;
+
+  // No extra info needed for split.
+  template<typename ElemType>
+  class AuxiliarySplitInfo { };
+
+  /**
+   * The class counts (or class weight sums) of the points of a node in each
+   * bin of a dimension, and the number of points in each bin.
+   */
+  struct Histogram
+  {
+    //! The class counts (rows) of each bin (columns), if weights are not used.
+    arma::Mat<size_t> classCounts;
+    //! The class weight sums (rows) of each bin (columns), if weights are used.
+    arma::mat classWeightSums;
+    //! The number of points in each bin.
+    arma::Col<size_t> counts;
+
+    //! Remove the points of the given histogram, which must be the histogram
+    //! of a subset of the points of this one.
+    Histogram& operator-=(const Histogram& other)
+    {
+      classCounts -= other.classCounts;
+      classWeightSums -= other.classWeightSums;
+      counts -= other.counts;
+      return *this;
+    }
+  };
+
+  /**
+   * Divide the given values into at most MaxBins bins at their quantiles with
+   * QuantileBinThresholds(), and find the bin of each value and the smallest
+   * and largest value in each bin.
+   *
+   * @param values Values to divide into bins.
+   * @param bins Output bin of each value.
+   * @param binMin Output smallest value in each bin.
+   * @param binMax Output largest value in each bin.
+   */
+  template<typename VecType>
+  static void BinValues(const VecType& values,
+                        arma::Row<unsigned char>& bins,
+                        arma::vec& binMin,
+                        arma::vec& binMax);
+
+  /**
+   * Build the histogram of the given points of a node in one dimension.
+   *
+   * @param bins Bin of each point in the dimension.
+   * @param numBins Number of bins of the dimension.
+   * @param labels Labels for each point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights associated with labels.
+   * @param histogram Output histogram.
+   */
+  template<bool UseWeights,
+           typename BinVecType,
+           typename LabelsType,
+           typename WeightVecType>
+  static void BuildHistogram(const BinVecType& bins,
+                             const size_t numBins,
+                             const LabelsType& labels,
+                             const size_t numClasses,
+                             const WeightVecType& weights,
+                             Histogram& histogram);
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return the value 'bestGain'.  If a split is made, then classProbabilities
+   * and aux may be modified.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in.
+   * @param labels Labels for each point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights associated with labels.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param classProbabilities Class probabilities vector, which may be filled
+   *      with split information a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights, typename VecType, typename WeightVecType>
+  static double SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const arma::Row<size_t>& labels,
+      const size_t numClasses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::Col<typename VecType::elem_type>& classProbabilities,
+      AuxiliarySplitInfo<typename VecType::elem_type>& aux);
+
+  /**
+   * Check if we can split a node, given the histogram of its points in the
+   * dimension to check, as SplitIfBetter() does with the values themselves.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param histogram Histogram of the points of the node in the dimension.
+   * @param binMin Smallest value in each bin of the dimension.
+   * @param binMax Largest value in each bin of the dimension.
+   * @param numClasses Number of classes in the dataset.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param classProbabilities Class probabilities vector, which may be filled
+   *      with split information a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights, typename ElemType, typename AuxiliaryType>
+  static double SplitIfBetter(const double bestGain,
+                              const Histogram& histogram,
+                              const arma::vec& binMin,
+                              const arma::vec& binMax,
+                              const size_t numClasses,
+                              const size_t minimumLeafSize,
+                              const double minimumGainSplit,
+                              arma::Col<ElemType>& classProbabilities,
+                              AuxiliaryType& aux);
+
+  /**
+   * Returns 2, since the binary split always has two children.
+   */
+  template<typename ElemType>
+  static size_t NumChildren(const arma::Col<ElemType>& /* classProbabilities */,
+                            const AuxiliarySplitInfo<ElemType>& /* aux */)
+  {
+    return 2;
+  }
+
+  /**
+   * Given a point, calculate which child it should go to (left or right).
+   *
+   * @param point Point to calculate direction of.
+   * @param classProbabilities Auxiliary information for the split.
+   * @param * (aux) Auxiliary information for the split (Unused).
+   */
+  template<typename ElemType>
+  static size_t CalculateDirection(
+      const ElemType& point,
+      const arma::Col<ElemType>& classProbabilities,
+      const AuxiliarySplitInfo<ElemType>& /* aux */)
+  {
+    if (point <= classProbabilities[0])
+      return 0; // Go left.
+    else
+      return 1; // Go right.
+  }
+};
+
+//! HistogramNumericSplit finds splits from the bins of each dimension.
+template<typename FitnessFunction>
+class NumericSplitTraits<HistogramNumericSplit<FitnessFunction>>
+{
+ public:
+  static const bool UsesBins = true;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "histogram_numeric_split_impl.hpp"
+
+#endif
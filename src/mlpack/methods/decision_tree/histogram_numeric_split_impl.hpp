@@ -0,0 +1,275 @@
+/**
+ * @file methods/decision_tree/histogram_numeric_split_impl.hpp
+ *
+ * Implementation of the histogram-based strategy that finds the best binary
+ * numeric split.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "histogram_numeric_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction>
+template<typename VecType>
+void HistogramNumericSplit<FitnessFunction>::BinValues(
+    const VecType& values,
+    arma::Row<unsigned char>& bins,
+    arma::vec& binMin,
+    arma::vec& binMax)
+{
+  // Divide the values into bins at their quantiles, so that a few outliers or a
+  // heavy tail don't put most of the points into one bin.
+  arma::vec thresholds;
+  QuantileBinThresholds(values, MaxBins, thresholds);
+
+  const size_t numBins = thresholds.n_elem + 1;
+  bins.set_size(values.n_elem);
+  binMin.set_size(numBins);
+  binMin.fill(DBL_MAX);
+  binMax.set_size(numBins);
+  binMax.fill(-DBL_MAX);
+
+  for (size_t i = 0; i < values.n_elem; ++i)
+  {
+    const double value = (double) values[i];
+    const size_t bin = std::lower_bound(thresholds.begin(), thresholds.end(),
+        value) - thresholds.begin();
+
+    bins[i] = (unsigned char) bin;
+    binMin[bin] = std::min(binMin[bin], value);
+    binMax[bin] = std::max(binMax[bin], value);
+  }
+}
+
+template<typename FitnessFunction>
+template<bool UseWeights,
+         typename BinVecType,
+         typename LabelsType,
+         typename WeightVecType>
+void HistogramNumericSplit<FitnessFunction>::BuildHistogram(
+    const BinVecType& bins,
+    const size_t numBins,
+    const LabelsType& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    Histogram& histogram)
+{
+  histogram.counts.zeros(numBins);
+  if (UseWeights)
+  {
+    histogram.classCounts.reset();
+    histogram.classWeightSums.zeros(numClasses, numBins);
+  }
+  else
+  {
+    histogram.classCounts.zeros(numClasses, numBins);
+    histogram.classWeightSums.reset();
+  }
+
+  for (size_t i = 0; i < bins.n_elem; ++i)
+  {
+    const size_t bin = bins[i];
+    if (UseWeights)
+      histogram.classWeightSums(labels[i], bin) += weights[i];
+    else
+      ++histogram.classCounts(labels[i], bin);
+
+    ++histogram.counts[bin];
+  }
+}
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename WeightVecType>
+double HistogramNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::Col<typename VecType::elem_type>& classProbabilities,
+    AuxiliarySplitInfo<typename VecType::elem_type>& aux)
+{
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  // Bin the values of this node, and build the histogram in one pass over the
+  // points.
+  arma::Row<unsigned char> bins;
+  arma::vec binMin, binMax;
+  BinValues(data, bins, binMin, binMax);
+
+  Histogram histogram;
+  BuildHistogram<UseWeights>(bins, binMin.n_elem, labels, numClasses, weights,
+      histogram);
+
+  return SplitIfBetter<UseWeights>(bestGain, histogram, binMin, binMax,
+      numClasses, minimumLeafSize, minimumGainSplit, classProbabilities, aux);
+}
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename ElemType, typename AuxiliaryType>
+double HistogramNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const Histogram& histogram,
+    const arma::vec& binMin,
+    const arma::vec& binMax,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::Col<ElemType>& classProbabilities,
+    AuxiliaryType& /* aux */)
+{
+  const size_t numPoints = arma::accu(histogram.counts);
+  const size_t numBins = histogram.counts.n_elem;
+
+  // First sanity check: if we don't have enough points, we can't split.
+  if (numPoints < (minimumLeafSize * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  const arma::Mat<size_t>& binClassCounts = histogram.classCounts;
+  const arma::mat& binClassWeightSums = histogram.classWeightSums;
+  const arma::Col<size_t>& binCounts = histogram.counts;
+
+  // Loop through the boundaries between the non-empty bins, choosing the best
+  // one.  Also, force a minimum leaf size of 1 (empty children don't make
+  // sense).
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
+  bool improved = false;
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+
+  // Class counts (or weight sums) of each child; everything starts on the
+  // right.
+  arma::Mat<size_t> classCounts;
+  arma::mat classWeightSums;
+  double totalWeight = 0.0;
+  double totalLeftWeight = 0.0;
+  double totalRightWeight = 0.0;
+  if (UseWeights)
+  {
+    classWeightSums.zeros(numClasses, 2);
+    classWeightSums.col(1) = arma::sum(binClassWeightSums, 1);
+    totalWeight = arma::accu(classWeightSums.col(1));
+    totalRightWeight = totalWeight;
+    bestFoundGain *= totalWeight;
+  }
+  else
+  {
+    classCounts.zeros(numClasses, 2);
+    classCounts.col(1) = arma::sum(binClassCounts, 1);
+    bestFoundGain *= numPoints;
+  }
+
+  size_t leftPoints = 0;
+  size_t bin = 0;
+  while (bin < numBins)
+  {
+    // Move the points of this bin to the left.
+    if (UseWeights)
+    {
+      classWeightSums.col(0) += binClassWeightSums.col(bin);
+      classWeightSums.col(1) -= binClassWeightSums.col(bin);
+      const double binWeight = arma::accu(binClassWeightSums.col(bin));
+      totalLeftWeight += binWeight;
+      totalRightWeight -= binWeight;
+    }
+    else
+    {
+      classCounts.col(0) += binClassCounts.col(bin);
+      classCounts.col(1) -= binClassCounts.col(bin);
+    }
+    leftPoints += binCounts[bin];
+
+    // Find the next non-empty bin, which is the first on the right.
+    size_t nextBin = bin + 1;
+    while (nextBin < numBins && binCounts[nextBin] == 0)
+      ++nextBin;
+    if (nextBin == numBins)
+      break;
+
+    const size_t rightPoints = numPoints - leftPoints;
+    if (leftPoints < minimum || rightPoints < minimum)
+    {
+      bin = nextBin;
+      continue;
+    }
+
+    // Calculate the gain for the left and right child.  Only use weights if
+    // needed.
+    const double leftGain = UseWeights ?
+        FitnessFunction::template EvaluatePtr<true>(classWeightSums.colptr(0),
+            numClasses, totalLeftWeight) :
+        FitnessFunction::template EvaluatePtr<false>(classCounts.colptr(0),
+            numClasses, leftPoints);
+    const double rightGain = UseWeights ?
+        FitnessFunction::template EvaluatePtr<true>(classWeightSums.colptr(1),
+            numClasses, totalRightWeight) :
+        FitnessFunction::template EvaluatePtr<false>(classCounts.colptr(1),
+            numClasses, rightPoints);
+
+    double gain;
+    if (UseWeights)
+    {
+      gain = totalLeftWeight * leftGain + totalRightWeight * rightGain;
+    }
+    else
+    {
+      // Calculate the gain at this split point.
+      gain = double(leftPoints) * leftGain + double(rightPoints) * rightGain;
+    }
+
+    // Corner case: is this the best possible split?
+    if (gain >= 0.0)
+    {
+      // We can take a shortcut: no split will be better than this, so just take
+      // this one.  The actual split value will be halfway between the largest
+      // value on the left and the smallest value on the right.
+      classProbabilities.set_size(1);
+      classProbabilities[0] = (binMax[bin] + binMin[nextBin]) / 2.0;
+
+      return gain;
+    }
+    else if (gain > bestFoundGain)
+    {
+      // We still have a better split.
+      bestFoundGain = gain;
+      classProbabilities.set_size(1);
+      classProbabilities[0] = (binMax[bin] + binMin[nextBin]) / 2.0;
+      improved = true;
+    }
+
+    bin = nextBin;
+  }
+
+  // If we didn't improve, return the original gain exactly as we got it
+  // (without introducing floating point errors).
+  if (!improved)
+    return DBL_MAX;
+
+  if (UseWeights)
+    bestFoundGain /= totalWeight;
+  else
+    bestFoundGain /= numPoints;
+
+  return bestFoundGain;
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,44 @@
+/**
+ * @file methods/decision_tree/numeric_split_traits.hpp
+ *
+ * This provides the NumericSplitTraits class, a template class to get
+ * information about numeric split types for decision trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_NUMERIC_SPLIT_TRAITS_HPP
+#define MLPACK_METHODS_DECISION_TREE_NUMERIC_SPLIT_TRAITS_HPP
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * This is a template class that can provide information about numeric split
+ * types.  By default, this class will provide the weakest possible assumptions
+ * on split types, and each split type should override values as necessary.  If
+ * a split type doesn't need to override a value, then there's no need to write
+ * a NumericSplitTraits specialization for that class.
+ */
+template<typename NumericSplitType>
+class NumericSplitTraits
+{
+ public:
+  /**
+   * If true, then the split type finds splits from the bins of each dimension.
+   * It must then provide a Histogram type, BinValues(), BuildHistogram(), and
+   * an overload of SplitIfBetter() that takes a Histogram (see
+   * HistogramNumericSplit).  DecisionTree bins each numeric dimension once
+   * before it trains a tree, and finds the histograms of the largest child of
+   * each node by subtracting the histograms of its siblings from those of the
+   * node.
+   */
+  static const bool UsesBins = false;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
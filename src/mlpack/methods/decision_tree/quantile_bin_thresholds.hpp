@@ -0,0 +1,133 @@
+/**
+ * @file methods/decision_tree/quantile_bin_thresholds.hpp
+ *
+ * Compute the thresholds that divide a set of values into bins at quantiles of
+ * the values, for histogram-based split finding.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_QUANTILE_BIN_THRESHOLDS_HPP
+#define MLPACK_METHODS_DECISION_TREE_QUANTILE_BIN_THRESHOLDS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <unordered_set>
+
+namespace mlpack {
+namespace tree {
+namespace details {
+
+/**
+ * Rearrange values[begin, end) so that, for each of the sorted ranks
+ * ranks[firstRank, lastRank), the value at that rank is the one that would be
+ * there if the values were sorted, and all the values before it are no larger
+ * and all the values after it are no smaller.  This takes O(n log k) time for
+ * k ranks.
+ */
+inline void MultipleSelect(std::vector<double>& values,
+                           const size_t begin,
+                           const size_t end,
+                           const std::vector<size_t>& ranks,
+                           const size_t firstRank,
+                           const size_t lastRank)
+{
+  if (firstRank >= lastRank)
+    return;
+
+  const size_t middleRank = firstRank + (lastRank - firstRank) / 2;
+  const size_t r = ranks[middleRank];
+  std::nth_element(values.begin() + begin, values.begin() + r,
+      values.begin() + end);
+
+  MultipleSelect(values, begin, r, ranks, firstRank, middleRank);
+  MultipleSelect(values, r + 1, end, ranks, middleRank + 1, lastRank);
+}
+
+} // namespace details
+
+/**
+ * Compute the thresholds that divide the given values into at most maxBins
+ * bins.  If there are at most maxBins distinct values, each gets its own bin;
+ * otherwise, the bins are placed at quantiles of the values, so that each holds
+ * about the same number of points, however skewed the values are.  Each
+ * threshold is halfway between the largest value below it and the smallest
+ * value above it, and the bin of a value is the number of thresholds less than
+ * it (see std::lower_bound()).
+ *
+ * The values are not sorted: this takes O(n log maxBins) time.
+ *
+ * @param values Values to divide into bins.
+ * @param maxBins Maximum number of bins (at least 2).
+ * @param thresholds Sorted thresholds between the bins; empty if all the values
+ *      are the same.
+ */
+template<typename VecType>
+void QuantileBinThresholds(const VecType& values,
+                           const size_t maxBins,
+                           arma::vec& thresholds)
+{
+  // Count the distinct values, stopping once there are too many.
+  std::unordered_set<double> distinctValues;
+  for (size_t i = 0; i < values.n_elem && distinctValues.size() <= maxBins; ++i)
+    distinctValues.insert((double) values[i]);
+
+  if (distinctValues.size() <= maxBins)
+  {
+    std::vector<double> sortedValues(distinctValues.begin(),
+        distinctValues.end());
+    std::sort(sortedValues.begin(), sortedValues.end());
+
+    thresholds.set_size(std::max(sortedValues.size(), (size_t) 1) - 1);
+    for (size_t i = 1; i < sortedValues.size(); ++i)
+      thresholds[i - 1] = (sortedValues[i - 1] + sortedValues[i]) / 2.0;
+
+    return;
+  }
+
+  // Otherwise, select the values at the maxBins - 1 ranks that divide the
+  // points evenly.  There are more than maxBins points, so the ranks are all
+  // different.
+  const size_t n = values.n_elem;
+  std::vector<double> partialValues(n);
+  for (size_t i = 0; i < n; ++i)
+    partialValues[i] = (double) values[i];
+
+  std::vector<size_t> ranks(maxBins - 1);
+  for (size_t b = 0; b < ranks.size(); ++b)
+    ranks[b] = (b + 1) * n / maxBins;
+  details::MultipleSelect(partialValues, 0, n, ranks, 0, ranks.size());
+
+  // The threshold after each selected value is halfway to the smallest larger
+  // value.  That value is between the selected rank and the next one, unless
+  // the value at the next rank is the same; then the next rank's threshold is
+  // the same, and is found from there.  So each point is scanned only once.
+  std::vector<double> result;
+  for (size_t b = 0; b < ranks.size(); ++b)
+  {
+    const double value = partialValues[ranks[b]];
+    const size_t end = (b + 1 < ranks.size()) ? ranks[b + 1] + 1 : n;
+
+    bool found = false;
+    double nextValue = DBL_MAX;
+    for (size_t i = ranks[b] + 1; i < end; ++i)
+    {
+      if (partialValues[i] > value && partialValues[i] <= nextValue)
+      {
+        nextValue = partialValues[i];
+        found = true;
+      }
+    }
+
+    if (found)
+      result.push_back((value + nextValue) / 2.0);
+  }
+
+  thresholds = arma::vec(result);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
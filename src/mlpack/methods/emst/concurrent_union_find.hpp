@@ -0,0 +1,107 @@
+/**
+ * @file methods/emst/concurrent_union_find.hpp
+ *
+ * Implements a union-find data structure that can be used from several threads
+ * at once.  Like the UnionFind class, calling Union(x, y) unites the components
+ * indexed by x and y and Find(x) returns the index of the component containing
+ * point x.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+#define MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <atomic>
+
+namespace mlpack {
+namespace emst {
+
+/**
+ * A lock-free Union-Find data structure.  Union() and Find() may be called
+ * concurrently from any number of threads.  The parent of each element is
+ * updated with compare-and-swap operations, and Find() compresses paths by
+ * path halving.
+ *
+ * The root of a component is always linked below the root with the smaller
+ * index, so once all unions are done, Find(x) is the smallest index in the
+ * component of x.  The result does not depend on the order of the unions or on
+ * the number of threads that performed them.
+ */
+class ConcurrentUnionFind
+{
+ private:
+  std::vector<std::atomic<size_t>> parent;
+
+ public:
+  //! Construct the object with the given size.
+  ConcurrentUnionFind(const size_t size) : parent(size)
+  {
+    for (size_t i = 0; i < size; ++i)
+      parent[i].store(i, std::memory_order_relaxed);
+  }
+
+  /**
+   * Returns the component containing an element.  If other threads are
+   * performing unions at the same time, the returned index was the root of
+   * the component of x at some point during the call.
+   *
+   * @param x the component to be found
+   * @return The index of the component containing x
+   */
+  size_t Find(size_t x)
+  {
+    size_t p = parent[x].load(std::memory_order_acquire);
+    while (p != x)
+    {
+      // Point x at its grandparent; if another thread got there first, that's
+      // fine, because both links point towards the same root.
+      const size_t gp = parent[p].load(std::memory_order_acquire);
+      if (gp != p)
+        parent[x].compare_exchange_weak(p, gp, std::memory_order_acq_rel);
+
+      x = p;
+      p = parent[x].load(std::memory_order_acquire);
+    }
+
+    return x;
+  }
+
+  /**
+   * Union the components containing x and y.
+   *
+   * @param x one component
+   * @param y the other component
+   */
+  void Union(const size_t x, const size_t y)
+  {
+    size_t xRoot = Find(x);
+    size_t yRoot = Find(y);
+
+    while (xRoot != yRoot)
+    {
+      // Always link the larger root below the smaller one.
+      if (xRoot < yRoot)
+        std::swap(xRoot, yRoot);
+
+      // This only succeeds if xRoot is still a root.
+      size_t expected = xRoot;
+      if (parent[xRoot].compare_exchange_strong(expected, yRoot,
+          std::memory_order_acq_rel))
+        return;
+
+      // Another thread changed the component of xRoot; try again.
+      xRoot = Find(xRoot);
+      yRoot = Find(yRoot);
+    }
+  }
+}; // class ConcurrentUnionFind
+
+} // namespace emst
+} // namespace mlpack
+
+#endif // MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
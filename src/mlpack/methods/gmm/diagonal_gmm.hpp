@@ -19,6 +19,8 @@
 
 // This is the default fitting method class.
 #include "em_fit.hpp"
+// This fitting method class can also update the model with one batch at a time.
+#include "stepwise_em_fit.hpp"
 
 // This is the default covariance matrix constraint.
 #include "diagonal_constraint.hpp"
@@ -263,6 +265,29 @@ class DiagonalGMM
                const bool useExistingModel = false,
                FittingType fitter = FittingType());
 
+  /**
+   * Update the model with one batch of observations, using the given online
+   * fitter, which keeps the state of the algorithm between calls (see
+   * StepwiseEMFit).  The model should already be initialized, for instance by
+   * training it on a first batch with Train(); this can be used to fit the
+   * model to data that does not fit in memory, one chunk at a time, or to
+   * refresh the model as new data arrives.
+   *
+   * The FittingType class must provide the following function:
+   *
+   * @code
+   * double Step(const arma::mat& observations,
+   *             std::vector<distribution::DiagonalGaussianDistribution>& dists,
+   *             arma::vec& weights);
+   * @endcode
+   *
+   * @param observations Batch of observations.
+   * @param fitter The online fitter to use.
+   * @return The log-likelihood of the batch under the model before the update.
+   */
+  template<typename FittingType>
+  double Update(const arma::mat& observations, FittingType& fitter);
+
   /**
    * Classify the given observations as being from an individual component in
    * this DiagonalGMM. The resultant classifications are stored in the 'labels'
@@ -189,6 +189,22 @@ double DiagonalGMM::Train(const arma::mat& observations,
   return bestLikelihood;
 }
 
+//! Update the DiagonalGMM with one batch of observations.
+template<typename FittingType>
+double DiagonalGMM::Update(const arma::mat& observations, FittingType& fitter)
+{
+  if (observations.n_rows != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "DiagonalGMM::Update(): dimensionality of observations ("
+        << observations.n_rows << ") does not match the dimensionality of "
+        << "the model (" << dimensionality << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  return fitter.Step(observations, dists, weights);
+}
+
 //! Serialize the object.
 template<typename Archive>
 void DiagonalGMM::serialize(Archive& ar, const uint32_t /* version */)
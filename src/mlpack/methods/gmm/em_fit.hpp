@@ -107,6 +107,22 @@ class EMFit
                 arma::vec& weights,
                 const bool useInitialModel = false);
 
+  /**
+   * Run the clusterer, and then turn the cluster assignments into Gaussians.
+   * This is a helper function for both overloads of Estimate(), and is also
+   * used by GMM::Train() to compute the initial model of each trial before
+   * the trials are run in parallel.  The vectors must be already set to the
+   * number of clusters.
+   *
+   * @param observations List of observations.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   */
+  void InitialClustering(
+      const arma::mat& observations,
+      std::vector<Distribution>& dists,
+      arma::vec& weights);
+
   //! Get the clusterer.
   const InitialClusteringType& Clusterer() const { return clusterer; }
   //! Modify the clusterer.
@@ -133,34 +149,26 @@ class EMFit
 
  private:
   /**
-   * Run the clusterer, and then turn the cluster assignments into Gaussians.
-   * This is a helper function for both overloads of Estimate().  The vectors
-   * must be already set to the number of clusters.
+   * The E-step: compute the log of the probability of each point being from
+   * each component (each row of condLogProb is normalized), and return the
+   * log-likelihood of the model.  Yes, the log-likelihood is reimplemented in
+   * the GMM code.  Intuition suggests that the log-likelihood is not the best
+   * way to determine if the EM algorithm has converged.
    *
-   * @param observations List of observations.
-   * @param means Vector to store means in.
-   * @param dists Distributions to store model in.
-   * @param weights Vector to store a priori weights in.
-   */
-  void InitialClustering(
-      const arma::mat& observations,
-      std::vector<Distribution>& dists,
-      arma::vec& weights);
-
-  /**
-   * Calculate the log-likelihood of a model.  Yes, this is reimplemented in the
-   * GMM code.  Intuition suggests that the log-likelihood is not the best way
-   * to determine if the EM algorithm has converged.
+   * The points are split into blocks, and the log-probabilities of each block
+   * under each component are computed in parallel if OpenMP is available.
    *
-   * @param data Data matrix.
-   * @param means Vector of means.
-   * @param dists Distributions to store model in.
+   * @param observations List of observations.
+   * @param dists Distributions of the model.
    * @param weights Vector of a priori weights.
+   * @param condLogProb Matrix to store the conditional log-probabilities in
+   *     (one row per point, one column per component).
    */
-  double LogLikelihood(
-      const arma::mat& data,
+  double ConditionalLogProbabilities(
+      const arma::mat& observations,
       const std::vector<Distribution>& dists,
-      const arma::vec& weights) const;
+      const arma::vec& weights,
+      arma::mat& condLogProb) const;
 
   /**
    * Use the Armadillo gmm_diag clusterer to train a GMM with diagonal
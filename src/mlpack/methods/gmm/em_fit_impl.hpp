@@ -71,13 +71,17 @@ Estimate(const arma::mat& observations,
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  // Calculate the conditional probabilities of choosing a particular Gaussian
+  // given the observations and the present theta value; the log-likelihood of
+  // the model comes out of the same pass.
+  arma::mat condLogProb(observations.n_cols, dists.size());
+  double l = ConditionalLogProbabilities(observations, dists, weights,
+      condLogProb);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condLogProb(observations.n_cols, dists.size());
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
@@ -86,27 +90,6 @@ Estimate(const arma::mat& observations,
     Log::Info << "EMFit::Estimate(): iteration " << iteration << ", "
         << "log-likelihood " << l << "." << std::endl;
 
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Store conditional log probabilities into condLogProb vector for each
-      // Gaussian.  First we make an alias of the condLogProb vector.
-      arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
-      dists[i].LogProbability(observations, condLogProbAlias);
-      condLogProbAlias += log(weights[i]);
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condLogProb.n_rows; ++i)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = mlpack::math::AccuLog(condLogProb.row(i));
-      if (probSum != -std::numeric_limits<double>::infinity())
-        condLogProb.row(i) -= probSum;
-    }
-
     // Store the sum of the probability of each state over all the observations.
     arma::vec probRowSums(dists.size());
     for (size_t i = 0; i < dists.size(); ++i)
@@ -158,9 +141,10 @@ Estimate(const arma::mat& observations,
     // probabilities.
     weights = arma::exp(probRowSums - std::log(observations.n_cols));
 
-    // Update values of l; calculate new log-likelihood.
+    // Update values of l; calculate new log-likelihood, and the conditional
+    // probabilities for the next iteration.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    l = ConditionalLogProbabilities(observations, dists, weights, condLogProb);
 
     iteration++;
   }
@@ -179,39 +163,22 @@ Estimate(const arma::mat& observations,
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  // Calculate the conditional probabilities of choosing a particular Gaussian
+  // given the observations and the present theta value, along with the
+  // log-likelihood of the model.
+  arma::mat condLogProb(observations.n_cols, dists.size());
+  double l = ConditionalLogProbabilities(observations, dists, weights,
+      condLogProb);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condLogProb(observations.n_cols, dists.size());
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
   while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
   {
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Store conditional log probabilities into condLogProb vector for each
-      // Gaussian.  First we make an alias of the condLogProb vector.
-      arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
-      dists[i].LogProbability(observations, condLogProbAlias);
-      condLogProbAlias += log(weights[i]);
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condLogProb.n_rows; ++i)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = mlpack::math::AccuLog(condLogProb.row(i));
-      if (probSum != -std::numeric_limits<double>::infinity())
-        condLogProb.row(i) -= probSum;
-    }
-
     // This will store the sum of probabilities of each state over all the
     // observations.
     arma::vec probRowSums(dists.size());
@@ -271,9 +238,10 @@ Estimate(const arma::mat& observations,
     // probabilities.
     weights = arma::exp(probRowSums - mlpack::math::AccuLog(logProbabilities));
 
-    // Update values of l; calculate new log-likelihood.
+    // Update values of l; calculate new log-likelihood, and the conditional
+    // probabilities for the next iteration.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    l = ConditionalLogProbabilities(observations, dists, weights, condLogProb);
 
     iteration++;
   }
@@ -377,31 +345,60 @@ template<typename InitialClusteringType,
          typename CovarianceConstraintPolicy,
          typename Distribution>
 double EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
-LogLikelihood(const arma::mat& observations,
-              const std::vector<Distribution>& dists,
-              const arma::vec& weights) const
+ConditionalLogProbabilities(const arma::mat& observations,
+                            const std::vector<Distribution>& dists,
+                            const arma::vec& weights,
+                            arma::mat& condLogProb) const
 {
-  double logLikelihood = 0;
+  const size_t numPoints = observations.n_cols;
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (numPoints + blockSize - 1) / blockSize;
+  const arma::vec logWeights = arma::log(weights);
+
+  // Each task computes the log-probabilities of one block of points under one
+  // component, so that there is enough work to split between threads even
+  // when there are few components.  The tasks write to disjoint parts of
+  // condLogProb.
+  #pragma omp parallel
+  {
+    arma::vec logProbabilities;
 
-  arma::vec logPhis;
-  arma::mat logLikelihoods(dists.size(), observations.n_cols);
+    #pragma omp for schedule(static)
+    for (omp_size_t task = 0; task < (omp_size_t) (numBlocks * dists.size());
+        ++task)
+    {
+      const size_t component = task % dists.size();
+      const size_t begin = (task / dists.size()) * blockSize;
+      const size_t end = std::min(begin + blockSize, numPoints);
+
+      dists[component].LogProbability(observations.cols(begin, end - 1),
+          logProbabilities);
+      condLogProb.submat(begin, component, end - 1, component) =
+          logProbabilities + logWeights[component];
+    }
+  }
 
-  // It has to be LogProbability() otherwise Probability() would overflow easily
-  for (size_t i = 0; i < dists.size(); ++i)
+  // Now normalize row-wise, summing the log-likelihood of each point.
+  double logLikelihood = 0.0;
+  size_t outliers = 0;
+  #pragma omp parallel for reduction(+:logLikelihood, outliers)
+  for (omp_size_t i = 0; i < (omp_size_t) numPoints; ++i)
   {
-    dists[i].LogProbability(observations, logPhis);
-    logLikelihoods.row(i) = log(weights(i)) + trans(logPhis);
+    // Avoid dividing by zero; if the probability for everything is 0, we
+    // don't want to make it NaN.
+    const double probSum = mlpack::math::AccuLog(condLogProb.row(i));
+    if (probSum != -std::numeric_limits<double>::infinity())
+      condLogProb.row(i) -= probSum;
+    else
+      ++outliers;
+
+    logLikelihood += probSum;
   }
-  // Now sum over every point.
-  for (size_t j = 0; j < observations.n_cols; ++j)
+
+  if (outliers > 0)
   {
-    if (mlpack::math::AccuLog(logLikelihoods.col(j)) ==
-        -std::numeric_limits<double>::infinity())
-    {
-      Log::Info << "Likelihood of point " << j << " is 0!  It is probably an "
-          << "outlier." << std::endl;
-    }
-    logLikelihood += mlpack::math::AccuLog(logLikelihoods.col(j));
+    Log::Info << "Likelihood of " << outliers << " points is 0!  They are "
+        << "probably outliers." << std::endl;
   }
 
   return logLikelihood;
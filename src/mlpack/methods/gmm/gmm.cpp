@@ -176,7 +176,8 @@ double GMM::LogLikelihood(
   }
 
   // Now sum over every point.
-  for (size_t j = 0; j < data.n_cols; ++j)
+  #pragma omp parallel for reduction(+:loglikelihood)
+  for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
     loglikelihood += mlpack::math::AccuLog(logLikelihoods.col(j));
   return loglikelihood;
 }
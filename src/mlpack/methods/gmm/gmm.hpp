@@ -17,6 +17,8 @@
 
 // This is the default fitting method class.
 #include "em_fit.hpp"
+// This fitting method class can also update the model with one batch at a time.
+#include "stepwise_em_fit.hpp"
 
 namespace mlpack {
 namespace gmm /** Gaussian Mixture Models. */ {
@@ -207,6 +209,11 @@ class GMM
    * with the greatest log-likelihood will be selected.  By default, only one
    * trial is performed.  The log-likelihood of the best fitting is returned.
    *
+   * If the fitter has an InitialClustering() method (as EMFit does), the
+   * initial models of all trials are computed first, and then the trials are
+   * run in parallel if OpenMP is available.  Each trial keeps its own copy of
+   * the fitter and its own working memory.
+   *
    * Optionally, the existing model can be used as an initial model for the
    * estimation by setting 'useExistingModel' to true.  If the fitting procedure
    * is deterministic after the initial position is given, then 'trials' should
@@ -236,7 +243,8 @@ class GMM
    *
    * The fitting will be performed 'trials' times; from these trials, the model
    * with the greatest log-likelihood will be selected.  By default, only one
-   * trial is performed.  The log-likelihood of the best fitting is returned.
+   * trial is performed, and as in the other overload, the trials may be run
+   * in parallel.  The log-likelihood of the best fitting is returned.
    *
    * Optionally, the existing model can be used as an initial model for the
    * estimation by setting 'useExistingModel' to true.  If the fitting procedure
@@ -260,6 +268,29 @@ class GMM
                const bool useExistingModel = false,
                FittingType fitter = FittingType());
 
+  /**
+   * Update the model with one batch of observations, using the given online
+   * fitter, which keeps the state of the algorithm between calls (see
+   * StepwiseEMFit).  The model should already be initialized, for instance by
+   * training it on a first batch with Train(); this can be used to fit the
+   * model to data that does not fit in memory, one chunk at a time, or to
+   * refresh the model as new data arrives.
+   *
+   * The FittingType class must provide the following function:
+   *
+   * @code
+   * double Step(const arma::mat& observations,
+   *             std::vector<distribution::GaussianDistribution>& dists,
+   *             arma::vec& weights);
+   * @endcode
+   *
+   * @param observations Batch of observations.
+   * @param fitter The online fitter to use.
+   * @return The log-likelihood of the batch under the model before the update.
+   */
+  template<typename FittingType>
+  double Update(const arma::mat& observations, FittingType& fitter);
+
   /**
    * Classify the given observations as being from an individual component in
    * this GMM.  The resultant classifications are stored in the 'labels' object,
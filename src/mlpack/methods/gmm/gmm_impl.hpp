@@ -17,9 +17,52 @@
 // In case it hasn't already been included.
 #include "gmm.hpp"
 
+#include <mlpack/core/util/sfinae_utility.hpp>
+
 namespace mlpack {
 namespace gmm {
 
+HAS_MEM_FUNC(InitialClustering, HasInitialClusteringCheck);
+
+/**
+ * 'value' is true if the FittingType class has a member
+ * InitialClustering(const arma::mat& observations,
+ *                   std::vector<GaussianDistribution>& dists,
+ *                   arma::vec& weights).
+ */
+template<typename FittingType>
+struct HasInitialClustering
+{
+  static const bool value = HasInitialClusteringCheck<FittingType,
+      void(FittingType::*)(const arma::mat&,
+                           std::vector<distribution::GaussianDistribution>&,
+                           arma::vec&)>::value;
+};
+
+//! Compute the initial model of a trial, if the fitter can do that on its own.
+template<typename FittingType>
+void TrialInitialModel(
+    FittingType& fitter,
+    const arma::mat& observations,
+    std::vector<distribution::GaussianDistribution>& dists,
+    arma::vec& weights,
+    const typename std::enable_if<
+        HasInitialClustering<FittingType>::value>::type* = 0)
+{
+  fitter.InitialClustering(observations, dists, weights);
+}
+
+//! Otherwise, each trial computes its initial model in Estimate().
+template<typename FittingType>
+void TrialInitialModel(
+    FittingType& /* fitter */,
+    const arma::mat& /* observations */,
+    std::vector<distribution::GaussianDistribution>& /* dists */,
+    arma::vec& /* weights */,
+    const typename std::enable_if<
+        !HasInitialClustering<FittingType>::value>::type* = 0)
+{ }
+
 /**
  * Fit the GMM to the given observations.
  */
@@ -44,55 +87,47 @@ double GMM::Train(const arma::mat& observations,
     if (trials == 0)
       return -DBL_MAX; // It's what they asked for...
 
-    // If each trial must start from the same initial location, we must save it.
-    std::vector<distribution::GaussianDistribution> distsOrig;
-    arma::vec weightsOrig;
-    if (useExistingModel)
+    // Each trial is trained into its own model.  If the fitter can compute the
+    // initial model on its own, we do that for every trial first, one trial
+    // after another (the initial clustering draws from the shared random
+    // number generator), and then run all of the trials in parallel.
+    // Otherwise, the trials are run one after another.
+    const bool fromInitialModel = useExistingModel ||
+        HasInitialClustering<FittingType>::value;
+    std::vector<std::vector<distribution::GaussianDistribution>> trialDists(
+        trials, dists);
+    std::vector<arma::vec> trialWeights(trials, weights);
+    if (!useExistingModel)
     {
-      distsOrig = dists;
-      weightsOrig = weights;
-    }
-
-    // We need to keep temporary copies.  We'll do the first training into the
-    // actual model position, so that if it's the best we don't need to copy it.
-    fitter.Estimate(observations, dists, weights, useExistingModel);
-
-    bestLikelihood = LogLikelihood(observations, dists, weights);
-
-    Log::Info << "GMM::Train(): Log-likelihood of trial 0 is "
-        << bestLikelihood << "." << std::endl;
-
-    // Now the temporary model.
-    std::vector<distribution::GaussianDistribution> distsTrial(gaussians,
-        distribution::GaussianDistribution(dimensionality));
-    arma::vec weightsTrial(gaussians);
-
-    for (size_t trial = 1; trial < trials; ++trial)
-    {
-      if (useExistingModel)
+      for (size_t trial = 0; trial < trials; ++trial)
       {
-        distsTrial = distsOrig;
-        weightsTrial = weightsOrig;
+        TrialInitialModel(fitter, observations, trialDists[trial],
+            trialWeights[trial]);
       }
+    }
 
-      fitter.Estimate(observations, distsTrial, weightsTrial, useExistingModel);
-
-      // Check to see if the log-likelihood of this one is better.
-      double newLikelihood = LogLikelihood(observations, distsTrial,
-          weightsTrial);
+    arma::vec likelihoods(trials);
+    #pragma omp parallel for schedule(dynamic) if (fromInitialModel)
+    for (omp_size_t trial = 0; trial < (omp_size_t) trials; ++trial)
+    {
+      FittingType trialFitter(fitter);
+      trialFitter.Estimate(observations, trialDists[trial], trialWeights[trial],
+          fromInitialModel);
+      likelihoods[trial] = LogLikelihood(observations, trialDists[trial],
+          trialWeights[trial]);
+    }
 
+    for (size_t trial = 0; trial < trials; ++trial)
+    {
       Log::Info << "GMM::Train(): Log-likelihood of trial " << trial << " is "
-          << newLikelihood << "." << std::endl;
-
-      if (newLikelihood > bestLikelihood)
-      {
-        // Save new likelihood and copy new model.
-        bestLikelihood = newLikelihood;
-
-        dists = distsTrial;
-        weights = weightsTrial;
-      }
+          << likelihoods[trial] << "." << std::endl;
     }
+
+    // Keep the model with the greatest log-likelihood.
+    const size_t bestTrial = likelihoods.index_max();
+    bestLikelihood = likelihoods[bestTrial];
+    dists = std::move(trialDists[bestTrial]);
+    weights = std::move(trialWeights[bestTrial]);
   }
 
   // Report final log-likelihood and return it.
@@ -128,57 +163,44 @@ double GMM::Train(const arma::mat& observations,
     if (trials == 0)
       return -DBL_MAX; // It's what they asked for...
 
-    // If each trial must start from the same initial location, we must save it.
-    std::vector<distribution::GaussianDistribution> distsOrig;
-    arma::vec weightsOrig;
-    if (useExistingModel)
+    // As in the other overload, the trials are run in parallel if their
+    // initial models can be computed beforehand.
+    const bool fromInitialModel = useExistingModel ||
+        HasInitialClustering<FittingType>::value;
+    std::vector<std::vector<distribution::GaussianDistribution>> trialDists(
+        trials, dists);
+    std::vector<arma::vec> trialWeights(trials, weights);
+    if (!useExistingModel)
     {
-      distsOrig = dists;
-      weightsOrig = weights;
-    }
-
-    // We need to keep temporary copies.  We'll do the first training into the
-    // actual model position, so that if it's the best we don't need to copy it.
-    fitter.Estimate(observations, probabilities, dists, weights,
-        useExistingModel);
-
-    bestLikelihood = LogLikelihood(observations, dists, weights);
-
-    Log::Debug << "GMM::Train(): Log-likelihood of trial 0 is "
-        << bestLikelihood << "." << std::endl;
-
-    // Now the temporary model.
-    std::vector<distribution::GaussianDistribution> distsTrial(gaussians,
-        distribution::GaussianDistribution(dimensionality));
-    arma::vec weightsTrial(gaussians);
-
-    for (size_t trial = 1; trial < trials; ++trial)
-    {
-      if (useExistingModel)
+      for (size_t trial = 0; trial < trials; ++trial)
       {
-        distsTrial = distsOrig;
-        weightsTrial = weightsOrig;
+        TrialInitialModel(fitter, observations, trialDists[trial],
+            trialWeights[trial]);
       }
+    }
 
-      fitter.Estimate(observations, probabilities, distsTrial, weightsTrial,
-          useExistingModel);
-
-      // Check to see if the log-likelihood of this one is better.
-      double newLikelihood = LogLikelihood(observations, distsTrial,
-          weightsTrial);
+    arma::vec likelihoods(trials);
+    #pragma omp parallel for schedule(dynamic) if (fromInitialModel)
+    for (omp_size_t trial = 0; trial < (omp_size_t) trials; ++trial)
+    {
+      FittingType trialFitter(fitter);
+      trialFitter.Estimate(observations, probabilities, trialDists[trial],
+          trialWeights[trial], fromInitialModel);
+      likelihoods[trial] = LogLikelihood(observations, trialDists[trial],
+          trialWeights[trial]);
+    }
 
+    for (size_t trial = 0; trial < trials; ++trial)
+    {
       Log::Debug << "GMM::Train(): Log-likelihood of trial " << trial << " is "
-          << newLikelihood << "." << std::endl;
-
-      if (newLikelihood > bestLikelihood)
-      {
-        // Save new likelihood and copy new model.
-        bestLikelihood = newLikelihood;
-
-        dists = distsTrial;
-        weights = weightsTrial;
-      }
+          << likelihoods[trial] << "." << std::endl;
     }
+
+    // Keep the model with the greatest log-likelihood.
+    const size_t bestTrial = likelihoods.index_max();
+    bestLikelihood = likelihoods[bestTrial];
+    dists = std::move(trialDists[bestTrial]);
+    weights = std::move(trialWeights[bestTrial]);
   }
 
   // Report final log-likelihood and return it.
@@ -187,6 +209,24 @@ double GMM::Train(const arma::mat& observations,
   return bestLikelihood;
 }
 
+/**
+ * Update the GMM with one batch of observations.
+ */
+template<typename FittingType>
+double GMM::Update(const arma::mat& observations, FittingType& fitter)
+{
+  if (observations.n_rows != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "GMM::Update(): dimensionality of observations ("
+        << observations.n_rows << ") does not match the dimensionality of "
+        << "the model (" << dimensionality << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  return fitter.Step(observations, dists, weights);
+}
+
 /**
  * Serialize the object.
  */
@@ -0,0 +1,283 @@
+/**
+ * @file methods/gmm/stepwise_em_fit.hpp
+ *
+ * Utility class to fit a GMM with stepwise (online) EM, one mini-batch of
+ * observations at a time.  It can be used by GMM::Train() and
+ * DiagonalGMM::Train() like EMFit, or by GMM::Update() and
+ * DiagonalGMM::Update() to fit a model to a stream of batches.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_STEPWISE_EM_FIT_HPP
+#define MLPACK_METHODS_GMM_STEPWISE_EM_FIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/dists/gaussian_distribution.hpp>
+#include <mlpack/core/dists/diagonal_gaussian_distribution.hpp>
+
+// The initial clustering is done like EMFit does it.
+#include "em_fit.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * This class fits a GMM with the stepwise EM algorithm: the model is updated
+ * after each mini-batch of observations, instead of after a pass over all of
+ * them.  The algorithm keeps running averages of the sufficient statistics of
+ * each component (its weight, and the weighted first and second moments of the
+ * points).  For each batch, the responsibilities of the components are
+ * computed under the current model, the statistics of the batch are blended
+ * into the running averages with a decaying step size
+ *
+ *   eta_t = (t + 2)^(-stepSizeExponent),
+ *
+ * where t is the number of batches seen so far, and the model is set from the
+ * running averages.  The running averages start from the model itself, so the
+ * model should already be initialized before the first batch.
+ *
+ * Only one batch needs to be in memory at once, so Step() (or GMM::Update())
+ * can fit a model to data that does not fit in memory, read one chunk at a
+ * time, and can keep refreshing a model as new data arrives.  Estimate() runs
+ * the same algorithm over shuffled mini-batches of a dataset in memory, so that
+ * this class can also be used as the FittingType of GMM::Train().
+ *
+ * For more information, see the following paper:
+ *
+ * @code
+ * @inproceedings{liang2009online,
+ *   title={Online EM for unsupervised models},
+ *   author={Liang, Percy and Klein, Dan},
+ *   booktitle={Proceedings of Human Language Technologies: The 2009 Annual
+ *       Conference of the North American Chapter of the Association for
+ *       Computational Linguistics},
+ *   pages={611--619},
+ *   year={2009}
+ * }
+ * @endcode
+ *
+ * @code
+ * extern arma::mat firstChunk;
+ * GMM gmm(10, firstChunk.n_rows);
+ * gmm.Train(firstChunk);
+ *
+ * StepwiseEMFit<> fitter;
+ * arma::mat chunk;
+ * while (ReadNextChunk(chunk)) // However the data arrives.
+ *   gmm.Update(chunk, fitter);
+ * @endcode
+ *
+ * @tparam InitialClusteringType Clustering algorithm used by Estimate() to
+ *     compute the initial model.
+ * @tparam CovarianceConstraintPolicy Constraint applied to each covariance.
+ * @tparam Distribution Type of the components (GaussianDistribution or
+ *     DiagonalGaussianDistribution).
+ */
+template<typename InitialClusteringType = kmeans::KMeans<>,
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint,
+         typename Distribution = distribution::GaussianDistribution>
+class StepwiseEMFit
+{
+ public:
+  /**
+   * Construct the StepwiseEMFit object.  Setting the maximum number of
+   * iterations to 0 means that Estimate() will make passes over the data until
+   * the average log-likelihood of the points changes by less than the
+   * tolerance between two passes.
+   *
+   * @param batchSize Number of points in each mini-batch of Estimate().
+   * @param stepSizeExponent Exponent of the decay of the step size; it should
+   *     be in (0.5, 1].  Smaller values forget the older batches faster.
+   * @param maxIterations Maximum number of passes over the data made by
+   *     Estimate().
+   * @param tolerance Change of the average log-likelihood of the points
+   *     between two passes required for convergence in Estimate().
+   * @param clusterer Object which will perform the initial clustering.
+   * @param constraint Constraint policy of covariance.
+   */
+  StepwiseEMFit(const size_t batchSize = 1000,
+                const double stepSizeExponent = 0.6,
+                const size_t maxIterations = 10,
+                const double tolerance = 1e-5,
+                InitialClusteringType clusterer = InitialClusteringType(),
+                CovarianceConstraintPolicy constraint =
+                    CovarianceConstraintPolicy());
+
+  /**
+   * Fit the observations to a GMM with stepwise EM, making passes over
+   * shuffled mini-batches of the observations.  The size of the vectors
+   * (indicating the number of components) must already be set.  If
+   * useInitialModel is false, the initial model is computed with
+   * InitialClustering().  The running statistics are reset first.
+   *
+   * @param observations List of observations to train on.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used for the initial
+   *      clustering.
+   */
+  void Estimate(const arma::mat& observations,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Fit the observations to a GMM with stepwise EM, taking into account the
+   * probabilities of each point being from this mixture.  See the other
+   * overload of Estimate() for details.
+   *
+   * @param observations List of observations to train on.
+   * @param probabilities Probability of each point being from this model.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used for the initial
+   *      clustering.
+   */
+  void Estimate(const arma::mat& observations,
+                const arma::vec& probabilities,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Update the model with one batch of observations.  If this is the first
+   * step since the object was created (or since Reset()), the running
+   * statistics are taken from the given model.
+   *
+   * @param observations Batch of observations.
+   * @param dists Distributions of the model, which will be updated.
+   * @param weights A priori weights of the model, which will be updated.
+   * @return The log-likelihood of the batch under the model before the update.
+   */
+  double Step(const arma::mat& observations,
+              std::vector<Distribution>& dists,
+              arma::vec& weights);
+
+  /**
+   * Update the model with one batch of observations, each of which has the
+   * given probability of being from this mixture.
+   *
+   * @param observations Batch of observations.
+   * @param probabilities Probability of each point being from this model.
+   * @param dists Distributions of the model, which will be updated.
+   * @param weights A priori weights of the model, which will be updated.
+   * @return The log-likelihood of the batch under the model before the update.
+   */
+  double Step(const arma::mat& observations,
+              const arma::vec& probabilities,
+              std::vector<Distribution>& dists,
+              arma::vec& weights);
+
+  /**
+   * Run the clusterer, and then turn the cluster assignments into Gaussians,
+   * as EMFit does.  The vectors must be already set to the number of clusters.
+   *
+   * @param observations List of observations.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   */
+  void InitialClustering(const arma::mat& observations,
+                         std::vector<Distribution>& dists,
+                         arma::vec& weights);
+
+  //! Forget the running statistics; the next step starts from the model.
+  void Reset() { steps = 0; }
+
+  //! Get the number of steps taken since the running statistics were reset.
+  size_t Steps() const { return steps; }
+
+  //! Get the number of points in each mini-batch of Estimate().
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points in each mini-batch of Estimate().
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the exponent of the decay of the step size.
+  double StepSizeExponent() const { return stepSizeExponent; }
+  //! Modify the exponent of the decay of the step size.
+  double& StepSizeExponent() { return stepSizeExponent; }
+
+  //! Get the maximum number of passes over the data made by Estimate().
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of passes over the data made by Estimate().
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for the convergence of Estimate().
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for the convergence of Estimate().
+  double& Tolerance() { return tolerance; }
+
+  //! Get the clusterer.
+  const InitialClusteringType& Clusterer() const { return clusterer; }
+  //! Modify the clusterer.
+  InitialClusteringType& Clusterer() { return clusterer; }
+
+  //! Get the covariance constraint policy class.
+  const CovarianceConstraintPolicy& Constraint() const { return constraint; }
+  //! Modify the covariance constraint policy class.
+  CovarianceConstraintPolicy& Constraint() { return constraint; }
+
+  /**
+   * Serialize the fitter, including the running statistics, so that a stream
+   * can be resumed later.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! True if the components have diagonal covariances.
+  static const bool isDiagGaussDist = std::is_same<Distribution,
+      distribution::DiagonalGaussianDistribution>::value;
+
+  //! The type of a covariance (or of the second moment of a component).
+  typedef typename std::conditional<isDiagGaussDist, arma::vec,
+      arma::mat>::type CovarianceType;
+
+  /**
+   * Set the running statistics from the given model.
+   */
+  void InitializeStatistics(const std::vector<Distribution>& dists,
+                            const arma::vec& weights);
+
+  /**
+   * Make passes over shuffled mini-batches of the observations until
+   * convergence.
+   */
+  void StepwiseEstimate(const arma::mat& observations,
+                        const arma::vec& probabilities,
+                        std::vector<Distribution>& dists,
+                        arma::vec& weights);
+
+  //! Number of points in each mini-batch of Estimate().
+  size_t batchSize;
+  //! Exponent of the decay of the step size.
+  double stepSizeExponent;
+  //! Maximum number of passes over the data made by Estimate().
+  size_t maxIterations;
+  //! Tolerance for convergence of Estimate().
+  double tolerance;
+  //! Object which will perform the clustering.
+  InitialClusteringType clusterer;
+  //! Object which applies constraints to the covariance matrix.
+  CovarianceConstraintPolicy constraint;
+
+  //! Number of steps taken since the running statistics were reset.
+  size_t steps;
+  //! Running average of the weight of each component.
+  arma::vec counts;
+  //! Running average of the weighted sum of the points of each component (one
+  //! column per component).
+  arma::mat sums;
+  //! Running average of the weighted second moment of each component.
+  std::vector<CovarianceType> squares;
+};
+
+} // namespace gmm
+} // namespace mlpack
+
+// Include implementation.
+#include "stepwise_em_fit_impl.hpp"
+
+#endif
@@ -0,0 +1,297 @@
+/**
+ * @file methods/gmm/stepwise_em_fit_impl.hpp
+ *
+ * Implementation of the stepwise EM algorithm for fitting GMMs.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_STEPWISE_EM_FIT_IMPL_HPP
+#define MLPACK_METHODS_GMM_STEPWISE_EM_FIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "stepwise_em_fit.hpp"
+#include <mlpack/core/math/log_add.hpp>
+
+namespace mlpack {
+namespace gmm {
+
+//! Constructor.
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+StepwiseEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::StepwiseEMFit(const size_t batchSize,
+                                 const double stepSizeExponent,
+                                 const size_t maxIterations,
+                                 const double tolerance,
+                                 InitialClusteringType clusterer,
+                                 CovarianceConstraintPolicy constraint) :
+    batchSize(batchSize),
+    stepSizeExponent(stepSizeExponent),
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    clusterer(clusterer),
+    constraint(constraint),
+    steps(0)
+{
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("StepwiseEMFit::StepwiseEMFit(): the batch "
+        "size must be greater than 0!");
+  }
+
+  if (stepSizeExponent <= 0.5 || stepSizeExponent > 1.0)
+  {
+    std::ostringstream oss;
+    oss << "StepwiseEMFit::StepwiseEMFit(): the step size exponent ("
+        << stepSizeExponent << ") must be in (0.5, 1]!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void StepwiseEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Estimate(const arma::mat& observations,
+                            std::vector<Distribution>& dists,
+                            arma::vec& weights,
+                            const bool useInitialModel)
+{
+  if (!useInitialModel)
+    InitialClustering(observations, dists, weights);
+
+  StepwiseEstimate(observations, arma::ones<arma::vec>(observations.n_cols),
+      dists, weights);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void StepwiseEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Estimate(const arma::mat& observations,
+                            const arma::vec& probabilities,
+                            std::vector<Distribution>& dists,
+                            arma::vec& weights,
+                            const bool useInitialModel)
+{
+  if (!useInitialModel)
+    InitialClustering(observations, dists, weights);
+
+  StepwiseEstimate(observations, probabilities, dists, weights);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+double StepwiseEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Step(const arma::mat& observations,
+                        std::vector<Distribution>& dists,
+                        arma::vec& weights)
+{
+  return Step(observations, arma::ones<arma::vec>(observations.n_cols), dists,
+      weights);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+double StepwiseEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Step(const arma::mat& observations,
+                        const arma::vec& probabilities,
+                        std::vector<Distribution>& dists,
+                        arma::vec& weights)
+{
+  if (observations.n_cols != probabilities.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "StepwiseEMFit::Step(): number of probabilities ("
+        << probabilities.n_elem << ") does not match the number of points ("
+        << observations.n_cols << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  const double totalProbability = arma::accu(probabilities);
+  if (totalProbability <= 0.0)
+    return 0.0; // Nothing to learn from this batch.
+
+  if (steps == 0)
+    InitializeStatistics(dists, weights);
+
+  // The E-step: calculate the conditional probabilities of choosing each
+  // Gaussian given the observations, under the current model.
+  arma::mat condLogProb(observations.n_cols, dists.size());
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
+    dists[i].LogProbability(observations, condLogProbAlias);
+    condLogProbAlias += std::log(weights[i]);
+  }
+
+  // Normalize row-wise, summing the log-likelihood of the batch.
+  double logLikelihood = 0.0;
+  for (size_t i = 0; i < condLogProb.n_rows; ++i)
+  {
+    // Avoid dividing by zero; if the probability for everything is 0, we
+    // don't want to make it NaN.
+    const double probSum = mlpack::math::AccuLog(condLogProb.row(i));
+    if (probSum != -std::numeric_limits<double>::infinity())
+      condLogProb.row(i) -= probSum;
+
+    logLikelihood += probSum;
+  }
+
+  // The statistics of the batch, averaged over its points.
+  arma::mat responsibilities = arma::exp(condLogProb);
+  responsibilities.each_col() %= probabilities / totalProbability;
+
+  const arma::vec batchCounts = arma::trans(arma::sum(responsibilities, 0));
+  const arma::mat batchSums = observations * responsibilities;
+  const arma::mat batchDiagSquares = isDiagGaussDist ?
+      arma::mat(arma::square(observations) * responsibilities) : arma::mat();
+
+  // Blend them into the running averages.
+  const double stepSize = std::pow(steps + 2.0, -stepSizeExponent);
+  counts = (1.0 - stepSize) * counts + stepSize * batchCounts;
+  sums = (1.0 - stepSize) * sums + stepSize * batchSums;
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    squares[i] *= (1.0 - stepSize);
+    if (isDiagGaussDist)
+    {
+      squares[i] += stepSize * batchDiagSquares.col(i);
+    }
+    else
+    {
+      squares[i] += stepSize * (observations.each_row() %
+          arma::trans(responsibilities.col(i))) * observations.t();
+    }
+  }
+  ++steps;
+
+  // The M-step: set the model from the running averages.
+  weights = counts / arma::accu(counts);
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    // Don't update if there's no probability of the Gaussian having points.
+    if (counts[i] <= 0.0)
+      continue;
+
+    arma::vec mean = sums.col(i) / counts[i];
+    CovarianceType covariance = squares[i] / counts[i];
+    if (isDiagGaussDist)
+      covariance -= arma::square(mean);
+    else
+      covariance -= mean * mean.t();
+
+    // Apply covariance constraint.
+    constraint.ApplyConstraint(covariance);
+    dists[i].Mean() = std::move(mean);
+    dists[i].Covariance(std::move(covariance));
+  }
+
+  return logLikelihood;
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void StepwiseEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::InitialClustering(const arma::mat& observations,
+                                     std::vector<Distribution>& dists,
+                                     arma::vec& weights)
+{
+  EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>
+      emFit(maxIterations, tolerance, clusterer, constraint);
+  emFit.InitialClustering(observations, dists, weights);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void StepwiseEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::InitializeStatistics(const std::vector<Distribution>& dists,
+                                        const arma::vec& weights)
+{
+  // The running averages are those of an infinite sample from the model.
+  counts = weights;
+  sums.set_size(dists[0].Mean().n_elem, dists.size());
+  squares.resize(dists.size());
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    const arma::vec& mean = dists[i].Mean();
+    sums.col(i) = weights[i] * mean;
+    if (isDiagGaussDist)
+      squares[i] = weights[i] * (dists[i].Covariance() + arma::square(mean));
+    else
+      squares[i] = weights[i] * (dists[i].Covariance() + mean * mean.t());
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void StepwiseEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::StepwiseEstimate(const arma::mat& observations,
+                                    const arma::vec& probabilities,
+                                    std::vector<Distribution>& dists,
+                                    arma::vec& weights)
+{
+  Reset();
+
+  const size_t numPoints = observations.n_cols;
+  double l = -DBL_MAX;
+  double lOld = -DBL_MAX;
+
+  // Make passes over the data until no more improvement is found.
+  size_t iteration = 0;
+  do
+  {
+    lOld = l;
+    l = 0.0;
+
+    // Visit the points in a different order in each pass, so that each batch
+    // is a random sample of the data.
+    const arma::uvec ordering = arma::shuffle(
+        arma::linspace<arma::uvec>(0, numPoints - 1, numPoints));
+    for (size_t begin = 0; begin < numPoints; begin += batchSize)
+    {
+      const size_t end = std::min(begin + batchSize, numPoints) - 1;
+      const arma::uvec batch = ordering.subvec(begin, end);
+      l += Step(observations.cols(batch), probabilities.elem(batch), dists,
+          weights);
+    }
+    l /= numPoints;
+
+    ++iteration;
+    Log::Info << "StepwiseEMFit::Estimate(): pass " << iteration << ", "
+        << "average log-likelihood " << l << "." << std::endl;
+  } while (std::abs(l - lOld) > tolerance && iteration != maxIterations);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+template<typename Archive>
+void StepwiseEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(batchSize));
+  ar(CEREAL_NVP(stepSizeExponent));
+  ar(CEREAL_NVP(maxIterations));
+  ar(CEREAL_NVP(tolerance));
+  ar(CEREAL_NVP(clusterer));
+  ar(CEREAL_NVP(constraint));
+  ar(CEREAL_NVP(steps));
+  ar(CEREAL_NVP(counts));
+  ar(CEREAL_NVP(sums));
+  ar(CEREAL_NVP(squares));
+}
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,114 @@
+/**
+ * @file methods/gradient_boosting/cross_entropy_loss.hpp
+ *
+ * The cross-entropy loss of the softmax of the scores, for gradient boosting
+ * classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_CROSS_ENTROPY_LOSS_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_CROSS_ENTROPY_LOSS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The cross-entropy loss for classification with GradientBoosting.  The model
+ * has one output (score) for each class, and the probability of each class is
+ * the softmax of the scores of the point; the loss of a point is the negative
+ * log-probability of its class.  The responses are the class labels.
+ */
+class CrossEntropyLoss
+{
+ public:
+  //! This loss is for classification.
+  static const bool IsClassification = true;
+
+  //! Return the number of outputs of the model, one for each class.
+  static size_t NumOutputs(const size_t numClasses) { return numClasses; }
+
+  /**
+   * Compute the scores that minimize the loss before any trees are added;
+   * these are the logarithms of the frequencies of the classes.
+   *
+   * @param responses Label of each training point.
+   * @param numClasses Number of classes.
+   * @param scores Output initial score of each class.
+   */
+  static void InitialScores(const arma::rowvec& responses,
+                            const size_t numClasses,
+                            arma::vec& scores)
+  {
+    scores.zeros(numClasses);
+    for (size_t i = 0; i < responses.n_elem; ++i)
+      scores[(size_t) responses[i]]++;
+
+    // Avoid the logarithm of zero for classes that don't appear.
+    scores = arma::log(arma::clamp(scores / responses.n_elem, 1e-15, 1.0));
+  }
+
+  /**
+   * Compute the gradients and the (diagonal) hessians of the loss with respect
+   * to the score of each class of each point.
+   *
+   * @param responses Label of each training point.
+   * @param scores Current scores of each class (rows) of each point (columns).
+   * @param gradients Output gradients, p - 1 for the class of the point and p
+   *     for the other classes, for the probability p of each class.
+   * @param hessians Output hessians, p (1 - p).
+   */
+  static void Gradients(const arma::rowvec& responses,
+                        const arma::mat& scores,
+                        arma::mat& gradients,
+                        arma::mat& hessians)
+  {
+    Probabilities(scores, gradients);
+    hessians = arma::clamp(gradients % (1.0 - gradients), 1e-16, 1.0);
+    for (size_t i = 0; i < responses.n_elem; ++i)
+      gradients((size_t) responses[i], i) -= 1.0;
+  }
+
+  /**
+   * Return the mean cross-entropy of the given scores.
+   *
+   * @param responses Label of each training point.
+   * @param scores Scores of each class (rows) of each point (columns).
+   */
+  static double Evaluate(const arma::rowvec& responses, const arma::mat& scores)
+  {
+    arma::mat probabilities;
+    Probabilities(scores, probabilities);
+
+    double loss = 0.0;
+    for (size_t i = 0; i < responses.n_elem; ++i)
+      loss -= std::log(std::max(probabilities((size_t) responses[i], i),
+          1e-15));
+
+    return loss / responses.n_elem;
+  }
+
+  /**
+   * Compute the probability of each class of each point, the softmax of the
+   * scores of the point.
+   *
+   * @param scores Scores of each class (rows) of each point (columns).
+   * @param probabilities Output probabilities of each class of each point.
+   */
+  static void Probabilities(const arma::mat& scores,
+                            arma::mat& probabilities)
+  {
+    // Subtract the largest score of each point to avoid overflow.
+    probabilities = arma::exp(scores.each_row() - arma::max(scores, 0));
+    probabilities.each_row() /= arma::sum(probabilities, 0);
+  }
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,323 @@
+/**
+ * @file methods/gradient_boosting/gradient_boosting.hpp
+ *
+ * Definition of the GradientBoosting class, which implements gradient-boosted
+ * decision trees for regression and classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/decision_tree/all_dimension_select.hpp>
+#include <mlpack/methods/decision_tree/multiple_random_dimension_select.hpp>
+#include <mlpack/methods/decision_tree/quantile_bin_thresholds.hpp>
+#include "gradient_boosting_tree.hpp"
+#include "squared_error_loss.hpp"
+#include "cross_entropy_loss.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The GradientBoosting class implements gradient-boosted decision trees.  The
+ * model starts from the constant scores that minimize the loss, and in each
+ * iteration a GradientBoostingTree is fit to the gradients and hessians of the
+ * loss of the current scores of the training points and added to the model,
+ * scaled by the learning rate.  For classification, one tree per class is
+ * added in each iteration.  GradientBoostingTree is a regression tree of its
+ * own; it is not built on DecisionTree, which only fits class labels.
+ *
+ * The loss is given by the LossType:
+ *
+ *  - SquaredErrorLoss, for regression; train with real-valued responses and
+ *    use Predict();
+ *  - CrossEntropyLoss, for classification; train with labels and use
+ *    Classify().
+ *
+ * Before training, each dimension of the dataset is divided into at most
+ * GradientBoostingTree::MaxBins bins at quantiles of its values, and the
+ * splits of all the trees are found with histograms of the bins, so the time
+ * to build a tree is linear in the number of points.  The histograms are built
+ * in parallel if OpenMP is available.  The trees split on the values
+ * themselves, so no binning is needed for prediction.
+ *
+ * @code
+ * // Regression.
+ * GradientBoosting<> gb(data, responses, 200);
+ * arma::rowvec predictions;
+ * gb.Predict(testData, predictions);
+ *
+ * // Classification.
+ * GradientBoosting<CrossEntropyLoss> gbc(data, labels, numClasses, 200);
+ * arma::Row<size_t> predictedLabels;
+ * gbc.Classify(testData, predictedLabels);
+ * @endcode
+ *
+ * Only numeric dimensions are supported.
+ *
+ * @tparam LossType Loss function to minimize.
+ * @tparam DimensionSelectionType Class for selecting dimensions to split on,
+ *     as for DecisionTree.
+ */
+template<typename LossType = SquaredErrorLoss,
+         typename DimensionSelectionType = AllDimensionSelect>
+class GradientBoosting
+{
+ public:
+  //! Allow access to the type of the trees.
+  typedef GradientBoostingTree<DimensionSelectionType> TreeType;
+
+  /**
+   * Construct the model without training it.  Predict() and Classify() will
+   * throw an exception until Train() is called.
+   */
+  GradientBoosting() : numClasses(0) { }
+
+  /**
+   * Create a regression model, training on the given data and responses.
+   *
+   * @param dataset Dataset to train on.
+   * @param responses Responses for each point of the dataset.
+   * @param numIterations Number of boosting iterations (trees).
+   * @param learningRate Factor that the predictions of each tree are scaled
+   *     by.
+   * @param maximumDepth Maximum depth of each tree (0 means no limit).
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param lambda L2 regularization of the values of the leaves.
+   * @param minimumGainSplit Minimum gain for splitting a node.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   */
+  template<typename MatType>
+  GradientBoosting(const MatType& dataset,
+                   const arma::rowvec& responses,
+                   const size_t numIterations = 100,
+                   const double learningRate = 0.1,
+                   const size_t maximumDepth = 6,
+                   const size_t minimumLeafSize = 1,
+                   const double lambda = 1.0,
+                   const double minimumGainSplit = 0.0,
+                   DimensionSelectionType dimensionSelector =
+                       DimensionSelectionType());
+
+  /**
+   * Create a classification model, training on the given data and labels.
+   *
+   * @param dataset Dataset to train on.
+   * @param labels Labels for each point of the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param numIterations Number of boosting iterations; one tree per class is
+   *     trained in each iteration.
+   * @param learningRate Factor that the predictions of each tree are scaled
+   *     by.
+   * @param maximumDepth Maximum depth of each tree (0 means no limit).
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param lambda L2 regularization of the values of the leaves.
+   * @param minimumGainSplit Minimum gain for splitting a node.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   */
+  template<typename MatType>
+  GradientBoosting(const MatType& dataset,
+                   const arma::Row<size_t>& labels,
+                   const size_t numClasses,
+                   const size_t numIterations = 100,
+                   const double learningRate = 0.1,
+                   const size_t maximumDepth = 6,
+                   const size_t minimumLeafSize = 1,
+                   const double lambda = 1.0,
+                   const double minimumGainSplit = 0.0,
+                   DimensionSelectionType dimensionSelector =
+                       DimensionSelectionType());
+
+  /**
+   * Train a regression model on the given data and responses.  Any existing
+   * trees are discarded.
+   *
+   * @param dataset Dataset to train on.
+   * @param responses Responses for each point of the dataset.
+   * @param numIterations Number of boosting iterations (trees).
+   * @param learningRate Factor that the predictions of each tree are scaled
+   *     by.
+   * @param maximumDepth Maximum depth of each tree (0 means no limit).
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param lambda L2 regularization of the values of the leaves.
+   * @param minimumGainSplit Minimum gain for splitting a node.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @return The loss of the model on the training set.
+   */
+  template<typename MatType>
+  double Train(const MatType& dataset,
+               const arma::rowvec& responses,
+               const size_t numIterations = 100,
+               const double learningRate = 0.1,
+               const size_t maximumDepth = 6,
+               const size_t minimumLeafSize = 1,
+               const double lambda = 1.0,
+               const double minimumGainSplit = 0.0,
+               DimensionSelectionType dimensionSelector =
+                   DimensionSelectionType());
+
+  /**
+   * Train a classification model on the given data and labels.  Any existing
+   * trees are discarded.
+   *
+   * @param dataset Dataset to train on.
+   * @param labels Labels for each point of the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param numIterations Number of boosting iterations; one tree per class is
+   *     trained in each iteration.
+   * @param learningRate Factor that the predictions of each tree are scaled
+   *     by.
+   * @param maximumDepth Maximum depth of each tree (0 means no limit).
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param lambda L2 regularization of the values of the leaves.
+   * @param minimumGainSplit Minimum gain for splitting a node.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @return The loss of the model on the training set.
+   */
+  template<typename MatType>
+  double Train(const MatType& dataset,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const size_t numIterations = 100,
+               const double learningRate = 0.1,
+               const size_t maximumDepth = 6,
+               const size_t minimumLeafSize = 1,
+               const double lambda = 1.0,
+               const double minimumGainSplit = 0.0,
+               DimensionSelectionType dimensionSelector =
+                   DimensionSelectionType());
+
+  /**
+   * Predict the response of the given point with a regression model.
+   *
+   * @param point Point to predict.
+   */
+  template<typename VecType>
+  double Predict(const VecType& point) const;
+
+  /**
+   * Predict the responses of each point in the given dataset with a regression
+   * model.
+   *
+   * @param data Dataset to predict.
+   * @param predictions Output predictions for each point in the dataset.
+   */
+  template<typename MatType>
+  void Predict(const MatType& data, arma::rowvec& predictions) const;
+
+  /**
+   * Predict the class of the given point with a classification model.
+   *
+   * @param point Point to be classified.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Predict the class of the given point with a classification model, and
+   * return the predicted probabilities of each class.
+   *
+   * @param point Point to be classified.
+   * @param prediction size_t to store predicted class in.
+   * @param probabilities Output vector of class probabilities.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                arma::vec& probabilities) const;
+
+  /**
+   * Predict the classes of each point in the given dataset with a
+   * classification model.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the classes of each point in the given dataset with a
+   * classification model, also returning the predicted class probabilities for
+   * each point.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   * @param probabilities Output matrix of class probabilities for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of trees; for classification, there is one tree for each
+  //! class in each iteration.
+  size_t NumTrees() const { return trees.size(); }
+  //! Get the number of classes (0 for regression models).
+  size_t NumClasses() const { return numClasses; }
+
+  //! Access a tree.
+  const TreeType& Tree(const size_t i) const { return trees[i]; }
+  //! Modify a tree (be careful!).
+  TreeType& Tree(const size_t i) { return trees[i]; }
+
+  //! Get the initial scores of the model.
+  const arma::vec& InitialScores() const { return initialScores; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  /**
+   * Train the model on the given responses (the labels, for classification).
+   */
+  template<typename MatType>
+  double Train(const MatType& dataset,
+               const arma::rowvec& responses,
+               const size_t numClasses,
+               const size_t numIterations,
+               const double learningRate,
+               const size_t maximumDepth,
+               const size_t minimumLeafSize,
+               const double lambda,
+               const double minimumGainSplit,
+               DimensionSelectionType& dimensionSelector);
+
+  /**
+   * Divide each dimension of the dataset into at most TreeType::MaxBins bins at
+   * quantiles of its values with QuantileBinThresholds(), and return the bin of
+   * each point (rows) in each dimension (columns) and the thresholds between
+   * the bins.
+   */
+  template<typename MatType>
+  static void BinData(const MatType& dataset,
+                      arma::Mat<unsigned char>& bins,
+                      std::vector<arma::vec>& binThresholds);
+
+  //! Compute the scores of each output for the given point.
+  template<typename VecType>
+  void Scores(const VecType& point, arma::vec& scores) const;
+
+  //! The trees, in the order they were trained.  Tree i adds to the score of
+  //! output i % initialScores.n_elem.
+  std::vector<TreeType> trees;
+  //! The initial score of each output.
+  arma::vec initialScores;
+  //! The number of classes, or 0 for regression.
+  size_t numClasses;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "gradient_boosting_impl.hpp"
+
+#endif
@@ -0,0 +1,375 @@
+/**
+ * @file methods/gradient_boosting/gradient_boosting_impl.hpp
+ *
+ * Implementation of the GradientBoosting class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_IMPL_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "gradient_boosting.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename LossType, typename DimensionSelectionType>
+template<typename MatType>
+GradientBoosting<LossType, DimensionSelectionType>::GradientBoosting(
+    const MatType& dataset,
+    const arma::rowvec& responses,
+    const size_t numIterations,
+    const double learningRate,
+    const size_t maximumDepth,
+    const size_t minimumLeafSize,
+    const double lambda,
+    const double minimumGainSplit,
+    DimensionSelectionType dimensionSelector) :
+    numClasses(0)
+{
+  // Pass off work to the Train() method.
+  Train(dataset, responses, numIterations, learningRate, maximumDepth,
+      minimumLeafSize, lambda, minimumGainSplit, dimensionSelector);
+}
+
+template<typename LossType, typename DimensionSelectionType>
+template<typename MatType>
+GradientBoosting<LossType, DimensionSelectionType>::GradientBoosting(
+    const MatType& dataset,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t numIterations,
+    const double learningRate,
+    const size_t maximumDepth,
+    const size_t minimumLeafSize,
+    const double lambda,
+    const double minimumGainSplit,
+    DimensionSelectionType dimensionSelector) :
+    numClasses(0)
+{
+  // Pass off work to the Train() method.
+  Train(dataset, labels, numClasses, numIterations, learningRate, maximumDepth,
+      minimumLeafSize, lambda, minimumGainSplit, dimensionSelector);
+}
+
+template<typename LossType, typename DimensionSelectionType>
+template<typename MatType>
+double GradientBoosting<LossType, DimensionSelectionType>::Train(
+    const MatType& dataset,
+    const arma::rowvec& responses,
+    const size_t numIterations,
+    const double learningRate,
+    const size_t maximumDepth,
+    const size_t minimumLeafSize,
+    const double lambda,
+    const double minimumGainSplit,
+    DimensionSelectionType dimensionSelector)
+{
+  static_assert(!LossType::IsClassification, "GradientBoosting::Train(): "
+      "a classification loss must be trained with labels!");
+
+  return Train(dataset, responses, 0, numIterations, learningRate,
+      maximumDepth, minimumLeafSize, lambda, minimumGainSplit,
+      dimensionSelector);
+}
+
+template<typename LossType, typename DimensionSelectionType>
+template<typename MatType>
+double GradientBoosting<LossType, DimensionSelectionType>::Train(
+    const MatType& dataset,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t numIterations,
+    const double learningRate,
+    const size_t maximumDepth,
+    const size_t minimumLeafSize,
+    const double lambda,
+    const double minimumGainSplit,
+    DimensionSelectionType dimensionSelector)
+{
+  static_assert(LossType::IsClassification, "GradientBoosting::Train(): "
+      "a regression loss must be trained with responses!");
+
+  if (numClasses < 2)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): there must be at "
+        "least two classes!");
+  }
+  else if (labels.n_elem > 0 && arma::max(labels) >= numClasses)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): labels must be "
+        "less than the number of classes!");
+  }
+
+  return Train(dataset, arma::conv_to<arma::rowvec>::from(labels), numClasses,
+      numIterations, learningRate, maximumDepth, minimumLeafSize, lambda,
+      minimumGainSplit, dimensionSelector);
+}
+
+template<typename LossType, typename DimensionSelectionType>
+template<typename VecType>
+double GradientBoosting<LossType, DimensionSelectionType>::Predict(
+    const VecType& point) const
+{
+  static_assert(!LossType::IsClassification, "GradientBoosting::Predict(): "
+      "use Classify() with a classification loss!");
+
+  if (trees.size() == 0)
+  {
+    throw std::invalid_argument("GradientBoosting::Predict(): no model "
+        "trained!");
+  }
+
+  arma::vec scores;
+  Scores(point, scores);
+  return scores[0];
+}
+
+template<typename LossType, typename DimensionSelectionType>
+template<typename MatType>
+void GradientBoosting<LossType, DimensionSelectionType>::Predict(
+    const MatType& data,
+    arma::rowvec& predictions) const
+{
+  static_assert(!LossType::IsClassification, "GradientBoosting::Predict(): "
+      "use Classify() with a classification loss!");
+
+  if (trees.size() == 0)
+  {
+    predictions.clear();
+    throw std::invalid_argument("GradientBoosting::Predict(): no model "
+        "trained!");
+  }
+
+  predictions.set_size(data.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    arma::vec scores;
+    Scores(data.col(i), scores);
+    predictions[i] = scores[0];
+  }
+}
+
+template<typename LossType, typename DimensionSelectionType>
+template<typename VecType>
+size_t GradientBoosting<LossType, DimensionSelectionType>::Classify(
+    const VecType& point) const
+{
+  // Pass off to another Classify() overload.
+  size_t prediction;
+  arma::vec probabilities;
+  Classify(point, prediction, probabilities);
+
+  return prediction;
+}
+
+template<typename LossType, typename DimensionSelectionType>
+template<typename VecType>
+void GradientBoosting<LossType, DimensionSelectionType>::Classify(
+    const VecType& point,
+    size_t& prediction,
+    arma::vec& probabilities) const
+{
+  static_assert(LossType::IsClassification, "GradientBoosting::Classify(): "
+      "use Predict() with a regression loss!");
+
+  if (trees.size() == 0)
+  {
+    probabilities.clear();
+    prediction = 0;
+
+    throw std::invalid_argument("GradientBoosting::Classify(): no model "
+        "trained!");
+  }
+
+  arma::vec scores;
+  Scores(point, scores);
+
+  arma::mat pointProbabilities;
+  LossType::Probabilities(scores, pointProbabilities);
+  probabilities = pointProbabilities.col(0);
+  prediction = probabilities.index_max();
+}
+
+template<typename LossType, typename DimensionSelectionType>
+template<typename MatType>
+void GradientBoosting<LossType, DimensionSelectionType>::Classify(
+    const MatType& data,
+    arma::Row<size_t>& predictions) const
+{
+  // The probabilities are needed to find the predictions anyway.
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename LossType, typename DimensionSelectionType>
+template<typename MatType>
+void GradientBoosting<LossType, DimensionSelectionType>::Classify(
+    const MatType& data,
+    arma::Row<size_t>& predictions,
+    arma::mat& probabilities) const
+{
+  static_assert(LossType::IsClassification, "GradientBoosting::Classify(): "
+      "use Predict() with a regression loss!");
+
+  if (trees.size() == 0)
+  {
+    predictions.clear();
+    probabilities.clear();
+
+    throw std::invalid_argument("GradientBoosting::Classify(): no model "
+        "trained!");
+  }
+
+  arma::mat scores(initialScores.n_elem, data.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    arma::vec pointScores;
+    Scores(data.col(i), pointScores);
+    scores.col(i) = pointScores;
+  }
+
+  LossType::Probabilities(scores, probabilities);
+  predictions.set_size(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    predictions[i] = probabilities.col(i).index_max();
+}
+
+template<typename LossType, typename DimensionSelectionType>
+template<typename Archive>
+void GradientBoosting<LossType, DimensionSelectionType>::serialize(
+    Archive& ar,
+    const uint32_t /* version */)
+{
+  size_t numTrees;
+  if (cereal::is_loading<Archive>())
+    trees.clear();
+  else
+    numTrees = trees.size();
+
+  ar(CEREAL_NVP(numTrees));
+
+  // Allocate space if needed.
+  if (cereal::is_loading<Archive>())
+    trees.resize(numTrees);
+
+  ar(CEREAL_NVP(trees));
+  ar(CEREAL_NVP(initialScores));
+  ar(CEREAL_NVP(numClasses));
+}
+
+template<typename LossType, typename DimensionSelectionType>
+template<typename MatType>
+double GradientBoosting<LossType, DimensionSelectionType>::Train(
+    const MatType& dataset,
+    const arma::rowvec& responses,
+    const size_t numClasses,
+    const size_t numIterations,
+    const double learningRate,
+    const size_t maximumDepth,
+    const size_t minimumLeafSize,
+    const double lambda,
+    const double minimumGainSplit,
+    DimensionSelectionType& dimensionSelector)
+{
+  if (dataset.n_cols == 0 || dataset.n_rows == 0)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): the dataset must "
+        "not be empty!");
+  }
+  else if (responses.n_elem != dataset.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "GradientBoosting::Train(): number of points (" << dataset.n_cols
+        << ") does not match number of responses (" << responses.n_elem
+        << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  this->numClasses = numClasses;
+  trees.clear();
+
+  // Bin the dataset once; all the trees are built on the bins.
+  arma::Mat<unsigned char> bins;
+  std::vector<arma::vec> binThresholds;
+  BinData(dataset, bins, binThresholds);
+
+  dimensionSelector.Dimensions() = dataset.n_rows;
+
+  // Start from the best constant scores.
+  const size_t numOutputs = LossType::NumOutputs(numClasses);
+  LossType::InitialScores(responses, numClasses, initialScores);
+  arma::mat scores = arma::repmat(initialScores, 1, dataset.n_cols);
+
+  arma::mat gradients, hessians;
+  arma::rowvec predictions;
+  trees.resize(numIterations * numOutputs);
+  for (size_t i = 0; i < numIterations; ++i)
+  {
+    LossType::Gradients(responses, scores, gradients, hessians);
+
+    // Fit one tree to the gradients of each output, and add its predictions
+    // to the scores.
+    for (size_t k = 0; k < numOutputs; ++k)
+    {
+      trees[i * numOutputs + k].Train(bins, binThresholds, gradients.row(k),
+          hessians.row(k), learningRate, maximumDepth, minimumLeafSize, lambda,
+          minimumGainSplit, dimensionSelector, predictions);
+      scores.row(k) += predictions;
+    }
+  }
+
+  return LossType::Evaluate(responses, scores);
+}
+
+template<typename LossType, typename DimensionSelectionType>
+template<typename MatType>
+void GradientBoosting<LossType, DimensionSelectionType>::BinData(
+    const MatType& dataset,
+    arma::Mat<unsigned char>& bins,
+    std::vector<arma::vec>& binThresholds)
+{
+  const size_t maxBins = TreeType::MaxBins;
+  bins.set_size(dataset.n_cols, dataset.n_rows);
+  binThresholds.resize(dataset.n_rows);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t d = 0; d < (omp_size_t) dataset.n_rows; ++d)
+  {
+    // The thresholds are found as for HistogramNumericSplit, but only once.
+    QuantileBinThresholds(dataset.row(d), maxBins, binThresholds[d]);
+    const arma::vec& thresholds = binThresholds[d];
+
+    // The bin of a value is the number of thresholds less than it.
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+    {
+      bins(i, d) = (unsigned char) (std::lower_bound(thresholds.begin(),
+          thresholds.end(), (double) dataset(d, i)) - thresholds.begin());
+    }
+  }
+}
+
+template<typename LossType, typename DimensionSelectionType>
+template<typename VecType>
+void GradientBoosting<LossType, DimensionSelectionType>::Scores(
+    const VecType& point,
+    arma::vec& scores) const
+{
+  // Add the trees in order, as in training.
+  scores = initialScores;
+  for (size_t i = 0; i < trees.size(); ++i)
+    scores[i % scores.n_elem] += trees[i].Predict(point);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,354 @@
+/**
+ * @file methods/gradient_boosting/gradient_boosting_main.cpp
+ *
+ * A program to build and evaluate gradient-boosted decision trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/gradient_boosting/gradient_boosting.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+using namespace mlpack;
+using namespace mlpack::tree;
+using namespace mlpack::util;
+using namespace std;
+
+// Program Name.
+BINDING_NAME("Gradient boosted trees");
+
+// Short description.
+BINDING_SHORT_DESC(
+    "An implementation of gradient-boosted decision trees for regression and "
+    "classification.  Given labeled data or real-valued responses, a model can "
+    "be trained and saved for future use; or, a pre-trained model can be used "
+    "for prediction.");
+
+// Long description.
+BINDING_LONG_DESC(
+    "This program is an implementation of gradient-boosted decision trees "
+    "(GBDT).  Each tree is fit to the gradients and hessians of the loss of "
+    "the model so far, with splits found from histograms of at most 256 bins "
+    "per dimension, and added to the model scaled by the learning rate.  A "
+    "model can be trained and saved for later use, or a model may be loaded "
+    "and predictions generated for points."
+    "\n\n"
+    "The training set is specified with the " + PRINT_PARAM_STRING("training") +
+    " parameter.  For classification, the labels are specified with the " +
+    PRINT_PARAM_STRING("labels") + " parameter, and should be in the range [0, "
+    "num_classes - 1]; the cross-entropy loss is minimized, with one tree per "
+    "class in each iteration.  For regression, the responses are specified "
+    "with the " + PRINT_PARAM_STRING("responses") + " parameter, and the "
+    "squared error is minimized.  Only one of the two may be given."
+    "\n\n"
+    "When a model is trained, the " + PRINT_PARAM_STRING("output_model") + " "
+    "output parameter may be used to save the trained model.  A model may be "
+    "loaded for predictions with the " + PRINT_PARAM_STRING("input_model") +
+    " parameter.  The " + PRINT_PARAM_STRING("input_model") + " parameter may "
+    "not be specified when the " + PRINT_PARAM_STRING("training") + " parameter"
+    " is specified.  The " + PRINT_PARAM_STRING("num_iterations") + " parameter"
+    " controls the number of boosting iterations, and the " +
+    PRINT_PARAM_STRING("learning_rate") + " parameter the factor that each "
+    "tree is scaled by.  The " + PRINT_PARAM_STRING("maximum_depth") + ", " +
+    PRINT_PARAM_STRING("minimum_leaf_size") + ", " +
+    PRINT_PARAM_STRING("lambda") + " (L2 regularization of the leaf values) "
+    "and " + PRINT_PARAM_STRING("minimum_gain_split") + " parameters control "
+    "the size of each tree.  If " + PRINT_PARAM_STRING("print_training_error") +
+    " is specified, the accuracy (for classification) or the mean squared "
+    "error (for regression) on the training set will be printed."
+    "\n\n"
+    "Test data may be specified with the " + PRINT_PARAM_STRING("test") + " "
+    "parameter.  For classification models, the predicted class of each test "
+    "point may be saved with the " + PRINT_PARAM_STRING("predictions") + " "
+    "output parameter and the class probabilities with the " +
+    PRINT_PARAM_STRING("probabilities") + " output parameter, and if " +
+    PRINT_PARAM_STRING("test_labels") + " are given, the accuracy is printed.  "
+    "For regression models, the predicted responses may be saved with the " +
+    PRINT_PARAM_STRING("predicted_responses") + " output parameter, and if " +
+    PRINT_PARAM_STRING("test_responses") + " are given, the mean squared error "
+    "is printed.");
+
+// Example.
+BINDING_EXAMPLE(
+    "For example, to train a classification model with 200 iterations and a "
+    "maximum depth of 4 on the dataset contained in " + PRINT_DATASET("data") +
+    " with labels " + PRINT_DATASET("labels") + ", saving the model to " +
+    PRINT_MODEL("gb_model") + " and printing the training error, one could "
+    "call"
+    "\n\n" +
+    PRINT_CALL("gradient_boosting", "training", "data", "labels", "labels",
+        "num_iterations", 200, "maximum_depth", 4, "output_model", "gb_model",
+        "print_training_error", true) +
+    "\n\n"
+    "Then, to use that model to classify points in " +
+    PRINT_DATASET("test_set") + " and print the test error given the labels " +
+    PRINT_DATASET("test_labels") + ", while saving the predictions for each "
+    "point to " + PRINT_DATASET("predictions") + ", one could call "
+    "\n\n" +
+    PRINT_CALL("gradient_boosting", "input_model", "gb_model", "test",
+        "test_set", "test_labels", "test_labels", "predictions",
+        "predictions"));
+
+// See also...
+BINDING_SEE_ALSO("@random_forest", "#random_forest");
+BINDING_SEE_ALSO("@decision_tree", "#decision_tree");
+BINDING_SEE_ALSO("@adaboost", "#adaboost");
+BINDING_SEE_ALSO("Gradient boosting on Wikipedia",
+        "https://en.wikipedia.org/wiki/Gradient_boosting");
+BINDING_SEE_ALSO("XGBoost: A Scalable Tree Boosting System (pdf)",
+        "https://arxiv.org/pdf/1603.02754.pdf");
+BINDING_SEE_ALSO("mlpack::tree::GradientBoosting C++ class documentation",
+        "@doxygen/classmlpack_1_1tree_1_1GradientBoosting.html");
+
+PARAM_MATRIX_IN("training", "Training dataset.", "t");
+PARAM_UROW_IN("labels", "Labels for training dataset, for classification.",
+    "l");
+PARAM_ROW_IN("responses", "Responses for training dataset, for regression.",
+    "r");
+PARAM_MATRIX_IN("test", "Test dataset to produce predictions for.", "T");
+PARAM_UROW_IN("test_labels", "Test dataset labels, if accuracy calculation is "
+    "desired.", "L");
+PARAM_ROW_IN("test_responses", "Test dataset responses, if error calculation "
+    "is desired.", "R");
+
+PARAM_FLAG("print_training_error", "If set, then the accuracy or the mean "
+    "squared error of the model on the training set will be printed (verbose "
+    "must also be specified).", "a");
+
+PARAM_INT_IN("num_iterations", "Number of boosting iterations.", "N", 100);
+PARAM_DOUBLE_IN("learning_rate", "Factor that the predictions of each tree are "
+    "scaled by.", "e", 0.1);
+PARAM_INT_IN("maximum_depth", "Maximum depth of each tree (0 means no limit).",
+    "D", 6);
+PARAM_INT_IN("minimum_leaf_size", "Minimum number of points in each leaf "
+    "node.", "n", 1);
+PARAM_DOUBLE_IN("lambda", "L2 regularization of the values of the leaves.",
+    "", 1.0);
+PARAM_DOUBLE_IN("minimum_gain_split", "Minimum gain needed to make a split "
+    "when building a tree.", "g", 0);
+
+PARAM_MATRIX_OUT("probabilities", "Predicted class probabilities for each "
+    "point in the test set.", "P");
+PARAM_UROW_OUT("predictions", "Predicted classes for each point in the test "
+    "set.", "p");
+PARAM_ROW_OUT("predicted_responses", "Predicted responses for each point in "
+    "the test set.", "");
+
+/**
+ * This is the class that we will serialize.  It holds either a regression
+ * model or a classification model.
+ */
+class GradientBoostingModel
+{
+ public:
+  // The models, left public for direct access by this program.
+  GradientBoosting<SquaredErrorLoss> regressor;
+  GradientBoosting<CrossEntropyLoss> classifier;
+  // Whether the model is a classification model.
+  bool classification;
+
+  // Create the model.
+  GradientBoostingModel() : classification(false) { /* Nothing to do. */ }
+
+  // Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(classification));
+    if (classification)
+      ar(CEREAL_NVP(classifier));
+    else
+      ar(CEREAL_NVP(regressor));
+  }
+};
+
+PARAM_MODEL_IN(GradientBoostingModel, "input_model", "Pre-trained model to use "
+    "for prediction.", "m");
+PARAM_MODEL_OUT(GradientBoostingModel, "output_model", "Model to save trained "
+    "gradient boosted trees to.", "M");
+
+static void mlpackMain()
+{
+  // Check for incompatible input parameters.
+  RequireOnlyOnePassed({ "training", "input_model" }, true);
+
+  ReportIgnoredParam({{ "training", false }}, "print_training_error");
+  ReportIgnoredParam({{ "test", false }}, "test_labels");
+  ReportIgnoredParam({{ "test", false }}, "test_responses");
+
+  RequireAtLeastOnePassed({ "test", "output_model", "print_training_error" },
+      false, "the trained model will not be used or saved");
+
+  if (IO::HasParam("training"))
+  {
+    RequireOnlyOnePassed({ "labels", "responses" }, true, "must pass labels "
+        "or responses when training set given");
+  }
+
+  RequireParamValue<int>("num_iterations", [](int x) { return x > 0; }, true,
+      "number of iterations must be positive");
+  RequireParamValue<double>("learning_rate", [](double x) { return x > 0.0; },
+      true, "learning rate must be positive");
+  RequireParamValue<int>("minimum_leaf_size", [](int x) { return x > 0; }, true,
+      "minimum leaf size must be greater than 0");
+  RequireParamValue<int>("maximum_depth", [](int x) { return x >= 0; }, true,
+      "maximum depth must not be negative");
+  RequireParamValue<double>("lambda", [](double x) { return x >= 0.0; }, true,
+      "lambda must be nonnegative");
+  RequireParamValue<double>("minimum_gain_split",
+      [](double x) { return x >= 0.0; }, true,
+      "minimum gain for splitting must be nonnegative");
+
+  ReportIgnoredParam({{ "training", false }}, "num_iterations");
+  ReportIgnoredParam({{ "training", false }}, "learning_rate");
+  ReportIgnoredParam({{ "training", false }}, "maximum_depth");
+  ReportIgnoredParam({{ "training", false }}, "minimum_leaf_size");
+  ReportIgnoredParam({{ "training", false }}, "lambda");
+  ReportIgnoredParam({{ "training", false }}, "minimum_gain_split");
+
+  GradientBoostingModel* model;
+  if (IO::HasParam("training"))
+  {
+    Timer::Start("gb_training");
+    model = new GradientBoostingModel();
+
+    arma::mat data = std::move(IO::GetParam<arma::mat>("training"));
+
+    const size_t numIterations = (size_t) IO::GetParam<int>("num_iterations");
+    const double learningRate = IO::GetParam<double>("learning_rate");
+    const size_t maxDepth = (size_t) IO::GetParam<int>("maximum_depth");
+    const size_t minimumLeafSize =
+        (size_t) IO::GetParam<int>("minimum_leaf_size");
+    const double lambda = IO::GetParam<double>("lambda");
+    const double minimumGainSplit = IO::GetParam<double>("minimum_gain_split");
+
+    Log::Info << "Training gradient boosted trees with " << numIterations
+        << " iterations..." << endl;
+
+    if (IO::HasParam("labels"))
+    {
+      arma::Row<size_t> labels =
+          std::move(IO::GetParam<arma::Row<size_t>>("labels"));
+      const size_t numClasses = arma::max(labels) + 1;
+
+      model->classification = true;
+      model->classifier.Train(data, labels, numClasses, numIterations,
+          learningRate, maxDepth, minimumLeafSize, lambda, minimumGainSplit);
+      Timer::Stop("gb_training");
+
+      // Did we want training accuracy?
+      if (IO::HasParam("print_training_error"))
+      {
+        Timer::Start("gb_prediction");
+        arma::Row<size_t> predictions;
+        model->classifier.Classify(data, predictions);
+
+        const size_t correct = arma::accu(predictions == labels);
+
+        Log::Info << correct << " of " << labels.n_elem << " correct on "
+            << "training set (" << (double(correct) / double(labels.n_elem) *
+            100) << ")." << endl;
+        Timer::Stop("gb_prediction");
+      }
+    }
+    else
+    {
+      arma::rowvec responses =
+          std::move(IO::GetParam<arma::rowvec>("responses"));
+
+      model->classification = false;
+      model->regressor.Train(data, responses, numIterations, learningRate,
+          maxDepth, minimumLeafSize, lambda, minimumGainSplit);
+      Timer::Stop("gb_training");
+
+      // Did we want training error?
+      if (IO::HasParam("print_training_error"))
+      {
+        Timer::Start("gb_prediction");
+        arma::rowvec predictions;
+        model->regressor.Predict(data, predictions);
+
+        Log::Info << "Mean squared error on training set: "
+            << arma::mean(arma::square(predictions - responses)) << "."
+            << endl;
+        Timer::Stop("gb_prediction");
+      }
+    }
+  }
+  else
+  {
+    // Then we must be loading a model.
+    model = IO::GetParam<GradientBoostingModel*>("input_model");
+  }
+
+  if (IO::HasParam("test"))
+  {
+    arma::mat testData = std::move(IO::GetParam<arma::mat>("test"));
+    Timer::Start("gb_prediction");
+
+    if (model->classification)
+    {
+      if (IO::HasParam("test_responses"))
+      {
+        Log::Warn << PRINT_PARAM_STRING("test_responses") << " ignored "
+            << "because the model is a classification model." << endl;
+      }
+
+      // Get predictions and probabilities.
+      arma::Row<size_t> predictions;
+      arma::mat probabilities;
+      model->classifier.Classify(testData, predictions, probabilities);
+
+      // Did we want to calculate test accuracy?
+      if (IO::HasParam("test_labels"))
+      {
+        arma::Row<size_t> testLabels =
+            std::move(IO::GetParam<arma::Row<size_t>>("test_labels"));
+
+        const size_t correct = arma::accu(predictions == testLabels);
+
+        Log::Info << correct << " of " << testLabels.n_elem << " correct on "
+            << "test set (" << (double(correct) / double(testLabels.n_elem) *
+            100) << ")." << endl;
+      }
+
+      // Save the outputs.
+      IO::GetParam<arma::mat>("probabilities") = std::move(probabilities);
+      IO::GetParam<arma::Row<size_t>>("predictions") = std::move(predictions);
+    }
+    else
+    {
+      if (IO::HasParam("test_labels"))
+      {
+        Log::Warn << PRINT_PARAM_STRING("test_labels") << " ignored because "
+            << "the model is a regression model." << endl;
+      }
+
+      arma::rowvec predictions;
+      model->regressor.Predict(testData, predictions);
+
+      // Did we want to calculate test error?
+      if (IO::HasParam("test_responses"))
+      {
+        arma::rowvec testResponses =
+            std::move(IO::GetParam<arma::rowvec>("test_responses"));
+
+        Log::Info << "Mean squared error on test set: "
+            << arma::mean(arma::square(predictions - testResponses)) << "."
+            << endl;
+      }
+
+      // Save the outputs.
+      IO::GetParam<arma::rowvec>("predicted_responses") =
+          std::move(predictions);
+    }
+
+    Timer::Stop("gb_prediction");
+  }
+
+  // Save the output model.
+  IO::GetParam<GradientBoostingModel*>("output_model") = model;
+}
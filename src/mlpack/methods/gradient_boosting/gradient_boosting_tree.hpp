@@ -0,0 +1,190 @@
+/**
+ * @file methods/gradient_boosting/gradient_boosting_tree.hpp
+ *
+ * Definition of the GradientBoostingTree class, a regression tree that is fit
+ * to the gradients and hessians of a loss function.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_TREE_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/decision_tree/all_dimension_select.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A GradientBoostingTree is a binary regression tree that is fit to the first
+ * and second derivatives (the gradients and hessians) of a loss function at
+ * each training point, for gradient boosting.  If G and H are the sums of the
+ * gradients and hessians of the points of a node, then each leaf predicts the
+ * Newton step -G / (H + lambda), scaled by the learning rate, and the gain of
+ * splitting a node into children L and R is
+ *
+ * (1 / 2) (G_L^2 / (H_L + lambda) + G_R^2 / (H_R + lambda) -
+ *     G^2 / (H + lambda)).
+ *
+ * Splits are found between the bins of histograms.  As with
+ * HistogramNumericSplit for DecisionTree, the bins of each dimension are placed
+ * at quantiles of its values with QuantileBinThresholds(), but they are
+ * computed once for the whole dataset (see GradientBoosting) instead of at
+ * each node, and the histogram of the larger child of each node is found by
+ * subtracting the histogram of the smaller child from that of the node.  Each
+ * node passes the histograms on to its children, so while a subtree is built,
+ * only one histogram is kept for each level above it.  The histograms are
+ * built in parallel over the dimensions if OpenMP is available; the tree does
+ * not depend on the number of threads.  The dimensions that are searched for a
+ * split at each node are chosen by the DimensionSelectionType, as with
+ * DecisionTree.
+ *
+ * This is a separate tree type, not a DecisionTree: DecisionTree is fit to
+ * class labels, and its fitness functions and leaves work with class counts
+ * and class probabilities, while this tree is fit to real-valued gradients and
+ * hessians and its leaves hold real values.  It only shares the dimension
+ * selection policies and QuantileBinThresholds() with DecisionTree.
+ *
+ * The nodes are stored in flat arrays; the children of a node are adjacent,
+ * and points that are less than or equal to the threshold of the node go to
+ * the first child.
+ *
+ * @tparam DimensionSelectionType Class for selecting dimensions to split on.
+ */
+template<typename DimensionSelectionType = AllDimensionSelect>
+class GradientBoostingTree
+{
+ public:
+  //! The maximum number of bins of each dimension.
+  static const size_t MaxBins = 256;
+
+  /**
+   * Create a tree with a single leaf that predicts 0.
+   */
+  GradientBoostingTree();
+
+  /**
+   * Fit the tree to the given gradients and hessians of the loss at each point
+   * of a binned dataset.  The prediction of the tree for each training point is
+   * returned.
+   *
+   * @param bins Bin of each point (rows) in each dimension (columns).
+   * @param binThresholds The thresholds between the bins of each dimension:
+   *     bin b of dimension d holds the values that are less than or equal to
+   *     binThresholds[d][b] and greater than binThresholds[d][b - 1].
+   * @param gradients Gradient of the loss at each point.
+   * @param hessians Hessian of the loss at each point.
+   * @param learningRate Factor that the values of the leaves are scaled by.
+   * @param maximumDepth Maximum depth of the tree (0 means no limit).
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param lambda L2 regularization of the values of the leaves.  If it is 0,
+   *     nodes whose hessians sum to 0 are not split and predict 0, and splits
+   *     that would give such a child are skipped.
+   * @param minimumGainSplit Minimum gain for splitting a node.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @param predictions Output prediction of the tree for each point.
+   */
+  void Train(const arma::Mat<unsigned char>& bins,
+             const std::vector<arma::vec>& binThresholds,
+             const arma::rowvec& gradients,
+             const arma::rowvec& hessians,
+             const double learningRate,
+             const size_t maximumDepth,
+             const size_t minimumLeafSize,
+             const double lambda,
+             const double minimumGainSplit,
+             DimensionSelectionType& dimensionSelector,
+             arma::rowvec& predictions);
+
+  /**
+   * Return the prediction of the tree for the given point.
+   *
+   * @param point Point to predict.
+   */
+  template<typename VecType>
+  double Predict(const VecType& point) const
+  {
+    size_t node = 0;
+    while (children[node] != 0)
+    {
+      node = children[node] +
+          ((point[splitDimensions[node]] <= thresholds[node]) ? 0 : 1);
+    }
+
+    return values[node];
+  }
+
+  //! Get the number of nodes of the tree.
+  size_t NumNodes() const { return children.n_elem; }
+
+  //! Serialize the tree.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Nodes with fewer points than this build their histograms serially.
+  static const size_t MinimumParallelPoints = 1024;
+
+  //! The sums of the gradients and hessians, and the number of points, in each
+  //! bin (rows) of each dimension (columns).
+  struct Histogram
+  {
+    arma::mat gradientSums;
+    arma::mat hessianSums;
+    arma::Mat<size_t> counts;
+  };
+
+  /**
+   * Build the histogram of the points indices[begin, begin + count).
+   */
+  static void BuildHistogram(const arma::Mat<unsigned char>& bins,
+                             const arma::rowvec& gradients,
+                             const arma::rowvec& hessians,
+                             const arma::Col<size_t>& indices,
+                             const size_t begin,
+                             const size_t count,
+                             Histogram& histogram);
+
+  /**
+   * Train the given node on the points indices[begin, begin + count), whose
+   * histogram is given, and then its children recursively.  The histogram is
+   * taken by value so that it can be moved in, and it is freed (or reused for
+   * a child) when it is no longer needed.
+   */
+  void TrainNode(const size_t node,
+                 const size_t begin,
+                 const size_t count,
+                 Histogram histogram,
+                 const arma::Mat<unsigned char>& bins,
+                 const std::vector<arma::vec>& binThresholds,
+                 const arma::rowvec& gradients,
+                 const arma::rowvec& hessians,
+                 arma::Col<size_t>& indices,
+                 const double learningRate,
+                 const size_t maximumDepth,
+                 const size_t minimumLeafSize,
+                 const double lambda,
+                 const double minimumGainSplit,
+                 DimensionSelectionType& dimensionSelector,
+                 arma::rowvec& predictions);
+
+  //! The split dimension of each node (unused for leaves).
+  arma::Col<size_t> splitDimensions;
+  //! The split threshold of each node (unused for leaves).
+  arma::vec thresholds;
+  //! The index of the first child of each node, or 0 for leaves.
+  arma::Col<size_t> children;
+  //! The value of each leaf (unused for other nodes).
+  arma::vec values;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "gradient_boosting_tree_impl.hpp"
+
+#endif
@@ -0,0 +1,255 @@
+/**
+ * @file methods/gradient_boosting/gradient_boosting_tree_impl.hpp
+ *
+ * Implementation of the GradientBoostingTree class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_TREE_IMPL_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_TREE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "gradient_boosting_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename DimensionSelectionType>
+GradientBoostingTree<DimensionSelectionType>::GradientBoostingTree() :
+    splitDimensions(1, arma::fill::zeros),
+    thresholds(1, arma::fill::zeros),
+    children(1, arma::fill::zeros),
+    values(1, arma::fill::zeros)
+{
+  // Nothing to do.
+}
+
+template<typename DimensionSelectionType>
+void GradientBoostingTree<DimensionSelectionType>::Train(
+    const arma::Mat<unsigned char>& bins,
+    const std::vector<arma::vec>& binThresholds,
+    const arma::rowvec& gradients,
+    const arma::rowvec& hessians,
+    const double learningRate,
+    const size_t maximumDepth,
+    const size_t minimumLeafSize,
+    const double lambda,
+    const double minimumGainSplit,
+    DimensionSelectionType& dimensionSelector,
+    arma::rowvec& predictions)
+{
+  // Start with only the root.
+  splitDimensions.zeros(1);
+  thresholds.zeros(1);
+  children.zeros(1);
+  values.zeros(1);
+
+  predictions.set_size(bins.n_rows);
+  arma::Col<size_t> indices(bins.n_rows);
+  for (size_t i = 0; i < bins.n_rows; ++i)
+    indices[i] = i;
+
+  Histogram histogram;
+  BuildHistogram(bins, gradients, hessians, indices, 0, bins.n_rows,
+      histogram);
+
+  TrainNode(0, 0, bins.n_rows, std::move(histogram), bins, binThresholds,
+      gradients, hessians, indices, learningRate, maximumDepth,
+      minimumLeafSize, lambda, minimumGainSplit, dimensionSelector,
+      predictions);
+}
+
+template<typename DimensionSelectionType>
+template<typename Archive>
+void GradientBoostingTree<DimensionSelectionType>::serialize(
+    Archive& ar,
+    const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(splitDimensions));
+  ar(CEREAL_NVP(thresholds));
+  ar(CEREAL_NVP(children));
+  ar(CEREAL_NVP(values));
+}
+
+template<typename DimensionSelectionType>
+void GradientBoostingTree<DimensionSelectionType>::BuildHistogram(
+    const arma::Mat<unsigned char>& bins,
+    const arma::rowvec& gradients,
+    const arma::rowvec& hessians,
+    const arma::Col<size_t>& indices,
+    const size_t begin,
+    const size_t count,
+    Histogram& histogram)
+{
+  histogram.gradientSums.zeros(MaxBins, bins.n_cols);
+  histogram.hessianSums.zeros(MaxBins, bins.n_cols);
+  histogram.counts.zeros(MaxBins, bins.n_cols);
+
+  // Each dimension is summed by one thread, in the order of the points, so the
+  // sums don't depend on the number of threads.
+  #pragma omp parallel for schedule(dynamic) \
+      if (count >= MinimumParallelPoints)
+  for (omp_size_t d = 0; d < (omp_size_t) bins.n_cols; ++d)
+  {
+    const unsigned char* dimensionBins = bins.colptr(d);
+    double* gradientSums = histogram.gradientSums.colptr(d);
+    double* hessianSums = histogram.hessianSums.colptr(d);
+    size_t* counts = histogram.counts.colptr(d);
+    for (size_t j = begin; j < begin + count; ++j)
+    {
+      const size_t i = indices[j];
+      const size_t bin = dimensionBins[i];
+      gradientSums[bin] += gradients[i];
+      hessianSums[bin] += hessians[i];
+      ++counts[bin];
+    }
+  }
+}
+
+template<typename DimensionSelectionType>
+void GradientBoostingTree<DimensionSelectionType>::TrainNode(
+    const size_t node,
+    const size_t begin,
+    const size_t count,
+    Histogram histogram,
+    const arma::Mat<unsigned char>& bins,
+    const std::vector<arma::vec>& binThresholds,
+    const arma::rowvec& gradients,
+    const arma::rowvec& hessians,
+    arma::Col<size_t>& indices,
+    const double learningRate,
+    const size_t maximumDepth,
+    const size_t minimumLeafSize,
+    const double lambda,
+    const double minimumGainSplit,
+    DimensionSelectionType& dimensionSelector,
+    arma::rowvec& predictions)
+{
+  // The bins of any dimension hold all the points of the node.
+  const double gradientSum = arma::accu(histogram.gradientSums.col(0));
+  const double hessianSum = arma::accu(histogram.hessianSums.col(0));
+
+  // Look through the boundaries between the bins of each selected dimension
+  // for the best split.  Force a minimum leaf size of 1 (empty children don't
+  // make sense).  If lambda is 0, a node or child whose hessians sum to 0 has
+  // no Newton step, so such a node isn't split, and such a child is skipped.
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+  size_t bestDim = bins.n_cols; // This means "no split".
+  size_t bestBin = 0;
+  double bestGain = minimumGainSplit;
+  if (maximumDepth != 1 && count >= 2 * minimum && hessianSum + lambda > 0.0)
+  {
+    const double nodeScore = gradientSum * gradientSum / (hessianSum + lambda);
+    for (size_t d = dimensionSelector.Begin(); d != dimensionSelector.End();
+         d = dimensionSelector.Next())
+    {
+      double leftGradientSum = 0.0;
+      double leftHessianSum = 0.0;
+      size_t leftCount = 0;
+      for (size_t b = 0; b < binThresholds[d].n_elem; ++b)
+      {
+        leftGradientSum += histogram.gradientSums(b, d);
+        leftHessianSum += histogram.hessianSums(b, d);
+        leftCount += histogram.counts(b, d);
+
+        if (leftCount < minimum)
+          continue;
+        else if (count - leftCount < minimum)
+          break;
+
+        const double rightGradientSum = gradientSum - leftGradientSum;
+        const double rightHessianSum = hessianSum - leftHessianSum;
+        if (leftHessianSum + lambda <= 0.0 || rightHessianSum + lambda <= 0.0)
+          continue;
+
+        const double gain = 0.5 * (
+            leftGradientSum * leftGradientSum / (leftHessianSum + lambda) +
+            rightGradientSum * rightGradientSum / (rightHessianSum + lambda) -
+            nodeScore);
+
+        if (gain > bestGain)
+        {
+          bestDim = d;
+          bestBin = b;
+          bestGain = gain;
+        }
+      }
+    }
+  }
+
+  if (bestDim == bins.n_cols)
+  {
+    // Make a leaf.  Without a Newton step, it predicts 0.
+    values[node] = (hessianSum + lambda > 0.0) ?
+        -learningRate * gradientSum / (hessianSum + lambda) : 0.0;
+    for (size_t j = begin; j < begin + count; ++j)
+      predictions[indices[j]] = values[node];
+
+    return;
+  }
+
+  splitDimensions[node] = bestDim;
+  thresholds[node] = binThresholds[bestDim][bestBin];
+
+  // Move the points of the left child to the front, keeping them in order.
+  const unsigned char* dimensionBins = bins.colptr(bestDim);
+  const size_t leftCount = std::stable_partition(
+      indices.begin() + begin, indices.begin() + begin + count,
+      [dimensionBins, bestBin](const size_t i)
+      {
+        return dimensionBins[i] <= bestBin;
+      }) - (indices.begin() + begin);
+  const size_t rightCount = count - leftCount;
+
+  // Add the children.
+  const size_t left = children.n_elem;
+  children[node] = left;
+  splitDimensions.resize(left + 2);
+  thresholds.resize(left + 2);
+  children.resize(left + 2);
+  values.resize(left + 2);
+  children[left] = children[left + 1] = 0;
+
+  // Build the histogram of the smaller child, and subtract it from ours to get
+  // the histogram of the larger child.  Ours isn't needed anymore, so its
+  // memory is reused.
+  Histogram smallerHistogram;
+  if (leftCount <= rightCount)
+  {
+    BuildHistogram(bins, gradients, hessians, indices, begin, leftCount,
+        smallerHistogram);
+  }
+  else
+  {
+    BuildHistogram(bins, gradients, hessians, indices, begin + leftCount,
+        rightCount, smallerHistogram);
+  }
+  histogram.gradientSums -= smallerHistogram.gradientSums;
+  histogram.hessianSums -= smallerHistogram.hessianSums;
+  histogram.counts -= smallerHistogram.counts;
+
+  Histogram& leftHistogram = (leftCount <= rightCount) ? smallerHistogram :
+      histogram;
+  Histogram& rightHistogram = (leftCount <= rightCount) ? histogram :
+      smallerHistogram;
+
+  // Now build the children recursively.  Each child takes its histogram and
+  // frees it when it returns, so while the left subtree is built, only the
+  // histogram of the right child is kept here.
+  TrainNode(left, begin, leftCount, std::move(leftHistogram), bins,
+      binThresholds, gradients, hessians, indices, learningRate,
+      maximumDepth - 1, minimumLeafSize, lambda, minimumGainSplit,
+      dimensionSelector, predictions);
+  TrainNode(left + 1, begin + leftCount, rightCount, std::move(rightHistogram),
+      bins, binThresholds, gradients, hessians, indices, learningRate,
+      maximumDepth - 1, minimumLeafSize, lambda, minimumGainSplit,
+      dimensionSelector, predictions);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
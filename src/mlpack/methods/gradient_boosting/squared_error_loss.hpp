@@ -0,0 +1,82 @@
+/**
+ * @file methods/gradient_boosting/squared_error_loss.hpp
+ *
+ * The squared error loss for gradient boosting regression.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_SQUARED_ERROR_LOSS_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_SQUARED_ERROR_LOSS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The squared error loss, (1 / 2) (s - y)^2 for a score s and a response y,
+ * for regression with GradientBoosting.  The model has one output, which is
+ * the predicted response.
+ */
+class SquaredErrorLoss
+{
+ public:
+  //! This loss is for regression.
+  static const bool IsClassification = false;
+
+  //! Return the number of outputs of the model, which is always 1.
+  static size_t NumOutputs(const size_t /* numClasses */) { return 1; }
+
+  /**
+   * Compute the score that minimizes the loss before any trees are added;
+   * this is the mean of the responses.
+   *
+   * @param responses Responses of each training point.
+   * @param * (numClasses) Unused.
+   * @param scores Output initial score.
+   */
+  static void InitialScores(const arma::rowvec& responses,
+                            const size_t /* numClasses */,
+                            arma::vec& scores)
+  {
+    scores.set_size(1);
+    scores[0] = arma::mean(responses);
+  }
+
+  /**
+   * Compute the gradient and the hessian of the loss with respect to the score
+   * of each point.
+   *
+   * @param responses Responses of each training point.
+   * @param scores Current score of each training point.
+   * @param gradients Output gradients, s - y.
+   * @param hessians Output hessians, which are all 1.
+   */
+  static void Gradients(const arma::rowvec& responses,
+                        const arma::mat& scores,
+                        arma::mat& gradients,
+                        arma::mat& hessians)
+  {
+    gradients = scores.row(0) - responses;
+    hessians.ones(1, responses.n_elem);
+  }
+
+  /**
+   * Return the mean squared error of the given scores.
+   *
+   * @param responses Responses of each training point.
+   * @param scores Score of each training point.
+   */
+  static double Evaluate(const arma::rowvec& responses, const arma::mat& scores)
+  {
+    return arma::mean(arma::square(scores.row(0) - responses));
+  }
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -158,6 +158,10 @@ class HMM
    * log-likelihood of the model between iterations is less than the tolerance,
    * the Baum-Welch algorithm terminates.
    *
+   * The sequences are processed in parallel if OpenMP is available; each
+   * thread accumulates the statistics of its own sequences, and these are
+   * combined at the end of each iteration.
+   *
    * @note
    * Train() can be called multiple times with different sequences; each time it
    * is called, it uses the current parameters of the HMM as a starting point
@@ -290,6 +294,36 @@ class HMM
    */
   double LogLikelihood(const arma::mat& dataSeq) const;
 
+  /**
+   * Compute the most probable hidden state sequence for each of the given data
+   * sequences, using the Viterbi algorithm.  The sequences may have different
+   * lengths.  They are decoded in parallel if OpenMP is available, and each
+   * thread reuses one workspace for all of its sequences, so this is much
+   * faster than calling Predict() on many short sequences one at a time.
+   *
+   * @param dataSeq Vector of observation sequences.
+   * @param stateSeq Vector in which the most probable state sequence of each
+   *    observation sequence will be stored.
+   * @param logLikelihoods Vector in which the log-likelihood of each most
+   *    probable state sequence will be stored.
+   */
+  void Predict(const std::vector<arma::mat>& dataSeq,
+               std::vector<arma::Row<size_t>>& stateSeq,
+               arma::vec& logLikelihoods) const;
+
+  /**
+   * Compute the log-likelihood of each of the given data sequences.  The
+   * sequences may have different lengths.  They are scored in parallel if
+   * OpenMP is available, and only the forward probabilities of the current
+   * time step are kept, so no memory is allocated for each sequence.
+   *
+   * @param dataSeq Vector of data sequences to evaluate the likelihood of.
+   * @param logLikelihoods Vector in which the log-likelihood of each sequence
+   *    will be stored.
+   */
+  void LogLikelihood(const std::vector<arma::mat>& dataSeq,
+                     arma::vec& logLikelihoods) const;
+
   /**
    * Compute the log of the scaling factor of the given emission probability
    * at time t. To calculate the log-likelihood for the whole sequence,
@@ -493,6 +527,105 @@ class HMM
                 const arma::vec& logScales,
                 arma::mat& backwardLogProb) const;
 
+  /**
+   * Compute the log-probability of each observation in the given data sequence
+   * under the emission distribution of each state.  The returned matrix has
+   * rows equal to the number of hidden states and columns equal to the number
+   * of observations.
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param emissionLogProb Matrix in which emission probabilities will be
+   *     saved.
+   */
+  void EmissionLogProbabilities(const arma::mat& dataSeq,
+                                arma::mat& emissionLogProb) const;
+
+  /**
+   * The Forward algorithm, given the emission log-probabilities of each
+   * observation (as computed by EmissionLogProbabilities()).
+   *
+   * @param emissionLogProb Emission log-probabilities of each observation.
+   * @param logScales Vector in which the log of scaling factors will be saved.
+   * @param forwardLogProb Matrix in which forward probabilities will be saved.
+   */
+  void EmissionForward(const arma::mat& emissionLogProb,
+                       arma::vec& logScales,
+                       arma::mat& forwardLogProb) const;
+
+  /**
+   * The Backward algorithm, given the emission log-probabilities of each
+   * observation (as computed by EmissionLogProbabilities()).
+   *
+   * @param emissionLogProb Emission log-probabilities of each observation.
+   * @param logScales Vector of log of scaling factors.
+   * @param backwardLogProb Matrix in which backward probabilities will be
+   *     saved.
+   */
+  void EmissionBackward(const arma::mat& emissionLogProb,
+                        const arma::vec& logScales,
+                        arma::mat& backwardLogProb) const;
+
+  /**
+   * Compute the log of the expected number of transitions between each pair of
+   * states in one sequence, given the results of the Forward-Backward
+   * algorithm.  The old transition probabilities are not multiplied in.  The
+   * sum over time is computed as one matrix product.
+   *
+   * @param emissionLogProb Emission log-probabilities of each observation.
+   * @param forwardLogProb Forward probabilities of the sequence.
+   * @param backwardLogProb Backward probabilities of the sequence.
+   * @param logScales Log of scaling factors of the sequence.
+   * @param logCounts Matrix in which element (i, j) will be the log of the
+   *     expected number of transitions from state j to state i.
+   */
+  void TransitionLogCounts(const arma::mat& emissionLogProb,
+                           const arma::mat& forwardLogProb,
+                           const arma::mat& backwardLogProb,
+                           const arma::vec& logScales,
+                           arma::mat& logCounts) const;
+
+  /**
+   * The Viterbi algorithm, with the given workspace.  This is used by both
+   * overloads of Predict().
+   *
+   * @param dataSeq Sequence of observations.
+   * @param logTransitionT Transpose of the log transition matrix.
+   * @param stateSeq Vector in which the most probable state sequence will be
+   *    stored.
+   * @param logStateProb Workspace for the log-probability of the best path to
+   *    each state; it must have at least as many columns as dataSeq.
+   * @param stateSeqBack Workspace for the previous state of the best path to
+   *    each state; it must have at least as many columns as dataSeq.
+   * @return Log-likelihood of most probable state sequence.
+   */
+  double Viterbi(const arma::mat& dataSeq,
+                 const arma::mat& logTransitionT,
+                 arma::Row<size_t>& stateSeq,
+                 arma::mat& logStateProb,
+                 arma::Mat<size_t>& stateSeqBack) const;
+
+  /**
+   * Compute the log-likelihood of the given data sequence with the forward
+   * algorithm, keeping only the forward probabilities of the current time step
+   * in the given workspace.  This is used by both overloads of
+   * LogLikelihood().
+   *
+   * @param dataSeq Data sequence to evaluate the likelihood of.
+   * @param logTransitionT Transpose of the log transition matrix.
+   * @param emissionLogProb Workspace for the emission probabilities; it must
+   *    have one element per state.
+   * @param forwardLogProb Workspace for the forward probabilities; it must
+   *    have one element per state.
+   * @param nextForwardLogProb Workspace for the forward probabilities; it must
+   *    have one element per state.
+   * @return Log-likelihood of the given sequence.
+   */
+  double ForwardLogLikelihood(const arma::mat& dataSeq,
+                              const arma::mat& logTransitionT,
+                              arma::vec& emissionLogProb,
+                              arma::vec& forwardLogProb,
+                              arma::vec& nextForwardLogProb) const;
+
   //! Set of emission probability distributions; one for each state.
   std::vector<Distribution> emission;
 
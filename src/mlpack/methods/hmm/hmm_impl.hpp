@@ -101,29 +101,42 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
   // Maximum iterations?
   size_t iterations = 1000;
 
-  // Find length of all sequences and ensure they are the correct size.
-  size_t totalLength = 0;
+  // Find length of all sequences and ensure they are the correct size.  The
+  // observations of each sequence start at its offset in the emission list.
+  arma::Col<size_t> offsets(dataSeq.size() + 1);
+  offsets[0] = 0;
   for (size_t seq = 0; seq < dataSeq.size(); seq++)
   {
-    totalLength += dataSeq[seq].n_cols;
+    offsets[seq + 1] = offsets[seq] + dataSeq[seq].n_cols;
 
     if (dataSeq[seq].n_rows != dimensionality)
       Log::Fatal << "HMM::Train(): data sequence " << seq << " has "
           << "dimensionality " << dataSeq[seq].n_rows << " (expected "
           << dimensionality << " dimensions)." << std::endl;
   }
+  const size_t totalLength = offsets[dataSeq.size()];
 
   // These are used later for training of each distribution.  We initialize it
-  // all now so we don't have to do any allocation later on.
+  // all now so we don't have to do any allocation later on.  The observations
+  // don't change between iterations, so they are only gathered once.
   std::vector<arma::vec> emissionProb(logTransition.n_cols,
       arma::vec(totalLength));
   arma::mat emissionList(dimensionality, totalLength);
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    if (dataSeq[seq].n_cols > 0)
+      emissionList.cols(offsets[seq], offsets[seq + 1] - 1) = dataSeq[seq];
+  }
 
   // This should be the Baum-Welch algorithm (EM for HMM estimation). This
   // follows the procedure outlined in Elliot, Aggoun, and Moore's book "Hidden
   // Markov Models: Estimation and Control", pp. 36-40.
   for (size_t iter = 0; iter < iterations; iter++)
   {
+    // The parameters in log space are only read from here on, so they can be
+    // shared between threads.
+    ConvertToLogSpace();
+
     // Clear new transition matrix and emission probabilities.
     arma::vec newLogInitial(logTransition.n_rows);
     newLogInitial.fill(-std::numeric_limits<double>::infinity());
@@ -133,53 +146,66 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
     // Reset log likelihood.
     loglik = 0;
 
-    // Sum over time.
-    size_t sumTime = 0;
-
-    // Loop over each sequence.
-    for (size_t seq = 0; seq < dataSeq.size(); seq++)
+    // Each thread processes some of the sequences, and accumulates its own
+    // estimates; these are added together at the end.
+    #pragma omp parallel
     {
+      arma::vec threadLogInitial(logTransition.n_rows);
+      threadLogInitial.fill(-std::numeric_limits<double>::infinity());
+      arma::mat threadLogTransition(logTransition.n_rows,
+          logTransition.n_cols);
+      threadLogTransition.fill(-std::numeric_limits<double>::infinity());
+      double threadLoglik = 0;
+
+      arma::mat emissionLogProb;
       arma::mat stateLogProb;
       arma::mat forwardLog;
       arma::mat backwardLog;
+      arma::mat logCounts;
       arma::vec logScales;
 
-      // Add the log-likelihood of this sequence.  This is the E-step.
-      loglik += LogEstimate(dataSeq[seq], stateLogProb, forwardLog,
-          backwardLog, logScales);
-
-      // Add to estimate of initial probability for state j.
-      for (size_t j = 0; j < logTransition.n_cols; ++j)
-        newLogInitial[j] = math::LogAdd(newLogInitial[j], stateLogProb(j, 0));
-
-      // Now re-estimate the parameters.  This is the M-step.
-      //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
-      //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t]) b(i,
-      //           t + 1)))
-      //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t) b(i, t)
-      // We store the new estimates in a different matrix.
-      for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
+      // Loop over each sequence.
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); seq++)
       {
+        // Run the forward-backward algorithm and add the log-likelihood of
+        // this sequence.  This is the E-step.  The emission probabilities of
+        // each observation are only computed once.
+        EmissionLogProbabilities(dataSeq[seq], emissionLogProb);
+        EmissionForward(emissionLogProb, logScales, forwardLog);
+        EmissionBackward(emissionLogProb, logScales, backwardLog);
+        stateLogProb = forwardLog + backwardLog;
+        threadLoglik += accu(logScales);
+
+        // Add to estimate of initial probability for state j.
+        math::LogAddInPlace(threadLogInitial, arma::vec(stateLogProb.col(0)));
+
+        // Now re-estimate the parameters.  This is the M-step.
+        //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
+        //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t])
+        //           b(i, t + 1)))
+        //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t)
+        //           b(i, t)
+        // We store the new estimates in a different matrix.  The
+        // multiplication by the old T_ij is postponed until later.
+        TransitionLogCounts(emissionLogProb, forwardLog, backwardLog,
+            logScales, logCounts);
+        math::LogAddInPlace(threadLogTransition, logCounts);
+
+        // Add to list of emission probabilities, for Distribution::Train().
+        const arma::mat stateProb = exp(stateLogProb);
         for (size_t j = 0; j < logTransition.n_cols; ++j)
         {
-          if (t < dataSeq[seq].n_cols - 1)
-          {
-            // Estimate of T_ij (probability of transition from state j to state
-            // i).  We postpone multiplication of the old T_ij until later.
-            for (size_t i = 0; i < logTransition.n_rows; i++)
-            {
-              newLogTransition(i, j) = math::LogAdd(newLogTransition(i, j),
-                  forwardLog(j, t) + backwardLog(i, t + 1) +
-                  emission[i].LogProbability(dataSeq[seq].unsafe_col(t + 1)) -
-                  logScales[t + 1]);
-            }
-          }
-
-          // Add to list of emission observations, for Distribution::Train().
-          emissionList.col(sumTime) = dataSeq[seq].col(t);
-          emissionProb[j][sumTime] = exp(stateLogProb(j, t));
+          emissionProb[j].subvec(offsets[seq], offsets[seq + 1] - 1) =
+              stateProb.row(j).t();
         }
-        sumTime++;
+      }
+
+      #pragma omp critical
+      {
+        loglik += threadLoglik;
+        math::LogAddInPlace(newLogInitial, threadLogInitial);
+        math::LogAddInPlace(newLogTransition, threadLogTransition);
       }
     }
 
@@ -338,8 +364,10 @@ double HMM<Distribution>::LogEstimate(const arma::mat& dataSeq,
                                       arma::vec& logScales) const
 {
   // First run the forward-backward algorithm.
-  Forward(dataSeq, logScales, forwardLogProb);
-  Backward(dataSeq, logScales, backwardLogProb);
+  arma::mat emissionLogProb;
+  EmissionLogProbabilities(dataSeq, emissionLogProb);
+  EmissionForward(emissionLogProb, logScales, forwardLogProb);
+  EmissionBackward(emissionLogProb, logScales, backwardLogProb);
 
   // Now assemble the state probability matrix based on the forward and backward
   // probabilities.
@@ -458,53 +486,50 @@ template<typename Distribution>
 double HMM<Distribution>::Predict(const arma::mat& dataSeq,
                                   arma::Row<size_t>& stateSeq) const
 {
-  // This is an implementation of the Viterbi algorithm for finding the most
-  // probable sequence of states to produce the observed data sequence.  We
-  // don't use log-likelihoods to save that little bit of time, but we'll
-  // calculate the log-likelihood at the end of it all.
-  stateSeq.set_size(dataSeq.n_cols);
+  ConvertToLogSpace();
+
   arma::mat logStateProb(logTransition.n_rows, dataSeq.n_cols);
-  arma::mat stateSeqBack(logTransition.n_rows, dataSeq.n_cols);
+  arma::Mat<size_t> stateSeqBack(logTransition.n_rows, dataSeq.n_cols);
 
+  return Viterbi(dataSeq, logTransition.t(), stateSeq, logStateProb,
+      stateSeqBack);
+}
+
+/**
+ * Compute the most probable hidden state sequence for each of the given
+ * observation sequences using the Viterbi algorithm.
+ */
+template<typename Distribution>
+void HMM<Distribution>::Predict(const std::vector<arma::mat>& dataSeq,
+                                std::vector<arma::Row<size_t>>& stateSeq,
+                                arma::vec& logLikelihoods) const
+{
+  // The parameters in log space are only read from here on, so they can be
+  // shared between threads.
   ConvertToLogSpace();
+  const arma::mat logTransitionT = logTransition.t();
 
-  // The calculation of the first state is slightly different; the probability
-  // of the first state being state j is the maximum probability that the state
-  // came to be j from another state.
-  logStateProb.col(0).zeros();
-  for (size_t state = 0; state < logTransition.n_rows; state++)
-  {
-    logStateProb(state, 0) = logInitial[state] +
-        emission[state].LogProbability(dataSeq.unsafe_col(0));
-    stateSeqBack(state, 0) = state;
-  }
+  size_t maxLength = 0;
+  for (size_t i = 0; i < dataSeq.size(); ++i)
+    maxLength = std::max(maxLength, (size_t) dataSeq[i].n_cols);
 
-  // Store the best first state.
-  arma::uword index;
-  for (size_t t = 1; t < dataSeq.n_cols; t++)
+  stateSeq.resize(dataSeq.size());
+  logLikelihoods.set_size(dataSeq.size());
+
+  #pragma omp parallel
   {
-    // Assemble the state probability for this element.
-    // Given that we are in state j, we use state with the highest probability
-    // of being the previous state.
-    for (size_t j = 0; j < logTransition.n_rows; j++)
+    // Each thread's workspace fits the longest sequence, and is reused for all
+    // of the sequences of that thread.
+    arma::mat logStateProb(logTransition.n_rows, maxLength);
+    arma::Mat<size_t> stateSeqBack(logTransition.n_rows, maxLength);
+
+    #pragma omp for schedule(dynamic, 64)
+    for (omp_size_t i = 0; i < (omp_size_t) dataSeq.size(); ++i)
     {
-      arma::vec prob = logStateProb.col(t - 1) + logTransition.row(j).t();
-      logStateProb(j, t) = prob.max(index) +
-          emission[j].LogProbability(dataSeq.unsafe_col(t));
-      stateSeqBack(j, t) = index;
+      logLikelihoods[i] = Viterbi(dataSeq[i], logTransitionT, stateSeq[i],
+          logStateProb, stateSeqBack);
     }
   }
-
-  // Backtrack to find the most probable state sequence.
-  logStateProb.unsafe_col(dataSeq.n_cols - 1).max(index);
-  stateSeq[dataSeq.n_cols - 1] = index;
-  for (size_t t = 2; t <= dataSeq.n_cols; t++)
-  {
-    stateSeq[dataSeq.n_cols - t] =
-        stateSeqBack(stateSeq[dataSeq.n_cols - t + 1], dataSeq.n_cols - t + 1);
-  }
-
-  return logStateProb(stateSeq(dataSeq.n_cols - 1), dataSeq.n_cols - 1);
 }
 
 /**
@@ -513,13 +538,43 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
 template<typename Distribution>
 double HMM<Distribution>::LogLikelihood(const arma::mat& dataSeq) const
 {
-  arma::mat forwardLog;
-  arma::vec logScales;
+  ConvertToLogSpace();
 
-  Forward(dataSeq, logScales, forwardLog);
+  arma::vec emissionLogProb(logTransition.n_rows);
+  arma::vec forwardLogProb(logTransition.n_rows);
+  arma::vec nextForwardLogProb(logTransition.n_rows);
 
-  // The log-likelihood is the log of the scales for each time step.
-  return accu(logScales);
+  return ForwardLogLikelihood(dataSeq, logTransition.t(), emissionLogProb,
+      forwardLogProb, nextForwardLogProb);
+}
+
+/**
+ * Compute the log-likelihood of each of the given data sequences.
+ */
+template<typename Distribution>
+void HMM<Distribution>::LogLikelihood(const std::vector<arma::mat>& dataSeq,
+                                      arma::vec& logLikelihoods) const
+{
+  // The parameters in log space are only read from here on, so they can be
+  // shared between threads.
+  ConvertToLogSpace();
+  const arma::mat logTransitionT = logTransition.t();
+
+  logLikelihoods.set_size(dataSeq.size());
+
+  #pragma omp parallel
+  {
+    arma::vec emissionLogProb(logTransition.n_rows);
+    arma::vec forwardLogProb(logTransition.n_rows);
+    arma::vec nextForwardLogProb(logTransition.n_rows);
+
+    #pragma omp for schedule(dynamic, 64)
+    for (omp_size_t i = 0; i < (omp_size_t) dataSeq.size(); ++i)
+    {
+      logLikelihoods[i] = ForwardLogLikelihood(dataSeq[i], logTransitionT,
+          emissionLogProb, forwardLogProb, nextForwardLogProb);
+    }
+  }
 }
 
 /**
@@ -708,12 +763,57 @@ template<typename Distribution>
 void HMM<Distribution>::Forward(const arma::mat& dataSeq,
                                 arma::vec& logScales,
                                 arma::mat& forwardLogProb) const
+{
+  arma::mat emissionLogProb;
+  EmissionLogProbabilities(dataSeq, emissionLogProb);
+  EmissionForward(emissionLogProb, logScales, forwardLogProb);
+}
+
+/**
+ * The Backward procedure (part of the Forward-Backward algorithm).
+ */
+template<typename Distribution>
+void HMM<Distribution>::Backward(const arma::mat& dataSeq,
+                                 const arma::vec& logScales,
+                                 arma::mat& backwardLogProb) const
+{
+  arma::mat emissionLogProb;
+  EmissionLogProbabilities(dataSeq, emissionLogProb);
+  EmissionBackward(emissionLogProb, logScales, backwardLogProb);
+}
+
+/**
+ * Compute the emission log-probability of each observation for each state.
+ */
+template<typename Distribution>
+void HMM<Distribution>::EmissionLogProbabilities(
+    const arma::mat& dataSeq,
+    arma::mat& emissionLogProb) const
+{
+  emissionLogProb.set_size(logTransition.n_rows, dataSeq.n_cols);
+  for (size_t t = 0; t < dataSeq.n_cols; t++)
+  {
+    for (size_t state = 0; state < logTransition.n_rows; state++)
+    {
+      emissionLogProb(state, t) =
+          emission[state].LogProbability(dataSeq.unsafe_col(t));
+    }
+  }
+}
+
+/**
+ * The Forward procedure, given the emission log-probabilities.
+ */
+template<typename Distribution>
+void HMM<Distribution>::EmissionForward(const arma::mat& emissionLogProb,
+                                        arma::vec& logScales,
+                                        arma::mat& forwardLogProb) const
 {
   // Our goal is to calculate the forward probabilities:
   //  P(X_k | o_{1:k}) for all possible states X_k, for each time point k.
-  forwardLogProb.resize(logTransition.n_rows, dataSeq.n_cols);
+  forwardLogProb.resize(logTransition.n_rows, emissionLogProb.n_cols);
   forwardLogProb.fill(-std::numeric_limits<double>::infinity());
-  logScales.resize(dataSeq.n_cols);
+  logScales.resize(emissionLogProb.n_cols);
   logScales.fill(-std::numeric_limits<double>::infinity());
 
   // The first entry in the forward algorithm uses the initial state
@@ -721,45 +821,35 @@ void HMM<Distribution>::Forward(const arma::mat& dataSeq,
   // t = -1) is state 0; this is not our assumption here.  To force that
   // behavior, you could append a single starting state to every single data
   // sequence and that should produce results in line with MATLAB.
-
-  arma::vec emissionLogProb(logTransition.n_rows);
-  for (size_t state = 0; state < logTransition.n_rows; state++)
-  {
-    emissionLogProb(state) =
-        emission[state].LogProbability(dataSeq.unsafe_col(0));
-  }
-
-  forwardLogProb.col(0) = ForwardAtT0(emissionLogProb, logScales(0));
+  forwardLogProb.col(0) = ForwardAtT0(emissionLogProb.unsafe_col(0),
+      logScales(0));
 
   // Now compute the probabilities for each successive observation.
-  for (size_t t = 1; t < dataSeq.n_cols; t++)
+  for (size_t t = 1; t < emissionLogProb.n_cols; t++)
   {
-    for (size_t state = 0; state < logTransition.n_rows; state++)
-    {
-          emissionLogProb(state) =
-                  emission[state].LogProbability(dataSeq.unsafe_col(t));
-    }
-
-    forwardLogProb.col(t) =
-      ForwardAtTn(emissionLogProb, logScales(t), forwardLogProb.col(t-1));
+    forwardLogProb.col(t) = ForwardAtTn(emissionLogProb.unsafe_col(t),
+        logScales(t), forwardLogProb.col(t - 1));
   }
 }
 
+/**
+ * The Backward procedure, given the emission log-probabilities.
+ */
 template<typename Distribution>
-void HMM<Distribution>::Backward(const arma::mat& dataSeq,
-                                 const arma::vec& logScales,
-                                 arma::mat& backwardLogProb) const
+void HMM<Distribution>::EmissionBackward(const arma::mat& emissionLogProb,
+                                         const arma::vec& logScales,
+                                         arma::mat& backwardLogProb) const
 {
   // Our goal is to calculate the backward probabilities:
   //  P(X_k | o_{k + 1:T}) for all possible states X_k, for each time point k.
-  backwardLogProb.resize(logTransition.n_rows, dataSeq.n_cols);
+  backwardLogProb.resize(logTransition.n_rows, emissionLogProb.n_cols);
   backwardLogProb.fill(-std::numeric_limits<double>::infinity());
 
   // The last element probability is 1.
-  backwardLogProb.col(dataSeq.n_cols - 1).fill(0);
+  backwardLogProb.col(emissionLogProb.n_cols - 1).fill(0);
 
   // Now step backwards through all other observations.
-  for (size_t t = dataSeq.n_cols - 2; t + 1 > 0; t--)
+  for (size_t t = emissionLogProb.n_cols - 2; t + 1 > 0; t--)
   {
     for (size_t j = 0; j < logTransition.n_rows; j++)
     {
@@ -771,7 +861,7 @@ void HMM<Distribution>::Backward(const arma::mat& dataSeq,
       {
         backwardLogProb(j, t) = math::LogAdd(backwardLogProb(j, t),
             logTransition(state, j) + backwardLogProb(state, t + 1)
-            + emission[state].LogProbability(dataSeq.unsafe_col(t + 1)));
+            + emissionLogProb(state, t + 1));
       }
 
       // Normalize by the weights from the forward algorithm.
@@ -781,6 +871,199 @@ void HMM<Distribution>::Backward(const arma::mat& dataSeq,
   }
 }
 
+/**
+ * Compute the log of the expected number of transitions between each pair of
+ * states in one sequence.
+ */
+template<typename Distribution>
+void HMM<Distribution>::TransitionLogCounts(const arma::mat& emissionLogProb,
+                                            const arma::mat& forwardLogProb,
+                                            const arma::mat& backwardLogProb,
+                                            const arma::vec& logScales,
+                                            arma::mat& logCounts) const
+{
+  const size_t length = emissionLogProb.n_cols;
+  logCounts.set_size(logTransition.n_rows, logTransition.n_cols);
+  logCounts.fill(-std::numeric_limits<double>::infinity());
+  if (length < 2)
+    return;
+
+  // The log of the count of transitions from state j at time t to state i at
+  // time t + 1 is forwardLogProb(j, t) + nextLogProb(i, t), where nextLogProb
+  // holds the terms that only depend on time t + 1.
+  arma::mat nextLogProb = backwardLogProb.tail_cols(length - 1) +
+      emissionLogProb.tail_cols(length - 1);
+  nextLogProb.each_row() -= logScales.tail(length - 1).t();
+
+  // The sum over time is a matrix product in linear space.  The forward
+  // probabilities are normalized, so they can be exponentiated directly; each
+  // column of nextLogProb is shifted by its maximum, and the shifts are applied
+  // relative to the largest one as weights.
+  arma::rowvec shifts = arma::max(nextLogProb, 0);
+  double maxShift = -std::numeric_limits<double>::infinity();
+  for (size_t t = 0; t < shifts.n_elem; t++)
+  {
+    if (std::isfinite(shifts[t]))
+      maxShift = std::max(maxShift, shifts[t]);
+  }
+
+  if (!std::isfinite(maxShift))
+    return;
+
+  arma::rowvec weights(shifts.n_elem);
+  for (size_t t = 0; t < shifts.n_elem; t++)
+  {
+    if (std::isfinite(shifts[t]))
+    {
+      weights[t] = std::exp(shifts[t] - maxShift);
+    }
+    else
+    {
+      // No transition into time t + 1 is possible.
+      weights[t] = 0;
+      shifts[t] = 0;
+    }
+  }
+
+  nextLogProb.each_row() -= shifts;
+  arma::mat nextProb = exp(nextLogProb);
+  nextProb.each_row() %= weights;
+
+  logCounts = log(nextProb * exp(forwardLogProb.head_cols(length - 1)).t()) +
+      maxShift;
+}
+
+/**
+ * The Viterbi algorithm, with the given workspace.
+ */
+template<typename Distribution>
+double HMM<Distribution>::Viterbi(const arma::mat& dataSeq,
+                                  const arma::mat& logTransitionT,
+                                  arma::Row<size_t>& stateSeq,
+                                  arma::mat& logStateProb,
+                                  arma::Mat<size_t>& stateSeqBack) const
+{
+  // This is an implementation of the Viterbi algorithm for finding the most
+  // probable sequence of states to produce the observed data sequence.  Only
+  // the first dataSeq.n_cols columns of the workspace are used.
+  const size_t states = logTransition.n_rows;
+  const size_t length = dataSeq.n_cols;
+  stateSeq.set_size(length);
+  if (length == 0)
+    return 0.0;
+
+  // The calculation of the first state is slightly different; the probability
+  // of the first state being state j is the maximum probability that the state
+  // came to be j from another state.
+  for (size_t state = 0; state < states; state++)
+  {
+    logStateProb(state, 0) = logInitial[state] +
+        emission[state].LogProbability(dataSeq.unsafe_col(0));
+    stateSeqBack(state, 0) = state;
+  }
+
+  for (size_t t = 1; t < length; t++)
+  {
+    // Assemble the state probability for this element.
+    // Given that we are in state j, we use state with the highest probability
+    // of being the previous state.
+    for (size_t j = 0; j < states; j++)
+    {
+      size_t index = 0;
+      double best = logStateProb(0, t - 1) + logTransitionT(0, j);
+      for (size_t i = 1; i < states; i++)
+      {
+        const double prob = logStateProb(i, t - 1) + logTransitionT(i, j);
+        if (prob > best)
+        {
+          best = prob;
+          index = i;
+        }
+      }
+
+      logStateProb(j, t) = best +
+          emission[j].LogProbability(dataSeq.unsafe_col(t));
+      stateSeqBack(j, t) = index;
+    }
+  }
+
+  // Backtrack to find the most probable state sequence.
+  size_t index = 0;
+  for (size_t state = 1; state < states; state++)
+  {
+    if (logStateProb(state, length - 1) > logStateProb(index, length - 1))
+      index = state;
+  }
+
+  stateSeq[length - 1] = index;
+  for (size_t t = 2; t <= length; t++)
+  {
+    stateSeq[length - t] =
+        stateSeqBack(stateSeq[length - t + 1], length - t + 1);
+  }
+
+  return logStateProb(stateSeq[length - 1], length - 1);
+}
+
+/**
+ * Compute the log-likelihood of the given data sequence with the forward
+ * algorithm, with the given workspace.
+ */
+template<typename Distribution>
+double HMM<Distribution>::ForwardLogLikelihood(
+    const arma::mat& dataSeq,
+    const arma::mat& logTransitionT,
+    arma::vec& emissionLogProb,
+    arma::vec& forwardLogProb,
+    arma::vec& nextForwardLogProb) const
+{
+  // This is the same computation as Forward(), but only the forward
+  // probabilities of the last time step are kept.  The log-likelihood is the
+  // sum of the log of the scales for each time step.
+  double logLikelihood = 0.0;
+  for (size_t t = 0; t < dataSeq.n_cols; t++)
+  {
+    for (size_t state = 0; state < logTransition.n_rows; state++)
+    {
+      emissionLogProb[state] =
+          emission[state].LogProbability(dataSeq.unsafe_col(t));
+    }
+
+    if (t == 0)
+    {
+      // The first entry uses the initial state probabilities.
+      nextForwardLogProb = logInitial + emissionLogProb;
+    }
+    else
+    {
+      // The forward probability of state j at time t is the sum over all
+      // states of the probability of the previous state transitioning to the
+      // current state and emitting the given observation.
+      for (size_t state = 0; state < logTransition.n_rows; state++)
+      {
+        double sum = -std::numeric_limits<double>::infinity();
+        for (size_t j = 0; j < logTransition.n_rows; j++)
+        {
+          sum = math::LogAdd(sum, forwardLogProb[j] +
+              logTransitionT(j, state));
+        }
+
+        nextForwardLogProb[state] = sum + emissionLogProb[state];
+      }
+    }
+
+    // Normalize probability.
+    const double logScale = math::AccuLog(nextForwardLogProb);
+    if (std::isfinite(logScale))
+      nextForwardLogProb -= logScale;
+
+    logLikelihood += logScale;
+    forwardLogProb.swap(nextForwardLogProb);
+  }
+
+  return logLikelihood;
+}
+
 /**
  * Make sure the variables in log space are in sync with the linear
  * counterparts.
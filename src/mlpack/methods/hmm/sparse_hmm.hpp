@@ -0,0 +1,280 @@
+/**
+ * @file methods/hmm/sparse_hmm.hpp
+ *
+ * Definition of the SparseHMM class, a hidden Markov model whose transition
+ * matrix has a fixed sparsity pattern.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HMM_SPARSE_HMM_HPP
+#define MLPACK_METHODS_HMM_SPARSE_HMM_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/dists/discrete_distribution.hpp>
+
+namespace mlpack {
+namespace hmm /** Hidden Markov Models. */ {
+
+/**
+ * A class that represents a Hidden Markov Model whose transition matrix is
+ * sparse: only the transitions in a given pattern (for instance, a band for a
+ * left-to-right model) are possible.  The interface mirrors the HMM class, but
+ * the forward and backward algorithms, the Viterbi algorithm and Baum-Welch
+ * training only visit the possible transitions, so their cost is O(T nnz)
+ * instead of O(T N^2), where T is the length of a sequence, N is the number of
+ * states, and nnz is the number of possible transitions.
+ *
+ * Transitions that are not in the pattern have probability 0, and stay that way
+ * through training and serialization; transitions in the pattern keep their
+ * place even if their probability becomes 0.  As for the HMM class, element
+ * (i, j) of the transition matrix is the probability of a transition from
+ * state j to state i.
+ *
+ * @code
+ * extern std::vector<arma::mat> observations;
+ *
+ * // A left-to-right model with 1000 states, where each state can only move to
+ * // itself or to the next two states.
+ * const arma::sp_mat pattern =
+ *     SparseHMM<DiscreteDistribution>::BandedPattern(1000, 0, 2);
+ * SparseHMM<DiscreteDistribution> hmm(pattern, DiscreteDistribution(20));
+ * hmm.Train(observations);
+ * @endcode
+ *
+ * @tparam Distribution Type of emission distribution for this HMM.
+ */
+template<typename Distribution = distribution::DiscreteDistribution>
+class SparseHMM
+{
+ public:
+  /**
+   * Create the sparse HMM with the given transition pattern; each nonzero
+   * element of the pattern is a possible transition.  The transition
+   * probabilities are initialized randomly on the pattern, and the initial
+   * state probabilities are uniform.  Each state must have at least one
+   * possible transition.
+   *
+   * @param pattern Sparsity pattern of the transition matrix (N x N).
+   * @param emissions Default distribution for emissions.
+   * @param tolerance Tolerance for convergence of training algorithm
+   *      (Baum-Welch).
+   */
+  SparseHMM(const arma::sp_mat& pattern = arma::sp_mat(),
+            const Distribution emissions = Distribution(),
+            const double tolerance = 1e-5);
+
+  /**
+   * Create the sparse HMM with the given initial probabilities, transition
+   * matrix, and emission distributions.  The nonzero elements of the
+   * transition matrix define the sparsity pattern; each column should sum to 1.
+   *
+   * @param initial Initial state probabilities.
+   * @param transition Sparse transition matrix.
+   * @param emission Emission distributions.
+   * @param tolerance Tolerance for convergence of training algorithm
+   *      (Baum-Welch).
+   */
+  SparseHMM(const arma::vec& initial,
+            const arma::sp_mat& transition,
+            const std::vector<Distribution>& emission,
+            const double tolerance = 1e-5);
+
+  /**
+   * Create a banded transition pattern: a transition from state j to state i
+   * is possible if j - backward <= i <= j + forward.  A left-to-right model
+   * has backward = 0.
+   *
+   * @param states Number of states.
+   * @param backward Number of states each state can move back by.
+   * @param forward Number of states each state can move ahead by.
+   */
+  static arma::sp_mat BandedPattern(const size_t states,
+                                    const size_t backward,
+                                    const size_t forward);
+
+  /**
+   * Train the model using the Baum-Welch algorithm, with only the given
+   * unlabeled observations.  The sequences are processed in parallel if OpenMP
+   * is available.  See HMM::Train() for details.
+   *
+   * @param dataSeq Vector of observation sequences.
+   * @return Log-likelihood of the observation sequences.
+   */
+  double Train(const std::vector<arma::mat>& dataSeq);
+
+  /**
+   * Train the model using the given labeled observations; the transition and
+   * emission distributions are directly estimated.  Every transition in the
+   * state sequences must be in the sparsity pattern.
+   *
+   * @param dataSeq Vector of observation sequences.
+   * @param stateSeq Vector of state sequences, corresponding to each
+   *     observation.
+   */
+  void Train(const std::vector<arma::mat>& dataSeq,
+             const std::vector<arma::Row<size_t>>& stateSeq);
+
+  /**
+   * Estimate the probabilities of each hidden state at each time step for the
+   * given data sequence, using the Forward-Backward algorithm.
+   *
+   * @param dataSeq Sequence of observations.
+   * @param stateProb Matrix in which the probabilities of each state at each
+   *    time interval will be stored.
+   * @return Log-likelihood of the given sequence.
+   */
+  double Estimate(const arma::mat& dataSeq, arma::mat& stateProb) const;
+
+  /**
+   * Generate a random data sequence of the given length.
+   *
+   * @param length Length of the sequence to generate.
+   * @param dataSequence Matrix to store data in.
+   * @param stateSequence Vector to store states in.
+   * @param startState Hidden state to start sequence in (default 0).
+   */
+  void Generate(const size_t length,
+                arma::mat& dataSequence,
+                arma::Row<size_t>& stateSequence,
+                const size_t startState = 0) const;
+
+  /**
+   * Compute the most probable hidden state sequence for the given data
+   * sequence, using the Viterbi algorithm, returning the log-likelihood of the
+   * most likely state sequence.
+   *
+   * @param dataSeq Sequence of observations.
+   * @param stateSeq Vector in which the most probable state sequence will be
+   *    stored.
+   * @return Log-likelihood of most probable state sequence.
+   */
+  double Predict(const arma::mat& dataSeq,
+                 arma::Row<size_t>& stateSeq) const;
+
+  /**
+   * Compute the log-likelihood of the given data sequence.
+   *
+   * @param dataSeq Data sequence to evaluate the likelihood of.
+   * @return Log-likelihood of the given sequence.
+   */
+  double LogLikelihood(const arma::mat& dataSeq) const;
+
+  //! Return the vector of initial state probabilities.
+  arma::vec Initial() const { return arma::exp(logInitial); }
+  //! Return the transition matrix.
+  arma::sp_mat Transition() const;
+
+  //! Get the number of states.
+  size_t States() const { return logInitial.n_elem; }
+  //! Get the number of possible transitions.
+  size_t NumTransitions() const { return rowIndices.n_elem; }
+
+  //! Return the emission distributions.
+  const std::vector<Distribution>& Emission() const { return emission; }
+  //! Return a modifiable emission probability matrix reference.
+  std::vector<Distribution>& Emission() { return emission; }
+
+  //! Get the dimensionality of observations.
+  size_t Dimensionality() const { return dimensionality; }
+  //! Set the dimensionality of observations.
+  size_t& Dimensionality() { return dimensionality; }
+
+  //! Get the tolerance of the Baum-Welch algorithm.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance of the Baum-Welch algorithm.
+  double& Tolerance() { return tolerance; }
+
+  /**
+   * Serialize the object.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  /**
+   * Set the sparsity pattern and the transition probabilities from the given
+   * sparse matrix.
+   */
+  void SetTransition(const arma::sp_mat& transition);
+
+  //! Build the row-wise index of the transitions from the column-wise one.
+  void BuildRowIndex();
+
+  /**
+   * Compute the emission log-probability of each observation for each state.
+   */
+  void EmissionLogProbabilities(const arma::mat& dataSeq,
+                                arma::mat& emissionLogProb) const;
+
+  /**
+   * The Forward algorithm, given the emission log-probabilities.  Only the
+   * possible transitions into each state are visited.
+   */
+  void Forward(const arma::mat& emissionLogProb,
+               arma::vec& logScales,
+               arma::mat& forwardLogProb) const;
+
+  /**
+   * The Backward algorithm, given the emission log-probabilities.  Only the
+   * possible transitions out of each state are visited.
+   */
+  void Backward(const arma::mat& emissionLogProb,
+                const arma::vec& logScales,
+                arma::mat& backwardLogProb) const;
+
+  /**
+   * Add the log of the expected number of each possible transition in one
+   * sequence to logCounts (one element per possible transition).  The old
+   * transition probabilities are not multiplied in.
+   */
+  void AddTransitionLogCounts(const arma::mat& emissionLogProb,
+                              const arma::mat& forwardLogProb,
+                              const arma::mat& backwardLogProb,
+                              const arma::vec& logScales,
+                              arma::vec& logCounts) const;
+
+  //! Normalize the transition probabilities out of each state.
+  void NormalizeTransition();
+
+  //! Set of emission probability distributions; one for each state.
+  std::vector<Distribution> emission;
+
+  //! The log of the initial state probabilities.
+  arma::vec logInitial;
+
+  //! The offset of the possible transitions out of each state in rowIndices
+  //! and logTransition, followed by the number of possible transitions.
+  arma::Col<size_t> colOffsets;
+  //! The destination state of each possible transition, grouped by source
+  //! state.
+  arma::Col<size_t> rowIndices;
+  //! The log-probability of each possible transition.
+  arma::vec logTransition;
+
+  //! The offset of the possible transitions into each state in rowSources and
+  //! rowPositions, followed by the number of possible transitions.
+  arma::Col<size_t> rowOffsets;
+  //! The source state of each possible transition, grouped by destination
+  //! state.
+  arma::Col<size_t> rowSources;
+  //! The index in logTransition of each possible transition, grouped by
+  //! destination state.
+  arma::Col<size_t> rowPositions;
+
+  //! Dimensionality of observations.
+  size_t dimensionality;
+
+  //! Tolerance of Baum-Welch algorithm.
+  double tolerance;
+};
+
+} // namespace hmm
+} // namespace mlpack
+
+// Include implementation.
+#include "sparse_hmm_impl.hpp"
+
+#endif
@@ -0,0 +1,710 @@
+/**
+ * @file methods/hmm/sparse_hmm_impl.hpp
+ *
+ * Implementation of the SparseHMM class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HMM_SPARSE_HMM_IMPL_HPP
+#define MLPACK_METHODS_HMM_SPARSE_HMM_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "sparse_hmm.hpp"
+#include <mlpack/core/math/log_add.hpp>
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace hmm {
+
+template<typename Distribution>
+SparseHMM<Distribution>::SparseHMM(const arma::sp_mat& pattern,
+                                   const Distribution emissions,
+                                   const double tolerance) :
+    emission(pattern.n_rows, /* default distribution */ emissions),
+    dimensionality(emissions.Dimensionality()),
+    tolerance(tolerance)
+{
+  SetTransition(pattern);
+
+  // Choose random transition probabilities on the pattern.
+  logTransition = arma::log(arma::randu<arma::vec>(logTransition.n_elem));
+  NormalizeTransition();
+
+  logInitial.set_size(pattern.n_rows);
+  logInitial.fill(-std::log((double) pattern.n_rows));
+}
+
+template<typename Distribution>
+SparseHMM<Distribution>::SparseHMM(const arma::vec& initial,
+                                   const arma::sp_mat& transition,
+                                   const std::vector<Distribution>& emission,
+                                   const double tolerance) :
+    emission(emission),
+    logInitial(arma::log(initial)),
+    tolerance(tolerance)
+{
+  if (initial.n_elem != transition.n_rows ||
+      emission.size() != transition.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "SparseHMM::SparseHMM(): the number of initial probabilities ("
+        << initial.n_elem << ") and emission distributions ("
+        << emission.size() << ") must both be equal to the number of states ("
+        << transition.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  SetTransition(transition);
+
+  // Set the dimensionality, if we can.
+  dimensionality = (emission.size() > 0) ? emission[0].Dimensionality() : 0;
+}
+
+template<typename Distribution>
+arma::sp_mat SparseHMM<Distribution>::BandedPattern(const size_t states,
+                                                    const size_t backward,
+                                                    const size_t forward)
+{
+  // Count the band of each column first, so the locations can be filled in
+  // column order.
+  size_t nonzeros = 0;
+  for (size_t j = 0; j < states; ++j)
+  {
+    const size_t first = (j > backward) ? j - backward : 0;
+    const size_t last = std::min(j + forward, states - 1);
+    nonzeros += last - first + 1;
+  }
+
+  arma::umat locations(2, nonzeros);
+  size_t k = 0;
+  for (size_t j = 0; j < states; ++j)
+  {
+    const size_t first = (j > backward) ? j - backward : 0;
+    const size_t last = std::min(j + forward, states - 1);
+    for (size_t i = first; i <= last; ++i, ++k)
+    {
+      locations(0, k) = i;
+      locations(1, k) = j;
+    }
+  }
+
+  return arma::sp_mat(locations, arma::ones<arma::vec>(nonzeros), states,
+      states);
+}
+
+template<typename Distribution>
+double SparseHMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
+{
+  const size_t states = logInitial.n_elem;
+  double loglik = 0;
+  double oldLoglik = 0;
+
+  // Maximum iterations?
+  size_t iterations = 1000;
+
+  // Find the offset of each sequence in the list of observations, and ensure
+  // the sequences are the correct size.
+  arma::Col<size_t> offsets(dataSeq.size() + 1);
+  offsets[0] = 0;
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    offsets[seq + 1] = offsets[seq] + dataSeq[seq].n_cols;
+
+    if (dataSeq[seq].n_rows != dimensionality)
+      Log::Fatal << "SparseHMM::Train(): data sequence " << seq << " has "
+          << "dimensionality " << dataSeq[seq].n_rows << " (expected "
+          << dimensionality << " dimensions)." << std::endl;
+  }
+  const size_t totalLength = offsets[dataSeq.size()];
+
+  // These are used later for training of each distribution.
+  std::vector<arma::vec> emissionProb(states, arma::vec(totalLength));
+  arma::mat emissionList(dimensionality, totalLength);
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    if (dataSeq[seq].n_cols > 0)
+      emissionList.cols(offsets[seq], offsets[seq + 1] - 1) = dataSeq[seq];
+  }
+
+  // This is the Baum-Welch algorithm, as in HMM::Train(), but the transition
+  // statistics are only accumulated for the possible transitions.
+  for (size_t iter = 0; iter < iterations; iter++)
+  {
+    arma::vec newLogInitial(states);
+    newLogInitial.fill(-std::numeric_limits<double>::infinity());
+    arma::vec newLogTransition(logTransition.n_elem);
+    newLogTransition.fill(-std::numeric_limits<double>::infinity());
+
+    // Reset log likelihood.
+    loglik = 0;
+
+    // Each thread processes some of the sequences, and accumulates its own
+    // estimates; these are added together at the end.
+    #pragma omp parallel
+    {
+      arma::vec threadLogInitial(states);
+      threadLogInitial.fill(-std::numeric_limits<double>::infinity());
+      arma::vec threadLogTransition(logTransition.n_elem);
+      threadLogTransition.fill(-std::numeric_limits<double>::infinity());
+      double threadLoglik = 0;
+
+      arma::mat emissionLogProb;
+      arma::mat forwardLog;
+      arma::mat backwardLog;
+      arma::vec logScales;
+
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); seq++)
+      {
+        if (dataSeq[seq].n_cols == 0)
+          continue;
+
+        // This is the E-step.
+        EmissionLogProbabilities(dataSeq[seq], emissionLogProb);
+        Forward(emissionLogProb, logScales, forwardLog);
+        Backward(emissionLogProb, logScales, backwardLog);
+        threadLoglik += arma::accu(logScales);
+
+        const arma::mat stateLogProb = forwardLog + backwardLog;
+        math::LogAddInPlace(threadLogInitial, arma::vec(stateLogProb.col(0)));
+
+        // The multiplication by the old transition probabilities is postponed
+        // until later.
+        AddTransitionLogCounts(emissionLogProb, forwardLog, backwardLog,
+            logScales, threadLogTransition);
+
+        // Add to list of emission probabilities, for Distribution::Train().
+        const arma::mat stateProb = arma::exp(stateLogProb);
+        for (size_t j = 0; j < states; ++j)
+        {
+          emissionProb[j].subvec(offsets[seq], offsets[seq + 1] - 1) =
+              stateProb.row(j).t();
+        }
+      }
+
+      #pragma omp critical
+      {
+        loglik += threadLoglik;
+        math::LogAddInPlace(newLogInitial, threadLogInitial);
+        math::LogAddInPlace(newLogTransition, threadLogTransition);
+      }
+    }
+
+    if (std::abs(oldLoglik - loglik) < tolerance)
+    {
+      Log::Debug << "Converged after " << iter << " iterations." << std::endl;
+      break;
+    }
+
+    oldLoglik = loglik;
+
+    // Normalize the new initial probabilities.
+    if (dataSeq.size() > 1)
+      logInitial = newLogInitial - std::log(dataSeq.size());
+    else
+      logInitial = newLogInitial;
+
+    // Multiply in the old transition probabilities, and then normalize.
+    logTransition += newLogTransition;
+    NormalizeTransition();
+
+    // Now estimate emission probabilities.
+    for (size_t state = 0; state < states; state++)
+      emission[state].Train(emissionList, emissionProb[state]);
+
+    Log::Debug << "Iteration " << iter << ": log-likelihood " << loglik
+        << "." << std::endl;
+  }
+
+  return loglik;
+}
+
+template<typename Distribution>
+void SparseHMM<Distribution>::Train(
+    const std::vector<arma::mat>& dataSeq,
+    const std::vector<arma::Row<size_t>>& stateSeq)
+{
+  // Simple error checking.
+  if (dataSeq.size() != stateSeq.size())
+  {
+    Log::Fatal << "SparseHMM::Train(): number of data sequences ("
+        << dataSeq.size() << ") not equal to number of state sequences ("
+        << stateSeq.size() << ")." << std::endl;
+  }
+
+  const size_t states = logInitial.n_elem;
+  arma::vec initial(states, arma::fill::zeros);
+  arma::vec transition(logTransition.n_elem, arma::fill::zeros);
+
+  // Estimate the transition and emission distributions directly from the
+  // observations.  The emission list holds the time indices for observations
+  // from each state.
+  std::vector<std::vector<std::pair<size_t, size_t>>> emissionList(states);
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    // Simple error checking.
+    if (dataSeq[seq].n_cols != stateSeq[seq].n_elem)
+    {
+      Log::Fatal << "SparseHMM::Train(): number of observations ("
+          << dataSeq[seq].n_cols << ") in sequence " << seq
+          << " not equal to number of states (" << stateSeq[seq].n_elem
+          << ") in sequence " << seq << "." << std::endl;
+    }
+
+    if (dataSeq[seq].n_rows != dimensionality)
+    {
+      Log::Fatal << "SparseHMM::Train(): data sequence " << seq << " has "
+          << "dimensionality " << dataSeq[seq].n_rows << " (expected "
+          << dimensionality << " dimensions)." << std::endl;
+    }
+
+    if (stateSeq[seq].n_elem == 0)
+      continue;
+
+    initial[stateSeq[seq][0]]++;
+    for (size_t t = 0; t < stateSeq[seq].n_elem; t++)
+    {
+      emissionList[stateSeq[seq][t]].push_back(std::make_pair(seq, t));
+      if (t + 1 == stateSeq[seq].n_elem)
+        break;
+
+      // Find the transition in the pattern; the destinations of each source
+      // state are sorted.
+      const size_t from = stateSeq[seq][t];
+      const size_t to = stateSeq[seq][t + 1];
+      const size_t* begin = rowIndices.memptr() + colOffsets[from];
+      const size_t* end = rowIndices.memptr() + colOffsets[from + 1];
+      const size_t* position = std::lower_bound(begin, end, to);
+      if (position == end || *position != to)
+      {
+        Log::Fatal << "SparseHMM::Train(): the transition from state " << from
+            << " to state " << to << " in sequence " << seq << " is not in "
+            << "the sparsity pattern." << std::endl;
+      }
+
+      transition[position - rowIndices.memptr()]++;
+    }
+  }
+
+  // Normalize initial weights.
+  initial /= arma::accu(initial);
+  logInitial = arma::log(initial);
+
+  // Normalize the transitions out of each state.  If there are none, we want
+  // to avoid division by 0.
+  for (size_t j = 0; j < states; ++j)
+  {
+    if (colOffsets[j + 1] == colOffsets[j])
+      continue;
+
+    const double sum = arma::accu(
+        transition.subvec(colOffsets[j], colOffsets[j + 1] - 1));
+    if (sum > 0)
+      transition.subvec(colOffsets[j], colOffsets[j + 1] - 1) /= sum;
+  }
+  logTransition = arma::log(transition);
+
+  // Estimate emission distributions.
+  for (size_t state = 0; state < states; state++)
+  {
+    if (emissionList[state].size() > 0)
+    {
+      arma::mat emissions(dimensionality, emissionList[state].size());
+      for (size_t i = 0; i < emissions.n_cols; i++)
+      {
+        emissions.col(i) = dataSeq[emissionList[state][i].first].col(
+            emissionList[state][i].second);
+      }
+
+      emission[state].Train(emissions);
+    }
+    else
+    {
+      Log::Warn << "There are no observations in training data with hidden "
+          << "state " << state << "!  The corresponding emission distribution "
+          << "is likely to be meaningless." << std::endl;
+    }
+  }
+}
+
+template<typename Distribution>
+double SparseHMM<Distribution>::Estimate(const arma::mat& dataSeq,
+                                         arma::mat& stateProb) const
+{
+  arma::mat emissionLogProb;
+  arma::mat forwardLogProb;
+  arma::mat backwardLogProb;
+  arma::vec logScales;
+
+  EmissionLogProbabilities(dataSeq, emissionLogProb);
+  Forward(emissionLogProb, logScales, forwardLogProb);
+  Backward(emissionLogProb, logScales, backwardLogProb);
+
+  stateProb = arma::exp(forwardLogProb + backwardLogProb);
+  return arma::accu(logScales);
+}
+
+template<typename Distribution>
+void SparseHMM<Distribution>::Generate(const size_t length,
+                                       arma::mat& dataSequence,
+                                       arma::Row<size_t>& stateSequence,
+                                       const size_t startState) const
+{
+  // Set vectors to the right size.
+  stateSequence.set_size(length);
+  dataSequence.set_size(dimensionality, length);
+  if (length == 0)
+    return;
+
+  // Set start state (default is 0), and choose the first emission.
+  stateSequence[0] = startState;
+  dataSequence.col(0) = emission[startState].Random();
+
+  // Now choose the states and emissions for the rest of the sequence.
+  for (size_t t = 1; t < length; t++)
+  {
+    // Find where our random value sits in the probability distribution of
+    // the transitions out of the previous state.
+    const size_t previous = stateSequence[t - 1];
+    const double randValue = math::Random();
+    double probSum = 0;
+    stateSequence[t] = rowIndices[colOffsets[previous + 1] - 1];
+    for (size_t k = colOffsets[previous]; k < colOffsets[previous + 1]; ++k)
+    {
+      probSum += std::exp(logTransition[k]);
+      if (randValue <= probSum)
+      {
+        stateSequence[t] = rowIndices[k];
+        break;
+      }
+    }
+
+    // Now choose the emission.
+    dataSequence.col(t) = emission[stateSequence[t]].Random();
+  }
+}
+
+template<typename Distribution>
+double SparseHMM<Distribution>::Predict(const arma::mat& dataSeq,
+                                        arma::Row<size_t>& stateSeq) const
+{
+  // This is the Viterbi algorithm, as in HMM::Predict(), but only the possible
+  // transitions into each state are considered.
+  const size_t states = logInitial.n_elem;
+  const size_t length = dataSeq.n_cols;
+  stateSeq.set_size(length);
+  if (length == 0)
+    return 0.0;
+
+  arma::mat emissionLogProb;
+  EmissionLogProbabilities(dataSeq, emissionLogProb);
+
+  arma::mat logStateProb(states, length);
+  arma::Mat<size_t> stateSeqBack(states, length);
+  logStateProb.col(0) = logInitial + emissionLogProb.col(0);
+  for (size_t state = 0; state < states; state++)
+    stateSeqBack(state, 0) = state;
+
+  for (size_t t = 1; t < length; t++)
+  {
+    for (size_t i = 0; i < states; i++)
+    {
+      // Given that we are in state i, use the possible previous state with
+      // the highest probability.
+      double best = -std::numeric_limits<double>::infinity();
+      size_t index = (rowOffsets[i] < rowOffsets[i + 1]) ?
+          rowSources[rowOffsets[i]] : i;
+      for (size_t p = rowOffsets[i]; p < rowOffsets[i + 1]; ++p)
+      {
+        const double prob = logStateProb(rowSources[p], t - 1) +
+            logTransition[rowPositions[p]];
+        if (prob > best)
+        {
+          best = prob;
+          index = rowSources[p];
+        }
+      }
+
+      logStateProb(i, t) = best + emissionLogProb(i, t);
+      stateSeqBack(i, t) = index;
+    }
+  }
+
+  // Backtrack to find the most probable state sequence.
+  arma::uword index;
+  logStateProb.unsafe_col(length - 1).max(index);
+  stateSeq[length - 1] = index;
+  for (size_t t = 2; t <= length; t++)
+  {
+    stateSeq[length - t] =
+        stateSeqBack(stateSeq[length - t + 1], length - t + 1);
+  }
+
+  return logStateProb(stateSeq[length - 1], length - 1);
+}
+
+template<typename Distribution>
+double SparseHMM<Distribution>::LogLikelihood(const arma::mat& dataSeq) const
+{
+  arma::mat emissionLogProb;
+  arma::mat forwardLogProb;
+  arma::vec logScales;
+
+  EmissionLogProbabilities(dataSeq, emissionLogProb);
+  Forward(emissionLogProb, logScales, forwardLogProb);
+
+  // The log-likelihood is the log of the scales for each time step.
+  return arma::accu(logScales);
+}
+
+template<typename Distribution>
+arma::sp_mat SparseHMM<Distribution>::Transition() const
+{
+  const size_t states = logInitial.n_elem;
+  arma::umat locations(2, rowIndices.n_elem);
+  for (size_t j = 0; j < states; ++j)
+  {
+    for (size_t k = colOffsets[j]; k < colOffsets[j + 1]; ++k)
+    {
+      locations(0, k) = rowIndices[k];
+      locations(1, k) = j;
+    }
+  }
+
+  return arma::sp_mat(locations, arma::exp(logTransition), states, states);
+}
+
+template<typename Distribution>
+void SparseHMM<Distribution>::SetTransition(const arma::sp_mat& transition)
+{
+  if (transition.n_rows != transition.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "SparseHMM::SetTransition(): the transition matrix must be square "
+        << "(it is " << transition.n_rows << " x " << transition.n_cols
+        << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Store the transitions column by column; within each column, the
+  // destination states are sorted.
+  const size_t states = transition.n_cols;
+  colOffsets.set_size(states + 1);
+  colOffsets[0] = 0;
+  rowIndices.set_size(transition.n_nonzero);
+  logTransition.set_size(transition.n_nonzero);
+
+  size_t k = 0;
+  for (size_t j = 0; j < states; ++j)
+  {
+    for (arma::sp_mat::const_col_iterator it = transition.begin_col(j);
+         it != transition.end_col(j); ++it, ++k)
+    {
+      rowIndices[k] = it.row();
+      logTransition[k] = std::log(*it);
+    }
+
+    colOffsets[j + 1] = k;
+    if (colOffsets[j + 1] == colOffsets[j])
+    {
+      std::ostringstream oss;
+      oss << "SparseHMM::SetTransition(): state " << j << " has no possible "
+          << "transitions!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  BuildRowIndex();
+}
+
+template<typename Distribution>
+void SparseHMM<Distribution>::BuildRowIndex()
+{
+  const size_t states = colOffsets.n_elem - 1;
+
+  // Count the transitions into each state, and then place them in order.
+  rowOffsets.zeros(states + 1);
+  for (size_t k = 0; k < rowIndices.n_elem; ++k)
+    ++rowOffsets[rowIndices[k] + 1];
+  rowOffsets = arma::cumsum(rowOffsets);
+
+  rowSources.set_size(rowIndices.n_elem);
+  rowPositions.set_size(rowIndices.n_elem);
+  arma::Col<size_t> next = rowOffsets.head(states);
+  for (size_t j = 0; j < states; ++j)
+  {
+    for (size_t k = colOffsets[j]; k < colOffsets[j + 1]; ++k)
+    {
+      const size_t p = next[rowIndices[k]]++;
+      rowSources[p] = j;
+      rowPositions[p] = k;
+    }
+  }
+}
+
+template<typename Distribution>
+void SparseHMM<Distribution>::EmissionLogProbabilities(
+    const arma::mat& dataSeq,
+    arma::mat& emissionLogProb) const
+{
+  emissionLogProb.set_size(logInitial.n_elem, dataSeq.n_cols);
+  for (size_t t = 0; t < dataSeq.n_cols; t++)
+  {
+    for (size_t state = 0; state < logInitial.n_elem; state++)
+    {
+      emissionLogProb(state, t) =
+          emission[state].LogProbability(dataSeq.unsafe_col(t));
+    }
+  }
+}
+
+template<typename Distribution>
+void SparseHMM<Distribution>::Forward(const arma::mat& emissionLogProb,
+                                      arma::vec& logScales,
+                                      arma::mat& forwardLogProb) const
+{
+  const size_t states = logInitial.n_elem;
+  const size_t length = emissionLogProb.n_cols;
+  forwardLogProb.set_size(states, length);
+  logScales.set_size(length);
+
+  for (size_t t = 0; t < length; t++)
+  {
+    if (t == 0)
+    {
+      // The first entry uses the initial state probabilities.
+      forwardLogProb.col(0) = logInitial + emissionLogProb.col(0);
+    }
+    else
+    {
+      // The forward probability of state i at time t is the sum over the
+      // possible previous states of the probability of the previous state
+      // transitioning to state i, times the probability of state i emitting
+      // the given observation.
+      for (size_t i = 0; i < states; i++)
+      {
+        double sum = -std::numeric_limits<double>::infinity();
+        for (size_t p = rowOffsets[i]; p < rowOffsets[i + 1]; ++p)
+        {
+          sum = math::LogAdd(sum, forwardLogProb(rowSources[p], t - 1) +
+              logTransition[rowPositions[p]]);
+        }
+
+        forwardLogProb(i, t) = sum + emissionLogProb(i, t);
+      }
+    }
+
+    // Normalize probability.
+    logScales[t] = math::AccuLog(forwardLogProb.unsafe_col(t));
+    if (std::isfinite(logScales[t]))
+      forwardLogProb.col(t) -= logScales[t];
+  }
+}
+
+template<typename Distribution>
+void SparseHMM<Distribution>::Backward(const arma::mat& emissionLogProb,
+                                       const arma::vec& logScales,
+                                       arma::mat& backwardLogProb) const
+{
+  const size_t states = logInitial.n_elem;
+  const size_t length = emissionLogProb.n_cols;
+  backwardLogProb.set_size(states, length);
+  if (length == 0)
+    return;
+
+  // The last element probability is 1.
+  backwardLogProb.col(length - 1).zeros();
+
+  // Now step backwards through all other observations.
+  for (size_t t = length - 1; t > 0; t--)
+  {
+    for (size_t j = 0; j < states; j++)
+    {
+      // The backward probability of state j at time t - 1 is the sum over the
+      // possible next states of the probability of the transition, times the
+      // probability of the next state emitting the next observation.
+      double sum = -std::numeric_limits<double>::infinity();
+      for (size_t k = colOffsets[j]; k < colOffsets[j + 1]; ++k)
+      {
+        const size_t i = rowIndices[k];
+        sum = math::LogAdd(sum, logTransition[k] + backwardLogProb(i, t) +
+            emissionLogProb(i, t));
+      }
+
+      // Normalize by the weights from the forward algorithm.
+      backwardLogProb(j, t - 1) =
+          std::isfinite(logScales[t]) ? sum - logScales[t] : sum;
+    }
+  }
+}
+
+template<typename Distribution>
+void SparseHMM<Distribution>::AddTransitionLogCounts(
+    const arma::mat& emissionLogProb,
+    const arma::mat& forwardLogProb,
+    const arma::mat& backwardLogProb,
+    const arma::vec& logScales,
+    arma::vec& logCounts) const
+{
+  const size_t states = logInitial.n_elem;
+  for (size_t t = 0; t + 1 < emissionLogProb.n_cols; t++)
+  {
+    for (size_t j = 0; j < states; j++)
+    {
+      // The probability of a transition from state j at time t to state i at
+      // time t + 1.
+      for (size_t k = colOffsets[j]; k < colOffsets[j + 1]; ++k)
+      {
+        const size_t i = rowIndices[k];
+        logCounts[k] = math::LogAdd(logCounts[k], forwardLogProb(j, t) +
+            backwardLogProb(i, t + 1) + emissionLogProb(i, t + 1) -
+            logScales[t + 1]);
+      }
+    }
+  }
+}
+
+template<typename Distribution>
+void SparseHMM<Distribution>::NormalizeTransition()
+{
+  for (size_t j = 0; j + 1 < colOffsets.n_elem; ++j)
+  {
+    const size_t first = colOffsets[j];
+    const size_t count = colOffsets[j + 1] - first;
+    if (count == 0)
+      continue;
+
+    const size_t last = first + count - 1;
+    const double sum = math::AccuLog(logTransition.subvec(first, last));
+    if (std::isfinite(sum))
+      logTransition.subvec(first, last) -= sum;
+    else
+      logTransition.subvec(first, last).fill(-std::log((double) count));
+  }
+}
+
+template<typename Distribution>
+template<typename Archive>
+void SparseHMM<Distribution>::serialize(Archive& ar,
+                                        const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(dimensionality));
+  ar(CEREAL_NVP(tolerance));
+  ar(CEREAL_NVP(logInitial));
+  ar(CEREAL_NVP(colOffsets));
+  ar(CEREAL_NVP(rowIndices));
+  ar(CEREAL_NVP(logTransition));
+  ar(CEREAL_NVP(emission));
+
+  // The row-wise index is not saved; it can be rebuilt from the pattern.
+  if (cereal::is_loading<Archive>())
+    BuildRowIndex();
+}
+
+} // namespace hmm
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,221 @@
+/**
+ * @file methods/hnsw/hnsw_main.cpp
+ *
+ * This file computes approximate nearest neighbors with a hierarchical
+ * navigable small world graph.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/io.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+#include "hnsw_search.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+using namespace mlpack::util;
+
+// Program Name.
+BINDING_NAME("K-Approximate-Nearest-Neighbor Search with HNSW");
+
+// Short description.
+BINDING_SHORT_DESC(
+    "An implementation of approximate k-nearest-neighbor search with a "
+    "hierarchical navigable small world (HNSW) graph.  Given a set of "
+    "reference points and a set of query points, this will compute the k "
+    "approximate nearest neighbors of each query point in the reference set; "
+    "models can be saved for future use.");
+
+// Long description.
+BINDING_LONG_DESC(
+    "This program will calculate the k approximate-nearest-neighbors of a set "
+    "of points using a hierarchical navigable small world (HNSW) graph.  You "
+    "may specify a separate set of reference points and query points, or just a"
+    " reference set which will be used as both the reference and query set."
+    "\n\n"
+    "The graph is controlled by two parameters: " +
+    PRINT_PARAM_STRING("max_connections") + " is the number of links each "
+    "point gets when it is inserted, and " +
+    PRINT_PARAM_STRING("ef_construction") + " is the number of candidates "
+    "considered when those links are chosen.  Larger values of either give a "
+    "better graph that takes longer to build.  At search time, " +
+    PRINT_PARAM_STRING("ef") + " is the number of candidates kept by the "
+    "search; larger values give a higher recall and slower queries.  It can be "
+    "changed when a saved model is used.");
+
+// Example.
+BINDING_EXAMPLE(
+    "For example, the following will return 5 neighbors from the data for each "
+    "point in " + PRINT_DATASET("input") + " and store the distances in " +
+    PRINT_DATASET("distances") + " and the neighbors in " +
+    PRINT_DATASET("neighbors") + ":"
+    "\n\n" +
+    PRINT_CALL("hnsw", "k", 5, "reference", "input", "distances", "distances",
+        "neighbors", "neighbors") +
+    "\n\n"
+    "The output is organized such that row i and column j in the neighbors "
+    "output corresponds to the index of the point in the reference set which "
+    "is the j'th nearest neighbor from the point in the query set with index "
+    "i.  Row j and column i in the distances output file corresponds to the "
+    "distance between those two points."
+    "\n\n"
+    "Because the graph is built randomly, results may be different from run to "
+    "run.  The " + PRINT_PARAM_STRING("seed") + " parameter can be specified "
+    "to set the random seed; the graph only depends on the seed when a single "
+    "thread is used.");
+
+// See also...
+BINDING_SEE_ALSO("@knn", "#knn");
+BINDING_SEE_ALSO("@lsh", "#lsh");
+BINDING_SEE_ALSO("Efficient and robust approximate nearest neighbor search "
+        "using hierarchical navigable small world graphs (pdf)",
+        "https://arxiv.org/pdf/1603.09320.pdf");
+BINDING_SEE_ALSO("mlpack::neighbor::HNSWSearch C++ class documentation",
+        "@doxygen/classmlpack_1_1neighbor_1_1HNSWSearch.html");
+
+// Define our input parameters that this program will take.
+PARAM_MATRIX_IN("reference", "Matrix containing the reference dataset.", "r");
+PARAM_MATRIX_OUT("distances", "Matrix to output distances into.", "d");
+PARAM_UMATRIX_OUT("neighbors", "Matrix to output neighbors into.", "n");
+
+// We can load or save models.
+PARAM_MODEL_IN(HNSWSearch<>, "input_model", "Input HNSW model.", "m");
+PARAM_MODEL_OUT(HNSWSearch<>, "output_model", "Output for trained HNSW model.",
+    "M");
+
+// For testing recall.
+PARAM_UMATRIX_IN("true_neighbors", "Matrix of true neighbors to compute "
+    "recall with (the recall is printed when -v is specified).", "t");
+
+PARAM_INT_IN("k", "Number of nearest neighbors to find.", "k", 0);
+PARAM_MATRIX_IN("query", "Matrix containing query points (optional).", "q");
+
+PARAM_INT_IN("max_connections", "The number of links each point gets when it "
+    "is inserted into a layer of the graph.", "c", 16);
+PARAM_INT_IN("ef_construction", "The number of candidates considered when the "
+    "links of a point are chosen.", "E", 200);
+PARAM_INT_IN("ef", "The number of candidates kept by each search.", "e", 50);
+PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
+
+static void mlpackMain()
+{
+  if (IO::GetParam<int>("seed") != 0)
+    math::RandomSeed((size_t) IO::GetParam<int>("seed"));
+  else
+    math::RandomSeed((size_t) time(NULL));
+
+  // Get all the parameters after checking them.
+  if (IO::HasParam("k"))
+  {
+    RequireParamValue<int>("k", [](int x) { return x > 0; }, true,
+        "k must be greater than 0");
+  }
+  RequireParamValue<int>("max_connections", [](int x) { return x > 0; }, true,
+      "number of connections must be greater than 0");
+  RequireParamValue<int>("ef_construction", [](int x) { return x > 0; }, true,
+      "ef_construction must be greater than 0");
+  RequireParamValue<int>("ef", [](int x) { return x > 0; }, true,
+      "ef must be greater than 0");
+
+  const size_t k = IO::GetParam<int>("k");
+
+  RequireOnlyOnePassed({ "input_model", "reference" }, true);
+  RequireAtLeastOnePassed({ "neighbors", "distances", "output_model" }, false,
+      "no results will be saved");
+
+  ReportIgnoredParam({{ "k", false }}, "neighbors");
+  ReportIgnoredParam({{ "k", false }}, "distances");
+  ReportIgnoredParam({{ "k", false }}, "true_neighbors");
+
+  ReportIgnoredParam({{ "reference", false }}, "max_connections");
+  ReportIgnoredParam({{ "reference", false }}, "ef_construction");
+
+  if (IO::HasParam("input_model") && !IO::HasParam("k"))
+  {
+    Log::Warn << PRINT_PARAM_STRING("k") << " not passed; no search will be "
+        << "performed!" << std::endl;
+  }
+
+  HNSWSearch<>* hnsw;
+  if (IO::HasParam("reference"))
+  {
+    hnsw = new HNSWSearch<>(IO::GetParam<int>("max_connections"),
+        IO::GetParam<int>("ef_construction"), IO::GetParam<int>("ef"));
+    Log::Info << "Using reference data from "
+        << IO::GetPrintableParam<arma::mat>("reference") << "." << endl;
+    arma::mat referenceData = std::move(IO::GetParam<arma::mat>("reference"));
+
+    Timer::Start("graph_building");
+    hnsw->Train(std::move(referenceData));
+    Timer::Stop("graph_building");
+
+    Log::Info << "Built a graph with " << hnsw->MaxLevel() + 1 << " layers."
+        << endl;
+  }
+  else // We must have an input model.
+  {
+    hnsw = IO::GetParam<HNSWSearch<>*>("input_model");
+    if (IO::HasParam("ef"))
+      hnsw->Ef() = (size_t) IO::GetParam<int>("ef");
+  }
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  if (IO::HasParam("k"))
+  {
+    Log::Info << "Computing " << k << " approximate nearest neighbors." << endl;
+
+    Timer::Start("computing_neighbors");
+    if (IO::HasParam("query"))
+    {
+      Log::Info << "Loaded query data from "
+          << IO::GetPrintableParam<arma::mat>("query") << "." << endl;
+      const arma::mat& queryData = IO::GetParam<arma::mat>("query");
+
+      hnsw->Search(queryData, k, neighbors, distances);
+    }
+    else
+    {
+      hnsw->Search(k, neighbors, distances);
+    }
+    Timer::Stop("computing_neighbors");
+
+    Log::Info << "Neighbors computed with " << hnsw->DistanceEvaluations()
+        << " distance evaluations in total." << endl;
+
+    // Compute recall, if desired.
+    if (IO::HasParam("true_neighbors"))
+    {
+      Log::Info << "Using true neighbor indices from '"
+          << IO::GetPrintableParam<arma::Mat<size_t>>("true_neighbors") << "'."
+          << endl;
+
+      const arma::Mat<size_t>& trueNeighbors =
+          IO::GetParam<arma::Mat<size_t>>("true_neighbors");
+
+      if (trueNeighbors.n_rows != neighbors.n_rows ||
+          trueNeighbors.n_cols != neighbors.n_cols)
+      {
+        // Delete the model if needed.
+        if (IO::HasParam("reference"))
+          delete hnsw;
+        Log::Fatal << "The true neighbors file must have the same number of "
+            << "values as the set of neighbors being queried!" << endl;
+      }
+
+      Log::Info << "Recall: "
+          << 100 * hnsw->ComputeRecall(neighbors, trueNeighbors) << endl;
+    }
+
+    IO::GetParam<arma::mat>("distances") = std::move(distances);
+    IO::GetParam<arma::Mat<size_t>>("neighbors") = std::move(neighbors);
+  }
+
+  IO::GetParam<HNSWSearch<>*>("output_model") = hnsw;
+}
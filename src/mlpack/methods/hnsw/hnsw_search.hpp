@@ -0,0 +1,360 @@
+/**
+ * @file methods/hnsw/hnsw_search.hpp
+ *
+ * Defines the HNSWSearch class, which performs approximate nearest neighbor
+ * search with a hierarchical navigable small world graph.
+ *
+ * The details of this method can be found in the following paper:
+ *
+ * @code
+ * @article{malkov2020efficient,
+ *   title={Efficient and robust approximate nearest neighbor search using
+ *       hierarchical navigable small world graphs},
+ *   author={Malkov, Yu A. and Yashunin, Dmitry A.},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={42},
+ *   number={4},
+ *   pages={824--836},
+ *   year={2020}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_SEARCH_HPP
+#define MLPACK_METHODS_HNSW_HNSW_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+#include <mutex>
+#include <queue>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The HNSWSearch class builds a hierarchical navigable small world (HNSW) graph
+ * on the reference set, and uses it to find approximate nearest neighbors of
+ * query points.
+ *
+ * Every point of the reference set is a node of the bottom layer of the graph,
+ * and belongs to each layer above it with a probability that decreases
+ * exponentially.  In every layer, each node is linked to a small set of nearby
+ * nodes.  A search descends greedily from the single node of the top layer to
+ * the bottom layer, and then explores the bottom layer with a beam search that
+ * keeps the best 'ef' candidates; larger values of 'ef' give a higher recall
+ * and slower queries.
+ *
+ * The points are inserted into the graph in parallel if OpenMP is available;
+ * the graph (but not its quality) then depends on the number of threads.
+ * Queries are also processed in parallel.
+ *
+ * @code
+ * extern arma::mat referenceSet, querySet;
+ *
+ * // Build the graph, and find the 5 approximate nearest neighbors of each
+ * // query point.
+ * HNSWSearch<> hnsw(referenceSet);
+ * arma::Mat<size_t> neighbors;
+ * arma::mat distances;
+ * hnsw.Search(querySet, 5, neighbors, distances);
+ * @endcode
+ *
+ * @tparam MetricType The metric to use for computation.
+ * @tparam MatType Type of matrix to use to store the data.
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         typename MatType = arma::mat>
+class HNSWSearch
+{
+ public:
+  /**
+   * Build the HNSW graph on the given reference set.  In order to avoid
+   * copying the reference set, it is suggested to pass that parameter with
+   * std::move().
+   *
+   * @param referenceSet Set of reference points.
+   * @param maxConnections Number of links that each node gets when it is
+   *     inserted into a layer (M in the paper); nodes of the bottom layer may
+   *     have twice as many links.  Anything between 8 and 48 is reasonable.
+   * @param efConstruction Size of the candidate list used to find the links of
+   *     each node when the graph is built.
+   * @param ef Size of the candidate list used by searches.  It is increased to
+   *     the number of requested neighbors if it is smaller.
+   * @param metric An optional instantiated metric.
+   */
+  HNSWSearch(MatType referenceSet,
+             const size_t maxConnections = 16,
+             const size_t efConstruction = 200,
+             const size_t ef = 50,
+             const MetricType metric = MetricType());
+
+  /**
+   * Create an HNSWSearch object without a reference set.  Be sure to call
+   * Train() before calling Search(); otherwise, an exception will be thrown
+   * when Search() is called.
+   *
+   * @param maxConnections Number of links that each node gets when it is
+   *     inserted into a layer (M in the paper); nodes of the bottom layer may
+   *     have twice as many links.
+   * @param efConstruction Size of the candidate list used to find the links of
+   *     each node when the graph is built.
+   * @param ef Size of the candidate list used by searches.
+   * @param metric An optional instantiated metric.
+   */
+  HNSWSearch(const size_t maxConnections = 16,
+             const size_t efConstruction = 200,
+             const size_t ef = 50,
+             const MetricType metric = MetricType());
+
+  /**
+   * Set the reference set to a new reference set, and build the HNSW graph on
+   * it.  In order to avoid copying the reference set, consider passing that
+   * parameter with std::move().
+   *
+   * @param referenceSet New set of reference data.
+   */
+  void Train(MatType referenceSet);
+
+  /**
+   * Compute the approximate nearest neighbors of each point in the given query
+   * set and store the output in the given matrices.  The matrices will be set
+   * to the size of n columns by k rows, where n is the number of points in the
+   * query dataset and k is the number of neighbors being searched for.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  /**
+   * Compute the approximate nearest neighbors of each point in the reference
+   * set (a point is not its own neighbor), and store the output in the given
+   * matrices.  The matrices will be set to the size of n columns by k rows,
+   * where n is the number of points in the reference dataset and k is the
+   * number of neighbors being searched for.
+   *
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each point.
+   * @param distances Matrix storing distances of neighbors for each point.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  /**
+   * Compute the recall (% of neighbors found) given the neighbors returned by
+   * HNSWSearch::Search() and a "ground truth" set of neighbors.  The recall
+   * returned will be in the range [0, 1].
+   *
+   * @param foundNeighbors Set of neighbors to compute recall of.
+   * @param realNeighbors Set of "ground truth" neighbors to compute recall
+   *     against.
+   */
+  static double ComputeRecall(const arma::Mat<size_t>& foundNeighbors,
+                              const arma::Mat<size_t>& realNeighbors);
+
+  //! Return the reference dataset.
+  const MatType& ReferenceSet() const { return referenceSet; }
+
+  //! Get the number of links that each node gets when it is inserted.
+  size_t MaxConnections() const { return maxConnections; }
+  //! Get the size of the candidate list used to build the graph.
+  size_t EfConstruction() const { return efConstruction; }
+
+  //! Get the size of the candidate list used by searches.
+  size_t Ef() const { return ef; }
+  //! Modify the size of the candidate list used by searches.
+  size_t& Ef() { return ef; }
+
+  //! Get the highest layer of the graph.
+  size_t MaxLevel() const { return maxLevel; }
+  //! Get the index of the point at which every search starts.
+  size_t EntryPoint() const { return entryPoint; }
+
+  //! Get the highest layer that the given point belongs to.
+  size_t Level(const size_t point) const { return graph[point].size() - 1; }
+  //! Get the links of the given point in the given layer.
+  const std::vector<size_t>& Links(const size_t point,
+                                   const size_t level) const
+  { return graph[point][level]; }
+
+  //! Get the maximum number of links of a node in the given layer.
+  size_t MaxLinks(const size_t level) const
+  { return (level == 0) ? 2 * maxConnections : maxConnections; }
+
+  //! Get the number of distance evaluations performed.
+  size_t DistanceEvaluations() const { return distanceEvaluations; }
+  //! Modify the number of distance evaluations performed.
+  size_t& DistanceEvaluations() { return distanceEvaluations; }
+
+  //! Get the metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the metric.
+  MetricType& Metric() { return metric; }
+
+  /**
+   * Serialize the HNSW model.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! A point in a candidate list: its distance, then its index.
+  typedef std::pair<double, size_t> Candidate;
+
+  /**
+   * Insert the given point into every layer of the graph up to its level,
+   * while other points may be inserted concurrently.
+   *
+   * @param point Index of the point to insert.
+   * @param locks One lock for the links of each point.
+   * @param entryLock Lock for the entry point and the highest layer.
+   * @param visited Visit marks of the calling thread.
+   * @param tag Last visit mark used by the calling thread.
+   * @param evaluations Incremented for each distance evaluation.
+   */
+  void InsertPoint(const size_t point,
+                   std::vector<std::mutex>& locks,
+                   std::mutex& entryLock,
+                   std::vector<size_t>& visited,
+                   size_t& tag,
+                   size_t& evaluations);
+
+  /**
+   * Add a link from one point to another in the given layer.  If the point
+   * then has too many links, the worst ones are dropped with the neighbor
+   * selection heuristic.
+   *
+   * @param from Index of the point that gets the link.
+   * @param to Index of the point being linked to.
+   * @param level Layer of the link.
+   * @param locks One lock for the links of each point.
+   * @param evaluations Incremented for each distance evaluation.
+   */
+  void Connect(const size_t from,
+               const size_t to,
+               const size_t level,
+               std::vector<std::mutex>& locks,
+               size_t& evaluations);
+
+  /**
+   * Select at most the given number of neighbors from the given candidates,
+   * which must be sorted by distance.  A candidate is skipped if it is closer
+   * to an already selected neighbor than to the point itself, which keeps the
+   * links spread out in every direction.
+   *
+   * @param candidates Candidates, sorted by distance.
+   * @param maxNeighbors Maximum number of neighbors to select.
+   * @param selected Filled with the indices of the selected neighbors.
+   * @param evaluations Incremented for each distance evaluation.
+   */
+  void SelectNeighbors(const std::vector<Candidate>& candidates,
+                       const size_t maxNeighbors,
+                       std::vector<size_t>& selected,
+                       size_t& evaluations);
+
+  /**
+   * Move greedily from the given point of the given layer to the neighbor
+   * closest to the query, until no neighbor is closer.
+   *
+   * @param query The query point.
+   * @param current The starting point; on return, the point that was reached.
+   * @param currentDistance Distance between the query and the current point.
+   * @param level Layer in which to search.
+   * @param locks Locks for the links of each point, or NULL if the graph is
+   *     not being modified.
+   * @param evaluations Incremented for each distance evaluation.
+   */
+  template<typename VecType>
+  void GreedySearch(const VecType& query,
+                    size_t& current,
+                    double& currentDistance,
+                    const size_t level,
+                    std::vector<std::mutex>* locks,
+                    size_t& evaluations);
+
+  /**
+   * Search the given layer for the nearest neighbors of the query with a beam
+   * search, starting from the given candidates.
+   *
+   * @param query The query point.
+   * @param candidates Starting points; on return, the (at most) numCandidates
+   *     nearest points that were found, sorted by distance.
+   * @param numCandidates Number of candidates to keep.
+   * @param level Layer in which to search.
+   * @param visited Visit marks of the calling thread.
+   * @param tag Visit mark to use for this search; it must be different from
+   *     every mark that was used before.
+   * @param locks Locks for the links of each point, or NULL if the graph is
+   *     not being modified.
+   * @param evaluations Incremented for each distance evaluation.
+   */
+  template<typename VecType>
+  void SearchLayer(const VecType& query,
+                   std::vector<Candidate>& candidates,
+                   const size_t numCandidates,
+                   const size_t level,
+                   std::vector<size_t>& visited,
+                   const size_t tag,
+                   std::vector<std::mutex>* locks,
+                   size_t& evaluations);
+
+  /**
+   * Find the (at most) numCandidates nearest points of the whole graph to the
+   * query, sorted by distance.
+   *
+   * @param query The query point.
+   * @param numCandidates Number of candidates to keep.
+   * @param results Filled with the nearest points that were found.
+   * @param visited Visit marks of the calling thread.
+   * @param tag Last visit mark used by the calling thread.
+   * @param evaluations Incremented for each distance evaluation.
+   */
+  template<typename VecType>
+  void SearchPoint(const VecType& query,
+                   const size_t numCandidates,
+                   std::vector<Candidate>& results,
+                   std::vector<size_t>& visited,
+                   size_t& tag,
+                   size_t& evaluations);
+
+  //! Reference dataset.
+  MatType referenceSet;
+  //! Number of links that each node gets when it is inserted into a layer.
+  size_t maxConnections;
+  //! Size of the candidate list used to build the graph.
+  size_t efConstruction;
+  //! Size of the candidate list used by searches.
+  size_t ef;
+  //! Instantiated metric.
+  MetricType metric;
+
+  //! The links of each point in each layer that it belongs to.
+  std::vector<std::vector<std::vector<size_t>>> graph;
+  //! The point at which every search starts; it belongs to the highest layer.
+  size_t entryPoint;
+  //! The highest layer of the graph.
+  size_t maxLevel;
+
+  //! The number of distance evaluations performed.
+  size_t distanceEvaluations;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "hnsw_search_impl.hpp"
+
+#endif
@@ -0,0 +1,553 @@
+/**
+ * @file methods/hnsw/hnsw_search_impl.hpp
+ *
+ * Implementation of the HNSWSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_HNSW_HNSW_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hnsw_search.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::
+HNSWSearch(MatType referenceSet,
+           const size_t maxConnections,
+           const size_t efConstruction,
+           const size_t ef,
+           const MetricType metric) :
+    maxConnections(maxConnections),
+    efConstruction(efConstruction),
+    ef(ef),
+    metric(metric),
+    entryPoint(0),
+    maxLevel(0),
+    distanceEvaluations(0)
+{
+  // Pass work to training function.
+  Train(std::move(referenceSet));
+}
+
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::
+HNSWSearch(const size_t maxConnections,
+           const size_t efConstruction,
+           const size_t ef,
+           const MetricType metric) :
+    maxConnections(maxConnections),
+    efConstruction(efConstruction),
+    ef(ef),
+    metric(metric),
+    entryPoint(0),
+    maxLevel(0),
+    distanceEvaluations(0)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Train(MatType referenceSetIn)
+{
+  if (maxConnections == 0)
+  {
+    throw std::invalid_argument("HNSWSearch::Train(): the number of "
+        "connections must be greater than 0!");
+  }
+
+  if (efConstruction == 0)
+  {
+    throw std::invalid_argument("HNSWSearch::Train(): efConstruction must be "
+        "greater than 0!");
+  }
+
+  referenceSet = std::move(referenceSetIn);
+  const size_t numPoints = referenceSet.n_cols;
+
+  graph.clear();
+  graph.resize(numPoints);
+  entryPoint = 0;
+  maxLevel = 0;
+  distanceEvaluations = 0;
+
+  if (numPoints == 0)
+    return;
+
+  // Draw the level of every point up front, so that the levels only depend on
+  // the random seed.  The probability of a point to belong to a layer falls by
+  // a factor of maxConnections with each layer.
+  const double levelMultiplier =
+      1.0 / std::log((double) std::max(maxConnections, (size_t) 2));
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    const size_t level = (size_t) std::floor(-std::log(1.0 - math::Random()) *
+        levelMultiplier);
+
+    // Reserve room for all links, so that the lists never move while other
+    // threads read them.
+    graph[i].resize(level + 1);
+    for (size_t l = 0; l <= level; ++l)
+      graph[i][l].reserve(MaxLinks(l) + 1);
+  }
+
+  // The first point is the initial entry point.
+  maxLevel = graph[0].size() - 1;
+
+  std::vector<std::mutex> locks(numPoints);
+  std::mutex entryLock;
+  size_t evaluations = 0;
+
+  #pragma omp parallel reduction(+:evaluations)
+  {
+    // Each thread marks the points it visits in its own vector.
+    std::vector<size_t> visited(numPoints, 0);
+    size_t tag = 0;
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 1; i < (omp_size_t) numPoints; ++i)
+      InsertPoint(i, locks, entryLock, visited, tag, evaluations);
+  }
+
+  distanceEvaluations = evaluations;
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Search(const MatType& querySet,
+                                             const size_t k,
+                                             arma::Mat<size_t>& neighbors,
+                                             arma::mat& distances)
+{
+  // Ensure the dimensionality of the query set is correct.
+  if (querySet.n_rows != referenceSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << referenceSet.n_rows << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (k > referenceSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but reference set has " << referenceSet.n_cols
+        << " points!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  // If the user asked for 0 nearest neighbors... uh... we're done.
+  if (k == 0)
+    return;
+
+  const size_t searchEf = std::max(ef, k);
+  size_t evaluations = 0;
+
+  #pragma omp parallel reduction(+:evaluations)
+  {
+    std::vector<size_t> visited(referenceSet.n_cols, 0);
+    size_t tag = 0;
+    std::vector<Candidate> results;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      SearchPoint(querySet.col(i), searchEf, results, visited, tag,
+          evaluations);
+
+      for (size_t j = 0; j < k; ++j)
+      {
+        if (j < results.size())
+        {
+          neighbors(j, i) = results[j].second;
+          distances(j, i) = results[j].first;
+        }
+        else
+        {
+          neighbors(j, i) = SIZE_MAX;
+          distances(j, i) = DBL_MAX;
+        }
+      }
+    }
+  }
+
+  distanceEvaluations += evaluations;
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Search(const size_t k,
+                                             arma::Mat<size_t>& neighbors,
+                                             arma::mat& distances)
+{
+  if (k >= referenceSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but reference set has " << referenceSet.n_cols
+        << " points (including the query point itself)!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k, referenceSet.n_cols);
+  distances.set_size(k, referenceSet.n_cols);
+
+  if (k == 0)
+    return;
+
+  // One more candidate is needed, since every point will find itself.
+  const size_t searchEf = std::max(ef, k + 1);
+  size_t evaluations = 0;
+
+  #pragma omp parallel reduction(+:evaluations)
+  {
+    std::vector<size_t> visited(referenceSet.n_cols, 0);
+    size_t tag = 0;
+    std::vector<Candidate> results;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) referenceSet.n_cols; ++i)
+    {
+      SearchPoint(referenceSet.col(i), searchEf, results, visited, tag,
+          evaluations);
+
+      size_t j = 0;
+      for (size_t r = 0; r < results.size() && j < k; ++r)
+      {
+        if (results[r].second == (size_t) i)
+          continue;
+
+        neighbors(j, i) = results[r].second;
+        distances(j, i) = results[r].first;
+        ++j;
+      }
+
+      for (; j < k; ++j)
+      {
+        neighbors(j, i) = SIZE_MAX;
+        distances(j, i) = DBL_MAX;
+      }
+    }
+  }
+
+  distanceEvaluations += evaluations;
+}
+
+template<typename MetricType, typename MatType>
+double HNSWSearch<MetricType, MatType>::ComputeRecall(
+    const arma::Mat<size_t>& foundNeighbors,
+    const arma::Mat<size_t>& realNeighbors)
+{
+  if (foundNeighbors.n_rows != realNeighbors.n_rows ||
+      foundNeighbors.n_cols != realNeighbors.n_cols)
+  {
+    throw std::invalid_argument("HNSWSearch::ComputeRecall(): matrices "
+        "provided must have equal size");
+  }
+
+  // The recall is the set intersection of found and real neighbors.
+  size_t found = 0;
+  for (size_t col = 0; col < foundNeighbors.n_cols; ++col)
+  {
+    for (size_t row = 0; row < realNeighbors.n_rows; ++row)
+    {
+      for (size_t nei = 0; nei < foundNeighbors.n_rows; ++nei)
+      {
+        if (realNeighbors(row, col) == foundNeighbors(nei, col))
+        {
+          found++;
+          break;
+        }
+      }
+    }
+  }
+
+  return ((double) found) / realNeighbors.n_elem;
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::InsertPoint(
+    const size_t point,
+    std::vector<std::mutex>& locks,
+    std::mutex& entryLock,
+    std::vector<size_t>& visited,
+    size_t& tag,
+    size_t& evaluations)
+{
+  const size_t level = graph[point].size() - 1;
+
+  // If the point becomes the new entry point, nobody else may start from the
+  // old one until the point is linked into every layer.
+  std::unique_lock<std::mutex> entryGuard(entryLock);
+  const size_t currentMaxLevel = maxLevel;
+  size_t current = entryPoint;
+  if (level <= currentMaxLevel)
+    entryGuard.unlock();
+
+  double currentDistance = metric.Evaluate(referenceSet.col(point),
+      referenceSet.col(current));
+  ++evaluations;
+
+  // Descend through the layers above the point.
+  for (size_t l = currentMaxLevel; l > level; --l)
+  {
+    GreedySearch(referenceSet.col(point), current, currentDistance, l, &locks,
+        evaluations);
+  }
+
+  // Link the point into each of its layers that already exist, from the top.
+  // The candidates found in a layer are the starting points in the next one.
+  std::vector<Candidate> candidates(1, Candidate(currentDistance, current));
+  std::vector<size_t> selected;
+  for (size_t l = std::min(level, currentMaxLevel) + 1; l-- > 0; )
+  {
+    SearchLayer(referenceSet.col(point), candidates, efConstruction, l,
+        visited, ++tag, &locks, evaluations);
+    SelectNeighbors(candidates, maxConnections, selected, evaluations);
+
+    {
+      std::lock_guard<std::mutex> guard(locks[point]);
+      graph[point][l] = selected;
+    }
+
+    for (size_t i = 0; i < selected.size(); ++i)
+      Connect(selected[i], point, l, locks, evaluations);
+  }
+
+  if (level > currentMaxLevel)
+  {
+    entryPoint = point;
+    maxLevel = level;
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Connect(const size_t from,
+                                              const size_t to,
+                                              const size_t level,
+                                              std::vector<std::mutex>& locks,
+                                              size_t& evaluations)
+{
+  std::lock_guard<std::mutex> guard(locks[from]);
+  std::vector<size_t>& links = graph[from][level];
+
+  if (links.size() < MaxLinks(level))
+  {
+    links.push_back(to);
+    return;
+  }
+
+  // There are too many links, so select the best ones again.
+  std::vector<Candidate> candidates;
+  candidates.reserve(links.size() + 1);
+  for (size_t i = 0; i < links.size(); ++i)
+  {
+    candidates.push_back(Candidate(metric.Evaluate(referenceSet.col(from),
+        referenceSet.col(links[i])), links[i]));
+  }
+  candidates.push_back(Candidate(metric.Evaluate(referenceSet.col(from),
+      referenceSet.col(to)), to));
+  evaluations += candidates.size();
+
+  std::sort(candidates.begin(), candidates.end());
+  SelectNeighbors(candidates, MaxLinks(level), links, evaluations);
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::SelectNeighbors(
+    const std::vector<Candidate>& candidates,
+    const size_t maxNeighbors,
+    std::vector<size_t>& selected,
+    size_t& evaluations)
+{
+  selected.clear();
+  for (size_t i = 0; i < candidates.size() &&
+      selected.size() < maxNeighbors; ++i)
+  {
+    bool keep = true;
+    for (size_t j = 0; j < selected.size(); ++j)
+    {
+      ++evaluations;
+      if (metric.Evaluate(referenceSet.col(candidates[i].second),
+          referenceSet.col(selected[j])) < candidates[i].first)
+      {
+        keep = false;
+        break;
+      }
+    }
+
+    if (keep)
+      selected.push_back(candidates[i].second);
+  }
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecType>
+void HNSWSearch<MetricType, MatType>::GreedySearch(
+    const VecType& query,
+    size_t& current,
+    double& currentDistance,
+    const size_t level,
+    std::vector<std::mutex>* locks,
+    size_t& evaluations)
+{
+  std::vector<size_t> links;
+  bool changed = true;
+  while (changed)
+  {
+    changed = false;
+
+    if (locks)
+    {
+      std::lock_guard<std::mutex> guard((*locks)[current]);
+      links = graph[current][level];
+    }
+    else
+    {
+      links = graph[current][level];
+    }
+
+    for (size_t i = 0; i < links.size(); ++i)
+    {
+      const double distance = metric.Evaluate(query,
+          referenceSet.col(links[i]));
+      ++evaluations;
+
+      if (distance < currentDistance)
+      {
+        current = links[i];
+        currentDistance = distance;
+        changed = true;
+      }
+    }
+  }
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecType>
+void HNSWSearch<MetricType, MatType>::SearchLayer(
+    const VecType& query,
+    std::vector<Candidate>& candidates,
+    const size_t numCandidates,
+    const size_t level,
+    std::vector<size_t>& visited,
+    const size_t tag,
+    std::vector<std::mutex>* locks,
+    size_t& evaluations)
+{
+  // The points still to be expanded, closest first, and the best points found
+  // so far, furthest first.
+  std::priority_queue<Candidate, std::vector<Candidate>,
+      std::greater<Candidate>> toExpand;
+  std::priority_queue<Candidate> results;
+
+  for (size_t i = 0; i < candidates.size(); ++i)
+  {
+    visited[candidates[i].second] = tag;
+    toExpand.push(candidates[i]);
+    results.push(candidates[i]);
+    if (results.size() > numCandidates)
+      results.pop();
+  }
+
+  std::vector<size_t> lockedLinks;
+  while (!toExpand.empty())
+  {
+    const Candidate closest = toExpand.top();
+    toExpand.pop();
+
+    // No point left to expand can improve the results.
+    if (results.size() >= numCandidates &&
+        closest.first > results.top().first)
+      break;
+
+    const std::vector<size_t>* links = &graph[closest.second][level];
+    if (locks)
+    {
+      std::lock_guard<std::mutex> guard((*locks)[closest.second]);
+      lockedLinks = *links;
+      links = &lockedLinks;
+    }
+
+    for (size_t i = 0; i < links->size(); ++i)
+    {
+      const size_t neighbor = (*links)[i];
+      if (visited[neighbor] == tag)
+        continue;
+      visited[neighbor] = tag;
+
+      const double distance = metric.Evaluate(query,
+          referenceSet.col(neighbor));
+      ++evaluations;
+
+      if (results.size() < numCandidates || distance < results.top().first)
+      {
+        toExpand.push(Candidate(distance, neighbor));
+        results.push(Candidate(distance, neighbor));
+        if (results.size() > numCandidates)
+          results.pop();
+      }
+    }
+  }
+
+  candidates.resize(results.size());
+  for (size_t i = results.size(); i > 0; --i)
+  {
+    candidates[i - 1] = results.top();
+    results.pop();
+  }
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecType>
+void HNSWSearch<MetricType, MatType>::SearchPoint(
+    const VecType& query,
+    const size_t numCandidates,
+    std::vector<Candidate>& results,
+    std::vector<size_t>& visited,
+    size_t& tag,
+    size_t& evaluations)
+{
+  size_t current = entryPoint;
+  double currentDistance = metric.Evaluate(query, referenceSet.col(current));
+  ++evaluations;
+
+  for (size_t l = maxLevel; l > 0; --l)
+    GreedySearch(query, current, currentDistance, l, NULL, evaluations);
+
+  results.assign(1, Candidate(currentDistance, current));
+  SearchLayer(query, results, numCandidates, 0, visited, ++tag, NULL,
+      evaluations);
+}
+
+template<typename MetricType, typename MatType>
+template<typename Archive>
+void HNSWSearch<MetricType, MatType>::serialize(Archive& ar,
+                                                const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(referenceSet));
+  ar(CEREAL_NVP(maxConnections));
+  ar(CEREAL_NVP(efConstruction));
+  ar(CEREAL_NVP(ef));
+  ar(CEREAL_NVP(metric));
+  ar(CEREAL_NVP(graph));
+  ar(CEREAL_NVP(entryPoint));
+  ar(CEREAL_NVP(maxLevel));
+  ar(CEREAL_NVP(distanceEvaluations));
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,253 @@
+/**
+ * @file methods/ivf_pq/ivf_pq_search.hpp
+ *
+ * Defines the IVFPQSearch class, which performs approximate nearest neighbor
+ * search on a compressed index: an inverted file over a coarse quantizer, with
+ * the points in each list encoded by product quantization.
+ *
+ * The details of this method can be found in the following paper:
+ *
+ * @code
+ * @article{jegou2011product,
+ *   title={Product quantization for nearest neighbor search},
+ *   author={J{\'e}gou, Herv{\'e} and Douze, Matthijs and Schmid, Cordelia},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={33},
+ *   number={1},
+ *   pages={117--128},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_IVF_PQ_IVF_PQ_SEARCH_HPP
+#define MLPACK_METHODS_IVF_PQ_IVF_PQ_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+
+#include <queue>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The IVFPQSearch class builds a compressed index of the reference set, and
+ * uses it to find approximate nearest neighbors (with respect to the Euclidean
+ * distance) of query points.  The reference set itself is not kept.
+ *
+ * The reference set is first clustered with k-means into a number of lists
+ * (the coarse quantizer), and each point is assigned to the list of its
+ * nearest centroid.  The residual of each point (its offset from that
+ * centroid) is split into a number of subspaces, and each subspace of the
+ * residual is replaced by the index of its nearest codeword in a codebook that
+ * is also learned with k-means.  Each point is thus stored as one byte per
+ * subspace plus its index, instead of as a column of doubles.
+ *
+ * A search visits the lists of the nearest few centroids of each query.  For
+ * each visited list, a table of the squared distances between each subspace of
+ * the query's residual and each codeword is computed once, and the distance to
+ * every point of the list is then the sum of one table entry per subspace.
+ * The returned distances are these approximations, not the true distances.
+ *
+ * Queries are processed in batches; the distances to the coarse centroids of a
+ * batch are computed with one matrix multiplication, and the queries of a
+ * batch are searched in parallel if OpenMP is available.
+ *
+ * @code
+ * extern arma::mat referenceSet, querySet;
+ *
+ * // Build an index with 100 lists and 8 bytes per point, and find the 5
+ * // approximate nearest neighbors of each query point.
+ * IVFPQSearch<> ivfpq(referenceSet, 100, 8);
+ * arma::Mat<size_t> neighbors;
+ * arma::mat distances;
+ * ivfpq.Search(querySet, 5, neighbors, distances);
+ * @endcode
+ *
+ * @tparam MatType Type of matrix that the reference and query sets are stored
+ *     in.
+ */
+template<typename MatType = arma::mat>
+class IVFPQSearch
+{
+ public:
+  /**
+   * Build the index on the given reference set.  The reference set is not
+   * kept, and can be discarded once the index is built.
+   *
+   * @param referenceSet Set of reference points.
+   * @param numLists Number of lists (coarse centroids) of the inverted file.
+   * @param numSubspaces Number of subspaces that each residual is split into;
+   *     this is the number of bytes of each code.  It can't be larger than the
+   *     dimensionality of the data.
+   * @param numCodes Number of codewords in the codebook of each subspace (at
+   *     most 256).
+   * @param numProbes Number of lists that each search visits.
+   * @param maxIterations Maximum number of k-means iterations used to learn
+   *     the coarse centroids and the codebooks.
+   */
+  IVFPQSearch(const MatType& referenceSet,
+              const size_t numLists = 64,
+              const size_t numSubspaces = 8,
+              const size_t numCodes = 256,
+              const size_t numProbes = 8,
+              const size_t maxIterations = 50);
+
+  /**
+   * Create an IVFPQSearch object without an index.  Be sure to call Train()
+   * before calling Search(); otherwise, an exception will be thrown when
+   * Search() is called.
+   *
+   * @param numLists Number of lists (coarse centroids) of the inverted file.
+   * @param numSubspaces Number of subspaces that each residual is split into.
+   * @param numCodes Number of codewords in the codebook of each subspace (at
+   *     most 256).
+   * @param numProbes Number of lists that each search visits.
+   * @param maxIterations Maximum number of k-means iterations used to learn
+   *     the coarse centroids and the codebooks.
+   */
+  IVFPQSearch(const size_t numLists = 64,
+              const size_t numSubspaces = 8,
+              const size_t numCodes = 256,
+              const size_t numProbes = 8,
+              const size_t maxIterations = 50);
+
+  /**
+   * Build the index on the given reference set, replacing any previous index.
+   * The reference set is not kept.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(const MatType& referenceSet);
+
+  /**
+   * Compute the approximate nearest neighbors of each point in the given query
+   * set and store the output in the given matrices.  The matrices will be set
+   * to the size of n columns by k rows, where n is the number of points in the
+   * query dataset and k is the number of neighbors being searched for.  If the
+   * visited lists hold fewer than k points, the remaining neighbors are
+   * SIZE_MAX and their distances are DBL_MAX.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing approximate distances of neighbors for
+   *     each query point.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  //! Get the dimensionality of the indexed points.
+  size_t Dimensionality() const { return coarseCentroids.n_rows; }
+  //! Get the number of indexed points.
+  size_t NumPoints() const { return indices.n_elem; }
+
+  //! Get the number of lists of the inverted file.
+  size_t NumLists() const { return numLists; }
+  //! Get the number of subspaces (the number of bytes of each code).
+  size_t NumSubspaces() const { return numSubspaces; }
+  //! Get the number of codewords in the codebook of each subspace.
+  size_t NumCodes() const { return numCodes; }
+  //! Get the maximum number of k-means iterations.
+  size_t MaxIterations() const { return maxIterations; }
+
+  //! Get the number of lists that each search visits.
+  size_t NumProbes() const { return numProbes; }
+  //! Modify the number of lists that each search visits.
+  size_t& NumProbes() { return numProbes; }
+
+  //! Get the coarse centroids (one column for each list).
+  const arma::mat& CoarseCentroids() const { return coarseCentroids; }
+  //! Get the codebooks; the rows of each subspace hold its codewords.
+  const arma::mat& Codebooks() const { return codebooks; }
+  //! Get the first dimension of each subspace, followed by the dimensionality.
+  const arma::Col<size_t>& SubspaceBounds() const { return subspaceBounds; }
+
+  //! Get the offset of each list in Indices() and Codes(), followed by the
+  //! number of points.
+  const arma::Col<size_t>& ListOffsets() const { return listOffsets; }
+  //! Get the index of each point in the reference set, grouped by list.
+  const arma::Col<size_t>& Indices() const { return indices; }
+  //! Get the code of each point (one column per point), grouped by list.
+  const arma::Mat<unsigned char>& Codes() const { return codes; }
+
+  /**
+   * Serialize the IVF-PQ index.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! A point in a result list: its squared distance, then its index.
+  typedef std::pair<double, size_t> Candidate;
+
+  /**
+   * Learn the codebook of each subspace from the residuals of the reference
+   * set.
+   *
+   * @param referenceSet Set of reference points.
+   * @param assignments The list of each reference point.
+   */
+  void TrainCodebooks(const MatType& referenceSet,
+                      const arma::uvec& assignments);
+
+  /**
+   * Search the given lists for the nearest neighbors of the query.
+   *
+   * @param query The query point.
+   * @param lists The lists to visit.
+   * @param k Number of neighbors to search for.
+   * @param residual Storage for the residual of the query.
+   * @param table Storage for the distance lookup table.
+   * @param results Filled with the (at most) k nearest points, sorted by
+   *     squared distance.
+   */
+  void SearchLists(const arma::vec& query,
+                   const arma::uvec& lists,
+                   const size_t k,
+                   arma::vec& residual,
+                   arma::mat& table,
+                   std::vector<Candidate>& results) const;
+
+  //! Number of lists of the inverted file.
+  size_t numLists;
+  //! Number of subspaces that each residual is split into.
+  size_t numSubspaces;
+  //! Number of codewords in the codebook of each subspace.
+  size_t numCodes;
+  //! Number of lists that each search visits.
+  size_t numProbes;
+  //! Maximum number of k-means iterations.
+  size_t maxIterations;
+
+  //! The coarse centroids, one column for each list.
+  arma::mat coarseCentroids;
+  //! The first dimension of each subspace, followed by the dimensionality.
+  arma::Col<size_t> subspaceBounds;
+  //! The codewords, one column for each code; the rows of each subspace hold
+  //! the codewords of that subspace.
+  arma::mat codebooks;
+
+  //! The offset of each list in indices and codes, followed by the number of
+  //! points.
+  arma::Col<size_t> listOffsets;
+  //! The index of each point in the reference set, grouped by list.
+  arma::Col<size_t> indices;
+  //! The code of each point, one column per point, grouped by list.
+  arma::Mat<unsigned char> codes;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "ivf_pq_search_impl.hpp"
+
+#endif
@@ -0,0 +1,338 @@
+/**
+ * @file methods/ivf_pq/ivf_pq_search_impl.hpp
+ *
+ * Implementation of the IVFPQSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_IVF_PQ_IVF_PQ_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_IVF_PQ_IVF_PQ_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "ivf_pq_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MatType>
+IVFPQSearch<MatType>::IVFPQSearch(const MatType& referenceSet,
+                                  const size_t numLists,
+                                  const size_t numSubspaces,
+                                  const size_t numCodes,
+                                  const size_t numProbes,
+                                  const size_t maxIterations) :
+    numLists(numLists),
+    numSubspaces(numSubspaces),
+    numCodes(numCodes),
+    numProbes(numProbes),
+    maxIterations(maxIterations)
+{
+  // Pass work to training function.
+  Train(referenceSet);
+}
+
+template<typename MatType>
+IVFPQSearch<MatType>::IVFPQSearch(const size_t numLists,
+                                  const size_t numSubspaces,
+                                  const size_t numCodes,
+                                  const size_t numProbes,
+                                  const size_t maxIterations) :
+    numLists(numLists),
+    numSubspaces(numSubspaces),
+    numCodes(numCodes),
+    numProbes(numProbes),
+    maxIterations(maxIterations)
+{
+  // Nothing to do.
+}
+
+template<typename MatType>
+void IVFPQSearch<MatType>::Train(const MatType& referenceSet)
+{
+  const size_t dims = referenceSet.n_rows;
+  const size_t numPoints = referenceSet.n_cols;
+
+  if (numLists == 0 || numLists > numPoints)
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::Train(): the number of lists (" << numLists << ") "
+        << "must be greater than 0 and at most the number of points ("
+        << numPoints << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (numSubspaces == 0 || numSubspaces > dims)
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::Train(): the number of subspaces (" << numSubspaces
+        << ") must be greater than 0 and at most the dimensionality of the "
+        << "data (" << dims << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (numCodes == 0 || numCodes > 256 || numCodes > numPoints)
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::Train(): the number of codes (" << numCodes << ") "
+        << "must be greater than 0 and at most 256 and the number of points ("
+        << numPoints << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Learn the coarse quantizer, and assign each point to a list.
+  arma::Row<size_t> assignments;
+  kmeans::KMeans<metric::EuclideanDistance, kmeans::SampleInitialization,
+      kmeans::MaxVarianceNewCluster, kmeans::NaiveKMeans, MatType>
+      coarseKMeans(maxIterations);
+  coarseKMeans.Cluster(referenceSet, numLists, assignments, coarseCentroids);
+
+  // Split the dimensions into subspaces of (nearly) equal size.
+  subspaceBounds.set_size(numSubspaces + 1);
+  for (size_t s = 0; s <= numSubspaces; ++s)
+    subspaceBounds[s] = s * dims / numSubspaces;
+
+  TrainCodebooks(referenceSet, arma::conv_to<arma::uvec>::from(assignments));
+
+  // Group the points by list: count the points of each list, and then place
+  // them in order.
+  listOffsets.zeros(numLists + 1);
+  for (size_t i = 0; i < numPoints; ++i)
+    ++listOffsets[assignments[i] + 1];
+  listOffsets = arma::cumsum(listOffsets);
+
+  indices.set_size(numPoints);
+  arma::Col<size_t> next = listOffsets.head(numLists);
+  for (size_t i = 0; i < numPoints; ++i)
+    indices[next[assignments[i]]++] = i;
+
+  // Now encode the residual of each point.
+  codes.set_size(numSubspaces, numPoints);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t p = 0; p < (omp_size_t) numPoints; ++p)
+  {
+    const size_t point = indices[p];
+    const arma::vec residual =
+        arma::conv_to<arma::vec>::from(referenceSet.col(point)) -
+        coarseCentroids.col(assignments[point]);
+
+    for (size_t s = 0; s < numSubspaces; ++s)
+    {
+      const size_t first = subspaceBounds[s];
+      const size_t last = subspaceBounds[s + 1] - 1;
+
+      size_t bestCode = 0;
+      double bestDistance = DBL_MAX;
+      for (size_t c = 0; c < numCodes; ++c)
+      {
+        const double distance = arma::accu(arma::square(
+            residual.subvec(first, last) -
+            codebooks.submat(first, c, last, c)));
+        if (distance < bestDistance)
+        {
+          bestDistance = distance;
+          bestCode = c;
+        }
+      }
+
+      codes(s, p) = (unsigned char) bestCode;
+    }
+  }
+}
+
+template<typename MatType>
+void IVFPQSearch<MatType>::Search(const MatType& querySet,
+                                  const size_t k,
+                                  arma::Mat<size_t>& neighbors,
+                                  arma::mat& distances) const
+{
+  // Ensure the dimensionality of the query set is correct.
+  if (querySet.n_rows != Dimensionality())
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << Dimensionality() << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (k > NumPoints())
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but the index has " << NumPoints() << " points!"
+        << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (numProbes == 0)
+  {
+    throw std::invalid_argument("IVFPQSearch::Search(): the number of probes "
+        "must be greater than 0!");
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  // If the user asked for 0 nearest neighbors... uh... we're done.
+  if (k == 0)
+    return;
+
+  const size_t probes = std::min(numProbes, numLists);
+  const arma::vec centroidNorms =
+      arma::sum(arma::square(coarseCentroids), 0).t();
+
+  // Process the queries in batches, so that the distances between a batch and
+  // the coarse centroids fit in memory and can be computed with one matrix
+  // multiplication.
+  const size_t batchSize = 1024;
+  for (size_t begin = 0; begin < querySet.n_cols; begin += batchSize)
+  {
+    const size_t end = std::min(begin + batchSize, (size_t) querySet.n_cols);
+    const arma::mat batch =
+        arma::conv_to<arma::mat>::from(querySet.cols(begin, end - 1));
+
+    // The squared distances to the centroids, minus the squared norm of each
+    // query; that doesn't change which centroids are the nearest.
+    arma::mat coarseDistances = -2.0 * coarseCentroids.t() * batch;
+    coarseDistances.each_col() += centroidNorms;
+
+    #pragma omp parallel
+    {
+      arma::vec residual;
+      arma::mat table(numCodes, numSubspaces);
+      std::vector<Candidate> results;
+
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t i = 0; i < (omp_size_t) (end - begin); ++i)
+      {
+        const arma::uvec order = arma::sort_index(coarseDistances.col(i));
+        const arma::uvec lists = order.head(probes);
+        SearchLists(batch.unsafe_col(i), lists, k, residual, table, results);
+
+        const size_t query = begin + i;
+        for (size_t j = 0; j < k; ++j)
+        {
+          if (j < results.size())
+          {
+            neighbors(j, query) = results[j].second;
+            distances(j, query) = std::sqrt(std::max(results[j].first, 0.0));
+          }
+          else
+          {
+            neighbors(j, query) = SIZE_MAX;
+            distances(j, query) = DBL_MAX;
+          }
+        }
+      }
+    }
+  }
+}
+
+template<typename MatType>
+void IVFPQSearch<MatType>::TrainCodebooks(const MatType& referenceSet,
+                                          const arma::uvec& assignments)
+{
+  codebooks.set_size(referenceSet.n_rows, numCodes);
+
+  // Each subspace has its own codebook, learned from that subspace of the
+  // residuals.  Only one subspace of the residuals is held at once.
+  kmeans::KMeans<> codebookKMeans(maxIterations);
+  for (size_t s = 0; s < numSubspaces; ++s)
+  {
+    const size_t first = subspaceBounds[s];
+    const size_t last = subspaceBounds[s + 1] - 1;
+
+    const arma::mat residuals =
+        arma::conv_to<arma::mat>::from(referenceSet.rows(first, last)) -
+        coarseCentroids.submat(arma::regspace<arma::uvec>(first, last),
+        assignments);
+
+    arma::mat codebook;
+    codebookKMeans.Cluster(residuals, numCodes, codebook);
+    codebooks.rows(first, last) = codebook;
+  }
+}
+
+template<typename MatType>
+void IVFPQSearch<MatType>::SearchLists(const arma::vec& query,
+                                       const arma::uvec& lists,
+                                       const size_t k,
+                                       arma::vec& residual,
+                                       arma::mat& table,
+                                       std::vector<Candidate>& results) const
+{
+  // The best candidates found so far, with the worst on top.
+  std::priority_queue<Candidate> best;
+
+  for (size_t l = 0; l < lists.n_elem; ++l)
+  {
+    const size_t list = lists[l];
+    if (listOffsets[list] == listOffsets[list + 1])
+      continue;
+
+    // Compute the squared distance between each subspace of the residual and
+    // each codeword of that subspace.
+    residual = query - coarseCentroids.col(list);
+    for (size_t s = 0; s < numSubspaces; ++s)
+    {
+      const size_t first = subspaceBounds[s];
+      const size_t last = subspaceBounds[s + 1] - 1;
+      for (size_t c = 0; c < numCodes; ++c)
+      {
+        table(c, s) = arma::accu(arma::square(residual.subvec(first, last) -
+            codebooks.submat(first, c, last, c)));
+      }
+    }
+
+    // The distance to each point of the list is now one lookup per subspace.
+    for (size_t p = listOffsets[list]; p < listOffsets[list + 1]; ++p)
+    {
+      const unsigned char* code = codes.colptr(p);
+      double distance = 0.0;
+      for (size_t s = 0; s < numSubspaces; ++s)
+        distance += table(code[s], s);
+
+      if (best.size() < k)
+        best.push(Candidate(distance, indices[p]));
+      else if (distance < best.top().first)
+      {
+        best.pop();
+        best.push(Candidate(distance, indices[p]));
+      }
+    }
+  }
+
+  results.resize(best.size());
+  for (size_t j = results.size(); j > 0; --j)
+  {
+    results[j - 1] = best.top();
+    best.pop();
+  }
+}
+
+template<typename MatType>
+template<typename Archive>
+void IVFPQSearch<MatType>::serialize(Archive& ar,
+                                     const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(numLists));
+  ar(CEREAL_NVP(numSubspaces));
+  ar(CEREAL_NVP(numCodes));
+  ar(CEREAL_NVP(numProbes));
+  ar(CEREAL_NVP(maxIterations));
+  ar(CEREAL_NVP(coarseCentroids));
+  ar(CEREAL_NVP(subspaceBounds));
+  ar(CEREAL_NVP(codebooks));
+  ar(CEREAL_NVP(listOffsets));
+  ar(CEREAL_NVP(indices));
+  ar(CEREAL_NVP(codes));
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
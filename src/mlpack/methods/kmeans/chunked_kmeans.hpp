@@ -0,0 +1,153 @@
+/**
+ * @file methods/kmeans/chunked_kmeans.hpp
+ *
+ * An out-of-core version of k-means, which streams the dataset from disk a
+ * chunk at a time for each Lloyd iteration.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_CHUNKED_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_CHUNKED_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/data/chunked_matrix_reader.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * This class performs k-means clustering on a dataset that does not fit in
+ * memory.  Each Lloyd iteration is one pass over the file with a
+ * data::ChunkedMatrixReader, so only a chunk or two of the points are in
+ * memory at once; with prefetching enabled in the reader, each chunk is read
+ * from disk while the previous chunk is being processed.  The closest centroid
+ * to each point of a chunk is found in parallel if OpenMP is available.
+ *
+ * The result is the same as that of the in-memory algorithm with the default
+ * Lloyd step, sample initialization and empty clusters allowed, that is,
+ *
+ * @code
+ * KMeans<MetricType, SampleInitialization, AllowEmptyClusters, NaiveKMeans>
+ * @endcode
+ *
+ * run on the same data with the same random seed: the same initial centroids
+ * are chosen, and the same iterations are run.  The points are added to the
+ * centroids in dataset order regardless of the number of threads, so the
+ * centroids are exactly those of the in-memory algorithm run on one thread
+ * (with more threads, the in-memory sums are rounded differently).
+ *
+ * @code
+ * data::ChunkedMatrixReader reader("huge.csv", 100000);
+ * ChunkedKMeans<> k;
+ * arma::Row<size_t> assignments;
+ * arma::mat centroids;
+ * k.Cluster(reader, 100, assignments, centroids);
+ * @endcode
+ *
+ * @tparam MetricType The distance metric to use for this KMeans; see
+ *     metric::LMetric for an example.
+ */
+template<typename MetricType = metric::EuclideanDistance>
+class ChunkedKMeans
+{
+ public:
+  /**
+   * Create a ChunkedKMeans object.
+   *
+   * @param maxIterations Maximum number of iterations allowed before giving up
+   *     (0 is valid, but the algorithm may never terminate).
+   * @param metric Optional MetricType object; for when the metric has state
+   *     it needs to store.
+   */
+  ChunkedKMeans(const size_t maxIterations = 1000,
+                const MetricType metric = MetricType());
+
+  /**
+   * Perform k-means clustering on the data in the given reader, returning the
+   * centroids of each cluster.  Each iteration rewinds the reader and reads
+   * the whole file.
+   *
+   * @param reader Reader of the dataset to cluster.
+   * @param clusters Number of clusters to compute.
+   * @param centroids Matrix in which centroids are stored.
+   * @param initialGuess If true, then it is assumed that centroids contains
+   *      the initial cluster centroids.
+   */
+  void Cluster(data::ChunkedMatrixReader& reader,
+               const size_t clusters,
+               arma::mat& centroids,
+               const bool initialGuess = false);
+
+  /**
+   * Perform k-means clustering on the data in the given reader, returning the
+   * cluster assignment of each point and the centroids of each cluster.  The
+   * assignments are computed with one more pass over the file.
+   *
+   * @param reader Reader of the dataset to cluster.
+   * @param clusters Number of clusters to compute.
+   * @param assignments Vector to store cluster assignments in.
+   * @param centroids Matrix in which centroids are stored.
+   * @param initialGuess If true, then it is assumed that centroids contains
+   *      the initial cluster centroids.
+   */
+  void Cluster(data::ChunkedMatrixReader& reader,
+               const size_t clusters,
+               arma::Row<size_t>& assignments,
+               arma::mat& centroids,
+               const bool initialGuess = false);
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Set the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the distance metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the distance metric.
+  MetricType& Metric() { return metric; }
+
+  //! Serialize the k-means object.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(maxIterations));
+    ar(CEREAL_NVP(metric));
+  }
+
+ private:
+  /**
+   * Choose initial centroids by sampling points, with the same random draws
+   * as SampleInitialization.
+   */
+  void SampleCentroids(data::ChunkedMatrixReader& reader,
+                       const size_t clusters,
+                       arma::mat& centroids);
+
+  /**
+   * Run a single Lloyd iteration with one pass over the file, as NaiveKMeans
+   * does in memory.
+   */
+  double Iterate(data::ChunkedMatrixReader& reader,
+                 const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  //! Maximum number of iterations before giving up.
+  size_t maxIterations;
+  //! Instantiated distance metric.
+  MetricType metric;
+  //! Number of distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "chunked_kmeans_impl.hpp"
+
+#endif
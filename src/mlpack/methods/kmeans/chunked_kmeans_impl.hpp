@@ -0,0 +1,257 @@
+/**
+ * @file methods/kmeans/chunked_kmeans_impl.hpp
+ *
+ * Implementation of the ChunkedKMeans class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_CHUNKED_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_CHUNKED_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "chunked_kmeans.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType>
+ChunkedKMeans<MetricType>::ChunkedKMeans(const size_t maxIterations,
+                                         const MetricType metric) :
+    maxIterations(maxIterations),
+    metric(metric),
+    distanceCalculations(0)
+{ /* Nothing to do. */ }
+
+template<typename MetricType>
+void ChunkedKMeans<MetricType>::Cluster(data::ChunkedMatrixReader& reader,
+                                        const size_t clusters,
+                                        arma::mat& centroids,
+                                        const bool initialGuess)
+{
+  // Make sure we have more points than clusters.
+  const size_t points = reader.Points();
+  if (clusters > points)
+    Log::Warn << "ChunkedKMeans::Cluster(): more clusters requested than "
+        << "points given." << std::endl;
+  else if (clusters == 0)
+    Log::Warn << "ChunkedKMeans::Cluster(): zero clusters requested.  This "
+        << "probably isn't going to work.  Brace for crash." << std::endl;
+
+  // Check validity of initial guess.
+  if (initialGuess)
+  {
+    if (centroids.n_cols != clusters)
+      Log::Fatal << "ChunkedKMeans::Cluster(): wrong number of initial cluster "
+        << "centroids (" << centroids.n_cols << ", should be " << clusters
+        << ")!" << std::endl;
+
+    if (centroids.n_rows != reader.Dimensionality())
+      Log::Fatal << "ChunkedKMeans::Cluster(): initial cluster centroids have "
+        << "wrong dimensionality (" << centroids.n_rows << ", should be "
+        << reader.Dimensionality() << ")!" << std::endl;
+  }
+  else
+  {
+    SampleCentroids(reader, clusters, centroids);
+  }
+
+  // Counts of points in each cluster.
+  arma::Col<size_t> counts(clusters);
+
+  size_t iteration = 0;
+  distanceCalculations = 0;
+
+  arma::mat centroidsOther;
+  double cNorm;
+
+  do
+  {
+    // As in KMeans, we alternate between two centroid matrices.
+    arma::mat& oldCentroids = (iteration % 2 == 0) ? centroids :
+        centroidsOther;
+    arma::mat& newCentroids = (iteration % 2 == 0) ? centroidsOther :
+        centroids;
+    cNorm = Iterate(reader, oldCentroids, newCentroids, counts);
+
+    // Empty clusters keep their last position, as with AllowEmptyClusters.
+    for (size_t i = 0; i < counts.n_elem; ++i)
+    {
+      if (counts[i] == 0)
+      {
+        Log::Info << "Cluster " << i << " is empty.\n";
+        newCentroids.col(i) = oldCentroids.col(i);
+      }
+    }
+
+    iteration++;
+    Log::Info << "ChunkedKMeans::Cluster(): iteration " << iteration
+        << ", residual " << cNorm << ".\n";
+    if (std::isnan(cNorm) || std::isinf(cNorm))
+      cNorm = 1e-4; // Keep iterating.
+  } while (cNorm > 1e-5 && iteration != maxIterations);
+
+  // If we ended on an even iteration, then the centroids are in the
+  // centroidsOther matrix.
+  if ((iteration - 1) % 2 == 0)
+    centroids.steal_mem(centroidsOther);
+
+  if (iteration != maxIterations)
+  {
+    Log::Info << "ChunkedKMeans::Cluster(): converged after " << iteration
+        << " iterations." << std::endl;
+  }
+  else
+  {
+    Log::Info << "ChunkedKMeans::Cluster(): terminated after limit of "
+        << iteration << " iterations." << std::endl;
+  }
+  Log::Info << distanceCalculations << " distance calculations." << std::endl;
+}
+
+template<typename MetricType>
+void ChunkedKMeans<MetricType>::Cluster(data::ChunkedMatrixReader& reader,
+                                        const size_t clusters,
+                                        arma::Row<size_t>& assignments,
+                                        arma::mat& centroids,
+                                        const bool initialGuess)
+{
+  Cluster(reader, clusters, centroids, initialGuess);
+
+  // Calculate final assignments with one more pass.
+  assignments.set_size(reader.Points());
+
+  reader.Rewind();
+  arma::mat chunk;
+  size_t offset = 0;
+  while (reader.NextChunk(chunk))
+  {
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) chunk.n_cols; ++i)
+    {
+      // Find the closest centroid to this point.
+      double minDistance = std::numeric_limits<double>::infinity();
+      size_t closestCluster = centroids.n_cols; // Invalid value.
+
+      for (size_t j = 0; j < centroids.n_cols; ++j)
+      {
+        const double distance = metric.Evaluate(chunk.col(i),
+            centroids.col(j));
+
+        if (distance < minDistance)
+        {
+          minDistance = distance;
+          closestCluster = j;
+        }
+      }
+
+      Log::Assert(closestCluster != centroids.n_cols);
+      assignments[offset + i] = closestCluster;
+    }
+
+    offset += chunk.n_cols;
+  }
+}
+
+template<typename MetricType>
+void ChunkedKMeans<MetricType>::SampleCentroids(
+    data::ChunkedMatrixReader& reader,
+    const size_t clusters,
+    arma::mat& centroids)
+{
+  // Draw the same points as SampleInitialization would.
+  std::vector<size_t> indices(clusters);
+  for (size_t i = 0; i < clusters; ++i)
+    indices[i] = (size_t) math::RandInt(0, reader.Points());
+
+  // Now find them in the file.
+  centroids.set_size(reader.Dimensionality(), clusters);
+  reader.Rewind();
+  arma::mat chunk;
+  size_t offset = 0;
+  while (reader.NextChunk(chunk))
+  {
+    for (size_t i = 0; i < clusters; ++i)
+    {
+      if (indices[i] >= offset && indices[i] < offset + chunk.n_cols)
+        centroids.col(i) = chunk.col(indices[i] - offset);
+    }
+
+    offset += chunk.n_cols;
+  }
+}
+
+template<typename MetricType>
+double ChunkedKMeans<MetricType>::Iterate(data::ChunkedMatrixReader& reader,
+                                          const arma::mat& centroids,
+                                          arma::mat& newCentroids,
+                                          arma::Col<size_t>& counts)
+{
+  newCentroids.zeros(centroids.n_rows, centroids.n_cols);
+  counts.zeros(centroids.n_cols);
+
+  reader.Rewind();
+  arma::mat chunk;
+  arma::Col<size_t> closestClusters;
+  while (reader.NextChunk(chunk))
+  {
+    // Find the closest centroid to each point of the chunk, in parallel.
+    closestClusters.set_size(chunk.n_cols);
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) chunk.n_cols; ++i)
+    {
+      double minDistance = std::numeric_limits<double>::infinity();
+      size_t closestCluster = centroids.n_cols; // Invalid value.
+
+      for (size_t j = 0; j < centroids.n_cols; ++j)
+      {
+        const double distance = metric.Evaluate(chunk.col(i),
+            centroids.unsafe_col(j));
+        if (distance < minDistance)
+        {
+          minDistance = distance;
+          closestCluster = j;
+        }
+      }
+
+      Log::Assert(closestCluster != centroids.n_cols);
+      closestClusters[i] = closestCluster;
+    }
+
+    // Add the points to their centroids in dataset order, so that the sums do
+    // not depend on the number of threads.
+    for (size_t i = 0; i < chunk.n_cols; ++i)
+    {
+      newCentroids.unsafe_col(closestClusters[i]) += chunk.unsafe_col(i);
+      counts(closestClusters[i])++;
+    }
+
+    distanceCalculations += centroids.n_cols * chunk.n_cols;
+  }
+
+  // Now normalize the centroid.
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+    if (counts(i) != 0)
+      newCentroids.col(i) /= counts(i);
+
+  // Calculate cluster distortion for this iteration.
+  double cNorm = 0.0;
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    cNorm += std::pow(metric.Evaluate(centroids.col(i), newCentroids.col(i)),
+        2.0);
+  }
+  distanceCalculations += centroids.n_cols;
+
+  return std::sqrt(cNorm);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -27,6 +27,7 @@ class ElkanKMeans
   /**
    * Run a single iteration of Elkan's algorithm, updating the given centroids
    * into the newCentroids matrix.
+   * The points are processed in parallel if OpenMP is available.
    *
    * @param centroids Current cluster centroids.
    * @param newCentroids New cluster centroids.
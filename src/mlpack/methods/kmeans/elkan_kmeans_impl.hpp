@@ -46,9 +46,6 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   // being the closest cluster centroid.
   clusterDistances.diag().fill(DBL_MAX);
 
-  // Initially set r(x) to true.
-  std::vector<bool> mustRecalculate(dataset.n_cols, true);
-
   // If this is the first iteration, we must reset all the bounds.
   if (lowerBounds.n_rows != centroids.n_cols)
   {
@@ -79,15 +76,36 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   // that this is equivalent to s(c) for each cluster c.
   minClusterDistances = 0.5 * arma::min(clusterDistances).t();
 
-  // Now loop over all points, and see which ones need to be updated.
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  // Now loop over all points in parallel, and see which ones need to be
+  // updated.  The bounds and assignment of each point are only touched by the
+  // thread that handles it.  Each fixed block of points is handled in order by
+  // one thread and summed into its own partial centroids, and the blocks are
+  // added in order afterwards, so the new centroids do not depend on the number
+  // of threads.  Blocks are at least as large as the number of clusters, so
+  // the partial centroids are no larger than the dataset.
+  const size_t blockSize = std::max((size_t) 1024, (size_t) centroids.n_cols);
+  const size_t numBlocks = (dataset.n_cols + blockSize - 1) / blockSize;
+  arma::cube blockCentroids(centroids.n_rows, centroids.n_cols, numBlocks,
+      arma::fill::zeros);
+  arma::Mat<size_t> blockCounts(centroids.n_cols, numBlocks,
+      arma::fill::zeros);
+
+  size_t pointDistanceCalculations = 0;
+  #pragma omp parallel for schedule(static, blockSize) \
+      reduction(+:pointDistanceCalculations)
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
   {
+    const size_t block = i / blockSize;
+
+    // Initially set r(x) to true.
+    bool mustRecalculate = true;
+
     // Step 2: identify all points such that u(x) <= s(c(x)).
     if (upperBounds(i) <= minClusterDistances(assignments[i]))
     {
       // No change needed.  This point must still belong to that cluster.
-      counts(assignments[i])++;
-      newCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
+      blockCounts(assignments[i], block)++;
+      blockCentroids.slice(block).col(assignments[i]) += dataset.col(i);
       continue;
     }
     else
@@ -108,13 +126,13 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
         // Step 3a: if r(x) then compute d(x, c(x)) and assign r(x) = false.
         // Otherwise, d(x, c(x)) = u(x).
         double dist;
-        if (mustRecalculate[i])
+        if (mustRecalculate)
         {
-          mustRecalculate[i] = false;
+          mustRecalculate = false;
           dist = metric.Evaluate(dataset.col(i), centroids.col(assignments[i]));
           lowerBounds(assignments[i], i) = dist;
           upperBounds(i) = dist;
-          distanceCalculations++;
+          pointDistanceCalculations++;
 
           // Check if we can prune again.
           if (upperBounds(i) <= lowerBounds(c, i))
@@ -136,7 +154,7 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
           const double pointDist = metric.Evaluate(dataset.col(i),
                                                    centroids.col(c));
           lowerBounds(c, i) = pointDist;
-          distanceCalculations++;
+          pointDistanceCalculations++;
           if (pointDist < dist)
           {
             upperBounds(i) = pointDist;
@@ -149,8 +167,20 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     // At this point, we know the new cluster assignment.
     // Step 4: for each center c, let m(c) be the mean of the points assigned to
     // c.
-    newCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
-    counts[assignments[i]]++;
+    blockCentroids.slice(block).col(assignments[i]) += dataset.col(i);
+    blockCounts(assignments[i], block)++;
+  }
+  distanceCalculations += pointDistanceCalculations;
+
+  // Add the partial centroids of the blocks in order.
+  #pragma omp parallel for
+  for (omp_size_t c = 0; c < (omp_size_t) centroids.n_cols; ++c)
+  {
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      newCentroids.col(c) += blockCentroids.slice(b).col(c);
+      counts[c] += blockCounts(c, b);
+    }
   }
 
   // Now, normalize and calculate the distance each cluster has moved.
@@ -166,7 +196,8 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     distanceCalculations++;
   }
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
   {
     // Step 5: for each point x and center c, assign
     //   l(x, c) = max { l(x, c) - d(c, m(c)), 0 }.
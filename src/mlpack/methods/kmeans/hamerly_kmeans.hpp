@@ -28,6 +28,7 @@ class HamerlyKMeans
   /**
    * Run a single iteration of Hamerly's algorithm, updating the given centroids
    * into the newCentroids matrix.
+   * The points are processed in parallel if OpenMP is available.
    *
    * @param centroids Current cluster centroids.
    * @param newCentroids New cluster centroids.
@@ -67,8 +67,26 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     }
   }
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  // Now loop over all points in parallel.  The bounds and assignment of each
+  // point are only touched by the thread that handles it.  The points are
+  // split into fixed blocks, each handled in order by a single thread, and each
+  // block sums its points into its own partial centroids; the block boundaries
+  // do not depend on the number of threads, so neither do the sums.  A block
+  // holds at least as many points as there are clusters, so the partial
+  // centroids take no more memory than the dataset.
+  const size_t blockSize = std::max((size_t) 1024, (size_t) centroids.n_cols);
+  const size_t numBlocks = (dataset.n_cols + blockSize - 1) / blockSize;
+  arma::cube blockCentroids(centroids.n_rows, centroids.n_cols, numBlocks,
+      arma::fill::zeros);
+  arma::Mat<size_t> blockCounts(centroids.n_cols, numBlocks,
+      arma::fill::zeros);
+
+  size_t pointDistanceCalculations = 0;
+  #pragma omp parallel for schedule(static, blockSize) \
+      reduction(+:hamerlyPruned, pointDistanceCalculations)
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
   {
+    const size_t block = i / blockSize;
     const double m = std::max(minClusterDistances(assignments[i]),
                               lowerBounds(i));
 
@@ -76,21 +94,21 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     if (upperBounds(i) <= m)
     {
       ++hamerlyPruned;
-      newCentroids.col(assignments[i]) += dataset.col(i);
-      ++counts(assignments[i]);
+      blockCentroids.slice(block).col(assignments[i]) += dataset.col(i);
+      ++blockCounts(assignments[i], block);
       continue;
     }
 
     // Tighten upper bound.
     upperBounds(i) = metric.Evaluate(dataset.col(i),
                                      centroids.col(assignments[i]));
-    ++distanceCalculations;
+    ++pointDistanceCalculations;
 
     // Second bound test.
     if (upperBounds(i) <= m)
     {
-      newCentroids.col(assignments[i]) += dataset.col(i);
-      ++counts(assignments[i]);
+      blockCentroids.slice(block).col(assignments[i]) += dataset.col(i);
+      ++blockCounts(assignments[i], block);
       continue;
     }
 
@@ -119,11 +137,23 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
         lowerBounds(i) = dist;
       }
     }
-    distanceCalculations += centroids.n_cols - 1;
+    pointDistanceCalculations += centroids.n_cols - 1;
 
     // Update new centroids.
-    newCentroids.col(assignments[i]) += dataset.col(i);
-    ++counts(assignments[i]);
+    blockCentroids.slice(block).col(assignments[i]) += dataset.col(i);
+    ++blockCounts(assignments[i], block);
+  }
+  distanceCalculations += pointDistanceCalculations;
+
+  // Add the partial centroids of the blocks in order.
+  #pragma omp parallel for
+  for (omp_size_t c = 0; c < (omp_size_t) centroids.n_cols; ++c)
+  {
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      newCentroids.col(c) += blockCentroids.slice(b).col(c);
+      counts(c) += blockCounts(c, b);
+    }
   }
 
   // Normalize centroids and calculate cluster movement (contains parts of
@@ -158,7 +188,8 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   }
 
   // Now update bounds (lines 3-8 of Update-Bounds()).
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
   {
     upperBounds(i) += centroidMovements(assignments[i]);
     if (assignments[i] == furthestMovingCluster)
@@ -17,10 +17,13 @@
 #include "allow_empty_clusters.hpp"
 #include "kill_empty_clusters.hpp"
 #include "refined_start.hpp"
+#include "kmeans_parallel_initialization.hpp"
 #include "elkan_kmeans.hpp"
 #include "hamerly_kmeans.hpp"
 #include "pelleg_moore_kmeans.hpp"
 #include "dual_tree_kmeans.hpp"
+#include "mini_batch_kmeans.hpp"
+#include "yinyang_kmeans.hpp"
 
 using namespace mlpack;
 using namespace mlpack::kmeans;
@@ -53,14 +56,29 @@ BINDING_LONG_DESC(
     "used in each sample, the " + PRINT_PARAM_STRING("percentage") +
     " parameter is used (it should be a value between 0.0 and 1.0)."
     "\n\n"
+    "Alternately, the k-means|| approach (\"Scalable k-means++\", 2012) can be "
+    "used to select initial points by specifying the " +
+    PRINT_PARAM_STRING("kmeans_parallel") + " parameter.  This approach picks "
+    "candidate points in a few parallel rounds; the number of rounds is given "
+    "by the " + PRINT_PARAM_STRING("rounds") + " parameter, and the expected "
+    "number of candidates picked in each round, as a multiple of the number of "
+    "clusters, is given by the " + PRINT_PARAM_STRING("oversampling") +
+    " parameter."
+    "\n\n"
     "There are several options available for the algorithm used for each Lloyd "
     "iteration, specified with the " + PRINT_PARAM_STRING("algorithm") + " "
     " option.  The standard O(kN) approach can be used ('naive').  Other "
     "options include the Pelleg-Moore tree-based algorithm ('pelleg-moore'), "
     "Elkan's triangle-inequality based algorithm ('elkan'), Hamerly's "
     "modification to Elkan's algorithm ('hamerly'), the dual-tree k-means "
-    "algorithm ('dualtree'), and the dual-tree k-means algorithm using the "
-    "cover tree ('dualtree-covertree')."
+    "algorithm ('dualtree'), the dual-tree k-means algorithm using the "
+    "cover tree ('dualtree-covertree'), the Yinyang algorithm ('yinyang'), "
+    "which keeps Elkan-style bounds for groups of clusters, and mini-batch "
+    "k-means ('minibatch'), which only visits a random batch of 1024 points in "
+    "each iteration and gives approximate results.  Mini-batch k-means "
+    "stops once the average drift of the centroids, relative to the spread of "
+    "the points around them, is small, and treats a cluster that no batch has "
+    "reached yet as empty."
     "\n\n"
     "The behavior for when an empty cluster is encountered can be modified with"
     " the " + PRINT_PARAM_STRING("allow_empty_clusters") + " option.  When "
@@ -148,9 +166,18 @@ PARAM_INT_IN("samplings", "Number of samplings to perform for refined start "
 PARAM_DOUBLE_IN("percentage", "Percentage of dataset to use for each refined "
     "start sampling (use when --refined_start is specified).", "p", 0.02);
 
+// Parameters for k-means|| initialization.
+PARAM_FLAG("kmeans_parallel", "Use the k-means|| (scalable k-means++) initial "
+    "point strategy to choose initial points.", "K");
+PARAM_INT_IN("rounds", "Number of sampling rounds for k-means|| (use when "
+    "--kmeans_parallel is specified).", "R", 5);
+PARAM_DOUBLE_IN("oversampling", "Expected number of candidates picked in each "
+    "k-means|| round, divided by the number of clusters (use when "
+    "--kmeans_parallel is specified).", "O", 2.0);
+
 PARAM_STRING_IN("algorithm", "Algorithm to use for the Lloyd iteration "
-    "('naive', 'pelleg-moore', 'elkan', 'hamerly', 'dualtree', or "
-    "'dualtree-covertree').", "a", "naive");
+    "('naive', 'pelleg-moore', 'elkan', 'hamerly', 'dualtree', "
+    "'dualtree-covertree', 'yinyang', or 'minibatch').", "a", "naive");
 
 // Given the type of initial partition policy, figure out the empty cluster
 // policy and run k-means.
@@ -179,6 +206,7 @@ static void mlpackMain()
   // Now, start building the KMeans type that we'll be using.  Start with the
   // initial partition policy.  The call to FindEmptyClusterPolicy<> results in
   // a call to RunKMeans<> and the algorithm is completed.
+  ReportIgnoredParam({{ "refined_start", true }}, "kmeans_parallel");
   if (IO::HasParam("refined_start"))
   {
     RequireParamValue<int>("samplings", [](int x) { return x > 0; }, true,
@@ -191,6 +219,18 @@ static void mlpackMain()
 
     FindEmptyClusterPolicy<RefinedStart>(RefinedStart(samplings, percentage));
   }
+  else if (IO::HasParam("kmeans_parallel"))
+  {
+    RequireParamValue<int>("rounds", [](int x) { return x >= 0; }, true,
+        "number of rounds must not be negative");
+    const int rounds = IO::GetParam<int>("rounds");
+    RequireParamValue<double>("oversampling", [](double x) { return x > 0.0; },
+        true, "oversampling factor must be positive");
+    const double oversampling = IO::GetParam<double>("oversampling");
+
+    FindEmptyClusterPolicy<KMeansParallelInitialization>(
+        KMeansParallelInitialization(rounds, oversampling));
+  }
   else
   {
     FindEmptyClusterPolicy<SampleInitialization>(SampleInitialization());
@@ -221,8 +261,9 @@ template<typename InitialPartitionPolicy, typename EmptyClusterPolicy>
 void FindLloydStepType(const InitialPartitionPolicy& ipp)
 {
   RequireParamInSet<string>("algorithm", { "elkan", "hamerly", "pelleg-moore",
-      "dualtree", "dualtree-covertree", "naive" }, true, "unknown k-means "
-      "algorithm");
+      "dualtree", "dualtree-covertree", "naive", "yinyang", "minibatch" },
+      true,
+      "unknown k-means algorithm");
 
   const string algorithm = IO::GetParam<string>("algorithm");
   if (algorithm == "elkan")
@@ -240,6 +281,12 @@ void FindLloydStepType(const InitialPartitionPolicy& ipp)
         CoverTreeDualTreeKMeans>(ipp);
   else if (algorithm == "naive")
     RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy, NaiveKMeans>(ipp);
+  else if (algorithm == "yinyang")
+    RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy,
+        DefaultYinyangKMeans>(ipp);
+  else if (algorithm == "minibatch")
+    RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy,
+        DefaultMiniBatchKMeans>(ipp);
 }
 
 // Given the template parameters, sanitize/load input and run k-means.
@@ -286,8 +333,9 @@ void RunKMeans(const InitialPartitionPolicy& ipp)
       clusters = centroids.n_cols;
 
     ReportIgnoredParam({{ "refined_start", true }}, "initial_centroids");
+    ReportIgnoredParam({{ "kmeans_parallel", true }}, "initial_centroids");
 
-    if (!IO::HasParam("refined_start"))
+    if (!IO::HasParam("refined_start") && !IO::HasParam("kmeans_parallel"))
       Log::Info << "Using initial centroid guesses." << endl;
   }
 
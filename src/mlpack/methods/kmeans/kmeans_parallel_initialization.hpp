@@ -0,0 +1,120 @@
+/**
+ * @file methods/kmeans/kmeans_parallel_initialization.hpp
+ *
+ * An implementation of k-means|| (scalable k-means++), which chooses initial
+ * centroids in a few oversampling rounds instead of k sequential rounds.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * The k-means|| initialization strategy, for use as the InitialPartitionPolicy
+ * of the KMeans class.  k-means++ picks each initial centroid with probability
+ * proportional to its squared distance to the centroids picked so far, which
+ * takes k passes over the data.  k-means|| instead makes a small number of
+ * rounds; in each round, every point is picked independently with probability
+ * proportional to its squared distance to the candidates so far, with about
+ * oversampling * k points picked per round.  Each candidate is then weighted
+ * by the number of points closest to it, and k-means++ is run on the weighted
+ * candidates (which are much fewer than the points) to choose the k initial
+ * centroids.
+ *
+ * The distances between the points and the candidates, which dominate the
+ * cost, are computed in parallel if OpenMP is available.  For more information,
+ * see the following paper:
+ *
+ * @code
+ * @article{bahmani2012scalable,
+ *   title={Scalable k-means++},
+ *   author={Bahmani, Bahman and Moseley, Benjamin and Vattani, Andrea and
+ *       Kumar, Ravi and Vassilvitskii, Sergei},
+ *   journal={Proceedings of the VLDB Endowment},
+ *   volume={5},
+ *   number={7},
+ *   pages={622--633},
+ *   year={2012}
+ * }
+ * @endcode
+ *
+ * Distances are squared Euclidean distances, as in k-means++.
+ */
+class KMeansParallelInitialization
+{
+ public:
+  /**
+   * Create the KMeansParallelInitialization object, optionally specifying the
+   * number of sampling rounds and the oversampling factor.
+   *
+   * @param rounds Number of sampling rounds.
+   * @param oversampling Expected number of candidates picked in each round,
+   *     as a multiple of the number of clusters.
+   */
+  KMeansParallelInitialization(const size_t rounds = 5,
+                               const double oversampling = 2.0) :
+      rounds(rounds), oversampling(oversampling) { }
+
+  /**
+   * Choose initial centroids for the given dataset with k-means||.
+   *
+   * @tparam MatType Type of data (arma::mat or arma::sp_mat).
+   * @param data Dataset to partition.
+   * @param clusters Number of clusters to split dataset into.
+   * @param centroids Matrix to store centroids into.
+   */
+  template<typename MatType>
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::mat& centroids) const;
+
+  //! Get the number of sampling rounds.
+  size_t Rounds() const { return rounds; }
+  //! Modify the number of sampling rounds.
+  size_t& Rounds() { return rounds; }
+
+  //! Get the oversampling factor.
+  double Oversampling() const { return oversampling; }
+  //! Modify the oversampling factor.
+  double& Oversampling() { return oversampling; }
+
+  //! Serialize the object.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(rounds));
+    ar(CEREAL_NVP(oversampling));
+  }
+
+ private:
+  /**
+   * Run k-means++ on the weighted candidates to choose the centroids.
+   */
+  static void WeightedKMeansPlusPlus(const arma::mat& candidates,
+                                     const arma::vec& weights,
+                                     const size_t clusters,
+                                     arma::mat& centroids);
+
+  //! The number of sampling rounds.
+  size_t rounds;
+  //! The expected number of candidates picked in each round, divided by the
+  //! number of clusters.
+  double oversampling;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "kmeans_parallel_initialization_impl.hpp"
+
+#endif
@@ -0,0 +1,161 @@
+/**
+ * @file methods/kmeans/kmeans_parallel_initialization_impl.hpp
+ *
+ * Implementation of the KMeansParallelInitialization class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kmeans_parallel_initialization.hpp"
+
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+//! Choose initial centroids with k-means||.
+template<typename MatType>
+void KMeansParallelInitialization::Cluster(const MatType& data,
+                                           const size_t clusters,
+                                           arma::mat& centroids) const
+{
+  // The squared distance from each point to its closest candidate, and the
+  // index of that candidate.
+  arma::vec minDistances(data.n_cols);
+  minDistances.fill(DBL_MAX);
+  arma::Col<size_t> closestCandidates(data.n_cols);
+
+  // Start with one point chosen uniformly at random.
+  std::vector<size_t> candidates;
+  candidates.push_back((size_t) math::RandInt(data.n_cols));
+
+  const double expectedSamples = oversampling * clusters;
+  size_t processedCandidates = 0;
+  for (size_t round = 0; round <= rounds; ++round)
+  {
+    // Update the distances with the candidates picked in the last round.  This
+    // is where nearly all of the time is spent.
+    const size_t numCandidates = candidates.size();
+    double cost = 0.0;
+    #pragma omp parallel for reduction(+:cost)
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    {
+      for (size_t j = processedCandidates; j < numCandidates; ++j)
+      {
+        const double distance = metric::SquaredEuclideanDistance::Evaluate(
+            data.col(i), data.col(candidates[j]));
+        if (distance < minDistances[i])
+        {
+          minDistances[i] = distance;
+          closestCandidates[i] = j;
+        }
+      }
+
+      cost += minDistances[i];
+    }
+    processedCandidates = numCandidates;
+
+    // The last round only computes the weights of the candidates.
+    if (round == rounds || cost == 0.0)
+      break;
+
+    // Pick each point independently, with probability proportional to its
+    // contribution to the cost.  This is done serially, since the random number
+    // generator is shared.
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      if (minDistances[i] > 0.0 &&
+          math::Random() * cost < expectedSamples * minDistances[i])
+        candidates.push_back(i);
+    }
+  }
+
+  Log::Info << "KMeansParallelInitialization::Cluster(): picked "
+      << candidates.size() << " candidates for " << clusters << " clusters."
+      << std::endl;
+
+  // Weight each candidate by the number of points closest to it.
+  arma::mat candidatePoints(data.n_rows, candidates.size());
+  arma::vec weights(candidates.size(), arma::fill::zeros);
+  for (size_t j = 0; j < candidates.size(); ++j)
+    candidatePoints.col(j) = data.col(candidates[j]);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    weights[closestCandidates[i]] += 1.0;
+
+  if (candidates.size() > clusters)
+  {
+    WeightedKMeansPlusPlus(candidatePoints, weights, clusters, centroids);
+  }
+  else
+  {
+    // There are too few candidates (this only happens when the data has very
+    // few distinct points), so fill the rest with random points.
+    centroids.set_size(data.n_rows, clusters);
+    centroids.cols(0, candidates.size() - 1) = candidatePoints;
+    for (size_t i = candidates.size(); i < clusters; ++i)
+      centroids.col(i) = data.col(math::RandInt(data.n_cols));
+  }
+}
+
+//! Run k-means++ on the weighted candidates.
+inline void KMeansParallelInitialization::WeightedKMeansPlusPlus(
+    const arma::mat& candidates,
+    const arma::vec& weights,
+    const size_t clusters,
+    arma::mat& centroids)
+{
+  centroids.set_size(candidates.n_rows, clusters);
+
+  arma::vec minDistances(candidates.n_cols);
+  minDistances.fill(DBL_MAX);
+  for (size_t c = 0; c < clusters; ++c)
+  {
+    // Pick the first centroid by weight, and the others by weight times
+    // squared distance to the centroids picked so far.  If every candidate
+    // is already a centroid, fall back to the weights.
+    arma::vec probabilities = weights;
+    if (c > 0)
+      probabilities %= minDistances;
+    double total = arma::accu(probabilities);
+    if (total <= 0.0)
+    {
+      probabilities = weights;
+      total = arma::accu(probabilities);
+    }
+
+    const double target = math::Random() * total;
+    double cumulative = 0.0;
+    size_t pick = candidates.n_cols - 1;
+    for (size_t j = 0; j < candidates.n_cols; ++j)
+    {
+      cumulative += probabilities[j];
+      if (target < cumulative)
+      {
+        pick = j;
+        break;
+      }
+    }
+
+    centroids.col(c) = candidates.col(pick);
+
+    // Update the distances from each candidate to the closest centroid.
+    #pragma omp parallel for
+    for (omp_size_t j = 0; j < (omp_size_t) candidates.n_cols; ++j)
+    {
+      const double distance = metric::SquaredEuclideanDistance::Evaluate(
+          candidates.col(j), centroids.col(c));
+      minDistances[j] = std::min(minDistances[j], distance);
+    }
+  }
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,147 @@
+/**
+ * @file methods/kmeans/mini_batch_kmeans.hpp
+ *
+ * An implementation of mini-batch k-means: each step of the algorithm only
+ * visits a small random sample of the dataset.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * This is an implementation of a single step of mini-batch k-means, for use as
+ * the LloydStepType of the KMeans class.  Instead of visiting every point, each
+ * call to Iterate() draws a random batch of BatchSize points (with
+ * replacement), assigns each of them to its nearest centroid, and moves each
+ * centroid towards its new points with a per-centroid learning rate of
+ * 1 / (number of points the centroid has been given so far).  Each centroid is
+ * therefore the mean of all of the batch points it has ever been given.
+ *
+ * Since each step moves the centroids by a random amount, the drift of the
+ * centroids rarely falls below the fixed convergence tolerance of KMeans
+ * (1e-5).  So MiniBatchKMeans keeps its own convergence check: after each step,
+ * the squared drift of the centroids is divided by the mean squared distance
+ * between the batch points and their nearest centroids, which makes it
+ * independent of the scale of the data, and an exponentially weighted average
+ * of this relative drift over the steps is taken, so that a single small step
+ * does not stop the algorithm.  Once the average falls below Tolerance(),
+ * Iterate() returns 0 and KMeans stops; otherwise it returns the norm of the
+ * drift of the centroids.  Each step costs O(BatchSize k) distance
+ * calculations instead of O(N k), and the assignment of the batch points is
+ * done in parallel if OpenMP is available.
+ *
+ * The counts reported by Iterate() are the numbers of batch points each cluster
+ * has been given so far, so a centroid that no batch has reached is reported
+ * as empty and is handled by the EmptyClusterPolicy of KMeans.  If the policy
+ * changes the counts (for instance, MaxVarianceNewCluster moves a point to the
+ * empty cluster, and KillEmptyClusters removes it), the next call to Iterate()
+ * continues from the changed counts.
+ *
+ * For more information, see the following paper:
+ *
+ * @code
+ * @inproceedings{sculley2010web,
+ *   title={Web-scale k-means clustering},
+ *   author={Sculley, David},
+ *   booktitle={Proceedings of the 19th International Conference on World Wide
+ *       Web},
+ *   pages={1177--1178},
+ *   year={2010}
+ * }
+ * @endcode
+ *
+ * The batch size is a template parameter, because KMeans constructs its step
+ * type from only the dataset and the metric; a template typedef can give a
+ * different batch size:
+ *
+ * @code
+ * template<typename MetricType, typename MatType>
+ * using SmallBatchKMeans = MiniBatchKMeans<MetricType, MatType, 256>;
+ *
+ * KMeans<metric::EuclideanDistance, SampleInitialization,
+ *     MaxVarianceNewCluster, SmallBatchKMeans> k(100);
+ * @endcode
+ *
+ * @tparam MetricType Type of metric used with this implementation.
+ * @tparam MatType Matrix type (arma::mat or arma::sp_mat).
+ * @tparam BatchSize Number of points in each batch.
+ */
+template<typename MetricType, typename MatType, size_t BatchSize = 1024>
+class MiniBatchKMeans
+{
+ public:
+  /**
+   * Construct the MiniBatchKMeans object with the given dataset and metric.
+   *
+   * @param dataset Dataset.
+   * @param metric Instantiated metric.
+   * @param tolerance Tolerance on the average relative drift of the centroids.
+   */
+  MiniBatchKMeans(const MatType& dataset,
+                  MetricType& metric,
+                  const double tolerance = 1e-5);
+
+  /**
+   * Run a single step of mini-batch k-means, updating the given centroids into
+   * the newCentroids matrix.  A centroid that has never been given a point
+   * keeps its position, and its count is reported as 0.  After the first call,
+   * counts should hold the counts returned by the previous call, possibly
+   * changed by an empty cluster policy.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Number of batch points each cluster has been given so far.
+   * @return 0 if the average relative drift of the centroids is below the
+   *     tolerance; otherwise, the norm of the drift of the centroids.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+  //! Get the tolerance on the average relative drift of the centroids.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance on the average relative drift of the centroids.
+  double& Tolerance() { return tolerance; }
+
+ private:
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+
+  //! Tolerance on the average relative drift of the centroids.
+  double tolerance;
+
+  //! The number of batch points each cluster has been given so far.
+  arma::Col<size_t> totalCounts;
+  //! The average relative drift of the centroids over the steps so far, or a
+  //! negative value before the first step.
+  double averageDrift;
+
+  //! Number of distance calculations.
+  size_t distanceCalculations;
+};
+
+//! A template typedef for mini-batch k-means with the default batch size.
+template<typename MetricType, typename MatType>
+using DefaultMiniBatchKMeans = MiniBatchKMeans<MetricType, MatType>;
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "mini_batch_kmeans_impl.hpp"
+
+#endif
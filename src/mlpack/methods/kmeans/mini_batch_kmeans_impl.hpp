@@ -0,0 +1,153 @@
+/**
+ * @file methods/kmeans/mini_batch_kmeans_impl.hpp
+ *
+ * Implementation of the MiniBatchKMeans class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mini_batch_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType, typename MatType, size_t BatchSize>
+MiniBatchKMeans<MetricType, MatType, BatchSize>::MiniBatchKMeans(
+    const MatType& dataset,
+    MetricType& metric,
+    const double tolerance) :
+    dataset(dataset),
+    metric(metric),
+    tolerance(tolerance),
+    averageDrift(-1.0),
+    distanceCalculations(0)
+{ /* Nothing to do. */ }
+
+// Run a single step.
+template<typename MetricType, typename MatType, size_t BatchSize>
+double MiniBatchKMeans<MetricType, MatType, BatchSize>::Iterate(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  // The counts given to the first call are not set yet; after that, they are
+  // the counts of the last call, which the empty cluster policy may have
+  // changed.
+  if (averageDrift < 0.0 || counts.n_elem != centroids.n_cols)
+    totalCounts.zeros(centroids.n_cols);
+  else
+    totalCounts = counts;
+
+  // Draw the batch.  This is done serially, since the random number generator
+  // is shared.
+  const size_t batchSize = std::min(BatchSize, (size_t) dataset.n_cols);
+  arma::Col<size_t> batch(batchSize);
+  for (size_t i = 0; i < batchSize; ++i)
+    batch[i] = math::RandInt(dataset.n_cols);
+
+  arma::mat batchSums(centroids.n_rows, centroids.n_cols, arma::fill::zeros);
+  arma::Col<size_t> batchCounts(centroids.n_cols, arma::fill::zeros);
+  double batchDistances = 0.0;
+
+  // Find the closest centroid to each point of the batch, in parallel.
+  #pragma omp parallel
+  {
+    // The sums of each thread are private.
+    arma::mat localSums(centroids.n_rows, centroids.n_cols, arma::fill::zeros);
+    arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
+    double localDistances = 0.0;
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) batchSize; ++i)
+    {
+      const size_t point = batch[i];
+
+      // Find the closest centroid to this point.
+      double minDistance = std::numeric_limits<double>::infinity();
+      size_t closestCluster = centroids.n_cols; // Invalid value.
+
+      for (size_t j = 0; j < centroids.n_cols; ++j)
+      {
+        const double distance = metric.Evaluate(dataset.col(point),
+            centroids.unsafe_col(j));
+        if (distance < minDistance)
+        {
+          minDistance = distance;
+          closestCluster = j;
+        }
+      }
+
+      Log::Assert(closestCluster != centroids.n_cols);
+
+      localSums.unsafe_col(closestCluster) += dataset.col(point);
+      localCounts(closestCluster)++;
+      localDistances += minDistance * minDistance;
+    }
+
+    // Combine calculated state from each thread
+    #pragma omp critical
+    {
+      batchSums += localSums;
+      batchCounts += localCounts;
+      batchDistances += localDistances;
+    }
+  }
+
+  // Taking one gradient step per point with learning rate 1 / (count of the
+  // centroid) makes each centroid the running mean of its points, so the steps
+  // for all of the points of the batch can be taken at once.
+  newCentroids = centroids;
+  for (size_t j = 0; j < centroids.n_cols; ++j)
+  {
+    if (batchCounts[j] == 0)
+      continue;
+
+    totalCounts[j] += batchCounts[j];
+    const double learningRate = double(batchCounts[j]) / totalCounts[j];
+    newCentroids.col(j) += learningRate *
+        (batchSums.col(j) / batchCounts[j] - centroids.col(j));
+  }
+
+  counts = totalCounts;
+
+  distanceCalculations += centroids.n_cols * batchSize;
+
+  // Calculate the drift of the centroids during this step.
+  double cNorm = 0.0;
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    cNorm += std::pow(metric.Evaluate(centroids.col(i), newCentroids.col(i)),
+        2.0);
+  }
+  distanceCalculations += centroids.n_cols;
+
+  // The drift relative to the mean squared distance of the batch points to
+  // their centroids does not depend on the scale of the data.  Its average is
+  // weighted towards the recent steps.  If every batch point is on its
+  // centroid, a nonzero drift is taken to be as large as the spread of the
+  // points.
+  const double meanDistance = batchDistances / batchSize;
+  double relativeDrift;
+  if (meanDistance > 0.0)
+    relativeDrift = cNorm / meanDistance;
+  else
+    relativeDrift = (cNorm > 0.0) ? 1.0 : 0.0;
+
+  if (averageDrift < 0.0)
+    averageDrift = relativeDrift;
+  else
+    averageDrift = 0.7 * averageDrift + 0.3 * relativeDrift;
+
+  return (averageDrift < tolerance) ? 0.0 : std::sqrt(cNorm);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
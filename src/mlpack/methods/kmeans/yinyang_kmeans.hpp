@@ -0,0 +1,135 @@
+/**
+ * @file methods/kmeans/yinyang_kmeans.hpp
+ *
+ * An implementation of the Yinyang algorithm for exact Lloyd iterations, which
+ * keeps one lower bound per group of centroids instead of one per centroid.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_YINYANG_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_YINYANG_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * An implementation of Yinyang k-means, for use as the LloydStepType of the
+ * KMeans class.  Like Elkan's algorithm, it gives exactly the same result as
+ * the naive Lloyd iteration, but avoids most distance calculations with bounds
+ * derived from the triangle inequality.  Elkan's algorithm keeps a lower bound
+ * on the distance between each point and each centroid, which takes O(kN)
+ * memory; this class splits the centroids into groups (by clustering the
+ * initial centroids) and keeps one lower bound per point and group, which
+ * takes O(tN) memory for t groups.
+ *
+ * Each point has an upper bound on the distance to its centroid.  A point whose
+ * upper bound is below all of its group lower bounds keeps its centroid (global
+ * filtering); otherwise only the groups whose lower bound is below the upper
+ * bound are visited (group filtering), and in those, the centroids that have
+ * not moved enough to come closer are skipped (local filtering).  The points
+ * are processed in parallel if OpenMP is available.
+ *
+ * For more information, see the following paper:
+ *
+ * @code
+ * @inproceedings{ding2015yinyang,
+ *   title={Yinyang k-means: A drop-in replacement of the classic k-means with
+ *       consistent speedup},
+ *   author={Ding, Yufei and Zhao, Yue and Shen, Xipeng and Musuvathi, Madanlal
+ *       and Mytkowicz, Todd},
+ *   booktitle={Proceedings of the 32nd International Conference on Machine
+ *       Learning (ICML '15)},
+ *   pages={579--587},
+ *   year={2015}
+ * }
+ * @endcode
+ *
+ * KMeans constructs its step type from only the dataset and the metric, so the
+ * number of groups is a template parameter; a template typedef can set it:
+ *
+ * @code
+ * template<typename MetricType, typename MatType>
+ * using Yinyang64KMeans = YinyangKMeans<MetricType, MatType, 64>;
+ * @endcode
+ *
+ * @tparam MetricType Type of metric used with this implementation; it must
+ *     satisfy the triangle inequality.
+ * @tparam MatType Matrix type (arma::mat or arma::sp_mat).
+ * @tparam Groups Number of groups of centroids; if 0, it is k / 10 (but at
+ *     least 1).
+ */
+template<typename MetricType, typename MatType, size_t Groups = 0>
+class YinyangKMeans
+{
+ public:
+  /**
+   * Construct the YinyangKMeans object, which must store several sets of
+   * bounds.
+   */
+  YinyangKMeans(const MatType& dataset, MetricType& metric);
+
+  /**
+   * Run a single iteration of the Yinyang algorithm, updating the given
+   * centroids into the newCentroids matrix.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Current counts, to be overwritten with new counts.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+ private:
+  /**
+   * Split the given centroids into groups, by clustering them.
+   */
+  void GroupCentroids(const arma::mat& centroids);
+
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+
+  //! The offset of each group in groupCentroids, followed by the number of
+  //! centroids.
+  arma::Col<size_t> groupOffsets;
+  //! The index of each centroid, grouped by group.
+  arma::Col<size_t> groupCentroids;
+  //! The group of each centroid.
+  arma::Col<size_t> centroidGroups;
+
+  //! The centroids given to the previous iteration.
+  arma::mat lastCentroids;
+
+  //! Holds the index of the cluster that owns each point.
+  arma::Col<size_t> assignments;
+
+  //! Upper bounds on the distance between each point and its closest cluster.
+  arma::vec upperBounds;
+  //! Lower bounds on the distance between each point and the clusters of each
+  //! group, other than its own cluster (one column per point).
+  arma::mat lowerBounds;
+
+  //! Track distance calculations.
+  size_t distanceCalculations;
+};
+
+//! A template typedef for Yinyang k-means with the default number of groups.
+template<typename MetricType, typename MatType>
+using DefaultYinyangKMeans = YinyangKMeans<MetricType, MatType>;
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "yinyang_kmeans_impl.hpp"
+
+#endif
@@ -0,0 +1,329 @@
+/**
+ * @file methods/kmeans/yinyang_kmeans_impl.hpp
+ *
+ * Implementation of the YinyangKMeans class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_YINYANG_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_YINYANG_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "yinyang_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType, typename MatType, size_t Groups>
+YinyangKMeans<MetricType, MatType, Groups>::YinyangKMeans(
+    const MatType& dataset,
+    MetricType& metric) :
+    dataset(dataset),
+    metric(metric),
+    distanceCalculations(0)
+{ /* Nothing to do. */ }
+
+// Run a single iteration of the Yinyang algorithm for Lloyd iterations.
+template<typename MetricType, typename MatType, size_t Groups>
+double YinyangKMeans<MetricType, MatType, Groups>::Iterate(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  newCentroids.zeros(centroids.n_rows, centroids.n_cols);
+  counts.zeros(centroids.n_cols);
+
+  // If this is the first iteration, the centroids must be grouped and all the
+  // bounds must be computed from scratch.
+  const bool initialize = (lastCentroids.n_cols != centroids.n_cols ||
+      assignments.n_elem != dataset.n_cols);
+  if (initialize)
+  {
+    GroupCentroids(centroids);
+
+    const size_t numGroups = groupOffsets.n_elem - 1;
+    assignments.set_size(dataset.n_cols);
+    upperBounds.set_size(dataset.n_cols);
+    lowerBounds.set_size(numGroups, dataset.n_cols);
+  }
+
+  const size_t numGroups = groupOffsets.n_elem - 1;
+
+  // Find how far each centroid (and the farthest centroid of each group) has
+  // moved since the bounds were computed.  The drifts are taken from the
+  // centroids we were last given, not the ones we last returned, since the
+  // empty cluster policy may have changed them in between.
+  arma::vec drifts(centroids.n_cols, arma::fill::zeros);
+  arma::vec groupDrifts(numGroups, arma::fill::zeros);
+  if (!initialize)
+  {
+    for (size_t g = 0; g < numGroups; ++g)
+    {
+      for (size_t j = groupOffsets[g]; j < groupOffsets[g + 1]; ++j)
+      {
+        const size_t c = groupCentroids[j];
+        drifts[c] = metric.Evaluate(lastCentroids.col(c), centroids.col(c));
+        groupDrifts[g] = std::max(groupDrifts[g], drifts[c]);
+      }
+    }
+    distanceCalculations += centroids.n_cols;
+  }
+
+  size_t pointDistanceCalculations = 0;
+
+  // Find the closest centroid to each point, in parallel.
+  #pragma omp parallel reduction(+:pointDistanceCalculations)
+  {
+    // The sums of each thread are private.
+    arma::mat localCentroids(centroids.n_rows, centroids.n_cols,
+        arma::fill::zeros);
+    arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
+
+    // For each group visited for a point, the smallest value (and the centroid
+    // it belongs to, or centroids.n_cols if it is only a bound) and the
+    // second-smallest value.
+    arma::vec firstValues(numGroups);
+    arma::Col<size_t> firstCentroids(numGroups);
+    arma::vec secondValues(numGroups);
+    std::vector<bool> visited(numGroups);
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+    {
+      if (initialize)
+      {
+        // Compute the distance to every centroid.
+        arma::vec distances(centroids.n_cols);
+        size_t closestCluster = centroids.n_cols; // Invalid value.
+        double minDistance = std::numeric_limits<double>::infinity();
+        for (size_t c = 0; c < centroids.n_cols; ++c)
+        {
+          distances[c] = metric.Evaluate(dataset.col(i),
+              centroids.unsafe_col(c));
+          if (distances[c] < minDistance)
+          {
+            minDistance = distances[c];
+            closestCluster = c;
+          }
+        }
+        pointDistanceCalculations += centroids.n_cols;
+
+        Log::Assert(closestCluster != centroids.n_cols);
+
+        assignments[i] = closestCluster;
+        upperBounds[i] = minDistance;
+        for (size_t g = 0; g < numGroups; ++g)
+        {
+          lowerBounds(g, i) = DBL_MAX;
+          for (size_t j = groupOffsets[g]; j < groupOffsets[g + 1]; ++j)
+          {
+            const size_t c = groupCentroids[j];
+            if (c != closestCluster)
+              lowerBounds(g, i) = std::min(lowerBounds(g, i), distances[c]);
+          }
+        }
+      }
+      else
+      {
+        // Update the bounds with the drifts.
+        const size_t oldCluster = assignments[i];
+        upperBounds[i] += drifts[oldCluster];
+        lowerBounds.col(i) -= groupDrifts;
+
+        // Global filtering: if the upper bound is below every group lower
+        // bound, the assignment can't change.
+        const double globalLowerBound = arma::min(lowerBounds.col(i));
+        if (upperBounds[i] > globalLowerBound)
+        {
+          // Tighten the upper bound, and try again.
+          upperBounds[i] = metric.Evaluate(dataset.col(i),
+              centroids.unsafe_col(oldCluster));
+          ++pointDistanceCalculations;
+        }
+
+        if (upperBounds[i] > globalLowerBound)
+        {
+          const double oldDistance = upperBounds[i];
+          double minDistance = oldDistance;
+          size_t closestCluster = oldCluster;
+
+          for (size_t g = 0; g < numGroups; ++g)
+          {
+            // Group filtering: skip the groups whose lower bound shows that
+            // none of their centroids can be closer.
+            visited[g] = (lowerBounds(g, i) < minDistance);
+            if (!visited[g])
+              continue;
+
+            // The bound from the last iteration, before the group drift.
+            const double lastBound = lowerBounds(g, i) + groupDrifts[g];
+            firstValues[g] = DBL_MAX;
+            firstCentroids[g] = centroids.n_cols;
+            secondValues[g] = DBL_MAX;
+            for (size_t j = groupOffsets[g]; j < groupOffsets[g + 1]; ++j)
+            {
+              const size_t c = groupCentroids[j];
+
+              double value;
+              size_t valueCentroid = c;
+              if (c == oldCluster)
+              {
+                value = oldDistance;
+              }
+              else
+              {
+                // Local filtering: the centroid can only have come closer by
+                // as much as it has moved.
+                value = lastBound - drifts[c];
+                if (value < minDistance)
+                {
+                  value = metric.Evaluate(dataset.col(i),
+                      centroids.unsafe_col(c));
+                  ++pointDistanceCalculations;
+
+                  if (value < minDistance)
+                  {
+                    minDistance = value;
+                    closestCluster = c;
+                  }
+                }
+                else
+                {
+                  valueCentroid = centroids.n_cols; // Only a bound.
+                }
+              }
+
+              if (value < firstValues[g])
+              {
+                secondValues[g] = firstValues[g];
+                firstValues[g] = value;
+                firstCentroids[g] = valueCentroid;
+              }
+              else if (value < secondValues[g])
+              {
+                secondValues[g] = value;
+              }
+            }
+          }
+
+          // Now that the closest centroid is known, set the new lower bounds,
+          // which must not account for the closest centroid itself.
+          for (size_t g = 0; g < numGroups; ++g)
+          {
+            if (visited[g])
+            {
+              lowerBounds(g, i) = (firstCentroids[g] == closestCluster) ?
+                  secondValues[g] : firstValues[g];
+            }
+            else if (closestCluster != oldCluster &&
+                     centroidGroups[oldCluster] == g)
+            {
+              // The old centroid is not in the bound of its group yet.
+              lowerBounds(g, i) = std::min(lowerBounds(g, i), oldDistance);
+            }
+          }
+
+          assignments[i] = closestCluster;
+          upperBounds[i] = minDistance;
+        }
+      }
+
+      localCentroids.unsafe_col(assignments[i]) += dataset.col(i);
+      localCounts(assignments[i])++;
+    }
+
+    // Combine calculated state from each thread
+    #pragma omp critical
+    {
+      newCentroids += localCentroids;
+      counts += localCounts;
+    }
+  }
+
+  distanceCalculations += pointDistanceCalculations;
+  lastCentroids = centroids;
+
+  // Now normalize the centroids and calculate how far they have moved.
+  double cNorm = 0.0;
+  for (size_t c = 0; c < centroids.n_cols; ++c)
+  {
+    if (counts[c] > 0)
+      newCentroids.col(c) /= counts[c];
+
+    cNorm += std::pow(metric.Evaluate(centroids.col(c), newCentroids.col(c)),
+        2.0);
+  }
+  distanceCalculations += centroids.n_cols;
+
+  return std::sqrt(cNorm);
+}
+
+// Group the centroids with a few Lloyd iterations over the centroids.
+template<typename MetricType, typename MatType, size_t Groups>
+void YinyangKMeans<MetricType, MatType, Groups>::GroupCentroids(
+    const arma::mat& centroids)
+{
+  const size_t k = centroids.n_cols;
+  const size_t numGroups = (Groups == 0) ? std::max(size_t(1), k / 10) :
+      std::min(Groups, k);
+
+  // Start from evenly spaced centroids, so that the grouping is deterministic.
+  arma::mat groupCenters(centroids.n_rows, numGroups);
+  for (size_t g = 0; g < numGroups; ++g)
+    groupCenters.col(g) = centroids.col((g * k) / numGroups);
+
+  arma::Col<size_t> groups(k, arma::fill::zeros);
+  for (size_t iteration = 0; iteration < 5 && numGroups > 1; ++iteration)
+  {
+    for (size_t c = 0; c < k; ++c)
+    {
+      double minDistance = DBL_MAX;
+      for (size_t g = 0; g < numGroups; ++g)
+      {
+        const double distance = metric.Evaluate(centroids.col(c),
+            groupCenters.col(g));
+        if (distance < minDistance)
+        {
+          minDistance = distance;
+          groups[c] = g;
+        }
+      }
+    }
+    distanceCalculations += k * numGroups;
+
+    arma::Col<size_t> groupCounts(numGroups, arma::fill::zeros);
+    groupCenters.zeros();
+    for (size_t c = 0; c < k; ++c)
+    {
+      groupCenters.col(groups[c]) += centroids.col(c);
+      groupCounts[groups[c]]++;
+    }
+    for (size_t g = 0; g < numGroups; ++g)
+      if (groupCounts[g] > 0)
+        groupCenters.col(g) /= groupCounts[g];
+  }
+
+  // Now list the centroids of each group, dropping any empty group.
+  const arma::uvec order = arma::stable_sort_index(
+      arma::conv_to<arma::uvec>::from(groups));
+  groupCentroids.set_size(k);
+  centroidGroups.set_size(k);
+  std::vector<size_t> offsets;
+  for (size_t j = 0; j < k; ++j)
+  {
+    groupCentroids[j] = order[j];
+    if (j == 0 || groups[order[j]] != groups[order[j - 1]])
+      offsets.push_back(j);
+    centroidGroups[order[j]] = offsets.size() - 1;
+  }
+  offsets.push_back(k);
+  groupOffsets = arma::Col<size_t>(offsets);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -101,8 +101,8 @@ PARAM_INT_IN("num_probes", "Number of additional probes for multiprobe LSH; if "
     "0, traditional LSH is used.", "T", 0);
 PARAM_INT_IN("second_hash_size", "The size of the second level hash table.",
     "S", 99901);
-PARAM_INT_IN("bucket_size", "The size of a bucket in the second level hash.",
-    "B", 500);
+PARAM_INT_IN("bucket_size", "The maximum number of points in a bucket of the "
+    "second level hash; if 0, buckets are unlimited.", "B", 500);
 PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
 
 static void mlpackMain()
@@ -120,8 +120,8 @@ static void mlpackMain()
   }
   RequireParamValue<int>("second_hash_size", [](int x) { return x > 0; }, true,
       "second hash size must be greater than 0");
-  RequireParamValue<int>("bucket_size", [](int x) { return x > 0; }, true,
-      "bucket size must be greater than 0");
+  RequireParamValue<int>("bucket_size", [](int x) { return x >= 0; }, true,
+      "bucket size must be nonnegative");
 
   size_t k = IO::GetParam<int>("k");
   size_t secondHashSize = IO::GetParam<int>("second_hash_size");
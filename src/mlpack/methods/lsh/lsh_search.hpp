@@ -89,10 +89,9 @@ class LSHSearch
    *     upper bound on the nearest-neighbor distance in general.
    * @param secondHashSize The size of the second hash table. This should be a
    *     large prime number.
-   * @param bucketSize The size of the bucket in the second hash table. This is
-   *     the maximum number of points that can be hashed into single bucket.  A
-   *     value of 0 indicates that there is no limit (so the second hash table
-   *     can be arbitrarily large---be careful!).
+   * @param bucketSize The maximum number of points that can be hashed into a
+   *     single bucket of the second hash table; further points are dropped
+   *     from that bucket.  A value of 0 indicates that there is no limit.
    */
   LSHSearch(MatType referenceSet,
             const arma::cube& projections,
@@ -117,10 +116,9 @@ class LSHSearch
    *     upper bound on the nearest-neighbor distance in general.
    * @param secondHashSize The size of the second hash table. This should be a
    *     large prime number.
-   * @param bucketSize The size of the bucket in the second hash table. This is
-   *     the maximum number of points that can be hashed into single bucket.  A
-   *     value of 0 indicates that there is no limit (so the second hash table
-   *     can be arbitrarily large---be careful!).
+   * @param bucketSize The maximum number of points that can be hashed into a
+   *     single bucket of the second hash table; further points are dropped
+   *     from that bucket.  A value of 0 indicates that there is no limit.
    */
   LSHSearch(MatType referenceSet,
             const size_t numProj,
@@ -180,10 +178,9 @@ class LSHSearch
    *     upper bound on the nearest-neighbor distance in general.
    * @param secondHashSize The size of the second hash table. This should be a
    *     large prime number.
-   * @param bucketSize The size of the bucket in the second hash table. This is
-   *     the maximum number of points that can be hashed into single bucket.  A
-   *     value of 0 indicates that there is no limit (so the second hash table
-   *     can be arbitrarily large---be careful!).
+   * @param bucketSize The maximum number of points that can be hashed into a
+   *     single bucket of the second hash table; further points are dropped
+   *     from that bucket.  A value of 0 indicates that there is no limit.
    * @param projection Cube of projection tables. For a cube of size (a, b, c)
    *     we set numProj = a, numTables = c. b is the reference set
    *     dimensionality.
@@ -196,6 +193,23 @@ class LSHSearch
              const size_t bucketSize = 500,
              const arma::cube& projection = arma::cube());
 
+  /**
+   * Add the given points to the reference set, and hash them into the existing
+   * tables; the projections, offsets and hash width are not changed.  The
+   * index of each new point is its column in the reference set, so the points
+   * get the indices following those of the points that were already there.
+   * The model must have been trained.
+   *
+   * The reference set is held in a single matrix, so each call copies the
+   * whole reference set (with join_rows()) and rebuilds the second hash table,
+   * which takes O(N (d + L) + secondHashSize) time and O(N d) extra memory for
+   * N reference points of d dimensions and L tables.  Insert points in large
+   * batches rather than one at a time.
+   *
+   * @param newPoints Points to add to the reference set.
+   */
+  void Insert(const MatType& newPoints);
+
   /**
    * Compute the nearest neighbors of the points in the given query set and
    * store the output in the given matrices.  The matrices will be set to the
@@ -264,6 +278,9 @@ class LSHSearch
   /**
    * Serialize the LSH model.
    *
+   * Models saved before version 1 held the second hash table in a different
+   * form; it is converted when they are loaded.
+   *
    * @param ar Archive to serialize to.
    * @param version serialize class version to provide backward compatibility
    */
@@ -290,9 +307,18 @@ class LSHSearch
   //! Get the bucket size of the second hash.
   size_t BucketSize() const { return bucketSize; }
 
-  //! Get the second hash table.
-  const std::vector<arma::Col<size_t>>& SecondHashTable() const
-      { return secondHashTable; }
+  //! Get the offset of each bucket of the second hash table in
+  //! BucketContents(), followed by the total number of entries.
+  const arma::Col<size_t>& BucketOffsets() const { return bucketOffsets; }
+  //! Get the points hashed into the second hash table, bucket by bucket.
+  const arma::Col<size_t>& BucketContents() const { return bucketContents; }
+
+  /**
+   * Get the second hash table as a vector holding the points of each non-empty
+   * bucket, in the order of the buckets.  This builds a copy from
+   * BucketOffsets() and BucketContents(); use those instead.
+   */
+  mlpack_deprecated std::vector<arma::Col<size_t>> SecondHashTable() const;
 
   //! Get the projection tables.
   const arma::cube& Projections() { return projections; }
@@ -306,6 +332,29 @@ class LSHSearch
   }
 
  private:
+  /**
+   * Hash each of the given points into each table, giving one bucket of the
+   * second hash table per point and table.  The tables are processed in
+   * parallel.
+   *
+   * @param points Points to hash.
+   * @param keys Filled with the bucket of each point (row) in each table
+   *     (column).
+   */
+  void HashPoints(const MatType& points, arma::Mat<size_t>& keys) const;
+
+  /**
+   * Add the points with the given buckets to the second hash table.  Within a
+   * bucket, the new points follow the points that were already there, in order
+   * of table and then of index; points beyond the maximum bucket size are
+   * dropped.
+   *
+   * @param keys The bucket of each new point (row) in each table (column), as
+   *     given by HashPoints().
+   * @param firstIndex Index of the first new point in the reference set.
+   */
+  void AddToBuckets(const arma::Mat<size_t>& keys, const size_t firstIndex);
+
   /**
    * This function takes a query and hashes it into each of the hash tables to
    * get keys for the query and then the key is hashed to a bucket of the second
@@ -450,17 +499,13 @@ class LSHSearch
   //! The bucket size of the second hash.
   size_t bucketSize;
 
-  //! The final hash table; should be (< secondHashSize) vectors each with
-  //! (<= bucketSize) elements.
-  std::vector<arma::Col<size_t>> secondHashTable;
+  //! The second hash table in compressed sparse row form: the points in
+  //! bucket b are bucketContents[bucketOffsets[b]] up to (but not including)
+  //! bucketContents[bucketOffsets[b + 1]].  Length secondHashSize + 1.
+  arma::Col<size_t> bucketOffsets;
 
-  //! The number of elements present in each hash bucket; should be
-  //! secondHashSize.
-  arma::Col<size_t> bucketContentSize;
-
-  //! For a particular hash value, points to the row in secondHashTable
-  //! corresponding to this value. Length secondHashSize.
-  arma::Col<size_t> bucketRowInHashTable;
+  //! The points in each bucket of the second hash table, bucket by bucket.
+  arma::Col<size_t> bucketContents;
 
   //! The number of distance evaluations.
   size_t distanceEvaluations;
@@ -484,6 +529,11 @@ class LSHSearch
 } // namespace neighbor
 } // namespace mlpack
 
+//! Set the serialization version of the LSHSearch class.  Version 1 stores the
+//! second hash table in compressed sparse row form.
+CEREAL_TEMPLATE_CLASS_VERSION((typename SortPolicy, typename MatType),
+    (mlpack::neighbor::LSHSearch<SortPolicy, MatType>), (1));
+
 // Include implementation.
 #include "lsh_search_impl.hpp"
 
@@ -83,9 +83,8 @@ LSHSearch<SortPolicy, MatType>::LSHSearch(const LSHSearch& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(other.secondHashWeights),
     bucketSize(other.bucketSize),
-    secondHashTable(other.secondHashTable),
-    bucketContentSize(other.bucketContentSize),
-    bucketRowInHashTable(other.bucketRowInHashTable),
+    bucketOffsets(other.bucketOffsets),
+    bucketContents(other.bucketContents),
     distanceEvaluations(other.distanceEvaluations)
 {
   // Nothing to do.
@@ -103,9 +102,8 @@ LSHSearch<SortPolicy, MatType>::LSHSearch(LSHSearch&& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(std::move(other.secondHashWeights)),
     bucketSize(other.bucketSize),
-    secondHashTable(std::move(other.secondHashTable)),
-    bucketContentSize(std::move(other.bucketContentSize)),
-    bucketRowInHashTable(std::move(other.bucketRowInHashTable)),
+    bucketOffsets(std::move(other.bucketOffsets)),
+    bucketContents(std::move(other.bucketContents)),
     distanceEvaluations(other.distanceEvaluations)
 {
   // Reset other model to defaults.
@@ -113,7 +111,7 @@ LSHSearch<SortPolicy, MatType>::LSHSearch(LSHSearch&& other) :
   other.numTables = 0;
   other.hashWidth = 0;
   other.secondHashSize = 99901;
-  other.bucketSize = 500;
+  other.bucketSize = 0;
   other.distanceEvaluations = 0;
 }
 
@@ -131,9 +129,8 @@ LSHSearch<SortPolicy, MatType>& LSHSearch<SortPolicy, MatType>::operator=(
   secondHashSize = other.secondHashSize;
   secondHashWeights = other.secondHashWeights;
   bucketSize = other.bucketSize;
-  secondHashTable = other.secondHashTable;
-  bucketContentSize = other.bucketContentSize;
-  bucketRowInHashTable = other.bucketRowInHashTable;
+  bucketOffsets = other.bucketOffsets;
+  bucketContents = other.bucketContents;
   distanceEvaluations = other.distanceEvaluations;
 
   return *this;
@@ -153,9 +150,8 @@ LSHSearch<SortPolicy, MatType>& LSHSearch<SortPolicy, MatType>::operator=(
   secondHashSize = other.secondHashSize;
   secondHashWeights = std::move(other.secondHashWeights);
   bucketSize = other.bucketSize;
-  secondHashTable = std::move(other.secondHashTable);
-  bucketContentSize = std::move(other.bucketContentSize);
-  bucketRowInHashTable = std::move(other.bucketRowInHashTable);
+  bucketOffsets = std::move(other.bucketOffsets);
+  bucketContents = std::move(other.bucketContents);
   distanceEvaluations = other.distanceEvaluations;
 
   // Reset other model to defaults.
@@ -163,7 +159,7 @@ LSHSearch<SortPolicy, MatType>& LSHSearch<SortPolicy, MatType>::operator=(
   other.numTables = 0;
   other.hashWidth = 0;
   other.secondHashSize = 99901;
-  other.bucketSize = 500;
+  other.bucketSize = 0;
   other.distanceEvaluations = 0;
 
   return *this;
@@ -219,13 +215,6 @@ void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
   secondHashWeights = arma::floor(arma::randu(numProj) *
                                   (double) secondHashSize);
 
-  // Instead of putting the points in the row corresponding to the bucket, we
-  // chose the next empty row and keep track of the row in which the bucket
-  // lies. This allows us to stack together and slice out the empty buckets at
-  // the end of the hashing.
-  bucketRowInHashTable.set_size(secondHashSize);
-  bucketRowInHashTable.fill(secondHashSize);
-
   // Step II: The offsets for all projections in all tables.
   // Since the 'offsets' are in [0, hashWidth], we obtain the 'offsets'
   // as randu(numProj, numTables) * hashWidth.
@@ -253,100 +242,158 @@ void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
         "tables provided must be equal to numProj");
   }
 
-  // We will store the second hash vectors in this matrix; the second hash
-  // vector for table i will be held in row i.  We have to use int and not
-  // size_t, otherwise negative numbers are cast to 0.
-  arma::Mat<size_t> secondHashVectors(numTables, this->referenceSet.n_cols);
+  // Steps IV and V: hash every point into every table, and put the points in
+  // the (empty) second hash table.
+  arma::Mat<size_t> keys;
+  HashPoints(this->referenceSet, keys);
+
+  bucketOffsets.zeros(secondHashSize + 1);
+  bucketContents.reset();
+  AddToBuckets(keys, 0);
+
+  const arma::Col<size_t> bucketSizes = arma::diff(bucketOffsets);
+  Log::Info << "Final hash table size: " << arma::accu(bucketSizes > 0)
+            << " nonempty buckets, with a maximum length of "
+            << arma::max(bucketSizes) << ", totaling " << bucketContents.n_elem
+            << " elements." << std::endl;
+}
+
+// Add new points to the reference set.
+template<typename SortPolicy, typename MatType>
+void LSHSearch<SortPolicy, MatType>::Insert(const MatType& newPoints)
+{
+  if (projections.n_slices == 0)
+  {
+    throw std::invalid_argument("LSHSearch::Insert(): the model must be "
+        "trained before points can be inserted!");
+  }
 
-  for (size_t i = 0; i < numTables; ++i)
+  if (newPoints.n_rows != referenceSet.n_rows)
   {
-    // Step IV: create the 'numProj'-dimensional key for each point in each
-    // table.
+    std::ostringstream oss;
+    oss << "LSHSearch::Insert(): dimensionality of new points ("
+        << newPoints.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << referenceSet.n_rows << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  arma::Mat<size_t> keys;
+  HashPoints(newPoints, keys);
+
+  const size_t firstIndex = referenceSet.n_cols;
+  referenceSet = arma::join_rows(referenceSet, newPoints);
+  AddToBuckets(keys, firstIndex);
+}
 
+// Build the old representation of the second hash table.
+template<typename SortPolicy, typename MatType>
+std::vector<arma::Col<size_t>>
+LSHSearch<SortPolicy, MatType>::SecondHashTable() const
+{
+  std::vector<arma::Col<size_t>> table;
+  for (size_t i = 0; i + 1 < bucketOffsets.n_elem; ++i)
+  {
+    if (bucketOffsets[i + 1] > bucketOffsets[i])
+    {
+      table.push_back(bucketContents.subvec(bucketOffsets[i],
+          bucketOffsets[i + 1] - 1));
+    }
+  }
+
+  return table;
+}
+
+// Hash points into every table.
+template<typename SortPolicy, typename MatType>
+void LSHSearch<SortPolicy, MatType>::HashPoints(const MatType& points,
+                                                arma::Mat<size_t>& keys) const
+{
+  keys.set_size(points.n_cols, numTables);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) numTables; ++i)
+  {
     // The following code performs the task of hashing each point to a
     // 'numProj'-dimensional integer key.  Hence you get a ('numProj' x
-    // 'referenceSet.n_cols') key matrix.
+    // 'points.n_cols') key matrix.
     //
     // For a single table, let the 'numProj' projections be denoted by 'proj_i'
     // and the corresponding offset be 'offset_i'.  Then the key of a single
     // point is obtained as:
     // key = { floor((<proj_i, point> + offset_i) / 'hashWidth') forall i }
-    arma::mat offsetMat = arma::repmat(offsets.unsafe_col(i), 1,
-                                       this->referenceSet.n_cols);
-    arma::mat hashMat = projections.slice(i).t() * (this->referenceSet);
-    hashMat += offsetMat;
+    arma::mat hashMat = projections.slice(i).t() * points;
+    hashMat.each_col() += offsets.col(i);
     hashMat /= hashWidth;
 
-    // Step V: Putting the points in the 'secondHashTable' by hashing the key.
-    // Now we hash every key, point ID to its corresponding bucket.  We must
-    // also normalize the hashes to the range [0, secondHashSize).
-    arma::rowvec unmodVector = secondHashWeights.t() * arma::floor(hashMat);
+    // Now we hash every key to its corresponding bucket.  We must also
+    // normalize the hashes to the range [0, secondHashSize).
+    const arma::rowvec unmodVector = secondHashWeights.t() *
+        arma::floor(hashMat);
+    const double shs = (double) secondHashSize; // Convenience cast.
     for (size_t j = 0; j < unmodVector.n_elem; ++j)
     {
-      double shs = (double) secondHashSize; // Convenience cast.
       if (unmodVector[j] >= 0.0)
       {
-        const size_t key = size_t(fmod(unmodVector[j], shs));
-        secondHashVectors(i, j) = key;
+        keys(j, i) = size_t(fmod(unmodVector[j], shs));
       }
       else
       {
         const double mod = fmod(-unmodVector[j], shs);
-        const size_t key = (mod < 1.0) ? 0 : secondHashSize - size_t(mod);
-        secondHashVectors(i, j) = key;
+        keys(j, i) = (mod < 1.0) ? 0 : secondHashSize - size_t(mod);
       }
     }
   }
+}
+
+// Add points to the second hash table.
+template<typename SortPolicy, typename MatType>
+void LSHSearch<SortPolicy, MatType>::AddToBuckets(const arma::Mat<size_t>& keys,
+                                                  const size_t firstIndex)
+{
+  // First sort the new points into buckets, by counting the points in each
+  // bucket.  Traversing the keys column by column puts the points of each
+  // bucket in order of table, then of index.
+  arma::Col<size_t> newOffsets(secondHashSize + 1, arma::fill::zeros);
+  for (size_t i = 0; i < keys.n_elem; ++i)
+    ++newOffsets[keys[i] + 1];
+  newOffsets = arma::cumsum(newOffsets);
+
+  arma::Col<size_t> newContents(keys.n_elem);
+  arma::Col<size_t> next = newOffsets.head(secondHashSize);
+  for (size_t t = 0; t < keys.n_cols; ++t)
+    for (size_t j = 0; j < keys.n_rows; ++j)
+      newContents[next[keys(j, t)]++] = firstIndex + j;
+
+  // Now compute the size of each merged bucket, enforcing the maximum bucket
+  // size.
+  const size_t maxBucketSize = (bucketSize == 0) ? SIZE_MAX : bucketSize;
+  arma::Col<size_t> mergedOffsets(secondHashSize + 1);
+  mergedOffsets[0] = 0;
+  for (size_t b = 0; b < secondHashSize; ++b)
+  {
+    const size_t size = (bucketOffsets[b + 1] - bucketOffsets[b]) +
+        (newOffsets[b + 1] - newOffsets[b]);
+    mergedOffsets[b + 1] = mergedOffsets[b] + std::min(size, maxBucketSize);
+  }
 
-  // Now, using the hash vectors for each table, count the number of rows we
-  // have in the second hash table.
-  arma::Row<size_t> secondHashBinCounts(secondHashSize, arma::fill::zeros);
-  for (size_t i = 0; i < secondHashVectors.n_elem; ++i)
-    secondHashBinCounts[secondHashVectors[i]]++;
-
-  // Enforce the maximum bucket size.
-  const size_t effectiveBucketSize = (bucketSize == 0) ? SIZE_MAX : bucketSize;
-  secondHashBinCounts.transform([effectiveBucketSize](size_t val)
-      { return std::min(val, effectiveBucketSize); });
-
-  const size_t numRowsInTable = arma::accu(secondHashBinCounts > 0);
-  bucketContentSize.zeros(numRowsInTable);
-  secondHashTable.resize(numRowsInTable);
-
-  // Next we must assign each point in each table to the right second hash
-  // table.
-  size_t currentRow = 0;
-  for (size_t i = 0; i < numTables; ++i)
+  // Each bucket can be filled independently: first the points that were
+  // already there, then the new points, until it is full.
+  arma::Col<size_t> mergedContents(mergedOffsets[secondHashSize]);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) secondHashSize; ++b)
   {
-    // Insert the point in the corresponding row to its bucket in the
-    // 'secondHashTable'.
-    for (size_t j = 0; j < secondHashVectors.n_cols; ++j)
-    {
-      // This is the bucket number.
-      size_t hashInd = (size_t) secondHashVectors(i, j);
-      // The point ID is 'j'.
-
-      // If this is currently an empty bucket, start a new row keep track of
-      // which row corresponds to the bucket.
-      const size_t maxSize = secondHashBinCounts[hashInd];
-      if (bucketRowInHashTable[hashInd] == secondHashSize)
-      {
-        bucketRowInHashTable[hashInd] = currentRow;
-        secondHashTable[currentRow].set_size(maxSize);
-        currentRow++;
-      }
+    size_t out = mergedOffsets[b];
+    const size_t end = mergedOffsets[b + 1];
+    for (size_t p = bucketOffsets[b]; p < bucketOffsets[b + 1] && out < end;
+        ++p)
+      mergedContents[out++] = bucketContents[p];
+    for (size_t p = newOffsets[b]; p < newOffsets[b + 1] && out < end; ++p)
+      mergedContents[out++] = newContents[p];
+  }
 
-      // If this vector in the hash table is not full, add the point.
-      const size_t index = bucketRowInHashTable[hashInd];
-      if (bucketContentSize[index] < maxSize)
-        secondHashTable[index](bucketContentSize[index]++) = j;
-    } // Loop over all points in the reference set.
-  } // Loop over tables.
-
-  Log::Info << "Final hash table size: " << numRowsInTable << " rows, with a "
-            << "maximum length of " << arma::max(secondHashBinCounts) << ", "
-            << "totaling " << arma::accu(secondHashBinCounts) << " elements."
-            << std::endl;
+  bucketOffsets = std::move(mergedOffsets);
+  bucketContents = std::move(mergedContents);
 }
 
 // Base case where the query set is the reference set.  (So, we can't return
@@ -775,9 +822,7 @@ void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
     for (size_t p = 0; p < T + 1; ++p)
     {
       const size_t hashInd = hashMat(p, i); // find query's bucket
-      const size_t tableRow = bucketRowInHashTable[hashInd];
-      if (tableRow < secondHashSize)
-        maxNumPoints += bucketContentSize[tableRow]; // count bucket contents
+      maxNumPoints += bucketOffsets[hashInd + 1] - bucketOffsets[hashInd];
     }
   }
 
@@ -805,15 +850,12 @@ void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
       for (size_t p = 0; p < T + 1; ++p) // For entire probing sequence.
       {
         // get the sequence code
-        size_t hashInd = hashMat(p, i);
-        size_t tableRow = bucketRowInHashTable[hashInd];
+        const size_t hashInd = hashMat(p, i);
 
-        if (tableRow < secondHashSize && bucketContentSize[tableRow] > 0)
-        {
-          // Pick the indices in the bucket corresponding to hashInd.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsidered[ secondHashTable[tableRow](j) ]++;
-        }
+        // Pick the indices in the bucket corresponding to hashInd.
+        for (size_t j = bucketOffsets[hashInd]; j < bucketOffsets[hashInd + 1];
+            ++j)
+          refPointsConsidered[bucketContents[j]]++;
       }
     }
 
@@ -837,14 +879,11 @@ void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
       for (size_t p = 0; p < T + 1; ++p)
       {
         const size_t hashInd =  hashMat(p, i); // Find the query's bucket.
-        const size_t tableRow = bucketRowInHashTable[hashInd];
 
-        if (tableRow < secondHashSize)
-        {
-          // Store all secondHashTable points in the candidates set.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsideredSmall(start++) = secondHashTable[tableRow](j);
-       }
+        // Store all points of the bucket in the candidates set.
+        for (size_t j = bucketOffsets[hashInd]; j < bucketOffsets[hashInd + 1];
+            ++j)
+          refPointsConsideredSmall(start++) = bucketContents[j];
       }
     }
 
@@ -1040,7 +1079,7 @@ double LSHSearch<SortPolicy, MatType>::ComputeRecall(
 template<typename SortPolicy, typename MatType>
 template<typename Archive>
 void LSHSearch<SortPolicy, MatType>::serialize(Archive& ar,
-                                               const uint32_t /* version */)
+                                               const uint32_t version)
 {
   ar(CEREAL_NVP(referenceSet));
   ar(CEREAL_NVP(numProj));
@@ -1056,9 +1095,57 @@ void LSHSearch<SortPolicy, MatType>::serialize(Archive& ar,
   ar(CEREAL_NVP(secondHashSize));
   ar(CEREAL_NVP(secondHashWeights));
   ar(CEREAL_NVP(bucketSize));
-  ar(CEREAL_NVP(secondHashTable));
-  ar(CEREAL_NVP(bucketContentSize));
-  ar(CEREAL_NVP(bucketRowInHashTable));
+
+  if (cereal::is_loading<Archive>() && version == 0)
+  {
+    // Models saved before version 1 store the second hash table as one row
+    // for each non-empty bucket; convert it to the compressed form.
+    std::vector<arma::Col<size_t>> secondHashTable;
+    arma::Col<size_t> bucketContentSize;
+    arma::Col<size_t> bucketRowInHashTable;
+    ar(CEREAL_NVP(secondHashTable));
+    ar(CEREAL_NVP(bucketContentSize));
+    ar(CEREAL_NVP(bucketRowInHashTable));
+
+    if (bucketRowInHashTable.n_elem != secondHashSize ||
+        bucketContentSize.n_elem != secondHashTable.size())
+    {
+      throw std::runtime_error("LSHSearch::serialize(): the second hash table "
+          "of the model is corrupt!");
+    }
+
+    bucketOffsets.set_size(secondHashSize + 1);
+    bucketOffsets[0] = 0;
+    for (size_t b = 0; b < secondHashSize; ++b)
+    {
+      const size_t row = bucketRowInHashTable[b];
+      bucketOffsets[b + 1] = bucketOffsets[b] +
+          ((row < secondHashTable.size()) ? bucketContentSize[row] : 0);
+    }
+
+    bucketContents.set_size(bucketOffsets[secondHashSize]);
+    for (size_t b = 0; b < secondHashSize; ++b)
+    {
+      const size_t row = bucketRowInHashTable[b];
+      if (row >= secondHashTable.size() || bucketContentSize[row] == 0)
+        continue;
+
+      if (bucketContentSize[row] > secondHashTable[row].n_elem)
+      {
+        throw std::runtime_error("LSHSearch::serialize(): the second hash "
+            "table of the model is corrupt!");
+      }
+
+      bucketContents.subvec(bucketOffsets[b], bucketOffsets[b + 1] - 1) =
+          secondHashTable[row].head(bucketContentSize[row]);
+    }
+  }
+  else
+  {
+    ar(CEREAL_NVP(bucketOffsets));
+    ar(CEREAL_NVP(bucketContents));
+  }
+
   ar(CEREAL_NVP(distanceEvaluations));
 }
 
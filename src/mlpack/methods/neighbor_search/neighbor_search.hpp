@@ -20,6 +20,7 @@
 #include <mlpack/core/tree/binary_space_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
 #include <mlpack/core/tree/binary_space_tree/binary_space_tree.hpp>
+#include <mlpack/core/data/mapped_file.hpp>
 
 #include "neighbor_search_stat.hpp"
 #include "sort_policies/nearest_neighbor_sort.hpp"
@@ -40,7 +41,8 @@ enum NeighborSearchMode
   NAIVE_MODE,
   SINGLE_TREE_MODE,
   DUAL_TREE_MODE,
-  GREEDY_SINGLE_TREE_MODE
+  GREEDY_SINGLE_TREE_MODE,
+  PARALLEL_DUAL_TREE_MODE
 };
 
 /**
@@ -321,6 +323,13 @@ class NeighborSearch
   //! Modify the relative error to be considered in approximate search.
   double& Epsilon() { return epsilon; }
 
+  //! Access the depth of the query tree at which the parallel dual-tree search
+  //! splits the traversal into parallel tasks.
+  size_t ParallelDepth() const { return parallelDepth; }
+  //! Modify the depth of the query tree at which the parallel dual-tree search
+  //! splits the traversal into parallel tasks.
+  size_t& ParallelDepth() { return parallelDepth; }
+
   //! Access the reference dataset.
   const MatType& ReferenceSet() const { return *referenceSet; }
 
@@ -333,6 +342,32 @@ class NeighborSearch
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t version);
 
+  /**
+   * Write the reference tree, its dataset, the mapping of the reference points,
+   * and, if the leaves of the tree cache them (see UseDistanceBlock), the
+   * squared norms of the reference points in a format that can be used in place
+   * after it is memory-mapped; see LoadMapped().  This can't be used in naive
+   * mode, and the tree type must support the memory-mapped format (see
+   * BinarySpaceTree::SaveMapped()).
+   *
+   * @param stream Stream to write to.
+   */
+  void SaveMapped(std::ostream& stream) const;
+
+  /**
+   * Load a model written by SaveMapped() from the given memory, which is
+   * usually a data::MappedFile.  The reference tree, the dataset, and the
+   * squared norms cached by the leaves are used in place, so the memory must
+   * outlive the model (or the next call to Train() or LoadMapped()).  Loading
+   * takes time linear in the number of nodes, and does not read the dataset.
+   *
+   * @param memory Memory holding the model.
+   * @param size Size of the memory, in bytes.
+   * @param offset Offset of the model in the memory.  On return, the offset of
+   *     whatever was written after the model.
+   */
+  void LoadMapped(char* memory, const size_t size, size_t& offset);
+
  private:
   //! Permutations of reference points during tree building.
   std::vector<size_t> oldFromNewReferences;
@@ -345,6 +380,8 @@ class NeighborSearch
   NeighborSearchMode searchMode;
   //! Indicates the relative error to be considered in approximate search.
   double epsilon;
+  //! Depth of the query tree at which parallel dual-tree search is split.
+  size_t parallelDepth;
 
   //! Instantiation of metric.
   MetricType metric;
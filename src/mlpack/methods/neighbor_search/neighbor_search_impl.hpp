@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/tree/greedy_single_tree_traverser.hpp>
+#include <mlpack/core/tree/parallel_dual_tree_traverser.hpp>
 #include "neighbor_search_rules.hpp"
 #include <mlpack/core/tree/spill_tree/is_spill_tree.hpp>
 
@@ -65,6 +66,7 @@ SingleTreeTraversalType>::NeighborSearch(MatType referenceSetIn,
         &referenceTree->Dataset()),
     searchMode(mode),
     epsilon(epsilon),
+    parallelDepth(8),
     metric(metric),
     baseCases(0),
     scores(0),
@@ -92,6 +94,7 @@ SingleTreeTraversalType>::NeighborSearch(Tree referenceTree,
     referenceSet(&this->referenceTree->Dataset()),
     searchMode(mode),
     epsilon(epsilon),
+    parallelDepth(8),
     metric(metric),
     baseCases(0),
     scores(0),
@@ -118,6 +121,7 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearchMode mode,
     referenceSet(mode == NAIVE_MODE ? new MatType() : NULL), // Empty matrix.
     searchMode(mode),
     epsilon(epsilon),
+    parallelDepth(8),
     metric(metric),
     baseCases(0),
     scores(0),
@@ -152,6 +156,7 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearch& other) :
         new MatType(*other.referenceSet)),
     searchMode(other.searchMode),
     epsilon(other.epsilon),
+    parallelDepth(other.parallelDepth),
     metric(other.metric),
     baseCases(other.baseCases),
     scores(other.scores),
@@ -176,6 +181,7 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
     referenceSet(other.referenceSet),
     searchMode(other.searchMode),
     epsilon(other.epsilon),
+    parallelDepth(other.parallelDepth),
     metric(std::move(other.metric)),
     baseCases(other.baseCases),
     scores(other.scores),
@@ -229,6 +235,7 @@ NeighborSearch<SortPolicy,
       new MatType(*other.referenceSet);
   searchMode = other.searchMode;
   epsilon = other.epsilon;
+  parallelDepth = other.parallelDepth;
   metric = other.metric;
   baseCases = other.baseCases;
   scores = other.scores;
@@ -271,6 +278,7 @@ NeighborSearch<SortPolicy,
   referenceSet = other.referenceSet;
   searchMode = other.searchMode;
   epsilon = other.epsilon;
+  parallelDepth = other.parallelDepth;
   metric = other.metric;
   baseCases = other.baseCases;
   scores = other.scores;
@@ -418,7 +426,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   // Mapping is only necessary if the tree rearranges points.
   if (tree::TreeTraits<Tree>::RearrangesDataset)
   {
-    if (searchMode == DUAL_TREE_MODE)
+    if (searchMode == DUAL_TREE_MODE || searchMode == PARALLEL_DUAL_TREE_MODE)
     {
       distancePtr = new arma::mat; // Query indices need to be mapped.
       neighborPtr = new arma::Mat<size_t>;
@@ -474,6 +482,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       break;
     }
     case DUAL_TREE_MODE:
+    case PARALLEL_DUAL_TREE_MODE:
     {
       // Build the query tree.
       Timer::Stop("computing_neighbors");
@@ -486,9 +495,17 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, epsilon);
 
       // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
-
-      traverser.Traverse(*queryTree, *referenceTree);
+      if (searchMode == PARALLEL_DUAL_TREE_MODE)
+      {
+        tree::ParallelDualTreeTraverser<Tree, RuleType, DualTreeTraversalType>
+            traverser(rules, parallelDepth);
+        traverser.Traverse(*queryTree, *referenceTree);
+      }
+      else
+      {
+        DualTreeTraversalType<RuleType> traverser(rules);
+        traverser.Traverse(*queryTree, *referenceTree);
+      }
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
@@ -533,7 +550,9 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   // Map points back to original indices, if necessary.
   if (tree::TreeTraits<Tree>::RearrangesDataset)
   {
-    if (searchMode == DUAL_TREE_MODE && !oldFromNewReferences.empty())
+    if ((searchMode == DUAL_TREE_MODE ||
+         searchMode == PARALLEL_DUAL_TREE_MODE) &&
+        !oldFromNewReferences.empty())
     {
       // We must map both query and reference indices.
       neighbors.set_size(k, querySet.n_cols);
@@ -556,7 +575,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       delete neighborPtr;
       delete distancePtr;
     }
-    else if (searchMode == DUAL_TREE_MODE)
+    else if (searchMode == DUAL_TREE_MODE ||
+             searchMode == PARALLEL_DUAL_TREE_MODE)
     {
       // We must map query indices only.
       neighbors.set_size(k, querySet.n_cols);
@@ -615,7 +635,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   }
 
   // Make sure we are in dual-tree mode.
-  if (searchMode != DUAL_TREE_MODE)
+  if (searchMode != DUAL_TREE_MODE && searchMode != PARALLEL_DUAL_TREE_MODE)
     throw std::invalid_argument("cannot call NeighborSearch::Search() with a "
         "query tree when naive or singleMode are set to true");
 
@@ -642,8 +662,17 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   RuleType rules(*referenceSet, querySet, k, metric, epsilon, sameSet);
 
   // Create the traverser.
-  DualTreeTraversalType<RuleType> traverser(rules);
-  traverser.Traverse(queryTree, *referenceTree);
+  if (searchMode == PARALLEL_DUAL_TREE_MODE)
+  {
+    tree::ParallelDualTreeTraverser<Tree, RuleType, DualTreeTraversalType>
+        traverser(rules, parallelDepth);
+    traverser.Traverse(queryTree, *referenceTree);
+  }
+  else
+  {
+    DualTreeTraversalType<RuleType> traverser(rules);
+    traverser.Traverse(queryTree, *referenceTree);
+  }
 
   scores += rules.Scores();
   baseCases += rules.BaseCases();
@@ -761,6 +790,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       break;
     }
     case DUAL_TREE_MODE:
+    case PARALLEL_DUAL_TREE_MODE:
     {
       // The dual-tree monochromatic search case may require resetting the
       // bounds in the tree.
@@ -782,23 +812,27 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
         }
       }
 
-      // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
+      // For Dual Tree Search on SpillTree, the queryTree must be built with
+      // non overlapping (tau = 0).
+      Tree* queryTree = tree::IsSpillTree<Tree>::value ?
+          new Tree(*referenceSet) : referenceTree;
 
-      if (tree::IsSpillTree<Tree>::value)
+      // Create the traverser.
+      if (searchMode == PARALLEL_DUAL_TREE_MODE)
       {
-        // For Dual Tree Search on SpillTree, the queryTree must be built with
-        // non overlapping (tau = 0).
-        Tree queryTree(*referenceSet);
-        traverser.Traverse(queryTree, *referenceTree);
+        tree::ParallelDualTreeTraverser<Tree, RuleType, DualTreeTraversalType>
+            traverser(rules, parallelDepth);
+        traverser.Traverse(*queryTree, *referenceTree);
       }
       else
       {
-        traverser.Traverse(*referenceTree, *referenceTree);
-        // Next time we perform this search, we'll need to reset the tree.
-        treeNeedsReset = true;
+        DualTreeTraversalType<RuleType> traverser(rules);
+        traverser.Traverse(*queryTree, *referenceTree);
       }
 
+      if (tree::IsSpillTree<Tree>::value)
+        delete queryTree;
+
       scores += rules.Scores();
       baseCases += rules.BaseCases();
 
@@ -928,6 +962,145 @@ DualTreeTraversalType, SingleTreeTraversalType>::Recall(
   return ((double) found) / realNeighbors.n_elem;
 }
 
+//! Write the model in the memory-mapped format.
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::SaveMapped(
+    std::ostream& stream) const
+{
+  if (searchMode == NAIVE_MODE)
+  {
+    throw std::invalid_argument("NeighborSearch::SaveMapped(): cannot save a "
+        "model without a reference tree!");
+  }
+
+  // All of the integers are written as 64-bit integers, so that the format
+  // does not depend on the platform.
+  const uint64_t header[3] = { (uint64_t) searchMode,
+      (uint64_t) treeNeedsReset, oldFromNewReferences.size() };
+  const std::vector<uint64_t> mapping(oldFromNewReferences.begin(),
+      oldFromNewReferences.end());
+  data::WriteMapped(stream, header, 3);
+  data::WriteMapped(stream, mapping.data(), mapping.size());
+  referenceTree->SaveMapped(stream);
+
+  // If the leaves cache the squared norms of their points, write the squared
+  // norms of the reference points, so that the leaves can use them in place
+  // instead of computing them when the model is loaded.
+  if (!UseDistanceBlock<MetricType, Tree>::value)
+    return;
+
+  const MatType& dataset = referenceTree->Dataset();
+  std::vector<double> squaredNorms(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    const double norm = arma::norm(dataset.col(i), 2);
+    squaredNorms[i] = norm * norm;
+  }
+  data::WriteMapped(stream, squaredNorms.data(), squaredNorms.size());
+}
+
+//! Load a model written in the memory-mapped format.
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::LoadMapped(
+    char* memory, const size_t size, size_t& offset)
+{
+  const uint64_t* header = data::ReadMapped<uint64_t>(memory, size, offset, 3);
+  if (header[0] == NAIVE_MODE || header[0] > PARALLEL_DUAL_TREE_MODE ||
+      header[1] > 1)
+  {
+    throw std::runtime_error("NeighborSearch::LoadMapped(): the memory does "
+        "not hold a neighbor search model!");
+  }
+
+  const uint64_t* mapping = data::ReadMapped<uint64_t>(memory, size, offset,
+      header[2]);
+
+  // Create the tree before anything is changed, in case it fails.
+  Tree* tree = new Tree(memory, size, offset);
+  double* squaredNorms = NULL;
+  try
+  {
+    // The mapping must be a permutation of the points of the tree, or the
+    // search will read out of bounds.
+    const size_t numPoints = tree->Dataset().n_cols;
+    if (header[2] != numPoints)
+    {
+      throw std::runtime_error("NeighborSearch::LoadMapped(): the size of the "
+          "mapping does not match the number of points in the tree!");
+    }
+
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+      if (mapping[i] >= numPoints)
+      {
+        throw std::runtime_error("NeighborSearch::LoadMapped(): the mapping "
+            "holds an invalid point index!");
+      }
+    }
+
+    if (UseDistanceBlock<MetricType, Tree>::value)
+    {
+      squaredNorms = data::ReadMapped<double>(memory, size, offset,
+          tree->Dataset().n_cols);
+    }
+  }
+  catch (...)
+  {
+    delete tree;
+    throw;
+  }
+
+  // The points of each leaf are contiguous, so each leaf can use its part of
+  // the squared norms in place.
+  std::vector<Tree*> nodes;
+  if (squaredNorms)
+    nodes.push_back(tree);
+  while (!nodes.empty())
+  {
+    Tree* node = nodes.back();
+    nodes.pop_back();
+    if (node->NumChildren() == 0)
+    {
+      node->Stat().SquaredNorms() = arma::vec(squaredNorms + node->Begin(),
+          node->NumPoints(), false, false);
+    }
+
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      nodes.push_back(&node->Child(i));
+  }
+
+  if (referenceTree)
+    delete referenceTree;
+  else
+    delete referenceSet;
+
+  referenceTree = tree;
+  referenceSet = &referenceTree->Dataset();
+  metric = referenceTree->Metric();
+  oldFromNewReferences.assign(mapping, mapping + header[2]);
+
+  searchMode = (NeighborSearchMode) header[0];
+  treeNeedsReset = (header[1] != 0);
+  baseCases = 0;
+  scores = 0;
+}
+
 //! Serialize the NeighborSearch model.
 template<typename SortPolicy,
          typename MetricType,
@@ -14,6 +14,10 @@
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/tree_traits.hpp>
+#include <mlpack/core/tree/parallel_dual_tree_traverser.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include "use_distance_block.hpp"
 
 #include <queue>
 
@@ -54,6 +58,26 @@ class NeighborSearchRules
                       const double epsilon = 0,
                       const bool sameSet = false);
 
+  /**
+   * Copy the given NeighborSearchRules object, including its candidate lists.
+   *
+   * @param other Rules object to copy.
+   */
+  NeighborSearchRules(const NeighborSearchRules& other);
+
+  /**
+   * Construct a NeighborSearchRules object that shares the candidate lists of
+   * the given NeighborSearchRules object, but has its own base case cache,
+   * traversal info, and counters.  This is used by
+   * tree::ParallelDualTreeTraverser to give each parallel task its own rules.
+   * Tasks must work on disjoint sets of query points, since the candidate list
+   * of a single query point is not protected against concurrent modification.
+   *
+   * @param other Rules object whose candidate lists will be shared.
+   */
+  NeighborSearchRules(NeighborSearchRules& other,
+                      const tree::SharedResultsTag& /* tag */);
+
   /**
    * Store the list of candidates for each query point in the given matrices.
    *
@@ -73,6 +97,27 @@ class NeighborSearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Evaluate the base cases between every point held in the query node that
+   * can't be pruned with Score(queryIndex, referenceNode) and every point held
+   * in the reference node.  This is called by the dual-tree traverser when two
+   * leaves are reached.
+   *
+   * When the metric is the (squared) Euclidean distance and the points of each
+   * leaf are held contiguously in a dense matrix, the whole block of distances
+   * is first computed with a single matrix multiplication as
+   * ||q||^2 + ||r||^2 - 2 q^T r, using the squared norms cached in the tree
+   * statistic.  Those distances are only used to skip reference points that
+   * can't improve the candidate list; the distance of any point that may be
+   * inserted is computed exactly, so the results are the same as when calling
+   * BaseCase() for every combination.
+   *
+   * @param queryNode Query leaf.
+   * @param referenceNode Reference leaf.
+   * @return Number of base cases that were evaluated.
+   */
+  size_t BlockBaseCase(TreeType& queryNode, TreeType& referenceNode);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -183,8 +228,14 @@ class NeighborSearchRules
   typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
       CandidateList;
 
-  //! Set of candidate neighbors for each point.
-  std::vector<CandidateList> candidates;
+  //! Storage for the candidate neighbors of each point, if this object owns
+  //! them.
+  std::vector<CandidateList> candidateStorage;
+
+  //! Set of candidate neighbors for each point.  This refers either to
+  //! candidateStorage or to the candidates of another NeighborSearchRules
+  //! object.
+  std::vector<CandidateList>& candidates;
 
   //! Number of neighbors to search for.
   const size_t k;
@@ -219,6 +270,35 @@ class NeighborSearchRules
    */
   double CalculateBound(TreeType& queryNode) const;
 
+  /**
+   * Evaluate the base cases between the given query points and the points of
+   * the given reference node using a matrix multiplication.  This is used when
+   * UseDistanceBlock<MetricType, TreeType>::value is true.
+   */
+  void DistanceBlockBaseCase(const std::vector<size_t>& queries,
+                             TreeType& queryNode,
+                             TreeType& referenceNode,
+                             const std::true_type& /* useDistanceBlock */);
+
+  /**
+   * Get the squared norms of the points held in the given leaf.  If they are
+   * not cached in the statistic of the node, they are computed and stored in
+   * the given vector.
+   */
+  static const arma::vec& GetSquaredNorms(
+      const TreeType& node,
+      const typename TreeType::Mat& dataset,
+      arma::vec& norms);
+
+  /**
+   * Evaluate the base cases between the given query points and the points of
+   * the given reference node one at a time.
+   */
+  void DistanceBlockBaseCase(const std::vector<size_t>& queries,
+                             TreeType& queryNode,
+                             TreeType& referenceNode,
+                             const std::false_type& /* useDistanceBlock */);
+
   /**
    * Helper function to insert a point into the list of candidate points.
    *
@@ -29,12 +29,14 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     const bool sameSet) :
     referenceSet(referenceSet),
     querySet(querySet),
+    candidates(candidateStorage),
     k(k),
     metric(metric),
     sameSet(sameSet),
     epsilon(epsilon),
     lastQueryIndex(querySet.n_cols),
     lastReferenceIndex(referenceSet.n_cols),
+    lastBaseCase(0.0),
     baseCases(0),
     scores(0)
 {
@@ -59,6 +61,48 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     candidates.push_back(pqueue);
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
+    const NeighborSearchRules& other) :
+    referenceSet(other.referenceSet),
+    querySet(other.querySet),
+    candidateStorage(other.candidates),
+    candidates(candidateStorage),
+    k(other.k),
+    metric(other.metric),
+    sameSet(other.sameSet),
+    epsilon(other.epsilon),
+    lastQueryIndex(other.lastQueryIndex),
+    lastReferenceIndex(other.lastReferenceIndex),
+    lastBaseCase(other.lastBaseCase),
+    baseCases(other.baseCases),
+    scores(other.scores),
+    traversalInfo(other.traversalInfo)
+{
+  // Nothing to do.
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
+    NeighborSearchRules& other,
+    const tree::SharedResultsTag& /* tag */) :
+    referenceSet(other.referenceSet),
+    querySet(other.querySet),
+    candidates(other.candidates),
+    k(other.k),
+    metric(other.metric),
+    sameSet(other.sameSet),
+    epsilon(other.epsilon),
+    lastQueryIndex(querySet.n_cols),
+    lastReferenceIndex(referenceSet.n_cols),
+    lastBaseCase(0.0),
+    baseCases(0),
+    scores(0),
+    traversalInfo(other.traversalInfo)
+{
+  // Nothing to do.
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 void NeighborSearchRules<SortPolicy, MetricType, TreeType>::GetResults(
     arma::Mat<size_t>& neighbors,
@@ -107,6 +151,133 @@ BaseCase(const size_t queryIndex, const size_t referenceIndex)
   return distance;
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+size_t NeighborSearchRules<SortPolicy, MetricType, TreeType>::BlockBaseCase(
+    TreeType& queryNode,
+    TreeType& referenceNode)
+{
+  // Find the query points that can't be pruned.
+  std::vector<size_t> queries;
+  queries.reserve(queryNode.NumPoints());
+  for (size_t i = 0; i < queryNode.NumPoints(); ++i)
+  {
+    if (Score(queryNode.Point(i), referenceNode) != DBL_MAX)
+      queries.push_back(i);
+  }
+
+  if (queries.empty())
+    return 0;
+
+  DistanceBlockBaseCase(queries, queryNode, referenceNode,
+      std::integral_constant<bool,
+          UseDistanceBlock<MetricType, TreeType>::value>());
+
+  return queries.size() * referenceNode.NumPoints();
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearchRules<SortPolicy, MetricType, TreeType>::
+DistanceBlockBaseCase(const std::vector<size_t>& queries,
+                      TreeType& queryNode,
+                      TreeType& referenceNode,
+                      const std::true_type& /* useDistanceBlock */)
+{
+  const size_t numReferences = referenceNode.NumPoints();
+  if (numReferences == 0)
+    return;
+
+  // The points of each leaf are contiguous, so we can take the block of
+  // inner products between all of them without copying any points.
+  const size_t queryBegin = queryNode.Point(0);
+  const size_t referenceBegin = referenceNode.Point(0);
+  const arma::mat products = arma::trans(querySet.cols(queryBegin,
+      queryBegin + queryNode.NumPoints() - 1)) * referenceSet.cols(
+      referenceBegin, referenceBegin + numReferences - 1);
+
+  // Use the cached squared norms if they are available.
+  arma::vec queryNorms, referenceNorms;
+  const arma::vec& qNorms = GetSquaredNorms(queryNode, querySet, queryNorms);
+  const arma::vec& rNorms = GetSquaredNorms(referenceNode, referenceSet,
+      referenceNorms);
+
+  // The rounding error of each approximate squared distance is bounded by a
+  // small multiple of the dimensionality times the sum of the squared norms.
+  const double slackFactor = (querySet.n_rows + 4) *
+      std::numeric_limits<double>::epsilon();
+
+  baseCases += queries.size() * numReferences;
+  for (size_t i = 0; i < queries.size(); ++i)
+  {
+    const size_t q = queries[i];
+    const size_t queryIndex = queryBegin + q;
+    CandidateList& pqueue = candidates[queryIndex];
+
+    for (size_t r = 0; r < numReferences; ++r)
+    {
+      const size_t referenceIndex = referenceBegin + r;
+      if (sameSet && (queryIndex == referenceIndex))
+        continue;
+
+      // Find the best distance this combination could possibly have.
+      const double squaredDistance = qNorms[q] + rNorms[r] -
+          2 * products(q, r);
+      const double slack = slackFactor * (qNorms[q] + rNorms[r]);
+      double lo = std::max(squaredDistance - slack, 0.0);
+      double hi = squaredDistance + slack;
+      if (MetricType::TakeRoot)
+      {
+        lo = std::sqrt(lo);
+        hi = std::sqrt(hi);
+      }
+      const double bestDistance = SortPolicy::IsBetter(lo, hi) ? lo : hi;
+
+      if (!SortPolicy::IsBetter(bestDistance, pqueue.top().first))
+        continue;
+
+      // This combination may improve the candidate list, so compute the exact
+      // distance.
+      const double distance = metric.Evaluate(querySet.col(queryIndex),
+          referenceSet.col(referenceIndex));
+      InsertNeighbor(queryIndex, referenceIndex, distance);
+    }
+  }
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+const arma::vec&
+NeighborSearchRules<SortPolicy, MetricType, TreeType>::GetSquaredNorms(
+    const TreeType& node,
+    const typename TreeType::Mat& dataset,
+    arma::vec& norms)
+{
+  if (node.Stat().SquaredNorms().n_elem == node.NumPoints())
+    return node.Stat().SquaredNorms();
+
+  norms.set_size(node.NumPoints());
+  for (size_t i = 0; i < node.NumPoints(); ++i)
+  {
+    const double norm = arma::norm(dataset.col(node.Point(i)), 2);
+    norms[i] = norm * norm;
+  }
+
+  return norms;
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearchRules<SortPolicy, MetricType, TreeType>::
+DistanceBlockBaseCase(const std::vector<size_t>& queries,
+                      TreeType& queryNode,
+                      TreeType& referenceNode,
+                      const std::false_type& /* useDistanceBlock */)
+{
+  for (size_t i = 0; i < queries.size(); ++i)
+  {
+    const size_t queryIndex = queryNode.Point(queries[i]);
+    for (size_t r = 0; r < referenceNode.NumPoints(); ++r)
+      BaseCase(queryIndex, referenceNode.Point(r));
+  }
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     const size_t queryIndex,
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_STAT_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "use_distance_block.hpp"
 
 namespace mlpack {
 namespace neighbor {
@@ -39,6 +40,11 @@ class NeighborSearchStat
   double auxBound;
   //! The last distance evaluation.
   double lastDistance;
+  //! The squared norms of the points held in this node.  These are only cached
+  //! for leaves when NeighborSearchRules::BlockBaseCase() uses them (see
+  //! UseDistanceBlock), and are empty otherwise.  They may be an alias of
+  //! external memory (see NeighborSearch::LoadMapped()).
+  arma::vec squaredNorms;
 
  public:
   /**
@@ -52,15 +58,29 @@ class NeighborSearchStat
       lastDistance(0.0) { }
 
   /**
-   * Initialization for a fully initialized node.  In this case, we don't need
-   * to worry about the node.
+   * Initialization for a fully initialized node.  If the node is a leaf and
+   * UseDistanceBlock holds for the metric and type of the tree, the squared
+   * norms of its points are cached.
    */
   template<typename TreeType>
-  NeighborSearchStat(TreeType& /* node */) :
+  NeighborSearchStat(TreeType& node) :
       firstBound(SortPolicy::WorstDistance()),
       secondBound(SortPolicy::WorstDistance()),
       auxBound(SortPolicy::WorstDistance()),
-      lastDistance(0.0) { }
+      lastDistance(0.0)
+  {
+    typedef typename std::decay<decltype(node.Metric())>::type MetricType;
+    if (UseDistanceBlock<MetricType, TreeType>::value &&
+        node.NumChildren() == 0)
+    {
+      squaredNorms.set_size(node.NumPoints());
+      for (size_t i = 0; i < node.NumPoints(); ++i)
+      {
+        const double norm = arma::norm(node.Dataset().col(node.Point(i)), 2);
+        squaredNorms[i] = norm * norm;
+      }
+    }
+  }
 
   /**
    * Reset statistic parameters to initial values.
@@ -89,8 +109,14 @@ class NeighborSearchStat
   double LastDistance() const { return lastDistance; }
   //! Modify the last distance calculation.
   double& LastDistance() { return lastDistance; }
+  //! Get the cached squared norms of the points held in this node.  This is
+  //! empty if the norms were not cached.
+  const arma::vec& SquaredNorms() const { return squaredNorms; }
+  //! Modify the cached squared norms of the points held in this node.
+  arma::vec& SquaredNorms() { return squaredNorms; }
 
-  //! Serialize the statistic to/from an archive.
+  //! Serialize the statistic to/from an archive.  The squared norms are not
+  //! serialized; they are computed on demand when not cached.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
   {
@@ -20,6 +20,7 @@
 #include <mlpack/core/tree/rectangle_tree.hpp>
 #include <mlpack/core/tree/spill_tree.hpp>
 #include <mlpack/core/tree/octree.hpp>
+#include <mlpack/core/data/mapped_file.hpp>
 #include <boost/variant.hpp>
 #include "neighbor_search.hpp"
 
@@ -306,6 +307,25 @@ class NSModel
                  NSType<SortPolicy, tree::UBTree>*,
                  NSType<SortPolicy, tree::Octree>*> nSearch;
 
+  //! If the model was loaded with LoadMapped(), the file that the reference
+  //! tree and dataset are used from.
+  std::shared_ptr<data::MappedFile> mappedFile;
+
+  //! Identifies the memory-mapped format written by SaveMapped().  All of the
+  //! integers in the format are 64-bit, so that it does not depend on the
+  //! platform.
+  static const uint64_t mappedFormatId = 0x314c444f4d534e4dULL;
+
+  //! Write the given neighbor search object in the memory-mapped format.
+  template<typename NSType>
+  static void SaveMappedSearch(const NSType* ns, std::ostream& stream);
+
+  //! Create a neighbor search object from the memory-mapped format.
+  template<typename NSType>
+  static NSType* LoadMappedSearch(char* memory,
+                                  const size_t size,
+                                  size_t& offset);
+
  public:
   /**
    * Initialize the NSModel with the given type and whether or not a random
@@ -352,6 +372,28 @@ class NSModel
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */);
 
+  /**
+   * Save the model to the given file in a format that is memory-mapped when it
+   * is loaded with LoadMapped(), so that the reference tree and dataset do not
+   * need to be read or copied.  Only models built with kd-trees, RP trees, or
+   * max-RP trees, and not in naive mode, can be saved in this format.  A
+   * std::invalid_argument is thrown for any other model.
+   *
+   * @param filename File to save the model to.
+   */
+  void SaveMapped(const std::string& filename) const;
+
+  /**
+   * Load a model saved with SaveMapped() by memory-mapping the given file.  The
+   * reference tree and dataset are used in place, so loading is fast even for
+   * very large models, and every process that loads the same file shares one
+   * copy of it in memory.  A std::runtime_error is thrown if the file does not
+   * hold a model of this type.
+   *
+   * @param filename File to load the model from.
+   */
+  void LoadMapped(const std::string& filename);
+
   //! Expose the dataset.
   const arma::mat& Dataset() const;
 
@@ -84,7 +84,8 @@ void BiSearchVisitor<SortPolicy>::operator()(SpillKNN* ns) const
 {
   if (ns)
   {
-    if (ns->SearchMode() == DUAL_TREE_MODE)
+    if (ns->SearchMode() == DUAL_TREE_MODE ||
+        ns->SearchMode() == PARALLEL_DUAL_TREE_MODE)
     {
       // For Dual Tree Search on SpillTrees, the queryTree must be built with
       // non overlapping (tau = 0).
@@ -113,7 +114,8 @@ template<typename SortPolicy>
 template<typename NSType>
 void BiSearchVisitor<SortPolicy>::SearchLeaf(NSType* ns) const
 {
-  if (ns->SearchMode() == DUAL_TREE_MODE)
+  if (ns->SearchMode() == DUAL_TREE_MODE ||
+      ns->SearchMode() == PARALLEL_DUAL_TREE_MODE)
   {
     std::vector<size_t> oldFromNewQueries;
     typename NSType::Tree queryTree(std::move(querySet), oldFromNewQueries,
@@ -281,7 +283,8 @@ NSModel<SortPolicy>::NSModel(const NSModel& other) :
     rho(other.rho),
     randomBasis(other.randomBasis),
     q(other.q),
-    nSearch(other.nSearch)
+    nSearch(other.nSearch),
+    mappedFile(other.mappedFile)
 {
   // Nothing to do.
 }
@@ -294,7 +297,8 @@ NSModel<SortPolicy>::NSModel(NSModel&& other) :
     rho(other.rho),
     randomBasis(other.randomBasis),
     q(std::move(other.q)),
-    nSearch(other.nSearch)
+    nSearch(other.nSearch),
+    mappedFile(std::move(other.mappedFile))
 {
   // Reset parameters of the other model.
   other.treeType = TreeTypes::KD_TREE;
@@ -317,6 +321,7 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(const NSModel& other)
   randomBasis = other.randomBasis;
   q = other.q;
   nSearch = other.nSearch;
+  mappedFile = other.mappedFile;
 
   return *this;
 }
@@ -334,6 +339,7 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
   q = std::move(other.q);
   // Copy the pointer and type.
   nSearch = other.nSearch;
+  mappedFile = std::move(other.mappedFile);
 
   // Reset parameters of the other model.
   other.treeType = TreeTypes::KD_TREE;
@@ -367,11 +373,141 @@ void NSModel<SortPolicy>::serialize(Archive& ar, const uint32_t /* version */)
 
   // This should never happen, but just in case, be clean with memory.
   if (cereal::is_loading<Archive>())
+  {
     boost::apply_visitor(DeleteVisitor(), nSearch);
+    mappedFile.reset();
+  }
 
   ar(CEREAL_VARIANT_POINTER(nSearch));
 }
 
+//! Save the kNN model in the memory-mapped format.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::SaveMapped(const std::string& filename) const
+{
+  if (treeType != KD_TREE && treeType != RP_TREE && treeType != MAX_RP_TREE)
+  {
+    throw std::invalid_argument("NSModel::SaveMapped(): only models with a "
+        "kd-tree, an RP tree, or a max-RP tree can be saved in the "
+        "memory-mapped format!");
+  }
+
+  std::ofstream ofs(filename, std::ofstream::out | std::ofstream::binary);
+  if (!ofs.is_open())
+  {
+    throw std::runtime_error("NSModel::SaveMapped(): cannot open file '" +
+        filename + "'!");
+  }
+
+  const uint64_t header[6] = { mappedFormatId, (uint64_t) treeType, leafSize,
+      (uint64_t) randomBasis, q.n_rows, q.n_cols };
+  // The worst distance identifies the sort policy.
+  const double parameters[3] = { tau, rho, SortPolicy::WorstDistance() };
+  data::WriteMapped(ofs, header, 6);
+  data::WriteMapped(ofs, parameters, 3);
+  data::WriteMapped(ofs, q.memptr(), q.n_elem);
+
+  switch (treeType)
+  {
+    case KD_TREE:
+      SaveMappedSearch(boost::get<NSType<SortPolicy, tree::KDTree>*>(nSearch),
+          ofs);
+      break;
+    case RP_TREE:
+      SaveMappedSearch(boost::get<NSType<SortPolicy, tree::RPTree>*>(nSearch),
+          ofs);
+      break;
+    default:
+      SaveMappedSearch(
+          boost::get<NSType<SortPolicy, tree::MaxRPTree>*>(nSearch), ofs);
+      break;
+  }
+}
+
+//! Load a kNN model saved in the memory-mapped format.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::LoadMapped(const std::string& filename)
+{
+  std::shared_ptr<data::MappedFile> file(new data::MappedFile(filename));
+  char* memory = file->Data();
+  const size_t size = file->Size();
+  size_t offset = 0;
+
+  const uint64_t* header = data::ReadMapped<uint64_t>(memory, size, offset, 6);
+  if (header[0] != mappedFormatId)
+  {
+    throw std::runtime_error("NSModel::LoadMapped(): '" + filename + "' does "
+        "not hold a memory-mapped neighbor search model!");
+  }
+
+  const double* parameters = data::ReadMapped<double>(memory, size, offset, 3);
+  if (parameters[2] != SortPolicy::WorstDistance())
+  {
+    throw std::runtime_error("NSModel::LoadMapped(): the model in '" +
+        filename + "' was saved with a different sort policy!");
+  }
+
+  double* qMemory = data::ReadMapped<double>(memory, size, offset,
+      header[4] * header[5]);
+
+  // Load the search object before anything is changed, in case it fails.
+  decltype(nSearch) newSearch;
+  switch ((TreeTypes) header[1])
+  {
+    case KD_TREE:
+      newSearch = LoadMappedSearch<NSType<SortPolicy, tree::KDTree>>(memory,
+          size, offset);
+      break;
+    case RP_TREE:
+      newSearch = LoadMappedSearch<NSType<SortPolicy, tree::RPTree>>(memory,
+          size, offset);
+      break;
+    case MAX_RP_TREE:
+      newSearch = LoadMappedSearch<NSType<SortPolicy, tree::MaxRPTree>>(
+          memory, size, offset);
+      break;
+    default:
+      throw std::runtime_error("NSModel::LoadMapped(): the model in '" +
+          filename + "' has an unsupported tree type!");
+  }
+
+  boost::apply_visitor(DeleteVisitor(), nSearch);
+  nSearch = newSearch;
+  mappedFile = file;
+
+  treeType = (TreeTypes) header[1];
+  leafSize = (size_t) header[2];
+  randomBasis = (header[3] != 0);
+  // The basis is small; copy it.
+  q = arma::mat(qMemory, (size_t) header[4], (size_t) header[5]);
+  tau = parameters[0];
+  rho = parameters[1];
+}
+
+//! Write the given neighbor search object in the memory-mapped format.
+template<typename SortPolicy>
+template<typename NSType>
+void NSModel<SortPolicy>::SaveMappedSearch(const NSType* ns,
+                                           std::ostream& stream)
+{
+  if (!ns)
+    throw std::runtime_error("no neighbor search model initialized");
+
+  ns->SaveMapped(stream);
+}
+
+//! Create a neighbor search object from the memory-mapped format.
+template<typename SortPolicy>
+template<typename NSType>
+NSType* NSModel<SortPolicy>::LoadMappedSearch(char* memory,
+                                              const size_t size,
+                                              size_t& offset)
+{
+  std::unique_ptr<NSType> ns(new NSType());
+  ns->LoadMapped(memory, size, offset);
+  return ns.release();
+}
+
 //! Expose the dataset.
 template<typename SortPolicy>
 const arma::mat& NSModel<SortPolicy>::Dataset() const
@@ -447,6 +583,7 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
 
   // Clean memory, if necessary.
   boost::apply_visitor(DeleteVisitor(), nSearch);
+  mappedFile.reset();
 
   // Do we need to modify the reference set?
   if (randomBasis)
@@ -547,6 +684,10 @@ void NSModel<SortPolicy>::Search(arma::mat&& querySet,
       Log::Info << "greedy single-tree " << TreeName() << " search..."
           << std::endl;
       break;
+    case PARALLEL_DUAL_TREE_MODE:
+      Log::Info << "parallel dual-tree " << TreeName() << " search..."
+          << std::endl;
+      break;
   }
 
   BiSearchVisitor<SortPolicy> search(querySet, k, neighbors, distances,
@@ -577,6 +718,10 @@ void NSModel<SortPolicy>::Search(const size_t k,
       Log::Info << "greedy single-tree " << TreeName() << " search..."
           << std::endl;
       break;
+    case PARALLEL_DUAL_TREE_MODE:
+      Log::Info << "parallel dual-tree " << TreeName() << " search..."
+          << std::endl;
+      break;
   }
 
   if (Epsilon() != 0 && SearchMode() != NAIVE_MODE)
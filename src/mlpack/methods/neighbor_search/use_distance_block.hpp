@@ -0,0 +1,49 @@
+/**
+ * @file methods/neighbor_search/use_distance_block.hpp
+ *
+ * A trait class that says whether the base cases between two leaves can be
+ * computed as a block of distances with a matrix multiplication.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_USE_DISTANCE_BLOCK_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_USE_DISTANCE_BLOCK_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/tree/tree_traits.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * UseDistanceBlock<MetricType, TreeType>::value is true if
+ * NeighborSearchRules::BlockBaseCase() can compute the distances between the
+ * points of two leaves with a matrix multiplication.  That is the case when the
+ * metric is the (squared) Euclidean distance and the points of each leaf are
+ * held contiguously in a dense matrix.  NeighborSearchStat only caches the
+ * squared norms of the points of a leaf in that case.
+ */
+template<typename MetricType, typename TreeType>
+struct UseDistanceBlock
+{
+  static const bool value = false;
+};
+
+//! The (squared) Euclidean distance can use a block of distances, if the tree
+//! holds the points of each leaf contiguously in a dense matrix.
+template<bool TakeRoot, typename TreeType>
+struct UseDistanceBlock<metric::LMetric<2, TakeRoot>, TreeType>
+{
+  static const bool value =
+      std::is_same<typename TreeType::Mat, arma::mat>::value &&
+      tree::TreeTraits<TreeType>::RearrangesDataset;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
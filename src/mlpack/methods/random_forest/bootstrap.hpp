@@ -3,7 +3,8 @@
  * @author Ryan Curtin
  *
  * Implementation of the Bootstrap() function, which creates a bootstrapped
- * dataset from the given input dataset.
+ * dataset from the given input dataset, and of the BootstrapView class, which
+ * represents a bootstrapped dataset without copying the input dataset.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -47,6 +48,144 @@ void Bootstrap(const MatType& dataset,
   }
 }
 
+/**
+ * A BootstrapView is a bootstrapped dataset that holds the indices of the
+ * sampled points instead of copies of them, so that many bootstrapped datasets
+ * can share one input dataset.  It provides the part of the Armadillo matrix
+ * interface that DecisionTree uses for training: element access, column swaps
+ * (which only swap indices), and extraction of a row of a range of columns.
+ * The input dataset must outlive the view.
+ *
+ * @code
+ * BootstrapView<arma::mat> bootstrapDataset;
+ * arma::Row<size_t> bootstrapLabels;
+ * arma::rowvec bootstrapWeights;
+ * Bootstrap<false>(dataset, labels, weights, bootstrapDataset,
+ *     bootstrapLabels, bootstrapWeights);
+ * DecisionTree<> tree(std::move(bootstrapDataset), bootstrapLabels, 3);
+ * @endcode
+ *
+ * @tparam MatType Type of the input dataset.
+ */
+template<typename MatType>
+class BootstrapView
+{
+ public:
+  //! The type of the elements of the dataset.
+  typedef typename MatType::elem_type elem_type;
+
+  /**
+   * A range of columns of a BootstrapView, from which rows can be extracted
+   * (like the result of arma::Mat::cols()).
+   */
+  class Cols
+  {
+   public:
+    //! Create the range [first, last] of the columns of the given view.
+    Cols(const BootstrapView& view, const size_t first, const size_t last) :
+        view(view), first(first), last(last) { }
+
+    //! Copy the given row of the range of columns.
+    arma::Row<elem_type> row(const size_t i) const
+    {
+      arma::Row<elem_type> result(last - first + 1);
+      for (size_t j = first; j <= last; ++j)
+        result[j - first] = view(i, j);
+      return result;
+    }
+
+   private:
+    //! The view the columns belong to.
+    const BootstrapView& view;
+    //! The first column of the range.
+    size_t first;
+    //! The last column of the range.
+    size_t last;
+  };
+
+  //! Create an empty view.
+  BootstrapView() : n_rows(0), n_cols(0), dataset(NULL) { }
+
+  /**
+   * Create a view of the given columns of the given dataset.  A column may
+   * appear more than once.
+   *
+   * @param dataset Input dataset.
+   * @param indices Indices of the columns of the dataset in the view.
+   */
+  BootstrapView(const MatType& dataset, arma::uvec indices) :
+      n_rows(dataset.n_rows),
+      n_cols(indices.n_elem),
+      dataset(&dataset),
+      indices(std::move(indices))
+  { }
+
+  //! Get the element of the given row and column of the view.
+  elem_type operator()(const size_t row, const size_t col) const
+  {
+    return (*dataset)(row, indices[col]);
+  }
+
+  //! Get the given range of columns of the view.
+  Cols cols(const size_t first, const size_t last) const
+  {
+    return Cols(*this, first, last);
+  }
+
+  //! Swap two columns of the view; the dataset is not modified.
+  void swap_cols(const size_t first, const size_t second)
+  {
+    std::swap(indices[first], indices[second]);
+  }
+
+  //! Get the indices of the columns of the dataset in the view.
+  const arma::uvec& Indices() const { return indices; }
+
+  //! The number of rows of the view.
+  size_t n_rows;
+  //! The number of columns of the view.
+  size_t n_cols;
+
+ private:
+  //! The input dataset.
+  const MatType* dataset;
+  //! The indices of the columns of the dataset in the view.
+  arma::uvec indices;
+};
+
+/**
+ * Given a dataset, create a view of it via bootstrap sampling, with labels.
+ * The same points are sampled as with the Bootstrap() overload that copies
+ * the dataset, but only their indices are stored.
+ */
+template<bool UseWeights,
+         typename MatType,
+         typename LabelsType,
+         typename WeightsType>
+void Bootstrap(const MatType& dataset,
+               const LabelsType& labels,
+               const WeightsType& weights,
+               BootstrapView<MatType>& bootstrapDataset,
+               LabelsType& bootstrapLabels,
+               WeightsType& bootstrapWeights)
+{
+  bootstrapLabels.set_size(labels.n_elem);
+  if (UseWeights)
+    bootstrapWeights.set_size(weights.n_elem);
+
+  // Random sampling with replacement.
+  arma::uvec indices = arma::randi<arma::uvec>(dataset.n_cols,
+      arma::distr_param(0, dataset.n_cols - 1));
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    bootstrapLabels[i] = labels[indices[i]];
+    if (UseWeights)
+      bootstrapWeights[i] = weights[indices[i]];
+  }
+
+  bootstrapDataset = BootstrapView<MatType>(dataset, std::move(indices));
+}
+
 } // namespace tree
 } // namespace mlpack
 
@@ -0,0 +1,205 @@
+/**
+ * @file methods/random_forest/flat_forest.hpp
+ *
+ * Definition of the FlatForest class, a flattened representation of decision
+ * trees and random forests for fast batch classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "random_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A FlatForest is a read-only copy of a trained DecisionTree or RandomForest
+ * that is laid out for fast classification.  The nodes of all the trees are
+ * stored in flat arrays, one array per field (structure of arrays), in
+ * breadth-first order, so that the top levels of each tree are contiguous and
+ * the children of each node are adjacent.  When a batch of points is
+ * classified, the points are processed in blocks (in parallel if OpenMP is
+ * available), and each tree is applied to all the points of a block before
+ * the next tree, so that the nodes of the tree stay in cache.
+ *
+ * The predictions and probabilities are exactly those of the DecisionTree or
+ * RandomForest that the FlatForest was built from.  Numeric splits are
+ * assumed to send points that are less than or equal to a threshold to the
+ * first child and other points to the second, as BestBinaryNumericSplit and
+ * HistogramNumericSplit do; categorical splits are assumed to send points to
+ * the child with the index of their category, as AllCategoricalSplit does.
+ * A std::invalid_argument is thrown for trees with other numeric splits.
+ *
+ * @code
+ * RandomForest<> rf(data, labels, numClasses, 100);
+ * FlatForest<> flat(rf);
+ * arma::Row<size_t> predictions;
+ * arma::mat probabilities;
+ * flat.Classify(testData, predictions, probabilities);
+ * @endcode
+ *
+ * The FlatForest does not refer to the tree or forest after it is built.
+ *
+ * @tparam ElemType Type of the elements of the data to classify.
+ */
+template<typename ElemType = double>
+class FlatForest
+{
+ public:
+  //! Number of points that are classified together by each tree.
+  static const size_t BlockSize = 64;
+
+  /**
+   * Create an empty FlatForest.  Classify() will throw an exception until a
+   * model is loaded.
+   */
+  FlatForest() { }
+
+  /**
+   * Flatten the given trained decision tree.
+   *
+   * @param tree Decision tree to flatten.
+   */
+  template<typename FitnessFunction,
+           template<typename> class NumericSplitType,
+           template<typename> class CategoricalSplitType,
+           typename DimensionSelectionType,
+           bool NoRecursion>
+  FlatForest(const DecisionTree<FitnessFunction,
+                                NumericSplitType,
+                                CategoricalSplitType,
+                                DimensionSelectionType,
+                                ElemType,
+                                NoRecursion>& tree);
+
+  /**
+   * Flatten the given trained random forest.
+   *
+   * @param forest Random forest to flatten.
+   */
+  template<typename FitnessFunction,
+           typename DimensionSelectionType,
+           template<typename> class NumericSplitType,
+           template<typename> class CategoricalSplitType>
+  FlatForest(const RandomForest<FitnessFunction,
+                                DimensionSelectionType,
+                                NumericSplitType,
+                                CategoricalSplitType,
+                                ElemType>& forest);
+
+  /**
+   * Predict the class of the given point.
+   *
+   * @param point Point to be classified.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Predict the class of the given point and return the predicted class
+   * probabilities for each class.
+   *
+   * @param point Point to be classified.
+   * @param prediction size_t to store predicted class in.
+   * @param probabilities Output vector of class probabilities.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                arma::vec& probabilities) const;
+
+  /**
+   * Predict the classes of each point in the given dataset.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the classes of each point in the given dataset, also returning the
+   * predicted class probabilities for each point.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   * @param probabilities Output matrix of class probabilities for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of trees.
+  size_t NumTrees() const { return roots.n_elem; }
+  //! Get the number of nodes of all the trees.
+  size_t NumNodes() const { return nodeTypes.n_elem; }
+  //! Get the number of classes.
+  size_t NumClasses() const { return leafProbabilities.n_rows; }
+
+  //! Serialize the flattened forest.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! The kinds of node.
+  enum NodeType
+  {
+    Leaf = 0,
+    NumericNode = 1,
+    CategoricalNode = 2
+  };
+
+  //! Append the nodes of the given tree.
+  template<typename TreeType>
+  void AddTree(const TreeType& tree);
+
+  /**
+   * Find the leaf of the given tree that the given point falls into, and
+   * return its index in leafProbabilities.
+   */
+  template<typename VecType>
+  size_t FindLeaf(const size_t tree, const VecType& point) const
+  {
+    size_t node = roots[tree];
+    while (nodeTypes[node] != Leaf)
+    {
+      const ElemType value = point[splitDimensions[node]];
+      if (nodeTypes[node] == NumericNode)
+        node = children[node] + ((value <= thresholds[node]) ? 0 : 1);
+      else
+        node = children[node] + (size_t) value;
+    }
+
+    return children[node];
+  }
+
+  //! The index of the root node of each tree.
+  arma::Col<size_t> roots;
+  //! The type of each node.
+  arma::Col<unsigned char> nodeTypes;
+  //! The split dimension of each node (unused for leaves).
+  arma::Col<size_t> splitDimensions;
+  //! The split threshold of each numeric node (unused for other nodes).
+  arma::vec thresholds;
+  //! The index of the first child of each node, or the index of the leaf in
+  //! leafProbabilities for leaves.
+  arma::Col<size_t> children;
+  //! The class probabilities of each leaf, one leaf per column.
+  arma::mat leafProbabilities;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "flat_forest_impl.hpp"
+
+#endif
@@ -0,0 +1,256 @@
+/**
+ * @file methods/random_forest/flat_forest_impl.hpp
+ *
+ * Implementation of the FlatForest class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_IMPL_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "flat_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename ElemType>
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+FlatForest<ElemType>::FlatForest(const DecisionTree<FitnessFunction,
+                                                    NumericSplitType,
+                                                    CategoricalSplitType,
+                                                    DimensionSelectionType,
+                                                    ElemType,
+                                                    NoRecursion>& tree)
+{
+  AddTree(tree);
+}
+
+template<typename ElemType>
+template<typename FitnessFunction,
+         typename DimensionSelectionType,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+FlatForest<ElemType>::FlatForest(const RandomForest<FitnessFunction,
+                                                    DimensionSelectionType,
+                                                    NumericSplitType,
+                                                    CategoricalSplitType,
+                                                    ElemType>& forest)
+{
+  if (forest.NumTrees() == 0)
+  {
+    throw std::invalid_argument("FlatForest::FlatForest(): no random forest "
+        "trained!");
+  }
+
+  for (size_t i = 0; i < forest.NumTrees(); ++i)
+    AddTree(forest.Tree(i));
+}
+
+template<typename ElemType>
+template<typename TreeType>
+void FlatForest<ElemType>::AddTree(const TreeType& tree)
+{
+  if (tree.NumClasses() == 0)
+  {
+    throw std::invalid_argument("FlatForest::FlatForest(): no decision tree "
+        "trained!");
+  }
+  else if (roots.n_elem > 0 && tree.NumClasses() != leafProbabilities.n_rows)
+  {
+    throw std::invalid_argument("FlatForest::FlatForest(): all trees must "
+        "have the same number of classes!");
+  }
+
+  // Number the nodes in breadth-first order; this gives the children of each
+  // node consecutive indices.
+  std::vector<const TreeType*> nodes(1, &tree);
+  size_t numLeaves = 0;
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    if (nodes[i]->NumChildren() == 0)
+      ++numLeaves;
+
+    for (size_t j = 0; j < nodes[i]->NumChildren(); ++j)
+      nodes.push_back(&nodes[i]->Child(j));
+  }
+
+  const size_t offset = nodeTypes.n_elem;
+  roots.resize(roots.n_elem + 1);
+  roots[roots.n_elem - 1] = offset;
+
+  nodeTypes.resize(offset + nodes.size());
+  splitDimensions.resize(offset + nodes.size());
+  thresholds.resize(offset + nodes.size());
+  children.resize(offset + nodes.size());
+
+  size_t leaf = leafProbabilities.n_cols;
+  leafProbabilities.resize(tree.NumClasses(), leaf + numLeaves);
+
+  size_t nextChild = offset + 1;
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    const TreeType& node = *nodes[i];
+    const size_t index = offset + i;
+
+    if (node.NumChildren() == 0)
+    {
+      nodeTypes[index] = Leaf;
+      splitDimensions[index] = 0;
+      thresholds[index] = 0.0;
+      children[index] = leaf;
+      leafProbabilities.col(leaf++) = node.classProbabilities;
+      continue;
+    }
+
+    splitDimensions[index] = node.splitDimension;
+    children[index] = nextChild;
+    nextChild += node.NumChildren();
+
+    if ((data::Datatype) node.dimensionTypeOrMajorityClass ==
+        data::Datatype::categorical)
+    {
+      nodeTypes[index] = CategoricalNode;
+      thresholds[index] = 0.0;
+      continue;
+    }
+
+    // Make sure that the numeric split compares with a threshold, by checking
+    // that the threshold goes left and the next larger value goes right.
+    const double threshold = node.classProbabilities[0];
+    const double above = std::nextafter(threshold, DBL_MAX);
+    if (node.NumChildren() != 2 ||
+        TreeType::NumericSplit::CalculateDirection(threshold,
+            node.classProbabilities, node) != 0 ||
+        TreeType::NumericSplit::CalculateDirection(above,
+            node.classProbabilities, node) != 1)
+    {
+      throw std::invalid_argument("FlatForest::FlatForest(): only numeric "
+          "splits on a threshold can be flattened!");
+    }
+
+    nodeTypes[index] = NumericNode;
+    thresholds[index] = threshold;
+  }
+}
+
+template<typename ElemType>
+template<typename VecType>
+size_t FlatForest<ElemType>::Classify(const VecType& point) const
+{
+  // Pass off to another Classify() overload.
+  size_t prediction;
+  arma::vec probabilities;
+  Classify(point, prediction, probabilities);
+
+  return prediction;
+}
+
+template<typename ElemType>
+template<typename VecType>
+void FlatForest<ElemType>::Classify(const VecType& point,
+                                    size_t& prediction,
+                                    arma::vec& probabilities) const
+{
+  if (roots.n_elem == 0)
+  {
+    probabilities.clear();
+    prediction = 0;
+
+    throw std::invalid_argument("FlatForest::Classify(): no trees to classify "
+        "with!");
+  }
+
+  // Average the probabilities of the trees in order, as RandomForest does.
+  probabilities.zeros(leafProbabilities.n_rows);
+  for (size_t i = 0; i < roots.n_elem; ++i)
+    probabilities += leafProbabilities.col(FindLeaf(i, point));
+
+  probabilities /= roots.n_elem;
+  arma::uword maxIndex = 0;
+  probabilities.max(maxIndex);
+  prediction = (size_t) maxIndex;
+}
+
+template<typename ElemType>
+template<typename MatType>
+void FlatForest<ElemType>::Classify(const MatType& data,
+                                    arma::Row<size_t>& predictions) const
+{
+  // The probabilities are needed to find the predictions anyway.
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename ElemType>
+template<typename MatType>
+void FlatForest<ElemType>::Classify(const MatType& data,
+                                    arma::Row<size_t>& predictions,
+                                    arma::mat& probabilities) const
+{
+  if (roots.n_elem == 0)
+  {
+    predictions.clear();
+    probabilities.clear();
+
+    throw std::invalid_argument("FlatForest::Classify(): no trees to classify "
+        "with!");
+  }
+
+  probabilities.zeros(leafProbabilities.n_rows, data.n_cols);
+  predictions.set_size(data.n_cols);
+
+  const size_t numBlocks = (data.n_cols + BlockSize - 1) / BlockSize;
+
+  #pragma omp parallel for
+  for (omp_size_t block = 0; block < (omp_size_t) numBlocks; ++block)
+  {
+    const size_t begin = block * BlockSize;
+    const size_t end = std::min(begin + BlockSize, (size_t) data.n_cols);
+
+    // Apply each tree to all the points of the block before moving on to the
+    // next tree, so that the nodes of the tree stay in cache.  Each point
+    // still gets the probabilities of the trees added in order.
+    for (size_t i = 0; i < roots.n_elem; ++i)
+    {
+      for (size_t j = begin; j < end; ++j)
+      {
+        probabilities.col(j) += leafProbabilities.col(FindLeaf(i,
+            data.col(j)));
+      }
+    }
+
+    for (size_t j = begin; j < end; ++j)
+    {
+      probabilities.col(j) /= roots.n_elem;
+      arma::uword maxIndex = 0;
+      probabilities.col(j).max(maxIndex);
+      predictions[j] = (size_t) maxIndex;
+    }
+  }
+}
+
+template<typename ElemType>
+template<typename Archive>
+void FlatForest<ElemType>::serialize(Archive& ar,
+                                     const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(roots));
+  ar(CEREAL_NVP(nodeTypes));
+  ar(CEREAL_NVP(splitDimensions));
+  ar(CEREAL_NVP(thresholds));
+  ar(CEREAL_NVP(children));
+  ar(CEREAL_NVP(leafProbabilities));
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
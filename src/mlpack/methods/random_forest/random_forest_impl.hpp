@@ -470,43 +470,47 @@ double RandomForest<
   #pragma omp parallel for reduction( + : avgGain)
   for (omp_size_t i = 0; i < numTrees; ++i)
   {
+    // The bootstrapped dataset only holds the indices of the sampled points, so
+    // the memory used by each tree doesn't depend on the dimensionality.
     Timer::Start("bootstrap");
-    MatType bootstrapDataset;
+    BootstrapView<MatType> bootstrapDataset;
     arma::Row<size_t> bootstrapLabels;
     arma::rowvec bootstrapWeights;
     Bootstrap<UseWeights>(dataset, labels, weights, bootstrapDataset,
         bootstrapLabels, bootstrapWeights);
     Timer::Stop("bootstrap");
 
-    // Now build the decision tree.
+    // Now build the decision tree.  The bootstrapped data isn't needed after
+    // that, so it can be moved.
     Timer::Start("train_tree");
     if (UseWeights)
     {
       if (UseDatasetInfo)
       {
-        avgGain += trees[i].Train(bootstrapDataset, datasetInfo,
-            bootstrapLabels, numClasses, bootstrapWeights, minimumLeafSize,
-            minimumGainSplit, maximumDepth, dimensionSelector);
+        avgGain += trees[i].Train(std::move(bootstrapDataset), datasetInfo,
+            std::move(bootstrapLabels), numClasses, std::move(bootstrapWeights),
+            minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
       }
       else
       {
-        avgGain += trees[i].Train(bootstrapDataset, bootstrapLabels, numClasses,
-            bootstrapWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
-            dimensionSelector);
+        avgGain += trees[i].Train(std::move(bootstrapDataset),
+            std::move(bootstrapLabels), numClasses, std::move(bootstrapWeights),
+            minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
       }
     }
     else
     {
       if (UseDatasetInfo)
       {
-        avgGain += trees[i].Train(bootstrapDataset, datasetInfo,
-            bootstrapLabels, numClasses, minimumLeafSize, minimumGainSplit,
-            maximumDepth, dimensionSelector);
+        avgGain += trees[i].Train(std::move(bootstrapDataset), datasetInfo,
+            std::move(bootstrapLabels), numClasses, minimumLeafSize,
+            minimumGainSplit, maximumDepth, dimensionSelector);
       }
       else
       {
-        avgGain += trees[i].Train(bootstrapDataset, bootstrapLabels, numClasses,
-            minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
+        avgGain += trees[i].Train(std::move(bootstrapDataset),
+            std::move(bootstrapLabels), numClasses, minimumLeafSize,
+            minimumGainSplit, maximumDepth, dimensionSelector);
       }
     }
     Timer::Stop("train_tree");
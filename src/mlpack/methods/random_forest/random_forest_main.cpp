@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/random_forest/random_forest.hpp>
+#include <mlpack/methods/random_forest/flat_forest.hpp>
 #include <mlpack/methods/decision_tree/random_dimension_select.hpp>
 #include <mlpack/core/util/mlpack_main.hpp>
 
@@ -241,7 +242,8 @@ static void mlpackMain()
     {
       Timer::Start("rf_prediction");
       arma::Row<size_t> predictions;
-      rfModel->rf.Classify(data, predictions);
+      FlatForest<> flatForest(rfModel->rf);
+      flatForest.Classify(data, predictions);
 
       const size_t correct = arma::accu(predictions == labels);
 
@@ -262,10 +264,12 @@ static void mlpackMain()
     arma::mat testData = std::move(IO::GetParam<arma::mat>("test"));
     Timer::Start("rf_prediction");
 
-    // Get predictions and probabilities.
+    // Get predictions and probabilities.  The flattened forest gives the same
+    // results as the forest, faster.
     arma::Row<size_t> predictions;
     arma::mat probabilities;
-    rfModel->rf.Classify(testData, predictions, probabilities);
+    FlatForest<> flatForest(rfModel->rf);
+    flatForest.Classify(testData, predictions, probabilities);
 
     // Did we want to calculate test accuracy?
     if (IO::HasParam("test_labels"))
@@ -16,6 +16,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/data/mapped_file.hpp>
 #include "range_search_stat.hpp"
 
 namespace mlpack {
@@ -173,6 +174,10 @@ class RangeSearch
    *
    * - neighbors[i] and distances[i] are not sorted in any particular order.
    *
+   * In naive and single-tree mode, the query points are searched in parallel
+   * if OpenMP is available (except with trees such as the cover tree, which
+   * cache distances in their nodes).
+   *
    * @param querySet Set of query points to search with.
    * @param range Range of distances in which to search.
    * @param neighbors Object which will hold the list of neighbors for each
@@ -278,6 +283,29 @@ class RangeSearch
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t version);
 
+  /**
+   * Write the reference tree, its dataset, and the mapping of the reference
+   * points in a format that can be used in place after it is memory-mapped;
+   * see LoadMapped().  This can't be used in naive mode, and the tree type must
+   * support the memory-mapped format (see BinarySpaceTree::SaveMapped()).
+   *
+   * @param stream Stream to write to.
+   */
+  void SaveMapped(std::ostream& stream) const;
+
+  /**
+   * Load a model written by SaveMapped() from the given memory, which is
+   * usually a data::MappedFile.  The reference tree and dataset are used in
+   * place, so the memory must outlive the model (or the next call to Train()
+   * or LoadMapped()).
+   *
+   * @param memory Memory holding the model.
+   * @param size Size of the memory, in bytes.
+   * @param offset Offset of the model in the memory.  On return, the offset of
+   *     whatever was written after the model.
+   */
+  void LoadMapped(char* memory, const size_t size, size_t& offset);
+
   //! Return the reference set.
   const MatType& ReferenceSet() const { return *referenceSet; }
 
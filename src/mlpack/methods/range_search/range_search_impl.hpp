@@ -330,29 +330,49 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
 
   if (naive)
   {
-    RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
-        metric);
+    // The naive brute-force solution.  The query points are split between
+    // threads; each thread has its own rules object and only writes the results
+    // of its own query points.
+    #pragma omp parallel
+    {
+      RuleType rules(*referenceSet, querySet, range, *neighborPtr,
+          *distancePtr, metric);
 
-    // The naive brute-force solution.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      for (size_t j = 0; j < referenceSet->n_cols; ++j)
-        rules.BaseCase(i, j);
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+        for (size_t j = 0; j < referenceSet->n_cols; ++j)
+          rules.BaseCase(i, j);
+    }
 
     baseCases += (querySet.n_cols * referenceSet->n_cols);
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
-        metric);
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    size_t threadBaseCases = 0;
+    size_t threadScores = 0;
+
+    // Each thread traverses the tree for its own query points.  Trees that
+    // cache distances in their statistics (the cover tree) can only be
+    // traversed by one thread at a time.
+    #pragma omp parallel reduction(+:threadBaseCases, threadScores) \
+        if (!tree::TreeTraits<Tree>::FirstPointIsCentroid)
+    {
+      // Create the traverser.
+      RuleType rules(*referenceSet, querySet, range, *neighborPtr,
+          *distancePtr, metric);
+      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+
+      // Now have it traverse for each point.
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+        traverser.Traverse(i, *referenceTree);
+
+      threadBaseCases += rules.BaseCases();
+      threadScores += rules.Scores();
+    }
 
-    baseCases += rules.BaseCases();
-    scores += rules.Scores();
+    baseCases += threadBaseCases;
+    scores += threadScores;
   }
   else // Dual-tree recursion.
   {
@@ -552,33 +572,57 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
 
   // Create the helper object for the traversal.
   typedef RangeSearchRules<MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, *referenceSet, range, *neighborPtr,
-      *distancePtr, metric, true /* don't return the query in the results */);
 
   if (naive)
   {
-    // The naive brute-force solution.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      for (size_t j = 0; j < referenceSet->n_cols; ++j)
-        rules.BaseCase(i, j);
+    // The naive brute-force solution, with the query points split between
+    // threads.
+    #pragma omp parallel
+    {
+      RuleType rules(*referenceSet, *referenceSet, range, *neighborPtr,
+          *distancePtr, metric, true /* don't return the query */);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) referenceSet->n_cols; ++i)
+        for (size_t j = 0; j < referenceSet->n_cols; ++j)
+          rules.BaseCase(i, j);
+    }
 
     baseCases = (referenceSet->n_cols * referenceSet->n_cols);
     scores = 0;
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+    size_t threadBaseCases = 0;
+    size_t threadScores = 0;
 
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    // As in the bichromatic search, trees that cache distances in their
+    // statistics are traversed by one thread only.
+    #pragma omp parallel reduction(+:threadBaseCases, threadScores) \
+        if (!tree::TreeTraits<Tree>::FirstPointIsCentroid)
+    {
+      // Create the traverser.
+      RuleType rules(*referenceSet, *referenceSet, range, *neighborPtr,
+          *distancePtr, metric, true /* don't return the query */);
+      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+
+      // Now have it traverse for each point.
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) referenceSet->n_cols; ++i)
+        traverser.Traverse(i, *referenceTree);
+
+      threadBaseCases += rules.BaseCases();
+      threadScores += rules.Scores();
+    }
 
-    baseCases = rules.BaseCases();
-    scores = rules.Scores();
+    baseCases = threadBaseCases;
+    scores = threadScores;
   }
   else // Dual-tree recursion.
   {
+    RuleType rules(*referenceSet, *referenceSet, range, *neighborPtr,
+        *distancePtr, metric, true /* don't return the query in the results */);
+
     // Create the traverser.
     typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
 
@@ -687,6 +731,65 @@ void RangeSearch<MetricType, MatType, TreeType>::serialize(
   }
 }
 
+//! Write the model in the memory-mapped format.
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::SaveMapped(
+    std::ostream& stream) const
+{
+  if (naive)
+  {
+    throw std::invalid_argument("RangeSearch::SaveMapped(): cannot save a "
+        "model without a reference tree!");
+  }
+
+  // All of the integers are written as 64-bit integers, so that the format
+  // does not depend on the platform.
+  const uint64_t header[2] = { (uint64_t) singleMode,
+      oldFromNewReferences.size() };
+  const std::vector<uint64_t> mapping(oldFromNewReferences.begin(),
+      oldFromNewReferences.end());
+  data::WriteMapped(stream, header, 2);
+  data::WriteMapped(stream, mapping.data(), mapping.size());
+  referenceTree->SaveMapped(stream);
+}
+
+//! Load a model written in the memory-mapped format.
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::LoadMapped(
+    char* memory, const size_t size, size_t& offset)
+{
+  const uint64_t* header = data::ReadMapped<uint64_t>(memory, size, offset, 2);
+  const uint64_t* mapping = data::ReadMapped<uint64_t>(memory, size, offset,
+      header[1]);
+
+  // Create the tree before anything is changed, in case it fails.
+  Tree* tree = new Tree(memory, size, offset);
+
+  if (treeOwner && referenceTree)
+    delete referenceTree;
+  if (naive && referenceSet)
+    delete referenceSet;
+
+  referenceTree = tree;
+  referenceSet = &referenceTree->Dataset();
+  metric = referenceTree->Metric();
+  oldFromNewReferences.assign(mapping, mapping + header[1]);
+
+  treeOwner = true;
+  naive = false;
+  singleMode = (header[0] != 0);
+  baseCases = 0;
+  scores = 0;
+}
+
 } // namespace range
 } // namespace mlpack
 
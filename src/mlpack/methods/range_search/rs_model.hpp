@@ -19,6 +19,7 @@
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
 #include <mlpack/core/tree/octree.hpp>
+#include <mlpack/core/data/mapped_file.hpp>
 #include <boost/variant.hpp>
 
 #include "range_search.hpp"
@@ -260,6 +261,25 @@ class RSModel
                  RSType<tree::UBTree>*,
                  RSType<tree::Octree>*> rSearch;
 
+  //! If the model was loaded with LoadMapped(), the file that the reference
+  //! tree and dataset are used from.
+  std::shared_ptr<data::MappedFile> mappedFile;
+
+  //! Identifies the memory-mapped format written by SaveMapped().  All of the
+  //! integers in the format are 64-bit, so that it does not depend on the
+  //! platform.
+  static const uint64_t mappedFormatId = 0x314c444f4d53524dULL;
+
+  //! Write the given range search object in the memory-mapped format.
+  template<typename RSType>
+  static void SaveMappedSearch(const RSType* rs, std::ostream& stream);
+
+  //! Create a range search object from the memory-mapped format.
+  template<typename RSType>
+  static RSType* LoadMappedSearch(char* memory,
+                                  const size_t size,
+                                  size_t& offset);
+
  public:
   /**
    * Initialize the RSModel with the given type and whether or not a random
@@ -303,6 +323,28 @@ class RSModel
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */);
 
+  /**
+   * Save the model to the given file in a format that is memory-mapped when it
+   * is loaded with LoadMapped(), so that the reference tree and dataset do not
+   * need to be read or copied.  Only models built with kd-trees, RP trees, or
+   * max-RP trees, and not in naive mode, can be saved in this format.  A
+   * std::invalid_argument is thrown for any other model.
+   *
+   * @param filename File to save the model to.
+   */
+  void SaveMapped(const std::string& filename) const;
+
+  /**
+   * Load a model saved with SaveMapped() by memory-mapping the given file.  The
+   * reference tree and dataset are used in place, so loading is fast even for
+   * very large models, and every process that loads the same file shares one
+   * copy of it in memory.  A std::runtime_error is thrown if the file does not
+   * hold a range search model.
+   *
+   * @param filename File to load the model from.
+   */
+  void LoadMapped(const std::string& filename);
+
   //! Expose the dataset.
   const arma::mat& Dataset() const;
 
@@ -38,7 +38,8 @@ inline RSModel::RSModel(const RSModel& other) :
     leafSize(other.leafSize),
     randomBasis(other.randomBasis),
     q(other.q),
-    rSearch(other.rSearch)
+    rSearch(other.rSearch),
+    mappedFile(other.mappedFile)
 {
   // Nothing to do.
 }
@@ -49,7 +50,8 @@ inline RSModel::RSModel(RSModel&& other) :
     leafSize(other.leafSize),
     randomBasis(other.randomBasis),
     q(std::move(other.q)),
-    rSearch(std::move(other.rSearch))
+    rSearch(std::move(other.rSearch)),
+    mappedFile(std::move(other.mappedFile))
 {
   // Reset other model.
   other.treeType = TreeTypes::KD_TREE;
@@ -67,6 +69,7 @@ inline RSModel& RSModel::operator=(RSModel other)
   randomBasis = other.randomBasis;
   q = std::move(other.q);
   rSearch = std::move(other.rSearch);
+  mappedFile = std::move(other.mappedFile);
 
   return *this;
 }
@@ -93,6 +96,7 @@ inline void RSModel::BuildModel(arma::mat&& referenceSet,
 
   // Clean memory, if necessary.
   boost::apply_visitor(DeleteVisitor(), rSearch);
+  mappedFile.reset();
 
   // Do we need to modify the reference set?
   if (randomBasis)
@@ -457,12 +461,120 @@ void RSModel::serialize(Archive& ar, const uint32_t /* version */)
 
   // This should never happen, but just in case...
   if (cereal::is_loading<Archive>())
+  {
     boost::apply_visitor(DeleteVisitor(), rSearch);
+    mappedFile.reset();
+  }
 
   // We'll only need to serialize one of the model objects, based on the type.
   ar(CEREAL_VARIANT_POINTER(rSearch));
 }
 
+// Save the model in the memory-mapped format.
+inline void RSModel::SaveMapped(const std::string& filename) const
+{
+  if (treeType != KD_TREE && treeType != RP_TREE && treeType != MAX_RP_TREE)
+  {
+    throw std::invalid_argument("RSModel::SaveMapped(): only models with a "
+        "kd-tree, an RP tree, or a max-RP tree can be saved in the "
+        "memory-mapped format!");
+  }
+
+  std::ofstream ofs(filename, std::ofstream::out | std::ofstream::binary);
+  if (!ofs.is_open())
+  {
+    throw std::runtime_error("RSModel::SaveMapped(): cannot open file '" +
+        filename + "'!");
+  }
+
+  const uint64_t header[6] = { mappedFormatId, (uint64_t) treeType, leafSize,
+      (uint64_t) randomBasis, q.n_rows, q.n_cols };
+  data::WriteMapped(ofs, header, 6);
+  data::WriteMapped(ofs, q.memptr(), q.n_elem);
+
+  switch (treeType)
+  {
+    case KD_TREE:
+      SaveMappedSearch(boost::get<RSType<tree::KDTree>*>(rSearch), ofs);
+      break;
+    case RP_TREE:
+      SaveMappedSearch(boost::get<RSType<tree::RPTree>*>(rSearch), ofs);
+      break;
+    default:
+      SaveMappedSearch(boost::get<RSType<tree::MaxRPTree>*>(rSearch), ofs);
+      break;
+  }
+}
+
+// Load a model saved in the memory-mapped format.
+inline void RSModel::LoadMapped(const std::string& filename)
+{
+  std::shared_ptr<data::MappedFile> file(new data::MappedFile(filename));
+  char* memory = file->Data();
+  const size_t size = file->Size();
+  size_t offset = 0;
+
+  const uint64_t* header = data::ReadMapped<uint64_t>(memory, size, offset, 6);
+  if (header[0] != mappedFormatId)
+  {
+    throw std::runtime_error("RSModel::LoadMapped(): '" + filename + "' does "
+        "not hold a memory-mapped range search model!");
+  }
+
+  double* qMemory = data::ReadMapped<double>(memory, size, offset,
+      header[4] * header[5]);
+
+  // Load the search object before anything is changed, in case it fails.
+  decltype(rSearch) newSearch;
+  switch ((TreeTypes) header[1])
+  {
+    case KD_TREE:
+      newSearch = LoadMappedSearch<RSType<tree::KDTree>>(memory, size, offset);
+      break;
+    case RP_TREE:
+      newSearch = LoadMappedSearch<RSType<tree::RPTree>>(memory, size, offset);
+      break;
+    case MAX_RP_TREE:
+      newSearch = LoadMappedSearch<RSType<tree::MaxRPTree>>(memory, size,
+          offset);
+      break;
+    default:
+      throw std::runtime_error("RSModel::LoadMapped(): the model in '" +
+          filename + "' has an unsupported tree type!");
+  }
+
+  boost::apply_visitor(DeleteVisitor(), rSearch);
+  rSearch = newSearch;
+  mappedFile = file;
+
+  treeType = (TreeTypes) header[1];
+  leafSize = (size_t) header[2];
+  randomBasis = (header[3] != 0);
+  // The basis is small; copy it.
+  q = arma::mat(qMemory, (size_t) header[4], (size_t) header[5]);
+}
+
+// Write the given range search object in the memory-mapped format.
+template<typename RSType>
+void RSModel::SaveMappedSearch(const RSType* rs, std::ostream& stream)
+{
+  if (!rs)
+    throw std::runtime_error("no range search model initialized");
+
+  rs->SaveMapped(stream);
+}
+
+// Create a range search object from the memory-mapped format.
+template<typename RSType>
+RSType* RSModel::LoadMappedSearch(char* memory,
+                                  const size_t size,
+                                  size_t& offset)
+{
+  std::unique_ptr<RSType> rs(new RSType());
+  rs->LoadMapped(memory, size, offset);
+  return rs.release();
+}
+
 inline const arma::mat& RSModel::Dataset() const
 {
   return boost::apply_visitor(ReferenceSetVisitor(), rSearch);
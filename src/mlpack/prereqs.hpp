@@ -103,6 +103,7 @@ using enable_if_t = typename enable_if<B, T>::type;
 #include <mlpack/core/cereal/pointer_vector_variant_wrapper.hpp>
 #include <mlpack/core/cereal/pointer_vector_wrapper.hpp>
 #include <mlpack/core/cereal/pointer_wrapper.hpp>
+#include <mlpack/core/cereal/template_class_version.hpp>
 #include <mlpack/core/data/has_serialize.hpp>
 
 // If we have Boost 1.58 or older and are using C++14, the compilation is likely
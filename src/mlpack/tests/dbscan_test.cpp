@@ -306,3 +306,55 @@ TEST_CASE("RandomPointSelectionTest", "[DBSCANTest]")
   // The number of assignments returned should be the same as points.
   REQUIRE(assignments.n_elem == points.n_cols);
 }
+
+/**
+ * Check that every search mode gives the same assignments, and that the
+ * clusters are numbered in order of their first point.
+ */
+TEST_CASE("DBSCANSearchModeTest", "[DBSCANTest]")
+{
+  // Three well-separated blobs, with some noise points around them.
+  arma::mat points(2, 1500);
+  for (size_t i = 0; i < 1500; ++i)
+  {
+    const double offset = 10.0 * ((i * 7) % 3);
+    points.col(i) = arma::randn<arma::vec>(2) * 0.3 + offset;
+  }
+  points.tail_cols(50) = arma::randu<arma::mat>(2, 50) * 30.0 - 5.0;
+
+  DBSCAN<> d(0.4, 5);
+  arma::Row<size_t> assignments;
+  const size_t clusters = d.Cluster(points, assignments);
+
+  // The cluster of each new point can only be one more than the largest
+  // cluster seen so far.
+  size_t nextCluster = 0;
+  for (size_t i = 0; i < assignments.n_elem; ++i)
+  {
+    if (assignments[i] == SIZE_MAX)
+      continue;
+
+    REQUIRE(assignments[i] <= nextCluster);
+    if (assignments[i] == nextCluster)
+      ++nextCluster;
+  }
+  REQUIRE(nextCluster == clusters);
+
+  DBSCAN<> pointwise(0.4, 5, false);
+  DBSCAN<> singleTree(0.4, 5, true, RangeSearch<>(false, true));
+  DBSCAN<> naive(0.4, 5, true, RangeSearch<>(true));
+  DBSCAN<> pointwiseNaive(0.4, 5, false, RangeSearch<>(true));
+  DBSCAN<RangeSearch<>, RandomPointSelection> random(0.4, 5);
+
+  arma::Row<size_t> otherAssignments;
+  REQUIRE(pointwise.Cluster(points, otherAssignments) == clusters);
+  CheckMatrices(assignments, otherAssignments);
+  REQUIRE(singleTree.Cluster(points, otherAssignments) == clusters);
+  CheckMatrices(assignments, otherAssignments);
+  REQUIRE(naive.Cluster(points, otherAssignments) == clusters);
+  CheckMatrices(assignments, otherAssignments);
+  REQUIRE(pointwiseNaive.Cluster(points, otherAssignments) == clusters);
+  CheckMatrices(assignments, otherAssignments);
+  REQUIRE(random.Cluster(points, otherAssignments) == clusters);
+  CheckMatrices(assignments, otherAssignments);
+}
@@ -376,6 +376,382 @@ TEST_CASE("BestBinaryNumericSplitNoGainTest", "[DecisionTreeTest]")
   REQUIRE(classProbabilities.n_elem == 0);
 }
 
+/**
+ * Check that the HistogramNumericSplit will split on an obviously splittable
+ * dimension.
+ */
+TEST_CASE("HistogramNumericSplitSimpleSplitTest", "[DecisionTreeTest]")
+{
+  arma::vec values("0.0 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 0.9 1.0");
+  arma::Row<size_t> labels("0 0 0 0 0 1 1 1 1 1 1");
+  arma::rowvec weights(labels.n_elem);
+  weights.ones();
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  // Call the method to do the splitting.
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 3, 1e-7, classProbabilities,
+      aux);
+  const double weightedGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<true>(bestGain, values,
+      labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+
+  // Make sure that a split was made.
+  REQUIRE(gain > bestGain);
+
+  // Make sure weight works and is not different than the unweighted one.
+  REQUIRE(gain == weightedGain);
+
+  // The split is perfect, so we should be able to accomplish a gain of 0.
+  REQUIRE(gain == Approx(0.0).margin(1e-7));
+
+  // The class probabilities, for this split, hold the splitting point, which
+  // should be between 4 and 5.
+  REQUIRE(classProbabilities.n_elem == 1);
+  REQUIRE(classProbabilities[0] > 0.4);
+  REQUIRE(classProbabilities[0] < 0.5);
+}
+
+/**
+ * Check that the HistogramNumericSplit won't split if not enough points are
+ * given.
+ */
+TEST_CASE("HistogramNumericSplitMinSamplesTest", "[DecisionTreeTest]")
+{
+  arma::vec values("0.0 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 0.9 1.0");
+  arma::Row<size_t> labels("0 0 0 0 0 1 1 1 1 1 1");
+  arma::rowvec weights(labels.n_elem);
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  // Call the method to do the splitting.
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 8, 1e-7, classProbabilities,
+      aux);
+  // This should make no difference because it won't split at all.
+  const double weightedGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<true>(bestGain, values,
+      labels, 2, weights, 8, 1e-7, classProbabilities, aux);
+
+  // Make sure that no split was made.
+  REQUIRE(gain == DBL_MAX);
+  REQUIRE(gain == weightedGain);
+  REQUIRE(classProbabilities.n_elem == 0);
+}
+
+/**
+ * Check that the HistogramNumericSplit doesn't split a dimension that gives no
+ * gain.
+ */
+TEST_CASE("HistogramNumericSplitNoGainTest", "[DecisionTreeTest]")
+{
+  arma::vec values(100);
+  arma::Row<size_t> labels(100);
+  arma::rowvec weights;
+  for (size_t i = 0; i < 100; i += 2)
+  {
+    values[i] = i;
+    labels[i] = 0;
+    values[i + 1] = i;
+    labels[i + 1] = 1;
+  }
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  // Call the method to do the splitting.
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 10, 1e-7, classProbabilities,
+      aux);
+
+  // Make sure there was no split.
+  REQUIRE(gain == DBL_MAX);
+  REQUIRE(classProbabilities.n_elem == 0);
+}
+
+/**
+ * Check that the HistogramNumericSplit finds the same split as the
+ * BestBinaryNumericSplit when each distinct value has its own bin.
+ */
+TEST_CASE("HistogramNumericSplitBestBinaryTest", "[DecisionTreeTest]")
+{
+  // 50 distinct values, so each gets its own bin.
+  arma::vec values(1000);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < values.n_elem; ++i)
+  {
+    values[i] = math::RandInt(0, 50);
+    labels[i] = (values[i] + math::RandInt(0, 20) > 30) ? 1 : 0;
+  }
+  arma::rowvec weights = arma::randu<arma::rowvec>(1000);
+
+  arma::vec bestClassProbabilities, histogramClassProbabilities;
+  BestBinaryNumericSplit<GiniGain>::template AuxiliarySplitInfo<double>
+      bestAux;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double>
+      histogramAux;
+
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = BestBinaryNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 5, 1e-7, bestClassProbabilities,
+      bestAux);
+  const double histogramGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain, values,
+      labels, 2, weights, 5, 1e-7, histogramClassProbabilities, histogramAux);
+
+  REQUIRE(gain != DBL_MAX);
+  REQUIRE(histogramGain == Approx(gain).epsilon(1e-7));
+  REQUIRE(histogramClassProbabilities.n_elem == 1);
+  REQUIRE(histogramClassProbabilities[0] == bestClassProbabilities[0]);
+
+  // The same holds with weights.
+  const double weightedBestGain = GiniGain::Evaluate<true>(labels, 2, weights);
+  const double weightedGain =
+      BestBinaryNumericSplit<GiniGain>::SplitIfBetter<true>(weightedBestGain,
+      values, labels, 2, weights, 5, 1e-7, bestClassProbabilities, bestAux);
+  const double weightedHistogramGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<true>(weightedBestGain,
+      values, labels, 2, weights, 5, 1e-7, histogramClassProbabilities,
+      histogramAux);
+
+  REQUIRE(weightedGain != DBL_MAX);
+  REQUIRE(weightedHistogramGain == Approx(weightedGain).epsilon(1e-7));
+  REQUIRE(histogramClassProbabilities[0] == bestClassProbabilities[0]);
+}
+
+/**
+ * Check that the HistogramNumericSplit finds the same split as the
+ * BestBinaryNumericSplit on a heavy-tailed dimension with an outlier, which
+ * would put almost all the points into one bin of equal width.
+ */
+TEST_CASE("HistogramNumericSplitSkewedTest", "[DecisionTreeTest]")
+{
+  arma::vec values = arma::exp(3.0 * arma::randn<arma::vec>(200));
+  values[0] = 1e9;
+  arma::Row<size_t> labels(200);
+  for (size_t i = 0; i < values.n_elem; ++i)
+    labels[i] = (std::log(values[i]) + 2.0 * math::RandNormal() > 1.0) ? 1 : 0;
+  arma::rowvec weights = arma::randu<arma::rowvec>(200);
+
+  arma::vec bestClassProbabilities, histogramClassProbabilities;
+  BestBinaryNumericSplit<GiniGain>::template AuxiliarySplitInfo<double>
+      bestAux;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double>
+      histogramAux;
+
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = BestBinaryNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 5, 1e-7, bestClassProbabilities,
+      bestAux);
+  const double histogramGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain, values,
+      labels, 2, weights, 5, 1e-7, histogramClassProbabilities, histogramAux);
+
+  REQUIRE(gain != DBL_MAX);
+  REQUIRE(histogramGain == Approx(gain).epsilon(1e-7));
+  REQUIRE(histogramClassProbabilities.n_elem == 1);
+  REQUIRE(histogramClassProbabilities[0] == bestClassProbabilities[0]);
+
+  // The same holds with weights.
+  const double weightedBestGain = GiniGain::Evaluate<true>(labels, 2, weights);
+  const double weightedGain =
+      BestBinaryNumericSplit<GiniGain>::SplitIfBetter<true>(weightedBestGain,
+      values, labels, 2, weights, 5, 1e-7, bestClassProbabilities, bestAux);
+  const double weightedHistogramGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<true>(weightedBestGain,
+      values, labels, 2, weights, 5, 1e-7, histogramClassProbabilities,
+      histogramAux);
+
+  REQUIRE(weightedGain != DBL_MAX);
+  REQUIRE(weightedHistogramGain == Approx(weightedGain).epsilon(1e-7));
+  REQUIRE(histogramClassProbabilities[0] == bestClassProbabilities[0]);
+}
+
+/**
+ * Check that the HistogramNumericSplit finds the exact split on a skewed
+ * dimension with more distinct values than bins, when the split falls on a
+ * quantile.
+ */
+TEST_CASE("HistogramNumericSplitSkewedQuantileTest", "[DecisionTreeTest]")
+{
+  // With 2560 points, the bins hold 10 points each.  The classes are split
+  // after the 1001st smallest value.
+  arma::vec values = arma::exp(3.0 * arma::randn<arma::vec>(2560));
+  values[0] = 1e9;
+  const arma::uvec order = arma::sort_index(values);
+  arma::Row<size_t> labels(2560, arma::fill::zeros);
+  labels.elem(order.tail(1559)).ones();
+  arma::rowvec weights(2560, arma::fill::ones);
+
+  arma::vec bestClassProbabilities, histogramClassProbabilities;
+  BestBinaryNumericSplit<GiniGain>::template AuxiliarySplitInfo<double>
+      bestAux;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double>
+      histogramAux;
+
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = BestBinaryNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 5, 1e-7, bestClassProbabilities,
+      bestAux);
+  const double histogramGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain, values,
+      labels, 2, weights, 5, 1e-7, histogramClassProbabilities, histogramAux);
+
+  REQUIRE(gain == Approx(0.0).margin(1e-7));
+  REQUIRE(histogramGain == Approx(gain).margin(1e-7));
+  REQUIRE(histogramClassProbabilities.n_elem == 1);
+  REQUIRE(histogramClassProbabilities[0] == bestClassProbabilities[0]);
+}
+
+/**
+ * Check that QuantileBinThresholds() gives bins with about the same number of
+ * points on a skewed dimension.
+ */
+TEST_CASE("QuantileBinThresholdsSkewedTest", "[DecisionTreeTest]")
+{
+  arma::vec values = arma::exp(3.0 * arma::randn<arma::vec>(10000));
+  values[0] = 1e9;
+
+  arma::vec thresholds;
+  QuantileBinThresholds(values, 256, thresholds);
+
+  REQUIRE(thresholds.n_elem == 255);
+  REQUIRE(thresholds.is_sorted("strictascend"));
+
+  arma::Col<size_t> binCounts(256, arma::fill::zeros);
+  for (size_t i = 0; i < values.n_elem; ++i)
+  {
+    ++binCounts[std::lower_bound(thresholds.begin(), thresholds.end(),
+        values[i]) - thresholds.begin()];
+  }
+
+  // Each bin holds 39 or 40 points.
+  REQUIRE(binCounts.min() >= 39);
+  REQUIRE(binCounts.max() <= 40);
+
+  // With few distinct values, each gets its own bin.
+  arma::vec fewValues("5 1 1 3 100 3 1");
+  QuantileBinThresholds(fewValues, 256, thresholds);
+  REQUIRE(thresholds.n_elem == 3);
+  REQUIRE(thresholds[0] == 2.0);
+  REQUIRE(thresholds[1] == 4.0);
+  REQUIRE(thresholds[2] == 52.5);
+
+  arma::vec sameValues(10);
+  sameValues.fill(2.0);
+  QuantileBinThresholds(sameValues, 256, thresholds);
+  REQUIRE(thresholds.n_elem == 0);
+}
+
+/**
+ * Check that the histogram of a subset of the points, subtracted from the
+ * histogram of all of them, is the histogram of the other points, and that it
+ * gives the same split.
+ */
+TEST_CASE("HistogramNumericSplitSubtractionTest", "[DecisionTreeTest]")
+{
+  typedef HistogramNumericSplit<GiniGain> SplitType;
+
+  arma::rowvec values(1000, arma::fill::randn);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = (values[i] > 0.5) ? 2 : math::RandInt(2);
+  arma::rowvec weights(1000, arma::fill::randu);
+
+  arma::Row<unsigned char> bins;
+  arma::vec binMin, binMax;
+  SplitType::BinValues(values, bins, binMin, binMax);
+  REQUIRE(binMin.n_elem == 256);
+
+  // The first 300 points are the smaller child, and the others are the larger
+  // child.
+  SplitType::Histogram histogram, smallerHistogram, largerHistogram;
+  SplitType::BuildHistogram<false>(bins, binMin.n_elem, labels, 3, weights,
+      histogram);
+  SplitType::BuildHistogram<false>(bins.subvec(0, 299), binMin.n_elem,
+      labels.subvec(0, 299), 3, weights, smallerHistogram);
+  SplitType::BuildHistogram<false>(bins.subvec(300, 999), binMin.n_elem,
+      labels.subvec(300, 999), 3, weights, largerHistogram);
+  histogram -= smallerHistogram;
+
+  REQUIRE(arma::all(arma::vectorise(histogram.classCounts ==
+      largerHistogram.classCounts)));
+  REQUIRE(arma::all(histogram.counts == largerHistogram.counts));
+
+  // The subtracted histogram gives the same split as the values of the larger
+  // child.
+  const double bestGain = GiniGain::Evaluate<false>(labels.subvec(300, 999), 3,
+      weights);
+  arma::vec classProbabilities, largerClassProbabilities;
+  SplitType::AuxiliarySplitInfo<double> aux;
+  const double gain = SplitType::SplitIfBetter<false>(bestGain, histogram,
+      binMin, binMax, 3, 1, 1e-7, classProbabilities, aux);
+  const double largerGain = SplitType::SplitIfBetter<false>(bestGain,
+      largerHistogram, binMin, binMax, 3, 1, 1e-7, largerClassProbabilities,
+      aux);
+  REQUIRE(gain == largerGain);
+  REQUIRE(gain > bestGain);
+  REQUIRE(classProbabilities[0] == largerClassProbabilities[0]);
+
+  // The same holds for the class weight sums, up to rounding.
+  SplitType::BuildHistogram<true>(bins, binMin.n_elem, labels, 3, weights,
+      histogram);
+  SplitType::BuildHistogram<true>(bins.subvec(0, 299), binMin.n_elem,
+      labels.subvec(0, 299), 3, weights.subvec(0, 299), smallerHistogram);
+  SplitType::BuildHistogram<true>(bins.subvec(300, 999), binMin.n_elem,
+      labels.subvec(300, 999), 3, weights.subvec(300, 999), largerHistogram);
+  histogram -= smallerHistogram;
+
+  REQUIRE(arma::approx_equal(histogram.classWeightSums,
+      largerHistogram.classWeightSums, "absdiff", 1e-10));
+  REQUIRE(arma::all(histogram.counts == largerHistogram.counts));
+}
+
+/**
+ * Make sure that a tree with histogram splits, whose nodes find the histograms
+ * of their largest child by subtraction, finds the splits of a simple rule on
+ * a grid with few distinct values.
+ */
+TEST_CASE("HistogramSplitSubtractionTreeTest", "[DecisionTreeTest]")
+{
+  // Points on a 20x20x20 grid; the third dimension is noise.
+  arma::mat dataset(3, 5000);
+  arma::Row<size_t> labels(5000);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    for (size_t d = 0; d < 3; ++d)
+      dataset(d, i) = math::RandInt(20);
+    labels[i] = (dataset(0, i) >= 10 ? 1 : 0) + (dataset(1, i) >= 5 ? 1 : 0);
+  }
+  arma::rowvec weights(5000, arma::fill::ones);
+
+  DecisionTree<GiniGain, HistogramNumericSplit> d(dataset, labels, 3, 1);
+  DecisionTree<GiniGain, HistogramNumericSplit> wd(dataset, labels, 3,
+      weights, 1);
+
+  // Each distinct value has its own bin, so the splits are halfway between two
+  // integers, and every point of the grid is classified by the rule.
+  arma::vec point(3);
+  for (size_t x = 0; x < 20; ++x)
+  {
+    for (size_t y = 0; y < 20; ++y)
+    {
+      point[0] = x;
+      point[1] = y;
+      point[2] = math::RandInt(20);
+      const size_t label = (x >= 10 ? 1 : 0) + (y >= 5 ? 1 : 0);
+      REQUIRE(d.Classify(point) == label);
+      REQUIRE(wd.Classify(point) == label);
+    }
+  }
+}
+
 /**
  * Check that the AllCategoricalSplit will split when the split is obviously
  * better.
@@ -701,6 +1077,47 @@ TEST_CASE("SimpleGeneralizationTest", "[DecisionTreeTest]")
   REQUIRE(wdcorrect > 0.75);
 }
 
+/**
+ * Test that the decision tree generalizes reasonably with histogram splits.
+ */
+TEST_CASE("HistogramSplitGeneralizationTest", "[DecisionTreeTest]")
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load labels for vc2_labels.txt");
+
+  // Build decision tree.
+  DecisionTree<GiniGain, HistogramNumericSplit> d(inputData, labels, 3, 10);
+
+  // Load testing data.
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData))
+    FAIL("Cannot load test dataset vc2_test.csv!");
+
+  arma::Mat<size_t> trueTestLabels;
+  if (!data::Load("vc2_test_labels.txt", trueTestLabels))
+    FAIL("Cannot load labels for vc2_test_labels.txt");
+
+  // Get the predicted test labels.
+  arma::Row<size_t> predictions;
+  d.Classify(testData, predictions);
+
+  REQUIRE(predictions.n_elem == testData.n_cols);
+
+  // Figure out the accuracy.
+  double correct = 0.0;
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    if (predictions[i] == trueTestLabels[i])
+      ++correct;
+  correct /= predictions.n_elem;
+
+  REQUIRE(correct > 0.75);
+}
+
 /**
  * Test that we can build a decision tree on a simple categorical dataset.
  */
@@ -1241,3 +1658,52 @@ TEST_CASE("DifferentMaximumDepthTest", "[DecisionTreeTest]")
   REQUIRE(d2.Child(0).NumChildren() == 2);
   REQUIRE(d2.Child(1).NumChildren() == 2);
 }
+
+/**
+ * Make sure that a tree trained in parallel is the same as one trained on one
+ * thread, for both the categorical and the numeric-only training paths.
+ */
+TEST_CASE("ParallelTrainingTest", "[DecisionTreeTest]")
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  #ifdef HAS_OPENMP
+  const int numThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  #endif
+
+  DecisionTree<> serialTree(d, di, l, 5, 10);
+  DecisionTree<> serialNumericTree(d, l, 5, 10);
+
+  #ifdef HAS_OPENMP
+  omp_set_num_threads(numThreads);
+  #endif
+
+  DecisionTree<> tree(d, di, l, 5, 10);
+  DecisionTree<> numericTree(d, l, 5, 10);
+
+  arma::Row<size_t> serialPredictions, predictions;
+  arma::mat serialProbabilities, probabilities;
+  serialTree.Classify(d, serialPredictions, serialProbabilities);
+  tree.Classify(d, predictions, probabilities);
+
+  REQUIRE(tree.NumChildren() == serialTree.NumChildren());
+  REQUIRE(arma::all(predictions == serialPredictions));
+  REQUIRE(arma::approx_equal(probabilities, serialProbabilities, "absdiff",
+      0.0));
+
+  serialNumericTree.Classify(d, serialPredictions, serialProbabilities);
+  numericTree.Classify(d, predictions, probabilities);
+
+  REQUIRE(numericTree.NumChildren() == serialNumericTree.NumChildren());
+  REQUIRE(arma::all(predictions == serialPredictions));
+  REQUIRE(arma::approx_equal(probabilities, serialProbabilities, "absdiff",
+      0.0));
+
+  // The tree should still fit the training data well.
+  const double correct = arma::accu(predictions == l) / (double) l.n_elem;
+  REQUIRE(correct > 0.7);
+}
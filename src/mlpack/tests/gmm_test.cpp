@@ -838,6 +838,47 @@ TEST_CASE("UseExistingModelTest", "[GMMTest]")
   }
 }
 
+/**
+ * Train with several trials (which run in parallel) on a dataset larger than
+ * one block of the E-step, and make sure that the kept model is the one whose
+ * log-likelihood is returned.
+ */
+TEST_CASE("GMMTrainTrialsTest", "[GMMTest]")
+{
+  // Two well-separated Gaussians.
+  arma::mat data(3, 2500, arma::fill::randn);
+  data.cols(0, 999) += 20.0;
+
+  GMM gmm(2, 3);
+  const double logLikelihood = gmm.Train(data, 4);
+
+  double expectedLogLikelihood = 0.0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+    expectedLogLikelihood += gmm.LogProbability(data.col(i));
+
+  REQUIRE(logLikelihood == Approx(expectedLogLikelihood).epsilon(1e-7));
+
+  // Each component should have found one of the Gaussians.
+  const arma::uvec order = arma::sort_index(gmm.Weights());
+  REQUIRE(gmm.Weights()[order[0]] == Approx(0.4).epsilon(1e-5));
+  REQUIRE(gmm.Weights()[order[1]] == Approx(0.6).epsilon(1e-5));
+  REQUIRE(arma::mean(gmm.Component(order[0]).Mean()) ==
+      Approx(20.0).epsilon(0.02));
+
+  // Training from the same existing model in every trial should give the same
+  // result as training once.
+  GMM once(gmm);
+  const double onceLogLikelihood = once.Train(data, 1, true);
+  const double trialsLogLikelihood = gmm.Train(data, 3, true);
+  REQUIRE(trialsLogLikelihood == Approx(onceLogLikelihood).epsilon(1e-10));
+  for (size_t i = 0; i < 2; ++i)
+  {
+    CheckMatrices(gmm.Component(i).Mean(), once.Component(i).Mean());
+    CheckMatrices(gmm.Component(i).Covariance(),
+        once.Component(i).Covariance());
+  }
+}
+
 /********************************************************/
 /** Diagonal Gaussian Mixture Model(DiagonalGMM) Tests **/
 /********************************************************/
@@ -1239,3 +1280,98 @@ TEST_CASE("DiagonalGMMLoadSaveTest", "[GMMTest]")
     }
   }
 }
+
+/**
+ * Generate points from two Gaussians: 40% of the points have mean 10 and
+ * variances (1, 4, 0.25), and the rest have mean 0 and unit variances.
+ */
+arma::mat StepwiseEMData(const size_t points)
+{
+  arma::mat data(3, points, arma::fill::randn);
+  const size_t first = (size_t) (0.4 * points);
+  data.submat(0, 0, 2, first - 1).each_col() %= arma::vec("1.0 2.0 0.5");
+  data.cols(0, first - 1) += 10.0;
+
+  return arma::shuffle(data, 1);
+}
+
+/**
+ * Make sure that a GMM refreshed with a stream of batches through
+ * StepwiseEMFit finds the Gaussians the data comes from.
+ */
+TEST_CASE("GMMStepwiseEMUpdateTest", "[GMMTest]")
+{
+  // Get a rough initial model from a small sample.
+  GMM gmm(2, 3);
+  gmm.Train(StepwiseEMData(200));
+
+  StepwiseEMFit<> fitter;
+  for (size_t i = 0; i < 50; ++i)
+    gmm.Update(StepwiseEMData(1000), fitter);
+
+  REQUIRE(fitter.Steps() == 50);
+
+  const arma::uvec order = arma::sort_index(gmm.Weights());
+  REQUIRE(gmm.Weights()[order[0]] == Approx(0.4).epsilon(0.05));
+  REQUIRE(gmm.Weights()[order[1]] == Approx(0.6).epsilon(0.05));
+
+  const distribution::GaussianDistribution& shifted =
+      gmm.Component(order[0]);
+  const arma::vec variances("1.0 4.0 0.25");
+  for (size_t i = 0; i < 3; ++i)
+  {
+    REQUIRE(shifted.Mean()[i] == Approx(10.0).epsilon(0.02));
+    REQUIRE(shifted.Covariance()(i, i) == Approx(variances[i]).epsilon(0.1));
+    REQUIRE(gmm.Component(order[1]).Mean()[i] == Approx(0.0).margin(0.1));
+  }
+
+  // A batch with the wrong dimensionality should be rejected.
+  REQUIRE_THROWS_AS(gmm.Update(arma::mat(4, 10, arma::fill::randn), fitter),
+      std::invalid_argument);
+}
+
+/**
+ * Training with StepwiseEMFit as the fitter of GMM::Train() should give nearly
+ * the same log-likelihood as EMFit.
+ */
+TEST_CASE("GMMStepwiseEMTrainTest", "[GMMTest]")
+{
+  const arma::mat data = StepwiseEMData(5000);
+
+  GMM em(2, 3);
+  const double emLogLikelihood = em.Train(data);
+
+  GMM stepwise(2, 3);
+  const double stepwiseLogLikelihood = stepwise.Train(data, 1, false,
+      StepwiseEMFit<>(500));
+
+  REQUIRE(stepwiseLogLikelihood == Approx(emLogLikelihood).epsilon(0.01));
+}
+
+/**
+ * Make sure that a DiagonalGMM can be refreshed with a stream of batches
+ * through StepwiseEMFit.
+ */
+TEST_CASE("DiagonalGMMStepwiseEMUpdateTest", "[GMMTest]")
+{
+  DiagonalGMM gmm(2, 3);
+  gmm.Train(StepwiseEMData(200));
+
+  StepwiseEMFit<kmeans::KMeans<>, DiagonalConstraint,
+      distribution::DiagonalGaussianDistribution> fitter;
+  for (size_t i = 0; i < 50; ++i)
+    gmm.Update(StepwiseEMData(1000), fitter);
+
+  const arma::uvec order = arma::sort_index(gmm.Weights());
+  REQUIRE(gmm.Weights()[order[0]] == Approx(0.4).epsilon(0.05));
+
+  const arma::vec variances("1.0 4.0 0.25");
+  for (size_t i = 0; i < 3; ++i)
+  {
+    REQUIRE(gmm.Component(order[0]).Mean()[i] == Approx(10.0).epsilon(0.02));
+    REQUIRE(gmm.Component(order[0]).Covariance()(i) ==
+        Approx(variances[i]).epsilon(0.1));
+    REQUIRE(gmm.Component(order[1]).Covariance()(i) ==
+        Approx(1.0).epsilon(0.1));
+  }
+}
@@ -0,0 +1,364 @@
+/**
+ * @file tests/gradient_boosting_test.cpp
+ *
+ * Tests for the GradientBoosting and GradientBoostingTree classes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/gradient_boosting/gradient_boosting.hpp>
+
+#include "serialization.hpp"
+#include "test_catch_tools.hpp"
+#include "catch.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+/**
+ * Create a regression dataset, y = sin(4 x_0) + x_1^2, with an irrelevant third
+ * dimension.
+ */
+void CreateRegressionData(const size_t n,
+                          arma::mat& data,
+                          arma::rowvec& responses)
+{
+  data.randu(3, n);
+  responses = arma::sin(4.0 * data.row(0)) + arma::square(data.row(1));
+}
+
+/**
+ * Make sure that a tree splits one dimension with two groups of gradients at
+ * the right place, and gives each leaf the right value.
+ */
+TEST_CASE("GradientBoostingTreeSimpleSplitTest", "[GradientBoostingTest]")
+{
+  // The points of the first half have gradient -1 and the others gradient 1.
+  arma::Mat<unsigned char> bins(100, 1);
+  std::vector<arma::vec> binThresholds(1, arma::vec(99));
+  arma::rowvec gradients(100), hessians(100, arma::fill::ones);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    bins(i, 0) = i;
+    gradients[i] = (i < 50) ? -1.0 : 1.0;
+    if (i < 99)
+      binThresholds[0][i] = i + 0.5;
+  }
+
+  GradientBoostingTree<> tree;
+  AllDimensionSelect selector;
+  selector.Dimensions() = 1;
+  arma::rowvec predictions;
+  tree.Train(bins, binThresholds, gradients, hessians, 0.5, 2, 1, 0.0, 0.0,
+      selector, predictions);
+
+  REQUIRE(tree.NumNodes() == 3);
+  REQUIRE(tree.Predict(arma::vec("49.0")) == Approx(0.5).epsilon(1e-7));
+  REQUIRE(tree.Predict(arma::vec("49.5")) == Approx(0.5).epsilon(1e-7));
+  REQUIRE(tree.Predict(arma::vec("49.6")) == Approx(-0.5).epsilon(1e-7));
+  for (size_t i = 0; i < 100; ++i)
+    REQUIRE(predictions[i] == tree.Predict(arma::vec(1).fill(i)));
+}
+
+/**
+ * Make sure that the maximum depth and minimum leaf size are respected.
+ */
+TEST_CASE("GradientBoostingTreeLimitsTest", "[GradientBoostingTest]")
+{
+  arma::Mat<unsigned char> bins(100, 1);
+  std::vector<arma::vec> binThresholds(1, arma::vec(99));
+  arma::rowvec gradients(100), hessians(100, arma::fill::ones);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    bins(i, 0) = i;
+    gradients[i] = (i < 50) ? -1.0 : 1.0;
+    if (i < 99)
+      binThresholds[0][i] = i + 0.5;
+  }
+
+  AllDimensionSelect selector;
+  selector.Dimensions() = 1;
+  arma::rowvec predictions;
+
+  // A maximum depth of 1 allows only a leaf.
+  GradientBoostingTree<> tree;
+  tree.Train(bins, binThresholds, gradients, hessians, 1.0, 1, 1, 1.0, 0.0,
+      selector, predictions);
+  REQUIRE(tree.NumNodes() == 1);
+
+  // Children must have at least 51 points here, which is impossible.
+  tree.Train(bins, binThresholds, gradients, hessians, 1.0, 0, 51, 1.0, 0.0,
+      selector, predictions);
+  REQUIRE(tree.NumNodes() == 1);
+
+  // The split must be better than the minimum gain.
+  tree.Train(bins, binThresholds, gradients, hessians, 1.0, 0, 1, 1.0, 1000.0,
+      selector, predictions);
+  REQUIRE(tree.NumNodes() == 1);
+}
+
+/**
+ * With lambda = 0, nodes and children whose hessians sum to 0 have no Newton
+ * step; the tree should skip those splits and never divide by 0.
+ */
+TEST_CASE("GradientBoostingTreeZeroHessianTest", "[GradientBoostingTest]")
+{
+  // The points of the first half have no hessian.
+  arma::Mat<unsigned char> bins(100, 1);
+  std::vector<arma::vec> binThresholds(1, arma::vec(99));
+  arma::rowvec gradients(100), hessians(100);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    bins(i, 0) = i;
+    gradients[i] = (i < 75) ? -1.0 : 1.0;
+    hessians[i] = (i < 50) ? 0.0 : 1.0;
+    if (i < 99)
+      binThresholds[0][i] = i + 0.5;
+  }
+
+  GradientBoostingTree<> tree;
+  AllDimensionSelect selector;
+  selector.Dimensions() = 1;
+  arma::rowvec predictions;
+  tree.Train(bins, binThresholds, gradients, hessians, 1.0, 0, 1, 0.0, 0.0,
+      selector, predictions);
+
+  REQUIRE(tree.NumNodes() > 1);
+  REQUIRE(predictions.is_finite());
+  for (size_t i = 0; i < 50; ++i)
+    REQUIRE(std::isfinite(tree.Predict(arma::vec(1).fill(i))));
+
+  // Without any hessian, the root can't be split and predicts 0.
+  hessians.zeros();
+  tree.Train(bins, binThresholds, gradients, hessians, 1.0, 0, 1, 0.0, 0.0,
+      selector, predictions);
+  REQUIRE(tree.NumNodes() == 1);
+  REQUIRE(arma::all(predictions == 0.0));
+}
+
+/**
+ * Make sure that regression models fit a smooth function.
+ */
+TEST_CASE("GradientBoostingRegressionTest", "[GradientBoostingTest]")
+{
+  arma::mat data, testData;
+  arma::rowvec responses, testResponses;
+  CreateRegressionData(2000, data, responses);
+  CreateRegressionData(1000, testData, testResponses);
+
+  GradientBoosting<> shortModel(data, responses, 10);
+  GradientBoosting<> model(data, responses, 200);
+  REQUIRE(model.NumTrees() == 200);
+  REQUIRE(model.NumClasses() == 0);
+
+  arma::rowvec shortPredictions, predictions;
+  shortModel.Predict(testData, shortPredictions);
+  model.Predict(testData, predictions);
+
+  const double shortError = arma::mean(arma::square(shortPredictions -
+      testResponses));
+  const double error = arma::mean(arma::square(predictions - testResponses));
+  REQUIRE(error < shortError);
+  REQUIRE(error < 0.02);
+}
+
+/**
+ * Make sure that the bins of a heavy-tailed dimension with an outlier, and of
+ * a dimension with a rare value, still let the trees fit a step function.
+ */
+TEST_CASE("GradientBoostingSkewedBinsTest", "[GradientBoostingTest]")
+{
+  arma::mat data(2, 2000);
+  data.row(0) = arma::exp(3.0 * arma::randn<arma::rowvec>(2000));
+  data(0, 0) = 1e9;
+  data.row(1).zeros();
+  data.row(1).head(20).ones();
+
+  arma::rowvec responses = arma::conv_to<arma::rowvec>::from(
+      data.row(0) > 1.0) + 5.0 * data.row(1);
+
+  GradientBoosting<> model;
+  const double loss = model.Train(data, responses, 50, 0.5, 3);
+  REQUIRE(loss < 0.01);
+}
+
+/**
+ * Make sure that the loss returned by Train() is the loss of the predictions
+ * of the model on the training set; that is, the trees predict the training
+ * points from their values as they did from their bins.
+ */
+TEST_CASE("GradientBoostingTrainingLossTest", "[GradientBoostingTest]")
+{
+  arma::mat data;
+  arma::rowvec responses;
+  CreateRegressionData(1000, data, responses);
+
+  GradientBoosting<> model;
+  const double loss = model.Train(data, responses, 50, 0.1, 4);
+
+  arma::rowvec predictions;
+  model.Predict(data, predictions);
+  REQUIRE(SquaredErrorLoss::Evaluate(responses, predictions) ==
+      Approx(loss).epsilon(1e-10));
+
+  for (size_t i = 0; i < 10; ++i)
+  {
+    REQUIRE(model.Predict(data.col(i)) ==
+        Approx(predictions[i]).epsilon(1e-10));
+  }
+}
+
+/**
+ * Make sure that classification models are accurate on the vc2 dataset.
+ */
+TEST_CASE("GradientBoostingClassificationTest", "[GradientBoostingTest]")
+{
+  arma::mat data, testData;
+  arma::Row<size_t> labels, testLabels;
+  if (!data::Load("vc2.csv", data))
+    FAIL("Cannot load test dataset vc2.csv!");
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load labels for vc2_labels.txt");
+  if (!data::Load("vc2_test.csv", testData))
+    FAIL("Cannot load test dataset vc2_test.csv!");
+  if (!data::Load("vc2_test_labels.txt", testLabels))
+    FAIL("Cannot load labels for vc2_test_labels.txt");
+
+  GradientBoosting<CrossEntropyLoss> model(data, labels, 3, 50, 0.1, 4);
+  REQUIRE(model.NumTrees() == 150);
+  REQUIRE(model.NumClasses() == 3);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  model.Classify(testData, predictions, probabilities);
+
+  REQUIRE(predictions.n_elem == testData.n_cols);
+  REQUIRE(probabilities.n_rows == 3);
+  REQUIRE(probabilities.n_cols == testData.n_cols);
+
+  for (size_t i = 0; i < testData.n_cols; ++i)
+  {
+    REQUIRE(arma::accu(probabilities.col(i)) == Approx(1.0).epsilon(1e-7));
+
+    size_t prediction;
+    arma::vec pointProbabilities;
+    model.Classify(testData.col(i), prediction, pointProbabilities);
+    REQUIRE(prediction == predictions[i]);
+    REQUIRE(model.Classify(testData.col(i)) == predictions[i]);
+  }
+
+  const double accuracy = arma::accu(predictions == testLabels) /
+      (double) testLabels.n_elem;
+  REQUIRE(accuracy > 0.7);
+}
+
+/**
+ * Make sure that the model does not depend on the number of threads.
+ */
+TEST_CASE("GradientBoostingParallelTest", "[GradientBoostingTest]")
+{
+  arma::mat data;
+  arma::rowvec responses;
+  CreateRegressionData(5000, data, responses);
+
+  #ifdef HAS_OPENMP
+  const int numThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  #endif
+
+  GradientBoosting<> serialModel(data, responses, 20);
+  arma::rowvec serialPredictions;
+  serialModel.Predict(data, serialPredictions);
+
+  #ifdef HAS_OPENMP
+  omp_set_num_threads(numThreads);
+  #endif
+
+  GradientBoosting<> model(data, responses, 20);
+  arma::rowvec predictions;
+  model.Predict(data, predictions);
+
+  REQUIRE(arma::approx_equal(predictions, serialPredictions, "absdiff", 0.0));
+}
+
+/**
+ * Make sure that untrained models and invalid training sets throw.
+ */
+TEST_CASE("GradientBoostingInvalidTest", "[GradientBoostingTest]")
+{
+  arma::mat data(3, 10, arma::fill::randu);
+  arma::rowvec predictions;
+  arma::Row<size_t> labelPredictions;
+
+  GradientBoosting<> model;
+  REQUIRE_THROWS_AS(model.Predict(data, predictions), std::invalid_argument);
+
+  GradientBoosting<CrossEntropyLoss> classifier;
+  REQUIRE_THROWS_AS(classifier.Classify(data, labelPredictions),
+      std::invalid_argument);
+
+  // Wrong number of responses.
+  REQUIRE_THROWS_AS(model.Train(data, arma::rowvec(9)), std::invalid_argument);
+
+  // Labels out of range, and too few classes.
+  arma::Row<size_t> labels(10, arma::fill::zeros);
+  labels[3] = 2;
+  REQUIRE_THROWS_AS(classifier.Train(data, labels, 2), std::invalid_argument);
+  REQUIRE_THROWS_AS(classifier.Train(data, labels, 1), std::invalid_argument);
+}
+
+/**
+ * Make sure we can serialize regression and classification models.
+ */
+TEST_CASE("GradientBoostingSerializationTest", "[GradientBoostingTest]")
+{
+  arma::mat data;
+  arma::rowvec responses;
+  CreateRegressionData(500, data, responses);
+
+  GradientBoosting<> model(data, responses, 20);
+  arma::rowvec predictions;
+  model.Predict(data, predictions);
+
+  GradientBoosting<> xmlModel, jsonModel, binaryModel;
+  binaryModel.Train(data, responses, 3);
+  SerializeObjectAll(model, xmlModel, jsonModel, binaryModel);
+
+  arma::rowvec xmlPredictions, jsonPredictions, binaryPredictions;
+  xmlModel.Predict(data, xmlPredictions);
+  jsonModel.Predict(data, jsonPredictions);
+  binaryModel.Predict(data, binaryPredictions);
+
+  CheckMatrices(predictions, xmlPredictions, jsonPredictions,
+      binaryPredictions);
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2.csv", data))
+    FAIL("Cannot load test dataset vc2.csv!");
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load labels for vc2_labels.txt");
+
+  GradientBoosting<CrossEntropyLoss> classifier(data, labels, 3, 10);
+  arma::Row<size_t> labelPredictions;
+  arma::mat probabilities;
+  classifier.Classify(data, labelPredictions, probabilities);
+
+  GradientBoosting<CrossEntropyLoss> xmlClassifier, jsonClassifier,
+      binaryClassifier;
+  binaryClassifier.Train(data, labels, 3, 2);
+  SerializeObjectAll(classifier, xmlClassifier, jsonClassifier,
+      binaryClassifier);
+
+  arma::Row<size_t> xmlLabels, jsonLabels, binaryLabels;
+  arma::mat xmlProbabilities, jsonProbabilities, binaryProbabilities;
+  xmlClassifier.Classify(data, xmlLabels, xmlProbabilities);
+  jsonClassifier.Classify(data, jsonLabels, jsonProbabilities);
+  binaryClassifier.Classify(data, binaryLabels, binaryProbabilities);
+
+  CheckMatrices(labelPredictions, xmlLabels, jsonLabels, binaryLabels);
+  CheckMatrices(probabilities, xmlProbabilities, jsonProbabilities,
+      binaryProbabilities);
+}
@@ -10,6 +10,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/hmm/hmm.hpp>
+#include <mlpack/methods/hmm/sparse_hmm.hpp>
 #include <mlpack/methods/gmm/gmm.hpp>
 #include <mlpack/methods/gmm/diagonal_gmm.hpp>
 
@@ -528,6 +529,79 @@ TEST_CASE("DiscreteHMMLogLikelihoodTest", "[HMMTest]")
       Approx(-24.51556128368).epsilon(1e-7));
 }
 
+/**
+ * Make sure that Baum-Welch training on many sequences does not depend on the
+ * order of the sequences (which are split between threads), and that repeating
+ * every sequence does not change the model.
+ */
+TEST_CASE("BaumWelchSequenceOrderTest", "[HMMTest]")
+{
+  arma::vec initial("0.6 0.4");
+  arma::mat transition("0.8 0.3;"
+                       "0.2 0.7");
+  std::vector<DiscreteDistribution> emission(2);
+  emission[0].Probabilities() = "0.6 0.3 0.1";
+  emission[1].Probabilities() = "0.1 0.3 0.6";
+  HMM<DiscreteDistribution> trueHMM(initial, transition, emission);
+
+  std::vector<arma::mat> observations(300);
+  arma::Row<size_t> states;
+  for (size_t i = 0; i < observations.size(); ++i)
+  {
+    const size_t startState = (math::Random() < 0.6) ? 0 : 1;
+    trueHMM.Generate(5 + math::RandInt(20), observations[i], states,
+        startState);
+  }
+
+  std::vector<arma::mat> reversed(observations.rbegin(), observations.rend());
+  std::vector<arma::mat> repeated(observations);
+  repeated.insert(repeated.end(), observations.begin(), observations.end());
+
+  // Start all models from the same (perturbed) parameters.
+  arma::mat startTransition("0.6 0.5;"
+                            "0.4 0.5");
+  std::vector<DiscreteDistribution> startEmission(2);
+  startEmission[0].Probabilities() = "0.4 0.35 0.25";
+  startEmission[1].Probabilities() = "0.25 0.35 0.4";
+  HMM<DiscreteDistribution> hmm(initial, startTransition, startEmission);
+  HMM<DiscreteDistribution> reversedHMM(initial, startTransition,
+      startEmission);
+  HMM<DiscreteDistribution> repeatedHMM(initial, startTransition,
+      startEmission);
+  // The log-likelihood of the repeated sequences is twice as large, so the
+  // tolerance must be too.
+  repeatedHMM.Tolerance() = 2 * hmm.Tolerance();
+
+  const double loglik = hmm.Train(observations);
+  const double reversedLoglik = reversedHMM.Train(reversed);
+  const double repeatedLoglik = repeatedHMM.Train(repeated);
+
+  REQUIRE(reversedLoglik == Approx(loglik).epsilon(1e-8));
+  REQUIRE(repeatedLoglik == Approx(2 * loglik).epsilon(1e-8));
+
+  for (size_t i = 0; i < 2; ++i)
+  {
+    REQUIRE(reversedHMM.Initial()[i] ==
+        Approx(hmm.Initial()[i]).epsilon(1e-6));
+    REQUIRE(repeatedHMM.Initial()[i] ==
+        Approx(hmm.Initial()[i]).epsilon(1e-6));
+
+    for (size_t j = 0; j < 2; ++j)
+    {
+      REQUIRE(reversedHMM.Transition()(i, j) ==
+          Approx(hmm.Transition()(i, j)).epsilon(1e-6));
+      REQUIRE(repeatedHMM.Transition()(i, j) ==
+          Approx(hmm.Transition()(i, j)).epsilon(1e-6));
+    }
+
+    for (size_t e = 0; e < 3; ++e)
+    {
+      REQUIRE(reversedHMM.Emission()[i].Probabilities()[e] ==
+          Approx(hmm.Emission()[i].Probabilities()[e]).epsilon(1e-6));
+    }
+  }
+}
+
 /**
  * A simple test to make sure HMMs with Gaussian output distributions work.
  */
@@ -1509,6 +1583,80 @@ TEST_CASE("HMMTrainReturnLogLikelihood", "[HMMTest]")
   REQUIRE(std::isfinite(loglik) == true);
 }
 
+/**
+ * Make sure that batch Viterbi decoding of ragged sequences gives the same
+ * results as decoding each sequence on its own.
+ */
+TEST_CASE("DiscreteHMMBatchPredictTest", "[HMMTest]")
+{
+  arma::vec initial("0.5 0.2 0.3");
+  arma::mat transition("0.5 0.0 0.1;"
+                       "0.2 0.6 0.2;"
+                       "0.3 0.4 0.7");
+  std::vector<DiscreteDistribution> emission(3);
+  emission[0].Probabilities() = "0.75 0.25 0.00 0.00";
+  emission[1].Probabilities() = "0.00 0.25 0.25 0.50";
+  emission[2].Probabilities() = "0.10 0.40 0.40 0.10";
+
+  HMM<DiscreteDistribution> hmm(initial, transition, emission);
+
+  std::vector<arma::mat> observations(500);
+  arma::Row<size_t> states;
+  for (size_t i = 0; i < observations.size(); ++i)
+    hmm.Generate(1 + math::RandInt(30), observations[i], states);
+
+  std::vector<arma::Row<size_t>> batchStates;
+  arma::vec batchLogLikelihoods;
+  hmm.Predict(observations, batchStates, batchLogLikelihoods);
+
+  REQUIRE(batchStates.size() == observations.size());
+  REQUIRE(batchLogLikelihoods.n_elem == observations.size());
+  for (size_t i = 0; i < observations.size(); ++i)
+  {
+    const double logLikelihood = hmm.Predict(observations[i], states);
+
+    REQUIRE(batchLogLikelihoods[i] == Approx(logLikelihood).epsilon(1e-10));
+    REQUIRE(batchStates[i].n_elem == states.n_elem);
+    for (size_t t = 0; t < states.n_elem; ++t)
+      REQUIRE(batchStates[i][t] == states[t]);
+  }
+}
+
+/**
+ * Make sure that batch scoring of ragged sequences gives the same
+ * log-likelihoods as the forward-backward algorithm on each sequence.
+ */
+TEST_CASE("GaussianHMMBatchLogLikelihoodTest", "[HMMTest]")
+{
+  arma::vec initial("0.4 0.6");
+  arma::mat transition("0.7 0.2;"
+                       "0.3 0.8");
+  std::vector<GaussianDistribution> emission(2);
+  emission[0] = GaussianDistribution("0.0 1.0", "1.0 0.2; 0.2 1.0");
+  emission[1] = GaussianDistribution("2.0 -1.0", "0.5 0.0; 0.0 2.0");
+
+  HMM<GaussianDistribution> hmm(initial, transition, emission);
+
+  std::vector<arma::mat> observations(300);
+  arma::Row<size_t> states;
+  for (size_t i = 0; i < observations.size(); ++i)
+    hmm.Generate(1 + math::RandInt(50), observations[i], states);
+
+  arma::vec batchLogLikelihoods;
+  hmm.LogLikelihood(observations, batchLogLikelihoods);
+
+  REQUIRE(batchLogLikelihoods.n_elem == observations.size());
+  for (size_t i = 0; i < observations.size(); ++i)
+  {
+    arma::mat stateProb;
+    const double logLikelihood = hmm.Estimate(observations[i], stateProb);
+
+    REQUIRE(batchLogLikelihoods[i] == Approx(logLikelihood).epsilon(1e-8));
+    REQUIRE(batchLogLikelihoods[i] ==
+        Approx(hmm.LogLikelihood(observations[i])).epsilon(1e-10));
+  }
+}
+
 /********************************************/
 /** DiagonalGMM Hidden Markov Models Tests **/
 /********************************************/
@@ -2108,3 +2256,218 @@ TEST_CASE("DiagonalGMMHMMLoadSaveTest", "[HMMTest]")
     }
   }
 }
+
+/****************************************/
+/** Sparse Hidden Markov Models Tests **/
+/****************************************/
+
+/**
+ * Create a banded left-to-right SparseHMM with discrete emissions, and an
+ * equivalent dense HMM.
+ */
+static void CreateBandedHMMs(SparseHMM<DiscreteDistribution>& sparse,
+                             HMM<DiscreteDistribution>& dense)
+{
+  const size_t states = 12;
+  const arma::sp_mat pattern =
+      SparseHMM<DiscreteDistribution>::BandedPattern(states, 0, 2);
+
+  // Random transition probabilities on the pattern.
+  arma::sp_mat transition(pattern);
+  arma::mat denseTransition(transition);
+  denseTransition %= arma::randu<arma::mat>(states, states) + 0.1;
+  denseTransition.each_row() /= arma::sum(denseTransition, 0);
+  transition = arma::sp_mat(denseTransition);
+
+  arma::vec initial = arma::randu<arma::vec>(states) + 0.1;
+  initial /= arma::accu(initial);
+
+  std::vector<DiscreteDistribution> emission(states);
+  for (size_t i = 0; i < states; ++i)
+  {
+    emission[i].Probabilities() = arma::randu<arma::vec>(4) + 0.1;
+    emission[i].Probabilities() /= arma::accu(emission[i].Probabilities());
+  }
+
+  sparse = SparseHMM<DiscreteDistribution>(initial, transition, emission);
+  dense = HMM<DiscreteDistribution>(initial, denseTransition, emission);
+}
+
+/**
+ * Make sure the banded pattern has the right transitions.
+ */
+TEST_CASE("SparseHMMBandedPatternTest", "[HMMTest]")
+{
+  const arma::sp_mat pattern =
+      SparseHMM<DiscreteDistribution>::BandedPattern(10, 1, 2);
+
+  REQUIRE(pattern.n_rows == 10);
+  REQUIRE(pattern.n_cols == 10);
+  for (size_t j = 0; j < 10; ++j)
+  {
+    for (size_t i = 0; i < 10; ++i)
+    {
+      const bool inBand = (i + 1 >= j) && (i <= j + 2);
+      REQUIRE((pattern(i, j) != 0.0) == inBand);
+    }
+  }
+
+  SparseHMM<DiscreteDistribution> hmm(pattern, DiscreteDistribution(3));
+  REQUIRE(hmm.States() == 10);
+  REQUIRE(hmm.NumTransitions() == pattern.n_nonzero);
+  REQUIRE(arma::accu(hmm.Initial()) == Approx(1.0).epsilon(1e-10));
+  const arma::mat transition(hmm.Transition());
+  for (size_t j = 0; j < 10; ++j)
+    REQUIRE(arma::accu(transition.col(j)) == Approx(1.0).epsilon(1e-10));
+}
+
+/**
+ * Make sure the sparse forward-backward and Viterbi algorithms give the same
+ * results as the dense HMM.
+ */
+TEST_CASE("SparseHMMMatchesDenseTest", "[HMMTest]")
+{
+  SparseHMM<DiscreteDistribution> sparse;
+  HMM<DiscreteDistribution> dense(1, DiscreteDistribution(1));
+  CreateBandedHMMs(sparse, dense);
+
+  for (size_t trial = 0; trial < 20; ++trial)
+  {
+    arma::mat observations;
+    arma::Row<size_t> states;
+    sparse.Generate(10 + math::RandInt(30), observations, states);
+
+    // Every generated transition must be in the band.
+    for (size_t t = 1; t < states.n_elem; ++t)
+    {
+      REQUIRE(states[t] >= states[t - 1]);
+      REQUIRE(states[t] <= states[t - 1] + 2);
+    }
+
+    REQUIRE(sparse.LogLikelihood(observations) ==
+        Approx(dense.LogLikelihood(observations)).epsilon(1e-8));
+
+    arma::mat sparseStateProb, denseStateProb;
+    sparse.Estimate(observations, sparseStateProb);
+    dense.Estimate(observations, denseStateProb);
+    REQUIRE(arma::approx_equal(sparseStateProb, denseStateProb, "absdiff",
+        1e-8));
+
+    arma::Row<size_t> sparseStates, denseStates;
+    const double sparseLogLik = sparse.Predict(observations, sparseStates);
+    const double denseLogLik = dense.Predict(observations, denseStates);
+    REQUIRE(sparseLogLik == Approx(denseLogLik).epsilon(1e-8));
+    for (size_t t = 0; t < sparseStates.n_elem; ++t)
+      REQUIRE(sparseStates[t] == denseStates[t]);
+  }
+}
+
+/**
+ * Make sure that Baum-Welch training of a sparse HMM gives the same model as
+ * training the dense HMM, and that the sparsity pattern is kept.
+ */
+TEST_CASE("SparseHMMTrainTest", "[HMMTest]")
+{
+  SparseHMM<DiscreteDistribution> sparse;
+  HMM<DiscreteDistribution> dense(1, DiscreteDistribution(1));
+  CreateBandedHMMs(sparse, dense);
+
+  std::vector<arma::mat> observations(50);
+  arma::Row<size_t> states;
+  for (size_t i = 0; i < observations.size(); ++i)
+    sparse.Generate(10 + math::RandInt(30), observations[i], states);
+
+  const size_t numTransitions = sparse.NumTransitions();
+  const double sparseLogLik = sparse.Train(observations);
+  const double denseLogLik = dense.Train(observations);
+
+  REQUIRE(sparseLogLik == Approx(denseLogLik).epsilon(1e-6));
+  REQUIRE(sparse.NumTransitions() == numTransitions);
+
+  const arma::mat sparseTransition(sparse.Transition());
+  REQUIRE(arma::approx_equal(sparseTransition, dense.Transition(), "absdiff",
+      1e-5));
+  REQUIRE(arma::approx_equal(sparse.Initial(), dense.Initial(), "absdiff",
+      1e-5));
+
+  // No transition outside of the band may appear.
+  for (size_t j = 0; j < sparseTransition.n_cols; ++j)
+  {
+    for (size_t i = 0; i < sparseTransition.n_rows; ++i)
+    {
+      if (i < j || i > j + 2)
+        REQUIRE(sparseTransition(i, j) == 0.0);
+    }
+  }
+}
+
+/**
+ * Make sure labeled training counts the transitions on the pattern, and
+ * rejects transitions outside of it.
+ */
+TEST_CASE("SparseHMMLabeledTrainTest", "[HMMTest]")
+{
+  const arma::sp_mat pattern =
+      SparseHMM<DiscreteDistribution>::BandedPattern(3, 0, 1);
+  SparseHMM<DiscreteDistribution> hmm(pattern, DiscreteDistribution(2));
+
+  std::vector<arma::mat> observations;
+  std::vector<arma::Row<size_t>> states;
+  observations.push_back("0 0 1 1 1 0");
+  states.push_back("0 0 1 1 2 2");
+  observations.push_back("0 1 1 0");
+  states.push_back("0 1 2 2");
+
+  hmm.Train(observations, states);
+
+  const arma::mat transition(hmm.Transition());
+  REQUIRE(transition(0, 0) == Approx(1.0 / 3.0).epsilon(1e-10));
+  REQUIRE(transition(1, 0) == Approx(2.0 / 3.0).epsilon(1e-10));
+  REQUIRE(transition(1, 1) == Approx(1.0 / 3.0).epsilon(1e-10));
+  REQUIRE(transition(2, 1) == Approx(2.0 / 3.0).epsilon(1e-10));
+  REQUIRE(transition(2, 2) == Approx(1.0).epsilon(1e-10));
+  REQUIRE(hmm.Initial()[0] == Approx(1.0).epsilon(1e-10));
+
+  // A transition from state 2 back to state 0 is not in the pattern.
+  states[1] = "0 1 2 0";
+  REQUIRE_THROWS_AS(hmm.Train(observations, states), std::runtime_error);
+}
+
+/**
+ * Make sure a sparse HMM can be saved and loaded.
+ */
+TEST_CASE("SparseHMMLoadSaveTest", "[HMMTest]")
+{
+  SparseHMM<DiscreteDistribution> hmm;
+  HMM<DiscreteDistribution> dense(1, DiscreteDistribution(1));
+  CreateBandedHMMs(hmm, dense);
+
+  // Save the HMM.
+  {
+    std::ofstream ofs("test-sparse-hmm-save.xml");
+    cereal::XMLOutputArchive ar(ofs);
+    ar(cereal::make_nvp("hmm", hmm));
+  }
+
+  // Load the HMM.
+  SparseHMM<DiscreteDistribution> hmm2;
+  {
+    std::ifstream ifs("test-sparse-hmm-save.xml");
+    cereal::XMLInputArchive ar(ifs);
+    ar(cereal::make_nvp("hmm", hmm2));
+  }
+
+  // Remove clutter.
+  remove("test-sparse-hmm-save.xml");
+
+  REQUIRE(hmm2.States() == hmm.States());
+  REQUIRE(hmm2.NumTransitions() == hmm.NumTransitions());
+  REQUIRE(arma::approx_equal(arma::mat(hmm2.Transition()),
+      arma::mat(hmm.Transition()), "absdiff", 1e-10));
+
+  arma::mat observations;
+  arma::Row<size_t> states;
+  hmm.Generate(30, observations, states);
+  REQUIRE(hmm2.LogLikelihood(observations) ==
+      Approx(hmm.LogLikelihood(observations)).epsilon(1e-10));
+}
@@ -0,0 +1,266 @@
+/**
+ * @file tests/hnsw_test.cpp
+ *
+ * Unit tests for the 'HNSWSearch' class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/hnsw/hnsw_search.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+#include "catch.hpp"
+#include "serialization.hpp"
+#include "test_catch_tools.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+/**
+ * Make sure that the approximate neighbors found in a bichromatic search are
+ * nearly all the true neighbors.
+ */
+TEST_CASE("HNSWRecallTest", "[HNSWTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(5, 2000);
+  arma::mat queryData = arma::randu<arma::mat>(5, 200);
+  const size_t k = 10;
+
+  KNN knn(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, k, trueNeighbors, trueDistances);
+
+  HNSWSearch<> hnsw(referenceData, 16, 200, 100);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(queryData, k, neighbors, distances);
+
+  REQUIRE(neighbors.n_rows == k);
+  REQUIRE(neighbors.n_cols == queryData.n_cols);
+  REQUIRE(HNSWSearch<>::ComputeRecall(neighbors, trueNeighbors) >= 0.95);
+
+  // The distances must be sorted and must be the real distances.
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < k; ++j)
+    {
+      if (j > 0)
+        REQUIRE(distances(j, i) >= distances(j - 1, i));
+
+      const double distance = metric::EuclideanDistance::Evaluate(
+          queryData.col(i), referenceData.col(neighbors(j, i)));
+      REQUIRE(distances(j, i) == Approx(distance).epsilon(1e-7));
+    }
+  }
+
+  // The search must have done far less work than a brute-force search.
+  REQUIRE(hnsw.DistanceEvaluations() > 0);
+  REQUIRE(hnsw.DistanceEvaluations() <
+      referenceData.n_cols * queryData.n_cols / 2);
+}
+
+/**
+ * Make sure that a monochromatic search never returns a point as its own
+ * neighbor, and that it finds nearly all the true neighbors.
+ */
+TEST_CASE("HNSWMonochromaticTest", "[HNSWTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+  const size_t k = 5;
+
+  KNN knn(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(k, trueNeighbors, trueDistances);
+
+  HNSWSearch<> hnsw(referenceData);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(k, neighbors, distances);
+
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+    for (size_t j = 0; j < k; ++j)
+      REQUIRE(neighbors(j, i) != i);
+
+  REQUIRE(HNSWSearch<>::ComputeRecall(neighbors, trueNeighbors) >= 0.95);
+}
+
+/**
+ * Check the structure of the graph: no point has more links than it is allowed
+ * or links to itself, and every link on a layer leads to a point that is on
+ * that layer.
+ */
+TEST_CASE("HNSWGraphTest", "[HNSWTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(4, 1500);
+
+  HNSWSearch<> hnsw(referenceData, 8, 50);
+
+  REQUIRE(hnsw.Level(hnsw.EntryPoint()) == hnsw.MaxLevel());
+  for (size_t i = 0; i < referenceData.n_cols; ++i)
+  {
+    REQUIRE(hnsw.Level(i) <= hnsw.MaxLevel());
+    for (size_t l = 0; l <= hnsw.Level(i); ++l)
+    {
+      const std::vector<size_t>& links = hnsw.Links(i, l);
+      REQUIRE(links.size() <= hnsw.MaxLinks(l));
+      for (size_t j = 0; j < links.size(); ++j)
+      {
+        REQUIRE(links[j] != i);
+        REQUIRE(links[j] < referenceData.n_cols);
+        REQUIRE(hnsw.Level(links[j]) >= l);
+      }
+    }
+
+    // Every point is linked to at least one other point on the bottom layer.
+    REQUIRE(hnsw.Links(i, 0).size() > 0);
+  }
+}
+
+/**
+ * Make sure that larger values of ef do not reduce the recall.
+ */
+TEST_CASE("HNSWEfTest", "[HNSWTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(10, 2000);
+  arma::mat queryData = arma::randu<arma::mat>(10, 100);
+  const size_t k = 10;
+
+  KNN knn(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, k, trueNeighbors, trueDistances);
+
+  HNSWSearch<> hnsw(referenceData, 6, 40);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  hnsw.Ef() = k;
+  hnsw.Search(queryData, k, neighbors, distances);
+  const double lowRecall = HNSWSearch<>::ComputeRecall(neighbors,
+      trueNeighbors);
+
+  hnsw.Ef() = 400;
+  hnsw.Search(queryData, k, neighbors, distances);
+  const double highRecall = HNSWSearch<>::ComputeRecall(neighbors,
+      trueNeighbors);
+
+  REQUIRE(highRecall >= lowRecall);
+  REQUIRE(highRecall >= 0.95);
+}
+
+/**
+ * Test that a model built with the empty constructor can be trained with
+ * Train() and keeps its parameters.
+ */
+TEST_CASE("HNSWTrainTest", "[HNSWTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 300);
+  arma::mat queryData = arma::randu<arma::mat>(3, 50);
+
+  HNSWSearch<> hnsw(8, 100, 30);
+  REQUIRE(hnsw.ReferenceSet().n_cols == 0);
+  hnsw.Train(referenceData);
+
+  REQUIRE(hnsw.ReferenceSet().n_cols == 300);
+  REQUIRE(hnsw.MaxConnections() == 8);
+  REQUIRE(hnsw.EfConstruction() == 100);
+  REQUIRE(hnsw.Ef() == 30);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(queryData, 3, neighbors, distances);
+
+  KNN knn(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, 3, trueNeighbors, trueDistances);
+
+  REQUIRE(HNSWSearch<>::ComputeRecall(neighbors, trueNeighbors) >= 0.95);
+}
+
+/**
+ * Make sure invalid parameters and queries throw.
+ */
+TEST_CASE("HNSWInvalidTest", "[HNSWTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 100);
+
+  REQUIRE_THROWS_AS(HNSWSearch<>(referenceData, 0), std::invalid_argument);
+  REQUIRE_THROWS_AS(HNSWSearch<>(referenceData, 16, 0),
+      std::invalid_argument);
+
+  HNSWSearch<> hnsw(referenceData);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  // Wrong dimensionality.
+  arma::mat queryData = arma::randu<arma::mat>(4, 10);
+  REQUIRE_THROWS_AS(hnsw.Search(queryData, 3, neighbors, distances),
+      std::invalid_argument);
+
+  // Too many neighbors.
+  queryData = arma::randu<arma::mat>(3, 10);
+  REQUIRE_THROWS_AS(hnsw.Search(queryData, 101, neighbors, distances),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(hnsw.Search(100, neighbors, distances),
+      std::invalid_argument);
+
+  // Mismatched recall matrices.
+  arma::Mat<size_t> a(3, 10, arma::fill::zeros);
+  arma::Mat<size_t> b(4, 10, arma::fill::zeros);
+  REQUIRE_THROWS_AS(HNSWSearch<>::ComputeRecall(a, b), std::invalid_argument);
+}
+
+/**
+ * Test the recall computation itself.
+ */
+TEST_CASE("HNSWComputeRecallTest", "[HNSWTest]")
+{
+  arma::Mat<size_t> truth = { { 0, 4 },
+                              { 1, 5 },
+                              { 2, 6 } };
+  arma::Mat<size_t> found = { { 2, 7 },
+                              { 1, 5 },
+                              { 3, 8 } };
+
+  // Three of the six neighbors are correct, regardless of their order.
+  REQUIRE(HNSWSearch<>::ComputeRecall(found, truth) == Approx(0.5));
+  REQUIRE(HNSWSearch<>::ComputeRecall(truth, truth) == Approx(1.0));
+}
+
+/**
+ * Make sure that a serialized model gives the same graph and the same results.
+ */
+TEST_CASE("HNSWSerializationTest", "[HNSWTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(4, 500);
+  arma::mat queryData = arma::randu<arma::mat>(4, 50);
+
+  HNSWSearch<> hnsw(referenceData, 8, 50, 40);
+  HNSWSearch<> xmlHnsw, jsonHnsw, binaryHnsw;
+
+  SerializeObjectAll(hnsw, xmlHnsw, jsonHnsw, binaryHnsw);
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, jsonNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, jsonDistances, binaryDistances;
+
+  hnsw.Search(queryData, 5, neighbors, distances);
+  xmlHnsw.Search(queryData, 5, xmlNeighbors, xmlDistances);
+  jsonHnsw.Search(queryData, 5, jsonNeighbors, jsonDistances);
+  binaryHnsw.Search(queryData, 5, binaryNeighbors, binaryDistances);
+
+  REQUIRE(xmlHnsw.MaxLevel() == hnsw.MaxLevel());
+  REQUIRE(jsonHnsw.EntryPoint() == hnsw.EntryPoint());
+  REQUIRE(binaryHnsw.Ef() == hnsw.Ef());
+  for (size_t i = 0; i < referenceData.n_cols; ++i)
+    REQUIRE(binaryHnsw.Links(i, 0) == hnsw.Links(i, 0));
+
+  CheckMatrices(neighbors, xmlNeighbors, jsonNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, jsonDistances, binaryDistances);
+}
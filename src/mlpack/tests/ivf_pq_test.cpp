@@ -0,0 +1,242 @@
+/**
+ * @file tests/ivf_pq_test.cpp
+ *
+ * Unit tests for the 'IVFPQSearch' class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ivf_pq/ivf_pq_search.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+#include "catch.hpp"
+#include "serialization.hpp"
+#include "test_catch_tools.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+/**
+ * Compute the fraction of the true neighbors that were found.
+ */
+double IVFPQRecall(const arma::Mat<size_t>& found,
+                   const arma::Mat<size_t>& truth)
+{
+  size_t hits = 0;
+  for (size_t i = 0; i < truth.n_cols; ++i)
+    for (size_t j = 0; j < truth.n_rows; ++j)
+      hits += arma::any(found.col(i) == truth(j, i)) ? 1 : 0;
+
+  return double(hits) / truth.n_elem;
+}
+
+/**
+ * Check the structure of the index: every point is in exactly one list, it is
+ * in the list of its nearest centroid, and its code uses valid codewords.
+ */
+TEST_CASE("IVFPQIndexTest", "[IVFPQTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(10, 1000);
+
+  IVFPQSearch<> ivfpq(referenceData, 16, 4, 32);
+
+  REQUIRE(ivfpq.NumPoints() == 1000);
+  REQUIRE(ivfpq.Dimensionality() == 10);
+  REQUIRE(ivfpq.CoarseCentroids().n_cols == 16);
+  REQUIRE(ivfpq.Codebooks().n_rows == 10);
+  REQUIRE(ivfpq.Codebooks().n_cols == 32);
+  REQUIRE(ivfpq.Codes().n_rows == 4);
+  REQUIRE(ivfpq.Codes().n_cols == 1000);
+
+  const arma::Col<size_t>& bounds = ivfpq.SubspaceBounds();
+  REQUIRE(bounds.n_elem == 5);
+  REQUIRE(bounds[0] == 0);
+  REQUIRE(bounds[4] == 10);
+
+  const arma::Col<size_t>& offsets = ivfpq.ListOffsets();
+  REQUIRE(offsets.n_elem == 17);
+  REQUIRE(offsets[0] == 0);
+  REQUIRE(offsets[16] == 1000);
+
+  arma::Col<size_t> sorted = arma::sort(ivfpq.Indices());
+  for (size_t i = 0; i < 1000; ++i)
+    REQUIRE(sorted[i] == i);
+
+  for (size_t l = 0; l < 16; ++l)
+  {
+    for (size_t p = offsets[l]; p < offsets[l + 1]; ++p)
+    {
+      const size_t point = ivfpq.Indices()[p];
+      arma::vec centroidDistances(16);
+      for (size_t c = 0; c < 16; ++c)
+      {
+        centroidDistances[c] = metric::EuclideanDistance::Evaluate(
+            referenceData.col(point), ivfpq.CoarseCentroids().col(c));
+      }
+
+      REQUIRE(centroidDistances[l] ==
+          Approx(centroidDistances.min()).epsilon(1e-7));
+      REQUIRE(arma::max(ivfpq.Codes().col(p)) < 32);
+    }
+  }
+}
+
+/**
+ * When every list is probed and the codes are fine enough, nearly all the true
+ * neighbors must be found, and the distances must be close to the true ones.
+ */
+TEST_CASE("IVFPQRecallTest", "[IVFPQTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(4, 2000);
+  arma::mat queryData = arma::randu<arma::mat>(4, 100);
+
+  KNN knn(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, 5, trueNeighbors, trueDistances);
+
+  IVFPQSearch<> ivfpq(referenceData, 8, 4, 256, 8);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  ivfpq.Search(queryData, 5, neighbors, distances);
+
+  REQUIRE(neighbors.n_rows == 5);
+  REQUIRE(neighbors.n_cols == 100);
+  REQUIRE(distances.n_rows == 5);
+  REQUIRE(distances.n_cols == 100);
+  REQUIRE(IVFPQRecall(neighbors, trueNeighbors) >= 0.8);
+
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      if (j > 0)
+        REQUIRE(distances(j, i) >= distances(j - 1, i));
+
+      REQUIRE(neighbors(j, i) < referenceData.n_cols);
+      const double distance = metric::EuclideanDistance::Evaluate(
+          queryData.col(i), referenceData.col(neighbors(j, i)));
+      REQUIRE(std::abs(distances(j, i) - distance) < 0.1);
+    }
+  }
+}
+
+/**
+ * Probing more lists must not reduce the recall.
+ */
+TEST_CASE("IVFPQProbesTest", "[IVFPQTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(8, 3000);
+  arma::mat queryData = arma::randu<arma::mat>(8, 200);
+
+  KNN knn(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, 10, trueNeighbors, trueDistances);
+
+  IVFPQSearch<> ivfpq(referenceData, 32, 8, 64, 1);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  ivfpq.Search(queryData, 10, neighbors, distances);
+  const double lowRecall = IVFPQRecall(neighbors, trueNeighbors);
+
+  ivfpq.NumProbes() = 32;
+  ivfpq.Search(queryData, 10, neighbors, distances);
+  const double highRecall = IVFPQRecall(neighbors, trueNeighbors);
+
+  REQUIRE(highRecall >= lowRecall);
+}
+
+/**
+ * Make sure that results that can't be found are padded, and that the search
+ * only returns points of the probed lists.
+ */
+TEST_CASE("IVFPQPaddingTest", "[IVFPQTest]")
+{
+  // Two well-separated clusters of 50 points.
+  arma::mat referenceData = arma::randu<arma::mat>(2, 100);
+  referenceData.cols(50, 99) += 100.0;
+
+  IVFPQSearch<> ivfpq(referenceData, 2, 2, 16, 1);
+
+  // A query at the first cluster only sees its 50 points.
+  arma::mat queryData(2, 1, arma::fill::zeros);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  ivfpq.Search(queryData, 60, neighbors, distances);
+
+  for (size_t j = 0; j < 50; ++j)
+  {
+    REQUIRE(neighbors(j, 0) < 50);
+    REQUIRE(distances(j, 0) < DBL_MAX);
+  }
+  for (size_t j = 50; j < 60; ++j)
+  {
+    REQUIRE(neighbors(j, 0) == SIZE_MAX);
+    REQUIRE(distances(j, 0) == DBL_MAX);
+  }
+}
+
+/**
+ * Make sure invalid parameters and queries throw.
+ */
+TEST_CASE("IVFPQInvalidTest", "[IVFPQTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(4, 100);
+
+  REQUIRE_THROWS_AS(IVFPQSearch<>(referenceData, 0), std::invalid_argument);
+  REQUIRE_THROWS_AS(IVFPQSearch<>(referenceData, 101), std::invalid_argument);
+  REQUIRE_THROWS_AS(IVFPQSearch<>(referenceData, 4, 0), std::invalid_argument);
+  REQUIRE_THROWS_AS(IVFPQSearch<>(referenceData, 4, 5), std::invalid_argument);
+  REQUIRE_THROWS_AS(IVFPQSearch<>(referenceData, 4, 2, 257),
+      std::invalid_argument);
+
+  IVFPQSearch<> ivfpq(referenceData, 4, 2, 16);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  arma::mat queryData = arma::randu<arma::mat>(3, 10);
+  REQUIRE_THROWS_AS(ivfpq.Search(queryData, 3, neighbors, distances),
+      std::invalid_argument);
+
+  queryData = arma::randu<arma::mat>(4, 10);
+  REQUIRE_THROWS_AS(ivfpq.Search(queryData, 101, neighbors, distances),
+      std::invalid_argument);
+
+  ivfpq.NumProbes() = 0;
+  REQUIRE_THROWS_AS(ivfpq.Search(queryData, 3, neighbors, distances),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that a serialized index gives the same results.
+ */
+TEST_CASE("IVFPQSerializationTest", "[IVFPQTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(6, 500);
+  arma::mat queryData = arma::randu<arma::mat>(6, 50);
+
+  IVFPQSearch<> ivfpq(referenceData, 8, 3, 32, 2);
+  IVFPQSearch<> xmlIvfpq, jsonIvfpq, binaryIvfpq;
+
+  SerializeObjectAll(ivfpq, xmlIvfpq, jsonIvfpq, binaryIvfpq);
+
+  REQUIRE(binaryIvfpq.NumProbes() == 2);
+  REQUIRE(binaryIvfpq.NumPoints() == 500);
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, jsonNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, jsonDistances, binaryDistances;
+
+  ivfpq.Search(queryData, 5, neighbors, distances);
+  xmlIvfpq.Search(queryData, 5, xmlNeighbors, xmlDistances);
+  jsonIvfpq.Search(queryData, 5, jsonNeighbors, jsonDistances);
+  binaryIvfpq.Search(queryData, 5, binaryNeighbors, binaryDistances);
+
+  CheckMatrices(neighbors, xmlNeighbors, jsonNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, jsonDistances, binaryDistances);
+}
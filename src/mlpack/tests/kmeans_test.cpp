@@ -12,16 +12,21 @@
 #include <mlpack/methods/kmeans/kmeans.hpp>
 #include <mlpack/methods/kmeans/allow_empty_clusters.hpp>
 #include <mlpack/methods/kmeans/refined_start.hpp>
+#include <mlpack/methods/kmeans/kmeans_parallel_initialization.hpp>
 #include <mlpack/methods/kmeans/elkan_kmeans.hpp>
 #include <mlpack/methods/kmeans/hamerly_kmeans.hpp>
 #include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
 #include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
+#include <mlpack/methods/kmeans/mini_batch_kmeans.hpp>
+#include <mlpack/methods/kmeans/chunked_kmeans.hpp>
+#include <mlpack/methods/kmeans/yinyang_kmeans.hpp>
 #include <mlpack/methods/kmeans/sample_initialization.hpp>
 #include <mlpack/methods/kmeans/random_partition.hpp>
 
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 
+#include "test_catch_tools.hpp"
 #include "catch.hpp"
 #include <mlpack/methods/kmeans/kill_empty_clusters.hpp>
 
@@ -602,6 +607,56 @@ TEST_CASE("HamerlyTest", "[KMeansTest]")
   }
 }
 
+/**
+ * Run k-means with the given Lloyd step type with one thread and with the
+ * default number of threads, and make sure that the assignments and centroids
+ * are exactly equal.
+ */
+template<template<class, class> class LloydStepType>
+void CheckThreadIndependence()
+{
+  arma::mat dataset(10, 5000);
+  dataset.randu();
+
+  const size_t k = 20;
+  arma::mat centroids(10, k);
+  centroids.randu();
+
+  KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      LloydStepType> km;
+
+  #ifdef HAS_OPENMP
+  const int numThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  #endif
+
+  arma::Row<size_t> serialAssignments;
+  arma::mat serialCentroids(centroids);
+  km.Cluster(dataset, k, serialAssignments, serialCentroids, false, true);
+
+  #ifdef HAS_OPENMP
+  omp_set_num_threads(numThreads);
+  #endif
+
+  arma::Row<size_t> assignments;
+  arma::mat parallelCentroids(centroids);
+  km.Cluster(dataset, k, assignments, parallelCentroids, false, true);
+
+  REQUIRE(arma::all(assignments == serialAssignments));
+  REQUIRE(arma::approx_equal(parallelCentroids, serialCentroids, "absdiff",
+      0.0));
+}
+
+/**
+ * Make sure that Elkan's and Hamerly's algorithms do not depend on the number
+ * of threads.
+ */
+TEST_CASE("ElkanHamerlyThreadTest", "[KMeansTest]")
+{
+  CheckThreadIndependence<ElkanKMeans>();
+  CheckThreadIndependence<HamerlyKMeans>();
+}
+
 TEST_CASE("PellegMooreTest", "[KMeansTest]")
 {
   const size_t trials = 5;
@@ -700,6 +755,246 @@ TEST_CASE("DTNNCoverTreeTest", "[KMeansTest]")
   }
 }
 
+/**
+ * Make sure that mini-batch k-means finds nearly the same clusters as the naive
+ * method on well-separated data.
+ */
+TEST_CASE("MiniBatchKMeansTest", "[KMeansTest]")
+{
+  // Three well-separated Gaussians.
+  arma::mat dataset(2, 30000, arma::fill::randn);
+  dataset.cols(0, 9999).each_col() += arma::vec("20.0 0.0");
+  dataset.cols(10000, 19999).each_col() += arma::vec("0.0 20.0");
+
+  arma::mat centroids("19.0 1.0 0.0; 1.0 19.0 0.0");
+
+  arma::mat naiveCentroids(centroids);
+  KMeans<> km;
+  arma::Row<size_t> assignments;
+  km.Cluster(dataset, 3, assignments, naiveCentroids, false, true);
+
+  KMeans<metric::EuclideanDistance, SampleInitialization,
+      MaxVarianceNewCluster, DefaultMiniBatchKMeans> miniBatch(100);
+  arma::Row<size_t> miniBatchAssignments;
+  arma::mat miniBatchCentroids(centroids);
+  miniBatch.Cluster(dataset, 3, miniBatchAssignments, miniBatchCentroids,
+      false, true);
+
+  // Points on the border between clusters could go either way, but there are
+  // very few of them.
+  REQUIRE(arma::accu(assignments != miniBatchAssignments) < 10);
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    REQUIRE(miniBatchCentroids[i] == Approx(naiveCentroids[i]).margin(0.05));
+}
+
+/**
+ * Each centroid of mini-batch k-means should be the mean of all the batch
+ * points it has been given, so its first batch moves it all the way.
+ */
+TEST_CASE("MiniBatchKMeansLearningRateTest", "[KMeansTest]")
+{
+  // Every point is the same, so every batch has the same mean.
+  arma::mat dataset(3, 100);
+  dataset.each_col() = arma::vec("1.0 2.0 3.0");
+
+  EuclideanDistance metric;
+  MiniBatchKMeans<EuclideanDistance, arma::mat, 10> step(dataset, metric);
+
+  arma::mat centroids(3, 1, arma::fill::zeros);
+  arma::mat newCentroids;
+  arma::Col<size_t> counts;
+
+  double drift = step.Iterate(centroids, newCentroids, counts);
+  REQUIRE(drift == Approx(std::sqrt(14.0)).epsilon(1e-10));
+  REQUIRE(counts[0] == 10);
+  CheckMatrices(newCentroids, dataset.col(0));
+
+  drift = step.Iterate(newCentroids, centroids, counts);
+  REQUIRE(drift == Approx(0.0).margin(1e-10));
+  REQUIRE(counts[0] == 20);
+  REQUIRE(step.DistanceCalculations() == 22);
+}
+
+/**
+ * A centroid of mini-batch k-means that no batch point has reached should keep
+ * its position and should be reported as empty.
+ */
+TEST_CASE("MiniBatchKMeansUnvisitedCentroidTest", "[KMeansTest]")
+{
+  arma::mat dataset(3, 100);
+  dataset.each_col() = arma::vec("1.0 2.0 3.0");
+
+  EuclideanDistance metric;
+  MiniBatchKMeans<EuclideanDistance, arma::mat, 10> step(dataset, metric);
+
+  // The second centroid is too far away to be given any points.
+  arma::mat centroids("0.0 100.0; 0.0 100.0; 0.0 100.0");
+  arma::mat newCentroids;
+  arma::Col<size_t> counts;
+
+  step.Iterate(centroids, newCentroids, counts);
+  REQUIRE(counts[0] == 10);
+  REQUIRE(counts[1] == 0);
+  CheckMatrices(newCentroids.col(1), centroids.col(1));
+
+  step.Iterate(newCentroids, centroids, counts);
+  REQUIRE(counts[0] == 20);
+  REQUIRE(counts[1] == 0);
+
+  // If the empty cluster policy gives the second cluster a point, the next
+  // step continues from that count.
+  centroids.col(1) = dataset.col(0);
+  counts[0] = 19;
+  counts[1] = 1;
+  step.Iterate(centroids, newCentroids, counts);
+  REQUIRE(counts[0] + counts[1] == 30);
+  REQUIRE(counts[1] >= 1);
+}
+
+/**
+ * On well-separated data, mini-batch k-means should stop on its own tolerance
+ * long before the maximum number of iterations.
+ */
+TEST_CASE("MiniBatchKMeansConvergenceTest", "[KMeansTest]")
+{
+  arma::mat dataset(2, 30000, arma::fill::randn);
+  dataset.cols(0, 9999).each_col() += arma::vec("20.0 0.0");
+  dataset.cols(10000, 19999).each_col() += arma::vec("0.0 20.0");
+
+  EuclideanDistance metric;
+  MiniBatchKMeans<EuclideanDistance, arma::mat, 1024> step(dataset, metric);
+
+  // Run the steps the same way KMeans does.
+  arma::mat centroids("19.0 1.0 0.0; 1.0 19.0 0.0");
+  arma::mat centroidsOther;
+  arma::Col<size_t> counts;
+  size_t iteration = 0;
+  double cNorm;
+  do
+  {
+    if (iteration % 2 == 0)
+      cNorm = step.Iterate(centroids, centroidsOther, counts);
+    else
+      cNorm = step.Iterate(centroidsOther, centroids, counts);
+    ++iteration;
+  } while (cNorm > 1e-5 && iteration != 1000);
+
+  REQUIRE(cNorm == 0.0);
+  REQUIRE(iteration < 200);
+
+  // The same holds when KMeans runs the steps.
+  KMeans<metric::EuclideanDistance, SampleInitialization,
+      MaxVarianceNewCluster, DefaultMiniBatchKMeans> miniBatch(1000);
+  arma::Row<size_t> assignments;
+  arma::mat kmeansCentroids("19.0 1.0 0.0; 1.0 19.0 0.0");
+  miniBatch.Cluster(dataset, 3, assignments, kmeansCentroids, false, true);
+
+  for (size_t i = 0; i < 10000; ++i)
+  {
+    REQUIRE(assignments[i] == 0);
+    REQUIRE(assignments[i + 10000] == 1);
+    REQUIRE(assignments[i + 20000] == 2);
+  }
+}
+
+// Yinyang k-means with a fixed number of groups.
+template<typename MetricType, typename MatType>
+using ThreeGroupYinyangKMeans = YinyangKMeans<MetricType, MatType, 3>;
+
+/**
+ * Make sure that the Yinyang algorithm returns the same clusters as the naive
+ * method, with the default number of groups and with three groups.
+ */
+TEST_CASE("YinyangTest", "[KMeansTest]")
+{
+  const size_t trials = 5;
+
+  for (size_t t = 0; t < trials; ++t)
+  {
+    arma::mat dataset(10, 1000);
+    dataset.randu();
+
+    const size_t k = 5 * (t + 1);
+    arma::mat centroids(10, k);
+    centroids.randu();
+
+    arma::mat naiveCentroids(centroids);
+    KMeans<> km;
+    arma::Row<size_t> assignments;
+    km.Cluster(dataset, k, assignments, naiveCentroids, false, true);
+
+    KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+        DefaultYinyangKMeans> yinyang;
+    arma::Row<size_t> yinyangAssignments;
+    arma::mat yinyangCentroids(centroids);
+    yinyang.Cluster(dataset, k, yinyangAssignments, yinyangCentroids, false,
+        true);
+
+    KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+        ThreeGroupYinyangKMeans> groupedYinyang;
+    arma::Row<size_t> groupedAssignments;
+    arma::mat groupedCentroids(centroids);
+    groupedYinyang.Cluster(dataset, k, groupedAssignments, groupedCentroids,
+        false, true);
+
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+    {
+      REQUIRE(assignments[i] == yinyangAssignments[i]);
+      REQUIRE(assignments[i] == groupedAssignments[i]);
+    }
+
+    for (size_t i = 0; i < centroids.n_elem; ++i)
+    {
+      REQUIRE(naiveCentroids[i] ==
+          Approx(yinyangCentroids[i]).epsilon(1e-7));
+      REQUIRE(naiveCentroids[i] ==
+          Approx(groupedCentroids[i]).epsilon(1e-7));
+    }
+  }
+}
+
+/**
+ * Make sure that out-of-core k-means, reading the dataset a chunk at a time,
+ * gives the same result as the in-memory algorithm, for each file format.
+ */
+TEST_CASE("ChunkedKMeansTest", "[KMeansTest]")
+{
+  // Values that are printed exactly in a CSV file.
+  arma::mat dataset = arma::round(100.0 * arma::randu<arma::mat>(4, 1000));
+  dataset.cols(0, 499) += 100.0;
+  REQUIRE(data::Save("test_chunked_kmeans.csv", dataset) == true);
+  REQUIRE(dataset.quiet_save("test_chunked_kmeans.bin", arma::arma_binary));
+
+  for (const std::string filename :
+      { "test_chunked_kmeans.csv", "test_chunked_kmeans.bin" })
+  {
+    math::RandomSeed(12);
+    KMeans<metric::EuclideanDistance, SampleInitialization, AllowEmptyClusters,
+        NaiveKMeans> km;
+    arma::Row<size_t> assignments;
+    arma::mat centroids;
+    km.Cluster(dataset, 6, assignments, centroids);
+
+    math::RandomSeed(12);
+    data::ChunkedMatrixReader reader(filename, 128);
+    ChunkedKMeans<> chunkedKm;
+    arma::Row<size_t> chunkedAssignments;
+    arma::mat chunkedCentroids;
+    chunkedKm.Cluster(reader, 6, chunkedAssignments, chunkedCentroids);
+
+    REQUIRE(chunkedAssignments.n_elem == dataset.n_cols);
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+      REQUIRE(assignments[i] == chunkedAssignments[i]);
+
+    // The in-memory sums may be rounded differently with several threads.
+    CheckMatrices(centroids, chunkedCentroids, 1e-10);
+  }
+
+  remove("test_chunked_kmeans.csv");
+  remove("test_chunked_kmeans.bin");
+}
+
 /**
  * Make sure that the sample initialization strategy successfully samples points
  * from the dataset.
@@ -733,3 +1028,44 @@ TEST_CASE("SampleInitializationTest", "[KMeansTest]")
     REQUIRE(j < dataset.n_cols);
   }
 }
+
+/**
+ * Make sure that k-means|| picks one centroid from each of several
+ * well-separated clusters, and that each centroid is a point of the dataset.
+ */
+TEST_CASE("KMeansParallelInitializationTest", "[KMeansTest]")
+{
+  // Ten tight, well-separated clusters.
+  const size_t clusters = 10;
+  arma::mat dataset(3, 100 * clusters, arma::fill::randu);
+  for (size_t c = 0; c < clusters; ++c)
+    dataset.cols(100 * c, 100 * c + 99) += 50.0 * c;
+
+  KMeansParallelInitialization kmpi(3, 2.0);
+  arma::mat centroids;
+  kmpi.Cluster(dataset, clusters, centroids);
+
+  REQUIRE(centroids.n_rows == 3);
+  REQUIRE(centroids.n_cols == clusters);
+
+  // Each cluster should own exactly one centroid.
+  arma::Col<size_t> owners(clusters, arma::fill::zeros);
+  for (size_t i = 0; i < clusters; ++i)
+  {
+    owners[(size_t) (centroids(0, i) / 50.0)]++;
+
+    size_t j;
+    for (j = 0; j < dataset.n_cols; ++j)
+    {
+      const double distance = metric::EuclideanDistance::Evaluate(
+          centroids.col(i), dataset.col(j));
+      if (distance < 1e-10)
+        break;
+    }
+
+    REQUIRE(j < dataset.n_cols);
+  }
+
+  for (size_t c = 0; c < clusters; ++c)
+    REQUIRE(owners[c] == 1);
+}
@@ -1814,3 +1814,399 @@ TEST_CASE("KNNSpillTreeSearchEnoughResults", "[KNNTest]")
   REQUIRE(arma::accu(distancesGreedy < 0.0 || distancesGreedy > std::sqrt(3.0))
       == 0);
 }
+
+/**
+ * Test that the parallel dual-tree search gives the same results as the naive
+ * search, for both the bichromatic and monochromatic cases and for a few
+ * different split depths.
+ */
+TEST_CASE("KNNParallelDualTreeVsNaive", "[KNNTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("test_data_3_1000.csv", dataset))
+    FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  KNN naive(dataset, NAIVE_MODE);
+
+  arma::Mat<size_t> neighborsNaive, neighborsNaiveMono;
+  arma::mat distancesNaive, distancesNaiveMono;
+  naive.Search(dataset, 15, neighborsNaive, distancesNaive);
+  naive.Search(15, neighborsNaiveMono, distancesNaiveMono);
+
+  for (size_t depth = 0; depth < 6; depth += 2)
+  {
+    KNN knn(dataset, PARALLEL_DUAL_TREE_MODE);
+    knn.ParallelDepth() = depth;
+
+    arma::Mat<size_t> neighborsTree, neighborsTreeMono;
+    arma::mat distancesTree, distancesTreeMono;
+    knn.Search(dataset, 15, neighborsTree, distancesTree);
+    knn.Search(15, neighborsTreeMono, distancesTreeMono);
+
+    for (size_t i = 0; i < neighborsTree.n_elem; ++i)
+    {
+      REQUIRE(neighborsTree[i] == neighborsNaive[i]);
+      REQUIRE(distancesTree[i] == Approx(distancesNaive[i]).epsilon(1e-7));
+      REQUIRE(neighborsTreeMono[i] == neighborsNaiveMono[i]);
+      REQUIRE(distancesTreeMono[i] ==
+          Approx(distancesNaiveMono[i]).epsilon(1e-7));
+    }
+  }
+}
+
+/**
+ * Make sure that a copy of NeighborSearchRules has its own candidate lists,
+ * while rules made with the SharedResultsTag constructor share them.
+ */
+TEST_CASE("KNNRulesCopyTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 10);
+  typedef KDTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+  typedef NeighborSearchRules<NearestNeighborSort, EuclideanDistance,
+      TreeType> RulesType;
+
+  EuclideanDistance metric;
+  RulesType rules(dataset, dataset, 1, metric, 0, true);
+
+  RulesType copy(rules);
+  copy.BaseCase(0, 1);
+  RulesType shared(rules, tree::SharedResultsTag());
+  shared.BaseCase(2, 3);
+
+  arma::Mat<size_t> neighbors, copyNeighbors;
+  arma::mat distances, copyDistances;
+  rules.GetResults(neighbors, distances);
+  copy.GetResults(copyNeighbors, copyDistances);
+
+  // The copy found a neighbor for point 0 only.
+  REQUIRE(copyNeighbors(0, 0) == 1);
+  REQUIRE(copyNeighbors(0, 2) == size_t() - 1);
+  // The original has the neighbor found through the shared rules only.
+  REQUIRE(neighbors(0, 0) == size_t() - 1);
+  REQUIRE(neighbors(0, 2) == 3);
+}
+
+/**
+ * Test that the parallel dual-tree search works with an R tree, which is not a
+ * binary tree, and with the cover tree, which falls back to the serial
+ * traversal.
+ */
+TEST_CASE("KNNParallelDualTreeOtherTreesTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 1000);
+
+  KNN naive(dataset, NAIVE_MODE);
+  arma::Mat<size_t> neighborsNaive;
+  arma::mat distancesNaive;
+  naive.Search(10, neighborsNaive, distancesNaive);
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, RTree>
+      rTreeSearch(dataset, PARALLEL_DUAL_TREE_MODE);
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      StandardCoverTree> coverTreeSearch(dataset, PARALLEL_DUAL_TREE_MODE);
+
+  arma::Mat<size_t> neighborsRTree, neighborsCoverTree;
+  arma::mat distancesRTree, distancesCoverTree;
+  rTreeSearch.Search(10, neighborsRTree, distancesRTree);
+  coverTreeSearch.Search(10, neighborsCoverTree, distancesCoverTree);
+
+  for (size_t i = 0; i < neighborsNaive.n_elem; ++i)
+  {
+    REQUIRE(neighborsRTree[i] == neighborsNaive[i]);
+    REQUIRE(distancesRTree[i] == Approx(distancesNaive[i]).epsilon(1e-7));
+    REQUIRE(neighborsCoverTree[i] == neighborsNaive[i]);
+    REQUIRE(distancesCoverTree[i] == Approx(distancesNaive[i]).epsilon(1e-7));
+  }
+}
+
+/**
+ * Make sure that the blocked base case computation gives exactly the same
+ * results as the naive search, even with large leaves, duplicated points, and
+ * the squared Euclidean distance.
+ */
+TEST_CASE("KNNBlockBaseCaseTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(10, 500);
+  // Add some duplicated points.
+  dataset = arma::join_rows(dataset, dataset.cols(0, 99));
+
+  typedef KDTree<SquaredEuclideanDistance,
+      NeighborSearchStat<NearestNeighborSort>, arma::mat> TreeType;
+  TreeType tree(dataset, 40);
+
+  NeighborSearch<NearestNeighborSort, SquaredEuclideanDistance, arma::mat,
+      KDTree> knn(std::move(tree));
+  NeighborSearch<NearestNeighborSort, SquaredEuclideanDistance, arma::mat,
+      KDTree> naive(knn.ReferenceSet(), NAIVE_MODE);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+  knn.Search(10, neighbors, distances);
+  naive.Search(10, naiveNeighbors, naiveDistances);
+
+  // The distances of any inserted point are computed exactly, so they should
+  // be exactly equal.
+  for (size_t i = 0; i < distances.n_elem; ++i)
+    REQUIRE(distances[i] == naiveDistances[i]);
+
+  // Now do the same with furthest neighbor search.
+  NeighborSearch<FurthestNeighborSort, SquaredEuclideanDistance, arma::mat,
+      KDTree> kfn(dataset);
+  NeighborSearch<FurthestNeighborSort, SquaredEuclideanDistance, arma::mat,
+      KDTree> naiveKfn(dataset, NAIVE_MODE);
+
+  kfn.Search(dataset, 5, neighbors, distances);
+  naiveKfn.Search(dataset, 5, naiveNeighbors, naiveDistances);
+
+  for (size_t i = 0; i < distances.n_elem; ++i)
+    REQUIRE(distances[i] == naiveDistances[i]);
+}
+
+/**
+ * Make sure that the leaves only cache the squared norms of their points when
+ * the metric is the (squared) Euclidean distance.
+ */
+TEST_CASE("KNNSquaredNormsOnlyForEuclideanTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 200);
+
+  KDTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> euclideanTree(dataset, 10);
+  KDTree<ManhattanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> manhattanTree(dataset, 10);
+
+  REQUIRE(UseDistanceBlock<EuclideanDistance,
+      decltype(euclideanTree)>::value);
+  REQUIRE(!UseDistanceBlock<ManhattanDistance,
+      decltype(manhattanTree)>::value);
+
+  // Check the leaves of both trees.
+  std::vector<decltype(&euclideanTree)> euclideanNodes(1, &euclideanTree);
+  while (!euclideanNodes.empty())
+  {
+    auto node = euclideanNodes.back();
+    euclideanNodes.pop_back();
+    const size_t expected = (node->NumChildren() == 0) ?
+        node->NumPoints() : 0;
+    REQUIRE(node->Stat().SquaredNorms().n_elem == expected);
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      euclideanNodes.push_back(&node->Child(i));
+  }
+
+  std::vector<decltype(&manhattanTree)> manhattanNodes(1, &manhattanTree);
+  while (!manhattanNodes.empty())
+  {
+    auto node = manhattanNodes.back();
+    manhattanNodes.pop_back();
+    REQUIRE(node->Stat().SquaredNorms().n_elem == 0);
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      manhattanNodes.push_back(&node->Child(i));
+  }
+}
+
+/**
+ * Make sure that searching with a packed tree gives the same results as the
+ * naive search.
+ */
+TEST_CASE("KNNPackedTreeTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 1000);
+
+  KNN naive(dataset, NAIVE_MODE);
+  arma::Mat<size_t> neighborsNaive;
+  arma::mat distancesNaive;
+  naive.Search(dataset, 10, neighborsNaive, distancesNaive);
+
+  for (size_t order = 0; order < 2; ++order)
+  {
+    KNN knn(dataset);
+    knn.ReferenceTree().Pack((order == 0) ? BREADTH_FIRST_ORDER :
+        VAN_EMDE_BOAS_ORDER);
+
+    arma::Mat<size_t> neighbors, neighborsSingle;
+    arma::mat distances, distancesSingle;
+    knn.Search(dataset, 10, neighbors, distances);
+
+    knn.SearchMode() = SINGLE_TREE_MODE;
+    knn.Search(dataset, 10, neighborsSingle, distancesSingle);
+
+    for (size_t i = 0; i < neighborsNaive.n_elem; ++i)
+    {
+      REQUIRE(neighbors[i] == neighborsNaive[i]);
+      REQUIRE(distances[i] == Approx(distancesNaive[i]).epsilon(1e-7));
+      REQUIRE(neighborsSingle[i] == neighborsNaive[i]);
+      REQUIRE(distancesSingle[i] == Approx(distancesNaive[i]).epsilon(1e-7));
+    }
+  }
+}
+
+/**
+ * Save NSModels in the memory-mapped format, load them again, and make sure
+ * that the results are the same.
+ */
+TEST_CASE("KNNModelMappedTest", "[KNNTest]")
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat queryData = arma::randu<arma::mat>(10, 50);
+  arma::mat referenceData = arma::randu<arma::mat>(10, 500);
+
+  KNNModel models[4];
+  models[0] = KNNModel(KNNModel::TreeTypes::KD_TREE, false);
+  models[1] = KNNModel(KNNModel::TreeTypes::KD_TREE, true);
+  models[2] = KNNModel(KNNModel::TreeTypes::RP_TREE, false);
+  models[3] = KNNModel(KNNModel::TreeTypes::MAX_RP_TREE, false);
+
+  for (size_t i = 0; i < 4; ++i)
+  {
+    arma::mat referenceCopy(referenceData);
+    models[i].BuildModel(std::move(referenceCopy), 15, DUAL_TREE_MODE);
+
+    arma::Mat<size_t> neighbors, neighborsMono;
+    arma::mat distances, distancesMono;
+    arma::mat queryCopy(queryData);
+    models[i].Search(std::move(queryCopy), 3, neighbors, distances);
+    models[i].Search(3, neighborsMono, distancesMono);
+
+    // Save and load through data::Save() and data::Load().
+    REQUIRE(data::Save("knn_model.mmap", "knn_model", models[i]));
+    KNNModel mapped;
+    REQUIRE(data::Load("knn_model.mmap", "knn_model", mapped));
+
+    REQUIRE(mapped.TreeType() == models[i].TreeType());
+    REQUIRE(mapped.RandomBasis() == models[i].RandomBasis());
+    REQUIRE(mapped.LeafSize() == 15);
+    REQUIRE(mapped.SearchMode() == DUAL_TREE_MODE);
+
+    arma::Mat<size_t> mappedNeighbors, mappedNeighborsMono;
+    arma::mat mappedDistances, mappedDistancesMono;
+    queryCopy = queryData;
+    mapped.Search(std::move(queryCopy), 3, mappedNeighbors, mappedDistances);
+    mapped.Search(3, mappedNeighborsMono, mappedDistancesMono);
+
+    CheckMatrices(neighbors, mappedNeighbors);
+    CheckMatrices(distances, mappedDistances);
+    CheckMatrices(neighborsMono, mappedNeighborsMono);
+    CheckMatrices(distancesMono, mappedDistancesMono);
+
+    remove("knn_model.mmap");
+  }
+
+  // Models with other trees can't be saved in the memory-mapped format, and
+  // models saved with one sort policy can't be loaded with another.
+  KNNModel coverTreeModel(KNNModel::TreeTypes::COVER_TREE);
+  arma::mat referenceCopy(referenceData);
+  coverTreeModel.BuildModel(std::move(referenceCopy), 15, DUAL_TREE_MODE);
+  REQUIRE_THROWS_AS(coverTreeModel.SaveMapped("knn_model.mmap"),
+      std::invalid_argument);
+
+  models[0].SaveMapped("knn_model.mmap");
+  NSModel<FurthestNeighborSort> kfnModel;
+  REQUIRE_THROWS_AS(kfnModel.LoadMapped("knn_model.mmap"), std::runtime_error);
+  remove("knn_model.mmap");
+}
+
+/**
+ * Make sure that LoadMapped() rejects a model whose header or mapping of the
+ * reference points is corrupt, and leaves the model unchanged.
+ */
+TEST_CASE("KNNMappedCorruptTest", "[KNNTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(5, 300);
+  KNN knn(referenceData);
+
+  std::ostringstream oss;
+  knn.SaveMapped(oss);
+  const std::string model = oss.str();
+
+  // The model starts with three 64-bit integers (the search mode, whether the
+  // tree needs to be reset, and the size of the mapping), followed by the
+  // mapping itself and then the tree.
+  std::vector<uint64_t> original(model.size() / sizeof(uint64_t));
+  std::memcpy(original.data(), model.data(), model.size());
+
+  KNN mapped(referenceData);
+  auto checkThrows = [&mapped](std::vector<uint64_t>& memory)
+  {
+    size_t offset = 0;
+    REQUIRE_THROWS_AS(mapped.LoadMapped((char*) memory.data(),
+        memory.size() * sizeof(uint64_t), offset), std::runtime_error);
+  };
+
+  // An invalid value for whether the tree needs to be reset.
+  std::vector<uint64_t> memory(original);
+  memory[1] = 2;
+  checkThrows(memory);
+
+  // A point index that is out of range.
+  memory = original;
+  memory[3 + 10] = 300;
+  checkThrows(memory);
+
+  // A mapping that is longer than the number of points.
+  memory.assign(original.begin(), original.begin() + 3 + 300);
+  memory[2] = 301;
+  memory.push_back(0);
+  memory.insert(memory.end(), original.begin() + 3 + 300, original.end());
+  checkThrows(memory);
+
+  // A truncated model.
+  memory.assign(original.begin(), original.begin() + original.size() / 2);
+  checkThrows(memory);
+
+  // The model still holds the original reference set.
+  REQUIRE(mapped.ReferenceSet().n_cols == 300);
+  arma::Mat<size_t> neighbors, mappedNeighbors;
+  arma::mat distances, mappedDistances;
+  knn.Search(3, neighbors, distances);
+  mapped.Search(3, mappedNeighbors, mappedDistances);
+  CheckMatrices(neighbors, mappedNeighbors);
+  CheckMatrices(distances, mappedDistances);
+}
+
+/**
+ * Make sure that the leaves of a memory-mapped model use the squared norms in
+ * the mapped file in place, and that the norms are right.
+ */
+TEST_CASE("KNNMappedSquaredNormsTest", "[KNNTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(5, 300);
+  KNN knn(referenceData);
+
+  {
+    std::ofstream ofs("knn_norms.mmap", std::ofstream::binary);
+    knn.SaveMapped(ofs);
+  }
+
+  data::MappedFile file("knn_norms.mmap");
+  size_t offset = 0;
+  KNN mapped;
+  mapped.LoadMapped(file.Data(), file.Size(), offset);
+
+  const double* begin = reinterpret_cast<const double*>(file.Data());
+  const double* end = begin + file.Size() / sizeof(double);
+  std::vector<const KNN::Tree*> nodes(1, &mapped.ReferenceTree());
+  while (!nodes.empty())
+  {
+    const KNN::Tree* node = nodes.back();
+    nodes.pop_back();
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      nodes.push_back(&node->Child(i));
+
+    if (node->NumChildren() != 0)
+      continue;
+
+    const arma::vec& norms = node->Stat().SquaredNorms();
+    REQUIRE(norms.n_elem == node->NumPoints());
+    REQUIRE(norms.memptr() >= begin);
+    REQUIRE(norms.memptr() + norms.n_elem <= end);
+    for (size_t i = 0; i < node->NumPoints(); ++i)
+    {
+      const double norm = arma::norm(node->Dataset().col(node->Point(i)), 2);
+      REQUIRE(norms[i] == Approx(norm * norm).epsilon(1e-10));
+    }
+  }
+
+  remove("knn_norms.mmap");
+}
@@ -13,6 +13,7 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/core/data/load_arff.hpp>
+#include <mlpack/core/data/chunked_matrix_reader.hpp>
 #include <mlpack/core/data/map_policies/missing_policy.hpp>
 #include "catch.hpp"
 #include "test_catch_tools.hpp"
@@ -2444,6 +2445,65 @@ TEST_CASE("LoadCSVNoTransposeTXTTest", "[LoadSaveTest]")
   remove("test.txt");
 }
 
+/**
+ * Make sure ChunkedMatrixReader reads CSV and binary files a chunk at a time,
+ * with and without prefetching, and can rewind.
+ */
+TEST_CASE("ChunkedMatrixReaderTest", "[LoadSaveTest]")
+{
+  arma::mat dataset = arma::round(1000.0 * arma::randu<arma::mat>(3, 25));
+  REQUIRE(data::Save("test_chunks.csv", dataset) == true);
+  REQUIRE(dataset.quiet_save("test_chunks.bin", arma::arma_binary) == true);
+
+  for (const std::string filename : { "test_chunks.csv", "test_chunks.bin" })
+  {
+    for (const bool prefetch : { true, false })
+    {
+      data::ChunkedMatrixReader reader(filename, 10, prefetch);
+      REQUIRE(reader.Dimensionality() == 3);
+      REQUIRE(reader.Points() == 25);
+
+      // Make two passes.
+      for (size_t pass = 0; pass < 2; ++pass)
+      {
+        arma::mat chunk;
+        size_t offset = 0;
+        while (reader.NextChunk(chunk))
+        {
+          REQUIRE(chunk.n_cols == std::min((size_t) 10, 25 - offset));
+          CheckMatrices(chunk,
+              dataset.cols(offset, offset + chunk.n_cols - 1));
+          offset += chunk.n_cols;
+        }
+
+        REQUIRE(offset == 25);
+        reader.Rewind();
+      }
+    }
+  }
+
+  remove("test_chunks.csv");
+  remove("test_chunks.bin");
+}
+
+/**
+ * Make sure ChunkedMatrixReader reports malformed lines.
+ */
+TEST_CASE("ChunkedMatrixReaderBadLineTest", "[LoadSaveTest]")
+{
+  fstream f;
+  f.open("test_chunks.csv", fstream::out);
+  f << "1, 2, 3" << endl;
+  f << "4, 5" << endl;
+  f.close();
+
+  data::ChunkedMatrixReader reader("test_chunks.csv", 10);
+  arma::mat chunk;
+  REQUIRE_THROWS_AS(reader.NextChunk(chunk), std::runtime_error);
+
+  remove("test_chunks.csv");
+}
+
 /**
  * Make sure DatasetMapper properly unmaps from non-unique strings.
  */
@@ -644,6 +644,76 @@ TEST_CASE("LSHTrainTest", "[LSHTest]")
   REQUIRE(distances.n_rows == 3);
 }
 
+/**
+ * Make sure that no point is dropped from the second hash table when there is
+ * no maximum bucket size, and that buckets are capped when there is one.
+ */
+TEST_CASE("LSHBucketTest", "[LSHTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(4, 500);
+
+  // The buckets are capped by default.
+  LSHSearch<> defaultLsh(referenceData, 3, 6, 0.5, 101);
+  REQUIRE(defaultLsh.BucketSize() == 500);
+
+  // With a small second hash table, many points share a bucket.
+  LSHSearch<> lsh(referenceData, 3, 6, 0.5, 101, 0);
+
+  const arma::Col<size_t>& offsets = lsh.BucketOffsets();
+  REQUIRE(offsets.n_elem == 102);
+  REQUIRE(offsets[0] == 0);
+  REQUIRE(offsets[101] == lsh.BucketContents().n_elem);
+  REQUIRE(lsh.BucketContents().n_elem == 6 * 500);
+
+  // Each point must appear once per table.
+  arma::Col<size_t> counts(500, arma::fill::zeros);
+  for (size_t i = 0; i < lsh.BucketContents().n_elem; ++i)
+    ++counts[lsh.BucketContents()[i]];
+  REQUIRE(arma::all(counts == 6));
+
+  LSHSearch<> cappedLsh(referenceData, 3, 6, 0.5, 101, 4);
+  REQUIRE(arma::max(arma::diff(cappedLsh.BucketOffsets())) <= 4);
+  REQUIRE(cappedLsh.BucketContents().n_elem < 6 * 500);
+}
+
+/**
+ * Inserting points into a trained model must give the same search results as
+ * training on all the points with the same hash functions.
+ */
+TEST_CASE("LSHInsertTest", "[LSHTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(5, 600);
+  arma::mat queryData = arma::randu<arma::mat>(5, 100);
+  const arma::cube projections = arma::randn<arma::cube>(5, 4, 8);
+
+  math::RandomSeed(42);
+  LSHSearch<> lsh(referenceData, projections, 1.0, 997);
+
+  math::RandomSeed(42);
+  LSHSearch<> insertLsh(referenceData.cols(0, 399), projections, 1.0, 997);
+  insertLsh.Insert(referenceData.cols(400, 599));
+
+  REQUIRE(insertLsh.ReferenceSet().n_cols == 600);
+  CheckMatrices(lsh.ReferenceSet(), insertLsh.ReferenceSet());
+  CheckMatrices(lsh.BucketOffsets(), insertLsh.BucketOffsets());
+
+  arma::Mat<size_t> neighbors, insertNeighbors;
+  arma::mat distances, insertDistances;
+  lsh.Search(queryData, 5, neighbors, distances);
+  insertLsh.Search(queryData, 5, insertNeighbors, insertDistances);
+
+  CheckMatrices(neighbors, insertNeighbors);
+  CheckMatrices(distances, insertDistances);
+
+  // Inserting points of the wrong dimensionality, or into an untrained model,
+  // must fail.
+  arma::mat wrongData = arma::randu<arma::mat>(4, 10);
+  REQUIRE_THROWS_AS(insertLsh.Insert(wrongData), std::invalid_argument);
+
+  LSHSearch<> emptyLsh;
+  REQUIRE_THROWS_AS(emptyLsh.Insert(queryData), std::invalid_argument);
+}
+
 /**
  * Test: this verifies ComputeRecall works correctly by providing two identical
  * vectors and requiring that Recall is equal to 1.
@@ -0,0 +1,186 @@
+/**
+ * @file tests/main_tests/gradient_boosting_test.cpp
+ *
+ * Test mlpackMain() of gradient_boosting_main.cpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#define BINDING_TYPE BINDING_TYPE_TEST
+
+#include <mlpack/core.hpp>
+static const std::string testName = "GradientBoosting";
+
+#include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/methods/gradient_boosting/gradient_boosting_main.cpp>
+#include "test_helper.hpp"
+
+#include "../catch.hpp"
+#include "../test_catch_tools.hpp"
+
+using namespace mlpack;
+
+struct GradientBoostingTestFixture
+{
+ public:
+  GradientBoostingTestFixture()
+  {
+    // Cache in the options for this program.
+    IO::RestoreSettings(testName);
+  }
+
+  ~GradientBoostingTestFixture()
+  {
+    // Clear the settings.
+    bindings::tests::CleanMemory();
+    IO::ClearSettings();
+  }
+};
+
+/**
+ * Check that a classification model gives a prediction and class
+ * probabilities for each test point.
+ */
+TEST_CASE_METHOD(GradientBoostingTestFixture,
+                 "GradientBoostingClassificationOutputDimensionTest",
+                 "[GradientBoostingMainTest][BindingTests]")
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    FAIL("Cannot load train dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load labels for vc2_labels.txt");
+
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData))
+    FAIL("Cannot load test dataset vc2_test.csv!");
+
+  size_t testSize = testData.n_cols;
+
+  SetInputParam("training", std::move(inputData));
+  SetInputParam("labels", std::move(labels));
+  SetInputParam("test", std::move(testData));
+  SetInputParam("num_iterations", (int) 10);
+
+  mlpackMain();
+
+  REQUIRE(IO::GetParam<arma::Row<size_t>>("predictions").n_cols == testSize);
+  REQUIRE(IO::GetParam<arma::Row<size_t>>("predictions").n_rows == 1);
+  REQUIRE(IO::GetParam<arma::mat>("probabilities").n_cols == testSize);
+  REQUIRE(IO::GetParam<arma::mat>("probabilities").n_rows == 3);
+}
+
+/**
+ * Check that a regression model gives a response for each test point.
+ */
+TEST_CASE_METHOD(GradientBoostingTestFixture,
+                 "GradientBoostingRegressionOutputDimensionTest",
+                 "[GradientBoostingMainTest][BindingTests]")
+{
+  arma::mat inputData(3, 200, arma::fill::randu);
+  arma::rowvec responses = arma::sin(4.0 * inputData.row(0));
+  arma::mat testData(3, 50, arma::fill::randu);
+
+  SetInputParam("training", std::move(inputData));
+  SetInputParam("responses", std::move(responses));
+  SetInputParam("test", std::move(testData));
+  SetInputParam("num_iterations", (int) 10);
+
+  mlpackMain();
+
+  REQUIRE(IO::GetParam<arma::rowvec>("predicted_responses").n_cols == 50);
+  REQUIRE(IO::GetParam<arma::rowvec>("predicted_responses").n_rows == 1);
+}
+
+/**
+ * Make sure that a saved model gives the same predictions.
+ */
+TEST_CASE_METHOD(GradientBoostingTestFixture, "GradientBoostingModelReuseTest",
+                 "[GradientBoostingMainTest][BindingTests]")
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    FAIL("Cannot load train dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load labels for vc2_labels.txt");
+
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData))
+    FAIL("Cannot load test dataset vc2_test.csv!");
+
+  SetInputParam("training", std::move(inputData));
+  SetInputParam("labels", std::move(labels));
+  SetInputParam("test", testData);
+  SetInputParam("num_iterations", (int) 10);
+
+  mlpackMain();
+
+  arma::Row<size_t> predictions =
+      std::move(IO::GetParam<arma::Row<size_t>>("predictions"));
+  arma::mat probabilities =
+      std::move(IO::GetParam<arma::mat>("probabilities"));
+
+  // Reset passed parameters.
+  IO::GetSingleton().Parameters()["training"].wasPassed = false;
+  IO::GetSingleton().Parameters()["labels"].wasPassed = false;
+  IO::GetSingleton().Parameters()["test"].wasPassed = false;
+
+  SetInputParam("test", std::move(testData));
+  SetInputParam("input_model",
+                IO::GetParam<GradientBoostingModel*>("output_model"));
+
+  mlpackMain();
+
+  CheckMatrices(predictions,
+      IO::GetParam<arma::Row<size_t>>("predictions"));
+  CheckMatrices(probabilities, IO::GetParam<arma::mat>("probabilities"));
+}
+
+/**
+ * Make sure that passing both labels and responses throws.
+ */
+TEST_CASE_METHOD(GradientBoostingTestFixture,
+                 "GradientBoostingLabelsAndResponsesTest",
+                 "[GradientBoostingMainTest][BindingTests]")
+{
+  arma::mat inputData(3, 20, arma::fill::randu);
+  arma::Row<size_t> labels(20, arma::fill::zeros);
+  labels.tail(10).fill(1);
+  arma::rowvec responses(20, arma::fill::randu);
+
+  SetInputParam("training", std::move(inputData));
+  SetInputParam("labels", std::move(labels));
+  SetInputParam("responses", std::move(responses));
+
+  REQUIRE_THROWS_AS(mlpackMain(), std::runtime_error);
+}
+
+/**
+ * Make sure that invalid numbers of iterations and learning rates throw.
+ */
+TEST_CASE_METHOD(GradientBoostingTestFixture,
+                 "GradientBoostingInvalidParametersTest",
+                 "[GradientBoostingMainTest][BindingTests]")
+{
+  arma::mat inputData(3, 20, arma::fill::randu);
+  arma::rowvec responses(20, arma::fill::randu);
+
+  SetInputParam("training", inputData);
+  SetInputParam("responses", responses);
+  SetInputParam("num_iterations", (int) 0);
+
+  REQUIRE_THROWS_AS(mlpackMain(), std::runtime_error);
+
+  SetInputParam("training", std::move(inputData));
+  SetInputParam("responses", std::move(responses));
+  SetInputParam("num_iterations", (int) 10);
+  SetInputParam("learning_rate", -0.1);
+
+  REQUIRE_THROWS_AS(mlpackMain(), std::runtime_error);
+}
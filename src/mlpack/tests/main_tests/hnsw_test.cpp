@@ -0,0 +1,203 @@
+/**
+ * @file tests/main_tests/hnsw_test.cpp
+ *
+ * Test mlpackMain() of hnsw_main.cpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <string>
+
+#define BINDING_TYPE BINDING_TYPE_TEST
+static const std::string testName = "HNSW";
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include "test_helper.hpp"
+#include <mlpack/methods/hnsw/hnsw_main.cpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+#include "../catch.hpp"
+#include "../test_catch_tools.hpp"
+
+using namespace mlpack;
+
+struct HNSWTestFixture
+{
+ public:
+  HNSWTestFixture()
+  {
+    // Cache in the options for this program.
+    IO::RestoreSettings(testName);
+  }
+
+  ~HNSWTestFixture()
+  {
+    // Clear the settings.
+    bindings::tests::CleanMemory();
+    IO::ClearSettings();
+  }
+};
+
+/**
+ * Check that output neighbors and distances have valid dimensions.
+ */
+TEST_CASE_METHOD(HNSWTestFixture, "HNSWOutputDimensionTest",
+                 "[HNSWMainTest][BindingTests]")
+{
+  arma::mat reference = arma::randu<arma::mat>(5, 100);
+
+  SetInputParam("reference", std::move(reference));
+  SetInputParam("k", (int) 6);
+
+  mlpackMain();
+
+  // Check the neighbors matrix has 6 points for each of the 100 input points.
+  REQUIRE(IO::GetParam<arma::Mat<size_t>>("neighbors").n_rows == 6);
+  REQUIRE(IO::GetParam<arma::Mat<size_t>>("neighbors").n_cols == 100);
+
+  // Check the distances matrix has 6 points for each of the 100 input points.
+  REQUIRE(IO::GetParam<arma::mat>("distances").n_rows == 6);
+  REQUIRE(IO::GetParam<arma::mat>("distances").n_cols == 100);
+}
+
+/**
+ * Ensure that k, max_connections, ef_construction and ef are always positive.
+ */
+TEST_CASE_METHOD(HNSWTestFixture, "HNSWParamValidityTest",
+                 "[HNSWMainTest][BindingTests]")
+{
+  arma::mat reference = arma::randu<arma::mat>(5, 100);
+
+  // Test for max_connections.
+  SetInputParam("reference", reference);
+  SetInputParam("k", (int) 6);
+  SetInputParam("max_connections", (int) 0);
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+
+  // Test for ef_construction.
+  SetInputParam("max_connections", (int) 16);
+  SetInputParam("ef_construction", (int) -1);
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+
+  // Test for ef.
+  SetInputParam("ef_construction", (int) 200);
+  SetInputParam("ef", (int) 0);
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+
+  // Test for number of nearest neighbors.
+  SetInputParam("ef", (int) 50);
+  SetInputParam("k", (int) -2);
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Make sure only one of reference data or pre-trained model is passed.
+ */
+TEST_CASE_METHOD(HNSWTestFixture, "HNSWModelValidityTest",
+                 "[HNSWMainTest][BindingTests]")
+{
+  arma::mat reference = arma::randu<arma::mat>(5, 100);
+
+  SetInputParam("reference", std::move(reference));
+  SetInputParam("k", (int) 6);
+
+  mlpackMain();
+
+  SetInputParam("input_model", IO::GetParam<HNSWSearch<>*>("output_model"));
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Check that the neighbors found on well-separated data match the true
+ * neighbors, and that the recall is computed without complaint.
+ */
+TEST_CASE_METHOD(HNSWTestFixture, "HNSWTrueNeighborsTest",
+                 "[HNSWMainTest][BindingTests]")
+{
+  arma::mat reference = arma::randu<arma::mat>(3, 200);
+
+  NeighborSearch<NearestNeighborSort> knn(reference);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(5, trueNeighbors, trueDistances);
+
+  SetInputParam("reference", std::move(reference));
+  SetInputParam("true_neighbors", trueNeighbors);
+  SetInputParam("k", (int) 5);
+  SetInputParam("ef", (int) 100);
+
+  mlpackMain();
+
+  const arma::Mat<size_t>& neighbors =
+      IO::GetParam<arma::Mat<size_t>>("neighbors");
+  REQUIRE(HNSWSearch<>::ComputeRecall(neighbors, trueNeighbors) >= 0.95);
+}
+
+/**
+ * Check that saved model can be reused again.
+ */
+TEST_CASE_METHOD(HNSWTestFixture, "HNSWModelReuseTest",
+                 "[HNSWMainTest][BindingTests]")
+{
+  arma::mat reference = arma::randu<arma::mat>(5, 100);
+  arma::mat query = arma::randu<arma::mat>(5, 40);
+
+  SetInputParam("reference", std::move(reference));
+  SetInputParam("query", query);
+  SetInputParam("k", (int) 6);
+
+  mlpackMain();
+
+  arma::Mat<size_t> neighbors = IO::GetParam<arma::Mat<size_t>>("neighbors");
+  arma::mat distances = IO::GetParam<arma::mat>("distances");
+
+  IO::GetSingleton().Parameters()["reference"].wasPassed = false;
+
+  SetInputParam("input_model", IO::GetParam<HNSWSearch<>*>("output_model"));
+  SetInputParam("query", std::move(query));
+
+  mlpackMain();
+
+  // Check that initial query outputs and final outputs using saved model are
+  // same.
+  CheckMatrices(neighbors, IO::GetParam<arma::Mat<size_t>>("neighbors"));
+  CheckMatrices(distances, IO::GetParam<arma::mat>("distances"));
+}
+
+/**
+ * Make sure true_neighbors have valid dimensions.
+ */
+TEST_CASE_METHOD(HNSWTestFixture, "HNSWModelTrueNeighborsDimTest",
+                 "[HNSWMainTest][BindingTests]")
+{
+  arma::mat reference = arma::randu<arma::mat>(5, 100);
+
+  // Initalize trueNeighbors with invalid dimensions.
+  arma::Mat<size_t> trueNeighbors = arma::randu<arma::Mat<size_t>>(7, 100);
+
+  SetInputParam("reference", std::move(reference));
+  SetInputParam("true_neighbors", std::move(trueNeighbors));
+  SetInputParam("k", (int) 6);
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
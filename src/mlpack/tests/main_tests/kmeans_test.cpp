@@ -131,6 +131,30 @@ TEST_CASE_METHOD(KmTestFixture, "NonNegativePercentageTest",
 }
 
 
+/**
+ * Checking that the oversampling factor is positive when --kmeans_parallel is
+ * specified.
+ */
+TEST_CASE_METHOD(KmTestFixture, "KMeansParallelOversamplingTest",
+                 "[KmeansMainTest][BindingTests]")
+{
+  int c = 2;
+  double O = 0.0;
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    FAIL("Unable to load train dataset vc2.csv!");
+
+  SetInputParam("input", std::move(inputData));
+  SetInputParam("kmeans_parallel", true);
+  SetInputParam("clusters", c);
+  SetInputParam("oversampling", O);     // Invalid
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+
 /**
  * Checking that size and dimensionality of prediction is correct.
  */
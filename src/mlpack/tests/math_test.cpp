@@ -10,6 +10,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/core/math/clamp.hpp>
+#include <mlpack/core/math/log_add.hpp>
 #include <mlpack/core/math/random.hpp>
 #include <mlpack/core/math/range.hpp>
 #include "catch.hpp"
@@ -1006,3 +1007,32 @@ TEST_CASE("InplaceSparseShuffleWeightsTest", "[MathTest]")
     REQUIRE(weightCounts[i] == 1);
   }
 }
+
+/**
+ * Make sure element-wise log-addition matches scalar log-addition, including
+ * for -inf values.
+ */
+TEST_CASE("LogAddInPlaceTest", "[MathTest]")
+{
+  const double negInf = -std::numeric_limits<double>::infinity();
+
+  arma::mat x = arma::log(arma::randu<arma::mat>(5, 4));
+  arma::mat y = arma::log(arma::randu<arma::mat>(5, 4));
+  x(0, 0) = negInf;
+  y(1, 1) = negInf;
+  x(2, 2) = negInf;
+  y(2, 2) = negInf;
+  y(3, 3) = -1000.0;
+
+  arma::mat result(x);
+  LogAddInPlace(result, y);
+
+  for (size_t i = 0; i < x.n_elem; ++i)
+  {
+    const double expected = LogAdd(x[i], y[i]);
+    if (std::isfinite(expected))
+      REQUIRE(result[i] == Approx(expected).epsilon(1e-12));
+    else
+      REQUIRE(result[i] == expected);
+  }
+}
@@ -123,6 +123,42 @@ TEST_CASE("MappingsTest", "[OctreeTest]")
   }
 }
 
+/**
+ * Build a large octree, whose children are built in parallel and whose nodes
+ * are split in parallel, and make sure that the mappings are correct and the
+ * same as with only one thread.
+ */
+TEST_CASE("ParallelBuildMappingsTest", "[OctreeTest]")
+{
+  arma::mat dataset(3, 40000, arma::fill::randu);
+  std::vector<size_t> oldFromNew;
+  Octree<> t(dataset, oldFromNew, 10);
+
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+    REQUIRE(arma::approx_equal(dataset.col(oldFromNew[i]), t.Dataset().col(i),
+        "absdiff", 0.0));
+
+  #ifdef HAS_OPENMP
+  const int numThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  #endif
+
+  std::vector<size_t> serialOldFromNew;
+  Octree<> serialTree(dataset, serialOldFromNew, 10);
+
+  #ifdef HAS_OPENMP
+  omp_set_num_threads(numThreads);
+  #endif
+
+  REQUIRE(oldFromNew == serialOldFromNew);
+  REQUIRE(t.NumChildren() == serialTree.NumChildren());
+  for (size_t i = 0; i < t.NumChildren(); ++i)
+  {
+    REQUIRE(t.Child(i).Begin() == serialTree.Child(i).Begin());
+    REQUIRE(t.Child(i).Count() == serialTree.Child(i).Count());
+  }
+}
+
 /**
  * Check that the reverse mappings are correct too.
  */
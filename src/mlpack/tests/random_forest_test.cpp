@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/random_forest/random_forest.hpp>
+#include <mlpack/methods/random_forest/flat_forest.hpp>
 #include <mlpack/methods/decision_tree/random_dimension_select.hpp>
 
 #include "serialization.hpp"
@@ -94,6 +95,61 @@ TEST_CASE("BootstrapWeightsTest", "[RandomForestTest]")
   }
 }
 
+/**
+ * Make sure a bootstrap view samples the same points as a bootstrapped copy,
+ * and that a decision tree trained on it is the same.
+ */
+TEST_CASE("BootstrapViewTest", "[RandomForestTest]")
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+  arma::rowvec weights(labels.n_elem, arma::fill::randu);
+  const arma::mat originalDataset(dataset);
+
+  arma::mat bootstrapDataset;
+  arma::Row<size_t> bootstrapLabels;
+  arma::rowvec bootstrapWeights;
+  math::RandomSeed(42);
+  Bootstrap<true>(dataset, labels, weights, bootstrapDataset,
+      bootstrapLabels, bootstrapWeights);
+
+  BootstrapView<arma::mat> bootstrapView;
+  arma::Row<size_t> viewLabels;
+  arma::rowvec viewWeights;
+  math::RandomSeed(42);
+  Bootstrap<true>(dataset, labels, weights, bootstrapView, viewLabels,
+      viewWeights);
+
+  REQUIRE(bootstrapView.n_rows == bootstrapDataset.n_rows);
+  REQUIRE(bootstrapView.n_cols == bootstrapDataset.n_cols);
+  for (size_t i = 0; i < bootstrapDataset.n_cols; ++i)
+  {
+    for (size_t j = 0; j < bootstrapDataset.n_rows; ++j)
+      REQUIRE(bootstrapView(j, i) == bootstrapDataset(j, i));
+
+    REQUIRE(viewLabels[i] == bootstrapLabels[i]);
+    REQUIRE(viewWeights[i] == bootstrapWeights[i]);
+  }
+
+  // Train a tree on each; they should be the same, and the dataset should not
+  // be modified.
+  DecisionTree<> tree(bootstrapDataset, bootstrapLabels, 3,
+      bootstrapWeights, 5);
+  DecisionTree<> viewTree(bootstrapView, viewLabels, 3, viewWeights, 5);
+
+  CheckMatrices(dataset, originalDataset);
+
+  arma::Row<size_t> predictions, viewPredictions;
+  arma::mat probabilities, viewProbabilities;
+  tree.Classify(dataset, predictions, probabilities);
+  viewTree.Classify(dataset, viewPredictions, viewProbabilities);
+
+  CheckMatrices(predictions, viewPredictions);
+  CheckMatrices(probabilities, viewProbabilities);
+}
+
 /**
  * Make sure an empty forest cannot predict.
  */
@@ -150,6 +206,43 @@ TEST_CASE("UnweightedNumericLearningTest", "[RandomForestTest]")
   REQUIRE(rfCorrect >= size_t(0.7 * testDataset.n_cols));
 }
 
+/**
+ * Test unweighted numeric learning with histogram splits, making sure that we
+ * get performance similar to that of the sorting splitter.
+ */
+TEST_CASE("HistogramSplitNumericLearningTest", "[RandomForestTest]")
+{
+  // Load the vc2 dataset.
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  // Build a random forest with each splitter.
+  RandomForest<> rf(dataset, labels, 3, 20 /* 20 trees */, 1, 1e-7);
+  RandomForest<GiniGain, MultipleRandomDimensionSelect, HistogramNumericSplit>
+      hrf(dataset, labels, 3, 20 /* 20 trees */, 1, 1e-7);
+
+  // Get performance statistics on test data.
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+  arma::Row<size_t> testLabels;
+  data::Load("vc2_test_labels.txt", testLabels);
+
+  arma::Row<size_t> rfPredictions;
+  arma::Row<size_t> hrfPredictions;
+
+  rf.Classify(testDataset, rfPredictions);
+  hrf.Classify(testDataset, hrfPredictions);
+
+  // Calculate the number of correct points.
+  size_t rfCorrect = arma::accu(rfPredictions == testLabels);
+  size_t hrfCorrect = arma::accu(hrfPredictions == testLabels);
+
+  REQUIRE(hrfCorrect >= rfCorrect * 0.9);
+  REQUIRE(hrfCorrect >= size_t(0.7 * testDataset.n_cols));
+}
+
 /**
  * Test weighted numeric learning, making sure that we get better performance
  * than a single decision tree.
@@ -484,3 +577,141 @@ TEST_CASE("DifferentTreesTest", "[RandomForestTest]")
 
   REQUIRE(success == true);
 }
+
+/**
+ * Make sure a flattened random forest gives the same results as the forest on
+ * numeric data.
+ */
+TEST_CASE("FlatForestNumericTest", "[RandomForestTest]")
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+
+  RandomForest<> rf(dataset, labels, 3, 20 /* 20 trees */, 1, 1e-7);
+  FlatForest<> flat(rf);
+
+  REQUIRE(flat.NumTrees() == 20);
+  REQUIRE(flat.NumClasses() == 3);
+
+  arma::Row<size_t> predictions, flatPredictions;
+  arma::mat probabilities, flatProbabilities;
+  rf.Classify(testDataset, predictions, probabilities);
+  flat.Classify(testDataset, flatPredictions, flatProbabilities);
+
+  CheckMatrices(predictions, flatPredictions);
+  CheckMatrices(probabilities, flatProbabilities);
+
+  // Check the single-point overloads too.
+  for (size_t i = 0; i < testDataset.n_cols; ++i)
+  {
+    size_t prediction;
+    arma::vec pointProbabilities;
+    flat.Classify(testDataset.col(i), prediction, pointProbabilities);
+
+    REQUIRE(prediction == predictions[i]);
+    REQUIRE(flat.Classify(testDataset.col(i)) == predictions[i]);
+    CheckMatrices(pointProbabilities, probabilities.col(i));
+  }
+}
+
+/**
+ * Make sure a flattened random forest gives the same results as the forest on
+ * categorical data.
+ */
+TEST_CASE("FlatForestCategoricalTest", "[RandomForestTest]")
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  RandomForest<> rf(d, di, l, 5, 10 /* 10 trees */, 1, 1e-7, 0,
+      MultipleRandomDimensionSelect(4));
+  FlatForest<> flat(rf);
+
+  arma::Row<size_t> predictions, flatPredictions;
+  arma::mat probabilities, flatProbabilities;
+  rf.Classify(d, predictions, probabilities);
+  flat.Classify(d, flatPredictions, flatProbabilities);
+
+  CheckMatrices(predictions, flatPredictions);
+  CheckMatrices(probabilities, flatProbabilities);
+}
+
+/**
+ * Make sure a flattened decision tree gives the same results as the tree.
+ */
+TEST_CASE("FlatForestDecisionTreeTest", "[RandomForestTest]")
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+
+  DecisionTree<> dt(dataset, labels, 3, 5);
+  FlatForest<> flat(dt);
+
+  REQUIRE(flat.NumTrees() == 1);
+
+  arma::Row<size_t> predictions, flatPredictions;
+  arma::mat probabilities, flatProbabilities;
+  dt.Classify(testDataset, predictions, probabilities);
+  flat.Classify(testDataset, flatPredictions, flatProbabilities);
+
+  CheckMatrices(predictions, flatPredictions);
+  CheckMatrices(probabilities, flatProbabilities);
+}
+
+/**
+ * Make sure an empty flattened forest cannot predict, and that an untrained
+ * forest cannot be flattened.
+ */
+TEST_CASE("FlatForestEmptyTest", "[RandomForestTest]")
+{
+  FlatForest<> flat;
+
+  arma::mat points(10, 100, arma::fill::randu);
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  REQUIRE_THROWS_AS(flat.Classify(points, predictions), std::invalid_argument);
+  REQUIRE_THROWS_AS(flat.Classify(points.col(0)), std::invalid_argument);
+  REQUIRE_THROWS_AS(flat.Classify(points, predictions, probabilities),
+      std::invalid_argument);
+
+  RandomForest<> rf;
+  REQUIRE_THROWS_AS(FlatForest<>(rf), std::invalid_argument);
+}
+
+/**
+ * Make sure a flattened forest can be serialized.
+ */
+TEST_CASE("FlatForestSerializationTest", "[RandomForestTest]")
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  RandomForest<> rf(dataset, labels, 3, 10 /* 10 trees */, 1, 1e-7);
+  FlatForest<> flat(rf);
+
+  FlatForest<> xmlFlat, jsonFlat, binaryFlat;
+  SerializeObjectAll(flat, xmlFlat, jsonFlat, binaryFlat);
+
+  arma::Row<size_t> predictions, xmlPredictions, jsonPredictions,
+      binaryPredictions;
+  flat.Classify(dataset, predictions);
+  xmlFlat.Classify(dataset, xmlPredictions);
+  jsonFlat.Classify(dataset, jsonPredictions);
+  binaryFlat.Classify(dataset, binaryPredictions);
+
+  CheckMatrices(predictions, xmlPredictions);
+  CheckMatrices(predictions, jsonPredictions);
+  CheckMatrices(predictions, binaryPredictions);
+}
@@ -1436,6 +1436,62 @@ TEST_CASE("RSModelMonochromaticTest", "[RangeSearchTest]")
   }
 }
 
+/**
+ * Save RSModels in the memory-mapped format, load them again, and make sure
+ * that the results are the same.
+ */
+TEST_CASE("RSModelMappedTest", "[RangeSearchTest]")
+{
+  arma::mat queryData = arma::randu<arma::mat>(10, 50);
+  arma::mat referenceData = arma::randu<arma::mat>(10, 200);
+
+  RSModel models[3];
+  models[0] = RSModel(RSModel::TreeTypes::KD_TREE, false);
+  models[1] = RSModel(RSModel::TreeTypes::RP_TREE, true);
+  models[2] = RSModel(RSModel::TreeTypes::MAX_RP_TREE, false);
+
+  for (size_t i = 0; i < 3; ++i)
+  {
+    arma::mat referenceCopy(referenceData);
+    models[i].BuildModel(std::move(referenceCopy), 5, false, false);
+
+    vector<vector<size_t>> neighbors;
+    vector<vector<double>> distances;
+    arma::mat queryCopy(queryData);
+    models[i].Search(std::move(queryCopy), math::Range(0.25, 0.5), neighbors,
+        distances);
+
+    REQUIRE(data::Save("rs_model.mmap", "rs_model", models[i]));
+    RSModel mapped;
+    REQUIRE(data::Load("rs_model.mmap", "rs_model", mapped));
+    REQUIRE(mapped.TreeType() == models[i].TreeType());
+    REQUIRE(mapped.RandomBasis() == models[i].RandomBasis());
+
+    vector<vector<size_t>> mappedNeighbors;
+    vector<vector<double>> mappedDistances;
+    queryCopy = queryData;
+    mapped.Search(std::move(queryCopy), math::Range(0.25, 0.5),
+        mappedNeighbors, mappedDistances);
+
+    vector<vector<pair<double, size_t>>> sorted, mappedSorted;
+    SortResults(neighbors, distances, sorted);
+    SortResults(mappedNeighbors, mappedDistances, mappedSorted);
+
+    REQUIRE(sorted.size() == mappedSorted.size());
+    for (size_t k = 0; k < sorted.size(); ++k)
+    {
+      REQUIRE(sorted[k].size() == mappedSorted[k].size());
+      for (size_t l = 0; l < sorted[k].size(); ++l)
+      {
+        REQUIRE(sorted[k][l].second == mappedSorted[k][l].second);
+        REQUIRE(sorted[k][l].first == mappedSorted[k][l].first);
+      }
+    }
+
+    remove("rs_model.mmap");
+  }
+}
+
 /**
  * Make sure that the neighborPtr matrix isn't accidentally deleted.
  * See issue #478.
@@ -1359,3 +1359,199 @@ TEST_CASE("RectangleTreeMoveDatasetTest", "[RectangleTreeTraitsTest]")
   REQUIRE(tree.Dataset().n_rows == 3);
   REQUIRE(tree.Dataset().n_cols == 1000);
 }
+
+/**
+ * A function to check that a bulk-loaded tree is as full as it should be: every
+ * leaf is at least half full, and every node except the root has at least half
+ * the maximum number of children.
+ */
+template<typename TreeType>
+void CheckBulkLoadFills(const TreeType& tree)
+{
+  if (tree.IsLeaf())
+  {
+    REQUIRE((2 * tree.Count() >= tree.MaxLeafSize() || tree.Parent() == NULL));
+    return;
+  }
+
+  REQUIRE((2 * tree.NumChildren() >= tree.MaxNumChildren() ||
+      tree.Parent() == NULL));
+  for (size_t i = 0; i < tree.NumChildren(); ++i)
+    CheckBulkLoadFills(tree.Child(i));
+}
+
+/**
+ * Bulk-load a tree of the given type with the given method, check that it is
+ * valid, balanced and full, and check that nearest neighbor search with it gives
+ * the same results as a naive search.
+ */
+template<template<typename, typename, typename> class TreeType>
+void CheckBulkLoad(const size_t numPoints, const BulkLoadMethod method)
+{
+  arma::mat dataset;
+  dataset.randu(8, numPoints);
+
+  typedef TreeType<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> Tree;
+  Tree tree(dataset, method, 20, 6, 5, 2);
+
+  REQUIRE(tree.NumDescendants() == numPoints);
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckHierarchy(tree);
+  CheckNumDescendants(tree);
+  CheckFills(tree);
+  CheckBulkLoadFills(tree);
+  REQUIRE(GetMinLevel(tree) == GetMaxLevel(tree));
+  REQUIRE(tree.TreeDepth() == GetMinLevel(tree));
+
+  // Nearest neighbor search with the bulk-loaded tree.
+  NeighborSearch<NearestNeighborSort, metric::LMetric<2, true>, arma::mat,
+      TreeType> knn1(std::move(tree), SINGLE_TREE_MODE);
+
+  arma::Mat<size_t> neighbors1;
+  arma::mat distances1;
+  knn1.Search(5, neighbors1, distances1);
+
+  // Nearest neighbor search the naive way.
+  KNN knn2(dataset, NAIVE_MODE);
+
+  arma::Mat<size_t> neighbors2;
+  arma::mat distances2;
+  knn2.Search(5, neighbors2, distances2);
+
+  for (size_t i = 0; i < neighbors1.size(); ++i)
+  {
+    REQUIRE(neighbors1[i] == neighbors2[i]);
+    REQUIRE(distances1[i] == distances2[i]);
+  }
+}
+
+// Make sure that bulk-loaded trees are valid, and give the right nearest
+// neighbors.
+TEST_CASE("RectangleTreeBulkLoadTest", "[RectangleTreeTraitsTest]")
+{
+  // 1000 points fill 50 leaves exactly; 1337 points don't.
+  CheckBulkLoad<RTree>(1000, SORT_TILE_RECURSIVE);
+  CheckBulkLoad<RTree>(1337, HILBERT_CURVE);
+  CheckBulkLoad<RStarTree>(1000, HILBERT_CURVE);
+  CheckBulkLoad<RStarTree>(1337, SORT_TILE_RECURSIVE);
+  CheckBulkLoad<XTree>(1337, SORT_TILE_RECURSIVE);
+  CheckBulkLoad<HilbertRTree>(1337, HILBERT_CURVE);
+
+  // A dataset that fits in a single leaf.
+  CheckBulkLoad<RStarTree>(15, SORT_TILE_RECURSIVE);
+}
+
+// Make sure that a bulk-loaded tree over a dataset that fills every leaf has
+// the smallest possible height.
+TEST_CASE("RectangleTreeBulkLoadHeightTest", "[RectangleTreeTraitsTest]")
+{
+  arma::mat dataset;
+  dataset.randu(3, 1000);
+
+  typedef RStarTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  TreeType tree(dataset, SORT_TILE_RECURSIVE, 20, 6, 5, 2);
+
+  // The root has 2 children with 5 children each, which have 5 full leaves
+  // each.
+  REQUIRE(tree.TreeDepth() == 4);
+  REQUIRE(tree.NumChildren() == 2);
+  REQUIRE(tree.Child(0).NumChildren() == 5);
+  REQUIRE(tree.Child(0).Child(0).NumChildren() == 5);
+  REQUIRE(tree.Child(0).Child(0).Child(0).Count() == 20);
+}
+
+// Make sure that a bulk-loaded Hilbert R tree keeps its points in Hilbert
+// order, and that it can't be bulk-loaded in any other order.
+TEST_CASE("HilbertRTreeBulkLoadTest", "[RectangleTreeTraitsTest]")
+{
+  arma::mat dataset;
+  dataset.randu(8, 1000); // 1000 points in 8 dimensions.
+
+  typedef HilbertRTree<EuclideanDistance,
+      NeighborSearchStat<NearestNeighborSort>, arma::mat> TreeType;
+  TreeType tree(dataset, HILBERT_CURVE, 20, 6, 5, 2);
+
+  CheckHilbertValue(tree);
+  CheckDiscreteHilbertValueSync(tree);
+  CheckHilbertOrdering(tree);
+
+  REQUIRE_THROWS_AS(TreeType(dataset, SORT_TILE_RECURSIVE),
+      std::invalid_argument);
+}
+
+// Make sure that points can be inserted into and deleted from bulk-loaded
+// trees.
+TEST_CASE("RectangleTreeBulkLoadUpdateTest", "[RectangleTreeTraitsTest]")
+{
+  const int numIter = 50;
+  arma::mat dataset;
+  dataset.randu(8, 1000); // 1000 points in 8 dimensions.
+
+  typedef RStarTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+  TreeType tree(dataset, SORT_TILE_RECURSIVE, 20, 6, 5, 2);
+
+  typedef HilbertRTree<EuclideanDistance,
+      NeighborSearchStat<NearestNeighborSort>, arma::mat> HilbertTreeType;
+  HilbertTreeType hilbertTree(dataset, HILBERT_CURVE, 20, 6, 5, 2);
+
+  // Delete the first points, and insert new points at the end.
+  arma::mat newPoints;
+  newPoints.randu(8, numIter);
+  tree.Dataset().resize(8, 1000 + numIter);
+  hilbertTree.Dataset().resize(8, 1000 + numIter);
+  for (int i = 0; i < numIter; ++i)
+  {
+    tree.DeletePoint(i);
+    hilbertTree.DeletePoint(i);
+
+    tree.Dataset().col(1000 + i) = newPoints.col(i);
+    tree.InsertPoint(1000 + i);
+    hilbertTree.Dataset().col(1000 + i) = newPoints.col(i);
+    hilbertTree.InsertPoint(1000 + i);
+  }
+
+  REQUIRE(tree.NumDescendants() == 1000);
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckHierarchy(tree);
+  CheckNumDescendants(tree);
+  REQUIRE(GetMinLevel(tree) == GetMaxLevel(tree));
+
+  REQUIRE(hilbertTree.NumDescendants() == 1000);
+  CheckContainment(hilbertTree);
+  CheckExactContainment(hilbertTree);
+  CheckHierarchy(hilbertTree);
+  CheckNumDescendants(hilbertTree);
+  CheckDiscreteHilbertValueSync(hilbertTree);
+  CheckHilbertOrdering(hilbertTree);
+
+  // Nearest neighbor search with the updated tree.  The deleted points are
+  // still in the dataset, but must never be returned.
+  arma::mat querySet;
+  querySet.randu(8, 100);
+
+  NeighborSearch<NearestNeighborSort, metric::LMetric<2, true>, arma::mat,
+      RStarTree> knn1(std::move(tree), SINGLE_TREE_MODE);
+
+  arma::Mat<size_t> neighbors1;
+  arma::mat distances1;
+  knn1.Search(querySet, 5, neighbors1, distances1);
+
+  // Nearest neighbor search the naive way, with only the points that are left.
+  arma::mat newDataset = arma::join_rows(dataset.cols(numIter, 999),
+      newPoints);
+  KNN knn2(newDataset, NAIVE_MODE);
+
+  arma::Mat<size_t> neighbors2;
+  arma::mat distances2;
+  knn2.Search(querySet, 5, neighbors2, distances2);
+
+  for (size_t i = 0; i < neighbors1.size(); ++i)
+  {
+    REQUIRE(neighbors1[i] == neighbors2[i] + numIter);
+    REQUIRE(distances1[i] == distances2[i]);
+  }
+}
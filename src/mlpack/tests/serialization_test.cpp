@@ -1073,16 +1073,109 @@ TEST_CASE("LSHTest", "[SerializationTest]")
   REQUIRE(lsh.BucketSize() == jsonLsh.BucketSize());
   REQUIRE(lsh.BucketSize() == binaryLsh.BucketSize());
 
-  REQUIRE(lsh.SecondHashTable().size() ==
-      xmlLsh.SecondHashTable().size());
-  REQUIRE(lsh.SecondHashTable().size() ==
-      jsonLsh.SecondHashTable().size());
-  REQUIRE(lsh.SecondHashTable().size() ==
-      binaryLsh.SecondHashTable().size());
-
-  for (size_t i = 0; i < lsh.SecondHashTable().size(); ++i)
-  CheckMatrices(lsh.SecondHashTable()[i], xmlLsh.SecondHashTable()[i],
-      jsonLsh.SecondHashTable()[i], binaryLsh.SecondHashTable()[i]);
+  CheckMatrices(lsh.BucketOffsets(), xmlLsh.BucketOffsets(),
+      jsonLsh.BucketOffsets(), binaryLsh.BucketOffsets());
+  CheckMatrices(lsh.BucketContents(), xmlLsh.BucketContents(),
+      jsonLsh.BucketContents(), binaryLsh.BucketContents());
+}
+
+/**
+ * The layout of LSHSearch models saved before the second hash table was stored
+ * in compressed sparse row form (class version 0).
+ */
+struct LSHSearchVersion0
+{
+  arma::mat referenceSet;
+  size_t numProj;
+  size_t numTables;
+  arma::cube projections;
+  arma::mat offsets;
+  double hashWidth;
+  size_t secondHashSize;
+  arma::vec secondHashWeights;
+  size_t bucketSize;
+  std::vector<arma::Col<size_t>> secondHashTable;
+  arma::Col<size_t> bucketContentSize;
+  arma::Col<size_t> bucketRowInHashTable;
+  size_t distanceEvaluations;
+
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(referenceSet));
+    ar(CEREAL_NVP(numProj));
+    ar(CEREAL_NVP(numTables));
+    ar(CEREAL_NVP(projections));
+    ar(CEREAL_NVP(offsets));
+    ar(CEREAL_NVP(hashWidth));
+    ar(CEREAL_NVP(secondHashSize));
+    ar(CEREAL_NVP(secondHashWeights));
+    ar(CEREAL_NVP(bucketSize));
+    ar(CEREAL_NVP(secondHashTable));
+    ar(CEREAL_NVP(bucketContentSize));
+    ar(CEREAL_NVP(bucketRowInHashTable));
+    ar(CEREAL_NVP(distanceEvaluations));
+  }
+};
+
+/**
+ * Make sure that LSH models saved in the old format are converted when they
+ * are loaded.
+ */
+TEST_CASE("LSHVersion0Test", "[SerializationTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(10, 200);
+  LSHSearch<> lsh(referenceData, 5, 10, 1.0, 997);
+
+  // Write the model in the old layout.
+  LSHSearchVersion0 old;
+  old.referenceSet = lsh.ReferenceSet();
+  old.projections = lsh.Projections();
+  old.numProj = old.projections.n_cols;
+  old.numTables = old.projections.n_slices;
+  old.offsets = lsh.Offsets();
+  old.hashWidth = 1.0;
+  old.secondHashSize = 997;
+  old.secondHashWeights = lsh.SecondHashWeights();
+  old.bucketSize = lsh.BucketSize();
+  old.bucketRowInHashTable.set_size(997);
+  old.bucketRowInHashTable.fill(997);
+  for (size_t b = 0; b < 997; ++b)
+  {
+    const size_t begin = lsh.BucketOffsets()[b];
+    const size_t end = lsh.BucketOffsets()[b + 1];
+    if (begin == end)
+      continue;
+
+    old.bucketRowInHashTable[b] = old.secondHashTable.size();
+    old.secondHashTable.push_back(lsh.BucketContents().subvec(begin, end - 1));
+  }
+  old.bucketContentSize.set_size(old.secondHashTable.size());
+  for (size_t i = 0; i < old.secondHashTable.size(); ++i)
+    old.bucketContentSize[i] = old.secondHashTable[i].n_elem;
+  old.distanceEvaluations = 0;
+
+  std::stringstream stream;
+  {
+    cereal::BinaryOutputArchive ar(stream);
+    ar(cereal::make_nvp("lsh", old));
+  }
+
+  LSHSearch<> loaded;
+  {
+    cereal::BinaryInputArchive ar(stream);
+    ar(cereal::make_nvp("lsh", loaded));
+  }
+
+  CheckMatrices(lsh.BucketOffsets(), loaded.BucketOffsets());
+  CheckMatrices(lsh.BucketContents(), loaded.BucketContents());
+
+  arma::Mat<size_t> neighbors, loadedNeighbors;
+  arma::mat distances, loadedDistances;
+  lsh.Search(3, neighbors, distances);
+  loaded.Search(3, loadedNeighbors, loadedDistances);
+  CheckMatrices(neighbors, loadedNeighbors);
+  CheckMatrices(distances, loadedDistances);
 }
 
 // Make sure serialization works for LARS.
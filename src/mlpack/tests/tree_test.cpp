@@ -1806,6 +1806,160 @@ TEST_CASE("BinarySpaceTreeMoveConstructorTest", "[TreeTest]")
   REQUIRE(tree2.NumChildren() == 2);
 }
 
+/**
+ * Make sure that two trees have the same structure and the same bounds.
+ */
+template<typename TreeType>
+void CheckSameTree(const TreeType& a, const TreeType& b)
+{
+  REQUIRE(a.Begin() == b.Begin());
+  REQUIRE(a.Count() == b.Count());
+  REQUIRE(a.NumChildren() == b.NumChildren());
+  REQUIRE(a.ParentDistance() == b.ParentDistance());
+  REQUIRE(a.FurthestDescendantDistance() == b.FurthestDescendantDistance());
+  REQUIRE(a.Bound().Dim() == b.Bound().Dim());
+  for (size_t d = 0; d < a.Bound().Dim(); ++d)
+  {
+    REQUIRE(a.Bound()[d].Lo() == b.Bound()[d].Lo());
+    REQUIRE(a.Bound()[d].Hi() == b.Bound()[d].Hi());
+  }
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+  {
+    REQUIRE(a.Child(i).Parent() == &a);
+    CheckSameTree(a.Child(i), b.Child(i));
+  }
+}
+
+/**
+ * Pack a tree in breadth-first and van Emde Boas order, and make sure that the
+ * packed tree is the same as the original tree and that it is laid out as
+ * expected.
+ */
+TEST_CASE("BinarySpaceTreePackTest", "[TreeTest]")
+{
+  arma::mat dataset(4, 1000);
+  dataset.randu();
+
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  TreeType tree(dataset, 10);
+
+  TreeType bfsTree(tree);
+  bfsTree.Pack(BREADTH_FIRST_ORDER);
+  REQUIRE(bfsTree.IsPacked());
+  CheckSameTree(bfsTree, tree);
+
+  // In breadth-first order, every level is contiguous.
+  REQUIRE(&bfsTree.Child(1) == &bfsTree.Child(0) + 1);
+  REQUIRE(&bfsTree.Child(0).Child(0) == &bfsTree.Child(1) + 1);
+  REQUIRE(&bfsTree.Child(1).Child(1) == &bfsTree.Child(0) + 5);
+  REQUIRE(!bfsTree.Child(0).Bound().OwnsMemory());
+  REQUIRE(&bfsTree.Child(1).Bound()[0] == &bfsTree.Child(0).Bound()[0] + 4);
+
+  TreeType vebTree(tree);
+  vebTree.Pack(VAN_EMDE_BOAS_ORDER);
+  REQUIRE(vebTree.IsPacked());
+  CheckSameTree(vebTree, tree);
+
+  // Packing again must also work.
+  vebTree.Pack(BREADTH_FIRST_ORDER);
+  CheckSameTree(vebTree, tree);
+
+  // A copy of a packed tree is not packed, but it is the same tree.
+  TreeType copy(vebTree);
+  REQUIRE(!copy.IsPacked());
+  CheckSameTree(copy, tree);
+
+  // Moving a packed tree keeps it packed.
+  TreeType moved(std::move(vebTree));
+  REQUIRE(moved.IsPacked());
+  REQUIRE(!vebTree.IsPacked());
+  CheckSameTree(moved, tree);
+
+  // Only the root can be packed.
+  REQUIRE_THROWS_AS(moved.Child(0).Pack(), std::invalid_argument);
+}
+
+/**
+ * Make sure that a split with ParallelPerformSplit() puts every point on the
+ * correct side and keeps the mapping correct, for a node with many blocks.
+ */
+TEST_CASE("ParallelPerformSplitTest", "[TreeTest]")
+{
+  typedef MidpointSplit<HRectBound<EuclideanDistance>, arma::mat> SplitType;
+
+  arma::mat dataset(3, 5 * split::parallelSplitBlockSize + 17);
+  dataset.randu();
+  arma::mat data(dataset);
+
+  std::vector<size_t> oldFromNew(data.n_cols);
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+    oldFromNew[i] = i;
+
+  SplitType::SplitInfo splitInfo;
+  splitInfo.splitDimension = 1;
+  splitInfo.splitVal = 0.3;
+
+  const size_t begin = 5;
+  const size_t count = data.n_cols - 10;
+  const size_t splitCol = split::ParallelPerformSplit<arma::mat, SplitType>(
+      data, begin, count, splitInfo, &oldFromNew);
+
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    if (i < begin || i >= begin + count)
+      REQUIRE(oldFromNew[i] == i);
+    else if (i < splitCol)
+      REQUIRE(data(1, i) < 0.3);
+    else
+      REQUIRE(data(1, i) >= 0.3);
+
+    for (size_t d = 0; d < data.n_rows; ++d)
+      REQUIRE(data(d, i) == dataset(d, oldFromNew[i]));
+  }
+}
+
+/**
+ * Build a large tree in parallel, and make sure that it is correct and that the
+ * same tree and mapping is built with only one thread.
+ */
+template<typename TreeType>
+void CheckParallelBuild()
+{
+  arma::mat dataset(4, 3 * split::parallelSplitBlockSize);
+  dataset.randu();
+
+  std::vector<size_t> oldFromNew;
+  TreeType tree(dataset, oldFromNew, 10);
+
+  REQUIRE(CheckPointBounds(tree));
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    for (size_t d = 0; d < dataset.n_rows; ++d)
+      REQUIRE(tree.Dataset()(d, i) == dataset(d, oldFromNew[i]));
+
+  #ifdef HAS_OPENMP
+  const int numThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  #endif
+
+  std::vector<size_t> serialOldFromNew;
+  TreeType serialTree(dataset, serialOldFromNew, 10);
+
+  #ifdef HAS_OPENMP
+  omp_set_num_threads(numThreads);
+  #endif
+
+  REQUIRE(oldFromNew == serialOldFromNew);
+  CheckSameTree(tree, serialTree);
+}
+
+TEST_CASE("ParallelBinarySpaceTreeBuildTest", "[TreeTest]")
+{
+  CheckParallelBuild<KDTree<EuclideanDistance, EmptyStatistic, arma::mat>>();
+  CheckParallelBuild<MeanSplitKDTree<EuclideanDistance, EmptyStatistic,
+      arma::mat>>();
+}
+
 template<typename TreeType>
 void RecurseTreeCountLeaves(const TreeType& node, arma::vec& counts)
 {
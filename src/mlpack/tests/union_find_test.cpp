@@ -10,6 +10,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 
 #include <mlpack/core.hpp>
 #include "catch.hpp"
@@ -47,3 +48,60 @@ TEST_CASE("TestUnion", "[UnionFindTest]")
   REQUIRE(testUnionFind.Find(1) == testUnionFind.Find(5));
   REQUIRE(testUnionFind.Find(6) == testUnionFind.Find(3));
 }
+
+TEST_CASE("ConcurrentTestUnion", "[UnionFindTest]")
+{
+  static const size_t testSize = 10;
+  ConcurrentUnionFind testUnionFind(testSize);
+
+  for (size_t i = 0; i < testSize; ++i)
+    REQUIRE(testUnionFind.Find(i) == i);
+
+  testUnionFind.Union(0, 1);
+  testUnionFind.Union(2, 3);
+  testUnionFind.Union(0, 2);
+  testUnionFind.Union(5, 0);
+  testUnionFind.Union(6, 9);
+
+  REQUIRE(testUnionFind.Find(0) == testUnionFind.Find(1));
+  REQUIRE(testUnionFind.Find(2) == testUnionFind.Find(3));
+  REQUIRE(testUnionFind.Find(1) == testUnionFind.Find(5));
+  REQUIRE(testUnionFind.Find(6) != testUnionFind.Find(3));
+
+  // The root of each component is its smallest element.
+  REQUIRE(testUnionFind.Find(5) == 0);
+  REQUIRE(testUnionFind.Find(9) == 6);
+  REQUIRE(testUnionFind.Find(4) == 4);
+}
+
+TEST_CASE("ConcurrentTestParallelUnion", "[UnionFindTest]")
+{
+  static const size_t testSize = 5000;
+  static const size_t numUnions = 4000;
+
+  arma::Col<size_t> first = arma::randi<arma::Col<size_t>>(numUnions,
+      arma::distr_param(0, testSize - 1));
+  arma::Col<size_t> second = arma::randi<arma::Col<size_t>>(numUnions,
+      arma::distr_param(0, testSize - 1));
+
+  UnionFind serialUnionFind(testSize);
+  for (size_t i = 0; i < numUnions; ++i)
+    serialUnionFind.Union(first[i], second[i]);
+
+  ConcurrentUnionFind testUnionFind(testSize);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) numUnions; ++i)
+    testUnionFind.Union(first[i], second[i]);
+
+  // The components must match, and each root must be the smallest element of
+  // its component.
+  for (size_t i = 0; i < testSize; ++i)
+  {
+    const size_t root = testUnionFind.Find(i);
+    REQUIRE(root <= i);
+    REQUIRE(serialUnionFind.Find(i) == serialUnionFind.Find(root));
+  }
+
+  for (size_t i = 0; i < numUnions; ++i)
+    REQUIRE(testUnionFind.Find(first[i]) == testUnionFind.Find(second[i]));
+}